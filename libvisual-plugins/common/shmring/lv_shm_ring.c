@@ -0,0 +1,281 @@
+/* Libvisual-plugins - Standard plugins for libvisual
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "lv_shm_ring.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+static LVShmRingSlot *get_slot (LVShmRing *ring, uint64_t seq)
+{
+	size_t stride = sizeof (LVShmRingSlot) + ring->slot_size;
+	size_t index  = (seq - 1) % ring->slot_count;
+
+	return (LVShmRingSlot *) ((uint8_t *) (ring->header + 1) + index * stride);
+}
+
+size_t lv_shm_ring_get_file_size (uint32_t slot_count, uint32_t slot_size)
+{
+	return sizeof (LVShmRingHeader) + (size_t) slot_count * (sizeof (LVShmRingSlot) + slot_size);
+}
+
+/* Clears the magic of the ring file open at fd, if it is one, so readers
+ * still mapping it know to reopen the path */
+static void retire_ring (int fd)
+{
+	uint32_t magic = 0;
+	ssize_t written;
+
+	if (pread (fd, &magic, sizeof (magic), 0) != sizeof (magic) || magic != LV_SHM_RING_MAGIC)
+		return;
+
+	/* Nothing more can be done if this fails, the new ring is in place */
+	magic = 0;
+	written = pwrite (fd, &magic, sizeof (magic), 0);
+	(void) written;
+}
+
+int lv_shm_ring_create (LVShmRing *ring, const char *path,
+                        uint32_t slot_count, uint32_t slot_size,
+                        uint32_t channels, uint32_t sample_rate, uint32_t format)
+{
+	size_t size;
+	void *area;
+	char *temp_path;
+	int old_fd, saved_errno;
+
+	if (slot_count == 0 || slot_size == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Keep slots 8 byte aligned */
+	slot_size = (slot_size + 7) & ~7U;
+	size = lv_shm_ring_get_file_size (slot_count, slot_size);
+
+	/* Build the ring in a new file, as readers may have the old one mapped
+	 * and truncating it under them would fault their next access */
+	temp_path = malloc (strlen (path) + sizeof (".XXXXXX"));
+	if (temp_path == NULL)
+		return -1;
+
+	sprintf (temp_path, "%s.XXXXXX", path);
+
+	ring->fd = mkstemp (temp_path);
+	if (ring->fd < 0) {
+		free (temp_path);
+		return -1;
+	}
+
+	if (fchmod (ring->fd, 0644) != 0 || ftruncate (ring->fd, size) != 0)
+		goto fail;
+
+	area = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->fd, 0);
+	if (area == MAP_FAILED)
+		goto fail;
+
+	ring->map_size   = size;
+	ring->header     = area;
+	ring->slot_count = slot_count;
+	ring->slot_size  = slot_size;
+	ring->read_seq   = 0;
+	ring->dropped    = 0;
+
+	ring->header->magic       = LV_SHM_RING_MAGIC;
+	ring->header->version     = LV_SHM_RING_VERSION;
+	ring->header->slot_count  = slot_count;
+	ring->header->slot_size   = slot_size;
+	ring->header->channels    = channels;
+	ring->header->sample_rate = sample_rate;
+	ring->header->format      = format;
+	ring->header->write_seq   = 0;
+
+	/* Put the complete ring in place, then retire the one it replaces */
+	old_fd = open (path, O_RDWR);
+
+	if (rename (temp_path, path) != 0) {
+		saved_errno = errno;
+
+		if (old_fd >= 0)
+			close (old_fd);
+
+		munmap (area, size);
+		ring->header = NULL;
+
+		errno = saved_errno;
+		goto fail;
+	}
+
+	if (old_fd >= 0) {
+		retire_ring (old_fd);
+		close (old_fd);
+	}
+
+	free (temp_path);
+
+	return 0;
+
+fail:
+	saved_errno = errno;
+
+	close (ring->fd);
+	unlink (temp_path);
+	free (temp_path);
+
+	errno = saved_errno;
+
+	return -1;
+}
+
+int lv_shm_ring_open (LVShmRing *ring, const char *path)
+{
+	LVShmRingHeader header;
+	struct stat st;
+	void *area;
+
+	ring->fd = open (path, O_RDONLY);
+	if (ring->fd < 0)
+		return -1;
+
+	if (fstat (ring->fd, &st) != 0 || (size_t) st.st_size < sizeof (header)
+			|| read (ring->fd, &header, sizeof (header)) != sizeof (header)
+			|| header.magic != LV_SHM_RING_MAGIC
+			|| header.version != LV_SHM_RING_VERSION
+			|| header.slot_count == 0
+			|| (size_t) st.st_size < lv_shm_ring_get_file_size (header.slot_count, header.slot_size)) {
+		close (ring->fd);
+		errno = EINVAL;
+		return -1;
+	}
+
+	ring->map_size = lv_shm_ring_get_file_size (header.slot_count, header.slot_size);
+
+	area = mmap (0, ring->map_size, PROT_READ, MAP_SHARED, ring->fd, 0);
+	if (area == MAP_FAILED) {
+		close (ring->fd);
+		return -1;
+	}
+
+	ring->header     = area;
+	ring->slot_count = header.slot_count;
+	ring->slot_size  = header.slot_size;
+	ring->read_seq   = __atomic_load_n (&ring->header->write_seq, __ATOMIC_ACQUIRE);
+	ring->dropped    = 0;
+
+	return 0;
+}
+
+void lv_shm_ring_close (LVShmRing *ring)
+{
+	if (ring->header != NULL)
+		munmap (ring->header, ring->map_size);
+
+	if (ring->fd >= 0)
+		close (ring->fd);
+
+	ring->header = NULL;
+	ring->fd = -1;
+}
+
+void lv_shm_ring_write (LVShmRing *ring, const void *data, uint32_t size, uint64_t timestamp)
+{
+	uint64_t seq = ring->header->write_seq + 1;
+	LVShmRingSlot *slot = get_slot (ring, seq);
+
+	if (size > ring->slot_size)
+		size = ring->slot_size;
+
+	/* Mark the slot busy before touching its contents */
+	__atomic_store_n (&slot->seq, 0, __ATOMIC_RELAXED);
+	__atomic_thread_fence (__ATOMIC_RELEASE);
+
+	slot->timestamp = timestamp;
+	slot->size = size;
+	memcpy (slot + 1, data, size);
+
+	__atomic_store_n (&slot->seq, seq, __ATOMIC_RELEASE);
+	__atomic_store_n (&ring->header->write_seq, seq, __ATOMIC_RELEASE);
+}
+
+int lv_shm_ring_read (LVShmRing *ring, void *dest, uint32_t *size, uint64_t *timestamp)
+{
+	uint64_t write_seq;
+
+	/* Only the layout taken at open is used for indexing, so the ring is
+	 * given up on as soon as the header disagrees with it */
+	if (__atomic_load_n (&ring->header->magic, __ATOMIC_ACQUIRE) != LV_SHM_RING_MAGIC
+			|| ring->header->slot_count != ring->slot_count
+			|| ring->header->slot_size != ring->slot_size) {
+		errno = ESTALE;
+		return -1;
+	}
+
+	write_seq = __atomic_load_n (&ring->header->write_seq, __ATOMIC_ACQUIRE);
+
+	/* The producer restarted, start over from its current position */
+	if (write_seq < ring->read_seq)
+		ring->read_seq = write_seq;
+
+	/* Skip blocks that have been overwritten already */
+	if (write_seq - ring->read_seq > ring->slot_count) {
+		ring->dropped += write_seq - ring->read_seq - ring->slot_count;
+		ring->read_seq = write_seq - ring->slot_count;
+	}
+
+	while (ring->read_seq < write_seq) {
+		uint64_t seq = ++ring->read_seq;
+		LVShmRingSlot *slot = get_slot (ring, seq);
+		uint32_t slot_size;
+
+		if (__atomic_load_n (&slot->seq, __ATOMIC_ACQUIRE) != seq) {
+			ring->dropped++;
+			continue;
+		}
+
+		slot_size = slot->size;
+		if (slot_size > ring->slot_size)
+			slot_size = ring->slot_size;
+
+		if (timestamp != NULL)
+			*timestamp = slot->timestamp;
+
+		memcpy (dest, slot + 1, slot_size);
+
+		/* Drop the block if the producer came around while copying */
+		__atomic_thread_fence (__ATOMIC_ACQUIRE);
+		if (__atomic_load_n (&slot->seq, __ATOMIC_RELAXED) != seq) {
+			ring->dropped++;
+			continue;
+		}
+
+		*size = slot_size;
+
+		return 1;
+	}
+
+	return 0;
+}
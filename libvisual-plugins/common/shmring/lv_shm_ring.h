@@ -0,0 +1,127 @@
+/* Libvisual-plugins - Standard plugins for libvisual
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_SHM_RING_H
+#define _LV_SHM_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Shared memory audio ring.
+ *
+ * A producer process maps a file and writes blocks of interleaved samples
+ * into a ring of fixed size slots. Each block gets the next sequence
+ * number, starting from 1. The file begins with a header, followed by
+ * slot_count slots of (sizeof (LVShmRingSlot) + slot_size) bytes each.
+ *
+ * To write block n, the producer marks slot (n - 1) % slot_count busy by
+ * setting its seq to 0, fills in the slot, sets its seq to n and finally
+ * sets the header's write_seq to n. A reader remembers the last sequence
+ * number it has taken and only reads newer blocks. It rereads a slot's seq
+ * after copying the data out, and drops the block if the producer got to
+ * the slot in the meantime.
+ *
+ * A ring file is never resized in place. A producer builds a new file
+ * next to the old one and renames it over the path, then clears the magic
+ * of the old file. Readers still mapping the old file see the magic change
+ * and reopen the path.
+ */
+
+#define LV_SHM_RING_MAGIC   0x5253564cU /* "LVSR" */
+#define LV_SHM_RING_VERSION 1
+
+typedef struct {
+	uint32_t magic;          /**< LV_SHM_RING_MAGIC */
+	uint32_t version;        /**< LV_SHM_RING_VERSION */
+	uint32_t slot_count;     /**< number of slots */
+	uint32_t slot_size;      /**< bytes of sample data per slot */
+	uint32_t channels;       /**< number of interleaved channels */
+	uint32_t sample_rate;    /**< sample rate in Hz */
+	uint32_t format;         /**< sample format, a VisAudioSampleFormatType */
+	uint32_t reserved;
+	uint64_t write_seq;      /**< sequence number of the last complete block */
+} LVShmRingHeader;
+
+typedef struct {
+	uint64_t seq;            /**< sequence number of the block, 0 while being written */
+	uint64_t timestamp;      /**< capture time of the first frame of the block, in CLOCK_MONOTONIC microseconds */
+	uint32_t size;           /**< bytes of sample data in the block */
+	uint32_t reserved;
+} LVShmRingSlot;
+
+typedef struct {
+	int              fd;
+	size_t           map_size;
+	LVShmRingHeader *header;
+	uint32_t         slot_count; /**< slot count the ring was mapped with */
+	uint32_t         slot_size;  /**< slot size the ring was mapped with */
+	uint64_t         read_seq;  /**< last sequence number taken by the reader */
+	uint64_t         dropped;   /**< blocks overwritten before they could be read */
+} LVShmRing;
+
+/** Returns the size of a ring file with the given layout. */
+size_t lv_shm_ring_get_file_size (uint32_t slot_count, uint32_t slot_size);
+
+/**
+ * Creates a ring file and maps it for writing. Any ring already at path
+ * is replaced, and its readers are told to reopen it.
+ *
+ * @return 0 on success, -1 on failure with errno set
+ */
+int lv_shm_ring_create (LVShmRing *ring, const char *path,
+                        uint32_t slot_count, uint32_t slot_size,
+                        uint32_t channels, uint32_t sample_rate, uint32_t format);
+
+/**
+ * Maps an existing ring file for reading. Only blocks written after this
+ * are read.
+ *
+ * @return 0 on success, -1 on failure with errno set (EINVAL if the file
+ *         is not a ring)
+ */
+int lv_shm_ring_open (LVShmRing *ring, const char *path);
+
+/** Unmaps the ring and closes its file. */
+void lv_shm_ring_close (LVShmRing *ring);
+
+/**
+ * Writes a block to the ring.
+ *
+ * @param data      interleaved samples
+ * @param size      size of data in bytes, at most slot_size
+ * @param timestamp capture time of the first frame in CLOCK_MONOTONIC
+ *                  microseconds, or 0 if not known
+ */
+void lv_shm_ring_write (LVShmRing *ring, const void *data, uint32_t size, uint64_t timestamp);
+
+/**
+ * Reads the oldest block not read yet.
+ *
+ * @param dest      buffer for the samples, at least slot_size bytes
+ * @param size      receives the size of the block in bytes
+ * @param timestamp receives the capture time of the block, may be NULL
+ *
+ * @return 1 if a block was read, 0 if there is no new block, -1 with errno
+ *         set to ESTALE if the ring was replaced or no longer has the
+ *         layout it was opened with. It must then be closed and reopened.
+ */
+int lv_shm_ring_read (LVShmRing *ring, void *dest, uint32_t *size, uint64_t *timestamp);
+
+#endif /* _LV_SHM_RING_H */
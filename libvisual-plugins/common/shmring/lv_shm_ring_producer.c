@@ -0,0 +1,119 @@
+/* Libvisual-plugins - Standard plugins for libvisual
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+/*
+ * Test producer for the shared memory audio ring. Writes a stereo 16-bit
+ * sine sweep into a ring file in real time, so input plugins reading the
+ * ring can be tried out without a player.
+ *
+ * Usage: lv_shm_ring_producer <file> [sample rate] [seconds]
+ */
+
+#include "lv_shm_ring.h"
+
+#include <libvisual/libvisual.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#define BLOCK_FRAMES 512
+#define SLOT_COUNT   16
+
+static uint64_t get_time_usecs (void)
+{
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+
+	return (uint64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+int main (int argc, char *argv[])
+{
+	LVShmRing ring;
+	int16_t block[BLOCK_FRAMES * 2];
+	unsigned int rate = 44100;
+	double seconds = 10.0;
+	double phase = 0.0;
+	uint64_t start, blocks, i;
+
+	if (argc < 2) {
+		fprintf (stderr, "Usage: %s <file> [sample rate] [seconds]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (argc > 2)
+		rate = strtoul (argv[2], NULL, 10);
+
+	if (argc > 3)
+		seconds = strtod (argv[3], NULL);
+
+	if (rate == 0) {
+		fprintf (stderr, "Invalid sample rate\n");
+		return EXIT_FAILURE;
+	}
+
+	if (lv_shm_ring_create (&ring, argv[1], SLOT_COUNT, sizeof (block), 2, rate,
+	                        VISUAL_AUDIO_SAMPLE_FORMAT_S16) != 0) {
+		fprintf (stderr, "Could not create ring '%s': %s\n", argv[1], strerror (errno));
+		return EXIT_FAILURE;
+	}
+
+	blocks = (uint64_t) (seconds * rate / BLOCK_FRAMES);
+	start  = get_time_usecs ();
+
+	for (i = 0; i < blocks; i++) {
+		uint64_t due = start + (i + 1) * BLOCK_FRAMES * 1000000 / rate;
+		uint64_t now;
+		int j;
+
+		/* Sweep from 110 Hz up to 1760 Hz and back every 8 seconds */
+		for (j = 0; j < BLOCK_FRAMES; j++) {
+			double t = (double) (i * BLOCK_FRAMES + j) / rate;
+			double freq = 110.0 * pow (2.0, 4.0 * (1.0 - fabs (fmod (t, 8.0) / 4.0 - 1.0)));
+
+			phase += 2.0 * M_PI * freq / rate;
+			if (phase > 2.0 * M_PI)
+				phase -= 2.0 * M_PI;
+
+			block[j * 2]     = (int16_t) (16384.0 * sin (phase));
+			block[j * 2 + 1] = (int16_t) (16384.0 * cos (phase));
+		}
+
+		now = get_time_usecs ();
+		if (due > now) {
+			struct timespec delay;
+
+			delay.tv_sec  = (due - now) / 1000000;
+			delay.tv_nsec = (due - now) % 1000000 * 1000;
+			nanosleep (&delay, NULL);
+		}
+
+		/* Stamp the block as if captured in real time */
+		lv_shm_ring_write (&ring, block, sizeof (block), due - BLOCK_FRAMES * 1000000 / rate);
+	}
+
+	lv_shm_ring_close (&ring);
+
+	return EXIT_SUCCESS;
+}
@@ -177,7 +177,7 @@ static int act_blursk_init (VisPluginData *plugin) {
     priv->pal      = visual_palette_new (256);
     priv->pcmbuf   = visual_buffer_new_allocate (512 * sizeof (float));
 
-    config_default (&config);
+    config_default (&priv->config);
 
     __blursk_init (priv);
 
@@ -227,8 +227,8 @@ static void act_blursk_resize (VisPluginData *plugin, int width, int height)
         priv->width = width;
         priv->height = height;
 
-        config.height = height;
-        config.width = width;
+        priv->config.height = height;
+        priv->config.width = width;
 }
 
 static int act_blursk_events (VisPluginData *plugin, VisEventQueue *events)
@@ -263,7 +263,7 @@ static int act_blursk_events (VisPluginData *plugin, VisEventQueue *events)
             case VISUAL_EVENT_NEWSONG:
                 newsong = ev.event.newsong.songinfo;
                 /* pass along the song info to blursk's core */
-                blursk_event_newsong(newsong);
+                blursk_event_newsong(priv, newsong);
                 break;
             default:
                 break;
@@ -280,7 +280,7 @@ static int act_blursk_events (VisPluginData *plugin, VisEventQueue *events)
 
     /* resize plugin */
     if(size_update)
-        img_resize(priv, config.width, config.height);
+        img_resize(priv, priv->config.width, priv->config.height);
 
     return TRUE;
 }
@@ -22,8 +22,236 @@
 #define _LV_ACTOR_BLURSK_H
 
 #include <libvisual/libvisual.h>
+#include <time.h>
 
+/* To detect rhythms, blursk tracks the loudness of the signal across multiple
+ * frames.  This is the maximum number of frames, and should correspond to the
+ * slowest rhythm.
+ */
+#define BEAT_MAX    200
+
+/* Each blur function can use up to MAXRANDOM random numbers when generating
+ * pixel motion vectors.
+ */
+#define MAXRANDOM   64
+
+/* Some of the plotting functions interpolate to generate extra data points. */
+#define MAXPOINTS   512
+
+/* Maximum number of floaters on screen */
+#define MAXFLOATERS 10
+
+typedef struct BlurskPrivate BlurskPrivate;
+
+typedef struct
+{
+    /* dimensions */
+    int width;
+    int height;
+
+    /* color options */
+    uint32_t color;
+    char    *color_style;
+    char    *fade_speed;
+    char    *signal_color;
+    int      contour_lines;
+    int      hue_on_beats;
+    char    *background;
+
+    /* blur/fade options */
+    char    *blur_style;
+    char    *transition_speed;
+    char    *blur_when;
+    char    *blur_stencil;
+    int      slow_motion;
+
+    /* other effects */
+    char    *signal_style;
+    char    *plot_style;
+    int      thick_on_beats;
+    char    *flash_style;
+    char    *overall_effect;
+    char    *floaters;
+
+    /* miscellany from the Advanced screen */
+    char    *cpu_speed;
+    char    *show_info;
+    int     info_timeout;
+    int     show_timestamp;
+
+    /* beat detector */
+    int32_t beat_sensitivity;
+
+    /* config-string */
+    char *config_string;
+} BlurskConfig;
+
+/* Beat detector state (blursk.c) */
 typedef struct {
+    int32_t  history[BEAT_MAX];
+    int      base;
+    int      quiet;      /* force "quiet" situation? */
+    int32_t  aged;       /* smoothed out loudness */
+    int32_t  lowest;     /* quietest point in current beat */
+    int      elapsed;    /* frames since last beat */
+    int      isquiet;    /* was previous frame quiet */
+    int      prevbeat;   /* period of previous beat */
+} BlurskBeat;
+
+/* Floater state (blursk.c) */
+typedef struct {
+    int      prevfloaters;
+    struct {
+        int      x, y, age;
+        uint8_t  color;
+    } floater[MAXFLOATERS];
+    int      oddeven;
+} BlurskFloaters;
+
+/* Song info overlay state (blursk.c) */
+typedef struct {
+    VisSongInfo *songinfo;
+    int          newsong;    /* set when a new song should be shown */
+    int          prevpos;
+    char         buf[1000];
+    time_t       start, then;
+    int          persistent;
+} BlurskInfo;
+
+/* Blur motion state (blur.c) */
+typedef struct {
+    /* random numbers held constant for all pixels in a given blur style */
+    int      randval[MAXRANDOM];
+
+    /* source offsets for the blurloop function */
+    int      width, height;
+    int      xcenter, ycenter;
+    int      last;
+
+    /* used to compute the transition from one blur style to another */
+    char     stylename[50];
+    char     stencilname[50];
+    char     blurname[50];
+    int      isspectrum; /* boolean: is current signal_style a spectrum? */
+    char     blurchar;   /* first letter of blurname, or random */
+    int    (*stylefunc)(BlurskPrivate *priv, int offset);
+    int      styletransition;
+    int      stylekeeprandom;
+    int      stylelower, styleprevlower;
+
+    /* used to help hide anomalies from some of the blur styles */
+    int      salt;
+
+    /* id of the current stencil bitmap, or -1 for no bitmap */
+    int      stencil;
+    int      intostencil;
+    int      edgesmooth;
+
+    /* wobble state of backward() */
+    int      wobble, dir;
+
+    /* "Reduced blur" phase, and alternate blurring direction */
+    int      phase, phase2;
+    int      odd;
+} BlurskBlur;
+
+/* Color map state (color.c) */
+typedef struct {
+    /* Blursk's version of the colors */
+    uint32_t  colors[256];
+
+    /* computes the value of a given cell in the color map */
+    int32_t (*stylefunc)(BlurskPrivate *priv, int32_t i);
+
+    /* R/G/B components of the base color */
+    int32_t   red, green, blue;
+
+    /* random color, used for the "Colored background" setting */
+    int32_t   tored, togreen, toblue;
+    int       tonew;
+    int32_t   fromred, fromgreen, fromblue;
+    int32_t   bgred, bggreen, bgblue;
+    char      bgletter; /* first letter of chosen bkgnd, after "Random" */
+
+    int       transition_bound;
+
+    /* fall-off of the "Flash bkgnd" color */
+    int32_t   fallr, fallg, fallb;
+} BlurskColor;
+
+/* Image buffers (img.c) */
+typedef struct {
+    uint8_t      *buf;        /* base of the current image buffer */
+    uint8_t      *tmp;        /* base of another image buffer, for temp operations */
+    uint8_t     **source;     /* an array of pixel pointers, for blur motion */
+    unsigned int  height;     /* height of the current image */
+    unsigned int  width;      /* width of the current image */
+    unsigned int  bpl;        /* bytes per line of the current image */
+    unsigned int  chunks;     /* number of 8-pixel chunks in the image */
+
+    unsigned int  physheight; /* height of the current window */
+    unsigned int  physwidth;  /* width of the current window */
+    uint8_t       rippleshift;/* ripple map cycling counter */
+    uint8_t       travelshift;/* colormap shift of the "Anti-fade effect" */
+
+    /* base addresses of allocated memory */
+    uint8_t      *base_buf;
+    uint8_t      *base_tmp;
+    uint8_t     **base_source;
+
+    /* state of the "cpu_speed" option when bufs were allocated */
+    char          speed;
+} BlurskImg;
+
+/* Plotting state (render.c) */
+typedef struct {
+    int16_t  data[MAXPOINTS];
+
+    int      first;
+    int      thick;
+    uint8_t  color;
+    double   theta;
+    double   sin, cos;
+    double   prevsin, prevcos;
+    int      count;
+    int      max;
+    int      x[512], y[512];
+    int      prevmax;
+    int      prevx[512], prevy[512];
+    int      fromx, fromy;
+
+    /* previous data of the radial spectrum */
+    int16_t  prev[MAXPOINTS];
+    int      nprev;
+} BlurskRender;
+
+/* Bitmap scaling state (bitmap.c) */
+struct bdx_s;
+
+typedef struct {
+    int      xnum, xdenom, xtrans;
+    int      ynum, ydenom, ytrans;
+    int      prevwidth, prevheight;
+    struct bdx_s *bdx;
+} BlurskBitmap;
+
+/* Text overlay state (text.c) */
+typedef struct {
+    const char **chmap[127];
+    int      height;     /* height of the tallest character, plus 1 */
+    int      frame;      /* frame counter, used for color-cycling */
+    int      bg;         /* background color for text */
+    int      row;
+    int      big;
+} BlurskText;
+
+/* Config string state (paste.c) */
+typedef struct {
+    char         buf[100];
+    BlurskConfig parsed;
+} BlurskPaste;
+
+struct BlurskPrivate {
         int                      height;
         int                      width;
         /* true if colormap should be regenerated */
@@ -36,6 +264,23 @@ typedef struct {
         VisColor                color;
         VisPluginData           *plugin;
         int                     update_config_string;
-} BlurskPrivate;
+
+        BlurskConfig            config;
+
+        /* used for slow motion */
+        int                     oddeven;
+        int                     nspectrums;
+
+        BlurskBeat              beat;
+        BlurskFloaters          floaters;
+        BlurskInfo              info;
+        BlurskBlur              blur;
+        BlurskColor             color_map;
+        BlurskImg               img;
+        BlurskRender            render;
+        BlurskBitmap            bitmap;
+        BlurskText              text;
+        BlurskPaste             paste;
+};
 
 #endif /* _LV_ACTOR_BLURSK_H */
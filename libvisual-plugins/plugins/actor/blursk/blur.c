@@ -155,120 +155,72 @@ static int dither[MAXTRANSITION] =
 };
 #endif
 
-/* These store random numbers that are held constant for all pixels in a
- * given blur style.  Each blur function can use up to MAXRANDOM random
- * numbers when generating pixel motion vectors.
- */
-#define MAXRANDOM   64
-static int randval[MAXRANDOM];
-
 /* The "Slow switch" setting performs less that one transition loop per frame.
  * For example, setting this constant to 3 causes one transition loop on every
  * third frame, for a very slow change.
  */
 #define SWITCH_FRACTION 3
 
-/* These store the source offsets for the blurloop function. */
-static int  blurwidth, blurheight;
-static int  blurxcenter, blurycenter;
-static int  blurlast;
-
-/* These are used to compute the transition from one blur style to another */
-static char stylename[50];
-static char stencilname[50];
-static char blurname[50];
-static int  isspectrum; /* boolean: is current signal_style a spectrum? */
-static char blurchar;   /* first letter of blurname, or random */
-static int  (*stylefunc)(int offset);
-static int  styletransition = -1;
-static int  stylekeeprandom;
-static int  stylelower, styleprevlower;
-
-/* This is used to help hide anomalies from some of the blur styles */
-static int  salt;
-
-/**
- * This stores the id of the current stencil bitmap, or -1 for no bitmap.
- * It is a global variable because it also affects bitmap flashes.
- */
-int blur_stencil;
-
-/**
- * This flag indicates whether blur motions should be happy about pulling
- * their source pixels from within a stencil.  Most blur motions try to work
- * around stencils, but a few look better with this turned on.
- */
-static int blurintostencil;
-
-/**
- * This flag indicates whether we prefer smooth edges, or smooth areas, for
- * this particular blur motion.  This is a minor feature; you need to look
- * close to see the difference.  With this flag turned off, the edges of some
- * blur motions may seem to vibrate; with it turned on, large areas which
- * should be smooth may appear to have a checkerboard pattern.
- */
- static int edgesmooth;
-
 
 /**
  * every pixel is blurred from the pixels around it 
  */
-static int simple(int offset)
+static int simple(BlurskPrivate *priv, int offset)
 {
-    if (randval[0] == 0)
+    if (priv->blur.randval[0] == 0)
         return 0;
-    switch (randval[0] & 0x7)
+    switch (priv->blur.randval[0] & 0x7)
     {
       case 0:   return 1;
-      case 1:   return img_bpl + 1;
-      case 2:   return img_bpl;
-      case 3:   return img_bpl - 1;
+      case 1:   return priv->img.bpl + 1;
+      case 2:   return priv->img.bpl;
+      case 3:   return priv->img.bpl - 1;
       case 4:   return -1;
-      case 5:   return -img_bpl - 1;
-      case 6:   return -img_bpl;
-      default:  return -img_bpl + 1;
+      case 5:   return -priv->img.bpl - 1;
+      case 6:   return -priv->img.bpl;
+      default:  return -priv->img.bpl + 1;
     }
 }
 
 /**
  * every pixel is blurred from pixels surrounding a neighbor 
  */
-static int grainy(int offset)
+static int grainy(BlurskPrivate *priv, int offset)
 {
-    if (++salt >= 14) salt = 0;
-    switch (salt)
+    if (++priv->blur.salt >= 14) priv->blur.salt = 0;
+    switch (priv->blur.salt)
     {
-      case 0:   return -img_bpl - 1;
-      case 1:   return -img_bpl;
-      case 2:   return -img_bpl + 1;
+      case 0:   return -priv->img.bpl - 1;
+      case 1:   return -priv->img.bpl;
+      case 2:   return -priv->img.bpl + 1;
       case 3:   return 1;
-      case 4:   return img_bpl + 1;
-      case 5:   return img_bpl;
-      case 6:   return img_bpl - 1;
+      case 4:   return priv->img.bpl + 1;
+      case 5:   return priv->img.bpl;
+      case 6:   return priv->img.bpl - 1;
       case 7:   return -1;
-      case 8:   return img_bpl + 2;
+      case 8:   return priv->img.bpl + 2;
       case 9:   return 2;
-      case 10:  return img_bpl - 2;
-      case 11:  return -img_bpl - 2;
+      case 10:  return priv->img.bpl - 2;
+      case 11:  return -priv->img.bpl - 2;
       case 12:  return -2;
-      default:  return -img_bpl + 2;
+      default:  return -priv->img.bpl + 2;
     }
 }
 
 /**
  * Pixels go up, down, left, and right 
  */
-static int fourway(int offset)
+static int fourway(BlurskPrivate *priv, int offset)
 {
     int x, y;
 
-    x = offset % img_bpl;
-    y = offset / img_bpl;
+    x = offset % priv->img.bpl;
+    y = offset / priv->img.bpl;
     switch (((y & 1) << 1) | (x & 1))
     {
       case 0:   return -2;
-      case 1:   return 2 * img_bpl;
-      case 2:   return -2 * img_bpl;
+      case 1:   return 2 * priv->img.bpl;
+      case 2:   return -2 * priv->img.bpl;
       default:  return 2;
     }
 }
@@ -277,45 +229,45 @@ static int fourway(int offset)
  * every pixel is blurred from pixels slightly below it, which causes the
  * blur to drift upward.
  */
-static int rise(int offset)
+static int rise(BlurskPrivate *priv, int offset)
 {
-    return img_bpl;
+    return priv->img.bpl;
 }
 
-static int wiggle(int offset)
+static int wiggle(BlurskPrivate *priv, int offset)
 {
-    int y = (offset / img_bpl) + (offset & 0x1);
+    int y = (offset / priv->img.bpl) + (offset & 0x1);
     if ((y & 0x0f) < 3)
-        return img_bpl;
+        return priv->img.bpl;
     else if (y & 0x10)
-        return img_bpl - 1;
+        return priv->img.bpl - 1;
     else
-        return img_bpl + 1;
+        return priv->img.bpl + 1;
 }
 
 /**
  * pixels above the middle blur up, and pixels below the middle blur down 
  */
-static int updown(int offset)
+static int updown(BlurskPrivate *priv, int offset)
 {
-    offset /= img_bpl;
-    if (offset < blurycenter)
-        return img_bpl;
+    offset /= priv->img.bpl;
+    if (offset < priv->blur.ycenter)
+        return priv->img.bpl;
     else
-        return -img_bpl;
+        return -priv->img.bpl;
 }
 
 /**
  * pixels on the left move leftward, and pixels on the right move rightward 
  */
-static int leftright(int offset)
+static int leftright(BlurskPrivate *priv, int offset)
 {
-    offset %= img_bpl;
-    if (offset < blurxcenter / 2)
+    offset %= priv->img.bpl;
+    if (offset < priv->blur.xcenter / 2)
         return 2;
-    else if (offset < blurxcenter)
+    else if (offset < priv->blur.xcenter)
         return 1;
-    else if (offset < (blurxcenter + blurwidth) / 2)
+    else if (offset < (priv->blur.xcenter + priv->blur.width) / 2)
         return -1;
     else
         return -2;
@@ -326,14 +278,14 @@ static int leftright(int offset)
  * to move outward.  This is done in a way which causes the blur to move faster
  * near the edge.
  */
-static int forward(int offset)
+static int forward(BlurskPrivate *priv, int offset)
 {
     int x, y;
     int dirx, diry;
 
     /* convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* Separate the sign from the magnitude.  We must do this to get
      * consistent behavior from the "/" operator in all quadrants.
@@ -347,29 +299,29 @@ static int forward(int offset)
     /* Convert coordinates to source offset, by subtracting a scaled-down
      * version of them from themselves.
      */
-    y -= (y * 63 + salt) / 64;
-    x -= (x * 63 + salt) / 64;
-    if (++salt >= 63) salt = 0;
+    y -= (y * 63 + priv->blur.salt) / 64;
+    x -= (x * 63 + priv->blur.salt) / 64;
+    if (++priv->blur.salt >= 63) priv->blur.salt = 0;
 
     /* adjust for quadrants */
     y *= diry;
     x *= dirx;
 
     /* return the offset of the source point, relative to this one */
-    return -y * img_bpl - x;
+    return -y * priv->img.bpl - x;
 }
 
 /**
  * A more extreme version of forward() 
  */
-static int fastfwd(int offset)
+static int fastfwd(BlurskPrivate *priv, int offset)
 {
     int x, y;
     int dirx, diry;
 
     /* convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* Separate the sign from the magnitude.  We must do this to get
      * consistent behavior from the "/" operator in all quadrants.
@@ -383,26 +335,26 @@ static int fastfwd(int offset)
     /* Convert coordinates to source offset, by subtracting a scaled-down
      * version of them from themselves.
      */
-    y -= (y * 15 + salt) >> 4;
-    x -= (x * 15 + salt) >> 4;
-    if (++salt >= 16) salt = 0;
+    y -= (y * 15 + priv->blur.salt) >> 4;
+    x -= (x * 15 + priv->blur.salt) >> 4;
+    if (++priv->blur.salt >= 16) priv->blur.salt = 0;
 
     /* adjust for quadrants */
     y *= diry;
     x *= dirx;
 
     /* return the offset of the source point, relative to this one */
-    return -y * img_bpl - x;
+    return -y * priv->img.bpl - x;
 }
 
-static int spray(int offset)
+static int spray(BlurskPrivate *priv, int offset)
 {
     int x, y;
-    x = offset % img_bpl;
-    y = offset / img_bpl;
+    x = offset % priv->img.bpl;
+    y = offset / priv->img.bpl;
     y >>= 1;
-    offset = y * img_bpl + x;
-    return forward(offset);
+    offset = y * priv->img.bpl + x;
+    return forward(priv, offset);
 }
 
 /**
@@ -410,35 +362,34 @@ static int spray(int offset)
  * to move inward.  This is done in a way which causes the blur to move faster
  * near the edge.  Also, it supports an optional random twisting motion.
  */
-static int backward(int offset)
+static int backward(BlurskPrivate *priv, int offset)
 {
     int     x, y;
     int     dirx, diry;
-    static int  wobble = 0, dir = 1;
 
     /* convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* adjust the wobble amount */
-    if (randval[0] == 0)
-        wobble = 0;
+    if (priv->blur.randval[0] == 0)
+        priv->blur.wobble = 0;
     else
     {
-        if (randval[0] != 3)
+        if (priv->blur.randval[0] != 3)
         {
-            if (wobble == -2)
-                dir = 1;
-            else if (wobble == 2)
-                dir = -1;
-            wobble += dir;
-            randval[0] = 3;
+            if (priv->blur.wobble == -2)
+                priv->blur.dir = 1;
+            else if (priv->blur.wobble == 2)
+                priv->blur.dir = -1;
+            priv->blur.wobble += priv->blur.dir;
+            priv->blur.randval[0] = 3;
         }
     }
 
     /* spin the image slightly, based on a random number */
     diry = y;
-    switch (wobble)
+    switch (priv->blur.wobble)
     {
       case -2:
         y += x;
@@ -477,37 +428,37 @@ static int backward(int offset)
     /* Convert coordinates to source offset, by subtracting a scaled-up
      * version of them from themselves.
      */
-    y -= (y * 65 + salt) / 64;
-    x -= (x * 65 + salt) / 64;
-    if (++salt >= 63) salt = 0;
+    y -= (y * 65 + priv->blur.salt) / 64;
+    x -= (x * 65 + priv->blur.salt) / 64;
+    if (++priv->blur.salt >= 63) priv->blur.salt = 0;
 
     /* adjust for quadrants */
     y *= diry;
     x *= dirx;
 
     /* return the offset of the source point, relative to this one */
-    return -y * img_bpl - x;
+    return -y * priv->img.bpl - x;
 }
 
 /**
  * This divides the screen into four quadrants, and then reduces & rotates
  * them to duplicate the image into each quadrant.
  */
-static int fractal(int offset)
+static int fractal(BlurskPrivate *priv, int offset)
 {
     int x, y;
 
     /* Compute the position within a quadrant, and then scale that quadrant
      * up to the size of the whole image.
      */
-    x = (offset % img_bpl) * 2 % img_width;
-    y = (offset / img_bpl) * 2 % img_height;
+    x = (offset % priv->img.bpl) * 2 % priv->img.width;
+    y = (offset / priv->img.bpl) * 2 % priv->img.height;
 
     /* return that offset */
-    return y * img_bpl + x - offset;
+    return y * priv->img.bpl + x - offset;
 }
 
-static int sphere(int offset)
+static int sphere(BlurskPrivate *priv, int offset)
 {
     int x, y;
     int dist2;
@@ -515,29 +466,29 @@ static int sphere(int offset)
     double  angle, through;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* For "Medium CPU", double X to preserve aspect ratio.  For "Slow CPU"
      * double both of them to preserve size. */
-    if (*config.cpu_speed != 'F')
+    if (*priv->config.cpu_speed != 'F')
     {
         x *= 2;
-        if (*config.cpu_speed == 'S')
+        if (*priv->config.cpu_speed == 'S')
             y *= 2;
     }
 
     /* compute the square of the distance from the center. */
     dist2 = x * x + y * y;
-    radius2 = blurycenter * blurycenter;
-    if (*config.cpu_speed != 'S')
+    radius2 = priv->blur.ycenter * priv->blur.ycenter;
+    if (*priv->config.cpu_speed != 'S')
         radius2 >>= 1;
     else
         radius2 <<= 1;
 
     /* If outside the "sphere" then use one of the other motions. */
-    if (randval[0] != 0 && radius2 < dist2)
-        return fractal(offset);
+    if (priv->blur.randval[0] != 0 && radius2 < dist2)
+        return fractal(priv, offset);
 
     /* the center could cause problems -- just use 0 as the offset there */
     if (dist2 < 5)
@@ -551,16 +502,16 @@ static int sphere(int offset)
     through = sqrt((double)abs(radius2 - dist2) / 6.0);
     if (radius2 < dist2)
         through = -through;
-    x = blurxcenter + (int)(through * cos(angle));
-    y = blurycenter + (int)(through * sin(angle));
-    return fastfwd(y * img_bpl + x);
+    x = priv->blur.xcenter + (int)(through * cos(angle));
+    y = priv->blur.ycenter + (int)(through * sin(angle));
+    return fastfwd(priv, y * priv->img.bpl + x);
 }
 
 
 /**
  * rotate left, right, or both. 
  */
-static int spinhelp(int offset, int right, int spiral, int twist)
+static int spinhelp(BlurskPrivate *priv, int offset, int right, int spiral, int twist)
 {
     int x, y;
     int dirx, diry;
@@ -568,8 +519,8 @@ static int spinhelp(int offset, int right, int spiral, int twist)
     int radius;
 
     /* convert offset to (x,y) coordinates */
-    y = offset / img_bpl;
-    x = offset % img_bpl;
+    y = offset / priv->img.bpl;
+    x = offset % priv->img.bpl;
 
     if (right)
     {
@@ -578,14 +529,14 @@ static int spinhelp(int offset, int right, int spiral, int twist)
          * other half of the scan line, to prevent "shadows" from
          * the perimeter.
          */
-        if (y == 1 && x > blurxcenter + 12)
-            return blurxcenter;
-        if (y == 2 && x > blurxcenter + 20)
-            return -img_bpl - blurxcenter;
-        if (y == blurheight - 3 && x < blurxcenter - 20)
-            return img_bpl + blurxcenter;
-        if (y == blurheight - 2 && x < blurxcenter - 12)
-            return -blurxcenter;
+        if (y == 1 && x > priv->blur.xcenter + 12)
+            return priv->blur.xcenter;
+        if (y == 2 && x > priv->blur.xcenter + 20)
+            return -priv->img.bpl - priv->blur.xcenter;
+        if (y == priv->blur.height - 3 && x < priv->blur.xcenter - 20)
+            return priv->img.bpl + priv->blur.xcenter;
+        if (y == priv->blur.height - 2 && x < priv->blur.xcenter - 12)
+            return -priv->blur.xcenter;
     }
     else
     {
@@ -594,19 +545,19 @@ static int spinhelp(int offset, int right, int spiral, int twist)
          * other half of the scan line, to prevent "shadows" from
          * the perimeter.
          */
-        if (y == 1 && x < blurxcenter - 12)
-            return img_bpl + blurxcenter;
-        if (y == 2 && x < blurxcenter - 20)
-            return -blurxcenter;
-        if (y == blurheight - 3 && x > blurxcenter + 20)
-            return blurxcenter;
-        if (y == blurheight - 2 && x > blurxcenter + 12)
-            return -img_bpl - blurxcenter;
+        if (y == 1 && x < priv->blur.xcenter - 12)
+            return priv->img.bpl + priv->blur.xcenter;
+        if (y == 2 && x < priv->blur.xcenter - 20)
+            return -priv->blur.xcenter;
+        if (y == priv->blur.height - 3 && x > priv->blur.xcenter + 20)
+            return priv->blur.xcenter;
+        if (y == priv->blur.height - 2 && x > priv->blur.xcenter + 12)
+            return -priv->img.bpl - priv->blur.xcenter;
     }
 
     /* Adjust so (0,0) is at center */
-    y -= blurycenter;
-    x -= blurxcenter;
+    y -= priv->blur.ycenter;
+    x -= priv->blur.xcenter;
 
     /* Separate the sign from the magnitude.  We must do this to get
      * consistent behavior from the "/" operator in all quadrants.
@@ -620,20 +571,20 @@ static int spinhelp(int offset, int right, int spiral, int twist)
     /* Convert coordinates to source offsets.  For the "Medium CPU"
      * setting, we need to tweak the aspect ratio.
      */
-    if (*config.cpu_speed == 'M')
+    if (*priv->config.cpu_speed == 'M')
     {
         x *= 2;
         radius = x + y + 5;
         if (twist)
         {
-            if (radius < blurycenter * 2)
-                radius = blurycenter - radius/2;
+            if (radius < priv->blur.ycenter * 2)
+                radius = priv->blur.ycenter - radius/2;
             else
                 radius = 5;
         }
-        if (++salt >= radius * 2) salt = 0;
-        dx = (y * 2 + salt) / radius;
-        dy = (x * 4 + salt) / radius;
+        if (++priv->blur.salt >= radius * 2) priv->blur.salt = 0;
+        dx = (y * 2 + priv->blur.salt) / radius;
+        dy = (x * 4 + priv->blur.salt) / radius;
     }
     else
     {
@@ -641,16 +592,16 @@ static int spinhelp(int offset, int right, int spiral, int twist)
         if (twist)
         {
 #if 1
-            radius = blurycenter - radius/2;
+            radius = priv->blur.ycenter - radius/2;
             if (radius < 5)
                 radius = 5;
 #else
-            radius = (blurycenter + blurxcenter + 10) / radius + 5;
+            radius = (priv->blur.ycenter + priv->blur.xcenter + 10) / radius + 5;
 #endif
         }
-        if (++salt * 2 >= radius * 3) salt = 0;
-        dx = (y * 4 + salt) / radius;
-        dy = (x * 4 + salt) / radius;
+        if (++priv->blur.salt * 2 >= radius * 3) priv->blur.salt = 0;
+        dx = (y * 4 + priv->blur.salt) / radius;
+        dy = (x * 4 + priv->blur.salt) / radius;
     }
 
     /* adjust for quadrants, depending on spin direction */
@@ -679,82 +630,82 @@ static int spinhelp(int offset, int right, int spiral, int twist)
     }
 
     /* return the offset of the source point, relative to this one */
-    return dy * img_bpl + dx;
+    return dy * priv->img.bpl + dx;
 }
 
 /**
  * pixels are blurred from pixels that are rotated around the image center 
  */
-static int spin(int offset)
+static int spin(BlurskPrivate *priv, int offset)
 {
-    return spinhelp(offset, randval[0] & 1, FALSE, FALSE);
+    return spinhelp(priv, offset, priv->blur.randval[0] & 1, FALSE, FALSE);
 }
 
-static int bullseye(int offset)
+static int bullseye(BlurskPrivate *priv, int offset)
 {
     int x, y;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* For "Medium CPU", double X to preserve aspect ratio.  For "Slow CPU"
      * double both of them to preserve size. */
-    if (*config.cpu_speed != 'F')
+    if (*priv->config.cpu_speed != 'F')
     {
         x *= 2;
-        if (*config.cpu_speed == 'S')
+        if (*priv->config.cpu_speed == 'S')
             y *= 2;
     }
     
     /* Based on distance to center, spin left or right */
     if ((x * x + y * y + 3000) & 4096)
-        return spinhelp(offset, TRUE, FALSE, FALSE);
+        return spinhelp(priv, offset, TRUE, FALSE, FALSE);
     else
-        return spinhelp(offset, FALSE, FALSE, FALSE);
+        return spinhelp(priv, offset, FALSE, FALSE, FALSE);
 }
 
-static int spiral(int offset)
+static int spiral(BlurskPrivate *priv, int offset)
 {
-    return spinhelp(offset, randval[0] & 1, TRUE, FALSE);
+    return spinhelp(priv, offset, priv->blur.randval[0] & 1, TRUE, FALSE);
 }
 
-static int drain(int offset)
+static int drain(BlurskPrivate *priv, int offset)
 {
-    return -spiral(offset);
+    return -spiral(priv, offset);
 }
 
-static int ripple(int offset)
+static int ripple(BlurskPrivate *priv, int offset)
 {
     int x, y;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* For "Medium CPU", double X to preserve aspect ratio.  For "Slow CPU"
      * double both of them to preserve size. */
-    if (*config.cpu_speed != 'F')
+    if (*priv->config.cpu_speed != 'F')
     {
         x *= 2;
-        if (*config.cpu_speed == 'S')
+        if (*priv->config.cpu_speed == 'S')
             y *= 2;
     }
     
     /* Based on distance to center, spin left or right */
     if ((x * x + y * y + 5000) & 2048)
-        return spinhelp(offset, TRUE, TRUE, FALSE);
+        return spinhelp(priv, offset, TRUE, TRUE, FALSE);
     else
-        return spinhelp(offset, FALSE, TRUE, FALSE);
+        return spinhelp(priv, offset, FALSE, TRUE, FALSE);
 }
 
-static int prismatic(int offset)
+static int prismatic(BlurskPrivate *priv, int offset)
 {
     int x, y, d;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* Choose a direction by reducing x & y to square coords instead of
      * pixel coords, and then checking their odd/evenness.  This is easier
@@ -764,24 +715,24 @@ static int prismatic(int offset)
     switch ((y & 0x08) | ((x >> 1) & 0x04))
     {
       case 0x00: d = -1;        break;
-      case 0x04: d = img_bpl;   break;
-      case 0x08: d = -img_bpl;  break;
+      case 0x04: d = priv->img.bpl;   break;
+      case 0x08: d = -priv->img.bpl;  break;
       default:   d = 1;     break;
     }
 
     return d;
 }
 
-static int swirl(int offset)
+static int swirl(BlurskPrivate *priv, int offset)
 {
     int x, y, d;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
-    salt = (salt + 1) & 0x7;
-    switch (salt >> 1)
+    priv->blur.salt = (priv->blur.salt + 1) & 0x7;
+    switch (priv->blur.salt >> 1)
     {
       case 0:   y += 2; break;
       case 1:   x += 2; break;
@@ -798,42 +749,42 @@ static int swirl(int offset)
      * diagonal directions, instead of Parquet's orthogonal directions.
      * Oh, and the squares are larger.
      */
-    d = 1 + (salt & 1);
+    d = 1 + (priv->blur.salt & 1);
     switch ((y & 0x10) | ((x >> 1) & 0x08))
     {
-      case 0x00: d = img_bpl - d;   break;
-      case 0x08: d = -img_bpl - d;  break;
-      case 0x10: d = img_bpl + d;   break;
-      default:   d = -img_bpl + d;  break;
+      case 0x00: d = priv->img.bpl - d;   break;
+      case 0x08: d = -priv->img.bpl - d;  break;
+      case 0x10: d = priv->img.bpl + d;   break;
+      default:   d = -priv->img.bpl + d;  break;
     }
 
     return d;
 }
 
-static int shred(int offset)
+static int shred(BlurskPrivate *priv, int offset)
 {
-    switch (randval[0] & 3)
+    switch (priv->blur.randval[0] & 3)
     {
       case 0:
-        if ((offset % (img_bpl - 1)) & 0x10)
-            return img_bpl - 1;
+        if ((offset % (priv->img.bpl - 1)) & 0x10)
+            return priv->img.bpl - 1;
         else
-            return -img_bpl + 1;
+            return -priv->img.bpl + 1;
 
       case 1:
-        if ((offset % (img_bpl + 1)) & 0x10)
-            return img_bpl + 1;
+        if ((offset % (priv->img.bpl + 1)) & 0x10)
+            return priv->img.bpl + 1;
         else
-            return -img_bpl - 1;
+            return -priv->img.bpl - 1;
 
       case 2:
-        if ((offset % img_bpl) & 0x10)
-            return img_bpl;
+        if ((offset % priv->img.bpl) & 0x10)
+            return priv->img.bpl;
         else
-            return -img_bpl;
+            return -priv->img.bpl;
 
       default:
-        if ((offset / img_bpl) & 0x10)
+        if ((offset / priv->img.bpl) & 0x10)
             return 1;
         else
             return -1;
@@ -843,7 +794,7 @@ static int shred(int offset)
 /**
  * This gives an interesting binary tree effect 
  */
-static int binary(int offset)
+static int binary(BlurskPrivate *priv, int offset)
 {
     return offset;
 }
@@ -851,35 +802,35 @@ static int binary(int offset)
 /**
  * Gravity -- images accelerate downward 
  */
-static int gravity(int offset)
+static int gravity(BlurskPrivate *priv, int offset)
 {
     /* compute height */
-    offset = offset / img_bpl;
+    offset = offset / priv->img.bpl;
     
     /* Compute dy from the height, with salt */
-    offset = (offset * 3 + salt) / blurheight;
-    if (++salt >= blurheight) salt = 0;
+    offset = (offset * 3 + priv->blur.salt) / priv->blur.height;
+    if (++priv->blur.salt >= priv->blur.height) priv->blur.salt = 0;
 
     /* Return an offset, derived from dy */
-    return offset * -img_bpl;
+    return offset * -priv->img.bpl;
 }
 
-static int cylinder(int offset)
+static int cylinder(BlurskPrivate *priv, int offset)
 {
     /* compute height, with salt */
-    offset = offset / img_bpl;
+    offset = offset / priv->img.bpl;
 
     /* return sin(height) */
-    if (++salt >= 100) salt = 0;
-    offset = (int)((double)salt/100.0 + 2.5 * sin((double)offset / (double)img_height * VISUAL_MATH_PI));
-    return offset * img_bpl;
+    if (++priv->blur.salt >= 100) priv->blur.salt = 0;
+    offset = (int)((double)priv->blur.salt/100.0 + 2.5 * sin((double)offset / (double)priv->img.height * VISUAL_MATH_PI));
+    return offset * priv->img.bpl;
 }
 
 
 /**
  * Each 16x16 pixel square moves in a random direction 
  */
-static int tangram(int offset)
+static int tangram(BlurskPrivate *priv, int offset)
 {
     int x, y;
 
@@ -889,21 +840,21 @@ static int tangram(int offset)
      * piece of the 8x8 square is actually a 16x16-pixel area.  All of this
      * complicates our computation somewhat.
      */
-    x = ((offset % img_bpl - blurxcenter) >> 4);
-    y = (((offset / img_bpl - blurycenter) >> 4) + (x >> 3)) & 0x7;
+    x = ((offset % priv->img.bpl - priv->blur.xcenter) >> 4);
+    y = (((offset / priv->img.bpl - priv->blur.ycenter) >> 4) + (x >> 3)) & 0x7;
     x &= 0x7;
 
     /* return an offset based on that square's random number */
-    switch (randval[(y << 3) + x] & 0x7)
+    switch (priv->blur.randval[(y << 3) + x] & 0x7)
     {
-      case 0:   return img_bpl - 1;
-      case 1:   return img_bpl + 1;
-      case 2:   return -img_bpl - 1;
-      case 3:   return -img_bpl + 1;
+      case 0:   return priv->img.bpl - 1;
+      case 1:   return priv->img.bpl + 1;
+      case 2:   return -priv->img.bpl - 1;
+      case 3:   return -priv->img.bpl + 1;
       case 4:   return -1;
       case 5:   return 1;
-      case 6:   return img_bpl;
-      default:  return -img_bpl;
+      case 6:   return priv->img.bpl;
+      default:  return -priv->img.bpl;
     }
 }
 
@@ -912,95 +863,95 @@ static int tangram(int offset)
  * in a random direction.  The division is based on 3 mostly-vertical lines
  * and 2 mostly-horizontal lines.
  */
-static int divided(int offset)
+static int divided(BlurskPrivate *priv, int offset)
 {
     int x, y, i;
 
     /* if first time, then convert random numbers to edge coordinates */
-    if (salt == 0)
+    if (priv->blur.salt == 0)
     {
-        salt = 1;
+        priv->blur.salt = 1;
 
         /* Convert mostly-vertical values */
         for (i = 0; i < 3; i++)
         {
-            randval[i * 2] %= img_width;
-            randval[i * 2 + 1] = (randval[i * 2 + 1] & 0xff) - 127;
+            priv->blur.randval[i * 2] %= priv->img.width;
+            priv->blur.randval[i * 2 + 1] = (priv->blur.randval[i * 2 + 1] & 0xff) - 127;
         }
 
         /* Convert mostly-horizontal values */
         for (i = 3; i < 5; i++)
         {
-            randval[i * 2] %= img_height;
-            randval[i * 2 + 1] = (randval[i * 2 + 1] & 0xff) - 127;
+            priv->blur.randval[i * 2] %= priv->img.height;
+            priv->blur.randval[i * 2 + 1] = (priv->blur.randval[i * 2 + 1] & 0xff) - 127;
         }
 
         /* Convert the motion values */
         for (i = 10; i < 42; i++)
         {
-            switch (randval[i] % 20)
+            switch (priv->blur.randval[i] % 20)
             {
-              case 0:   randval[i] = -2 * img_bpl - 1;  break;
-              case 1:   randval[i] = -2 * img_bpl;  break;
-              case 2:   randval[i] = -2 * img_bpl + 1;  break;
-              case 3:   randval[i] = -img_bpl - 2;  break;
-              case 4:   randval[i] = -img_bpl - 1;  break;
-              case 5:   randval[i] = -img_bpl;      break;
-              case 6:   randval[i] = -img_bpl + 1;  break;
-              case 7:   randval[i] = -img_bpl + 1;  break;
-              case 8:   randval[i] = -2;        break;
-              case 9:   randval[i] = -1;        break;
-              case 10:  randval[i] = 1;         break;
-              case 11:  randval[i] = 2;         break;
-              case 12:  randval[i] = img_bpl - 2;   break;
-              case 13:  randval[i] = img_bpl - 1;   break;
-              case 14:  randval[i] = img_bpl;       break;
-              case 15:  randval[i] = img_bpl + 1;   break;
-              case 16:  randval[i] = img_bpl + 2;   break;
-              case 17:  randval[i] = 2 * img_bpl - 1;   break;
-              case 18:  randval[i] = 2 * img_bpl;   break;
-              case 19:  randval[i] = 2 * img_bpl + 1;   break;
+              case 0:   priv->blur.randval[i] = -2 * priv->img.bpl - 1;  break;
+              case 1:   priv->blur.randval[i] = -2 * priv->img.bpl;  break;
+              case 2:   priv->blur.randval[i] = -2 * priv->img.bpl + 1;  break;
+              case 3:   priv->blur.randval[i] = -priv->img.bpl - 2;  break;
+              case 4:   priv->blur.randval[i] = -priv->img.bpl - 1;  break;
+              case 5:   priv->blur.randval[i] = -priv->img.bpl;      break;
+              case 6:   priv->blur.randval[i] = -priv->img.bpl + 1;  break;
+              case 7:   priv->blur.randval[i] = -priv->img.bpl + 1;  break;
+              case 8:   priv->blur.randval[i] = -2;        break;
+              case 9:   priv->blur.randval[i] = -1;        break;
+              case 10:  priv->blur.randval[i] = 1;         break;
+              case 11:  priv->blur.randval[i] = 2;         break;
+              case 12:  priv->blur.randval[i] = priv->img.bpl - 2;   break;
+              case 13:  priv->blur.randval[i] = priv->img.bpl - 1;   break;
+              case 14:  priv->blur.randval[i] = priv->img.bpl;       break;
+              case 15:  priv->blur.randval[i] = priv->img.bpl + 1;   break;
+              case 16:  priv->blur.randval[i] = priv->img.bpl + 2;   break;
+              case 17:  priv->blur.randval[i] = 2 * priv->img.bpl - 1;   break;
+              case 18:  priv->blur.randval[i] = 2 * priv->img.bpl;   break;
+              case 19:  priv->blur.randval[i] = 2 * priv->img.bpl + 1;   break;
             }
         }
     }
         
     /* get the pixel coordinates of this point */
-    x = offset % img_bpl;
-    y = offset / img_bpl;
+    x = offset % priv->img.bpl;
+    y = offset / priv->img.bpl;
 
     /* Use each line as a divider, and merge a '1' or '0' bit into the
      * chunk id based on which side of each line the point is on.
      */
     i = 0;
-    if (x - randval[0] < (y * randval[1]) >> 8)
+    if (x - priv->blur.randval[0] < (y * priv->blur.randval[1]) >> 8)
         i |= 1;
-    if (x - randval[2] < (y * randval[3]) >> 8)
+    if (x - priv->blur.randval[2] < (y * priv->blur.randval[3]) >> 8)
         i |= 2;
-    if (x - randval[4] < (y * randval[5]) >> 8)
+    if (x - priv->blur.randval[4] < (y * priv->blur.randval[5]) >> 8)
         i |= 4;
-    if (y - randval[6] < (x * randval[7]) >> 8)
+    if (y - priv->blur.randval[6] < (x * priv->blur.randval[7]) >> 8)
         i |= 8;
-    if (y - randval[8] < (x * randval[9]) >> 8)
+    if (y - priv->blur.randval[8] < (x * priv->blur.randval[9]) >> 8)
         i |= 16;
 
     /* Return the motion vector for that chunk */
-    return randval[i + 10];
+    return priv->blur.randval[i + 10];
 }
 
-static int weave(int offset)
+static int weave(BlurskPrivate *priv, int offset)
 {
     int x, y, g;
     int xsize, ysize;
 
     /* Convert offset to (x,y) coordinates, with (0,0) at center */
-    y = offset / img_bpl - blurycenter;
-    x = offset % img_bpl - blurxcenter;
+    y = offset / priv->img.bpl - priv->blur.ycenter;
+    x = offset % priv->img.bpl - priv->blur.xcenter;
 
     /* The weave pattern consists of a 4x4 grid of squares.  Figure out
      * where this pixel is in the grid.  Also set x & y to the position
      * within the square, because sometimes that matters.
      */
-    switch (*config.cpu_speed)
+    switch (*priv->config.cpu_speed)
     {
       case 'S': /* Slow CPU */
         xsize = 8;
@@ -1032,19 +983,19 @@ static int weave(int offset)
     {
       case 1:
         if (y == 0)
-            return -(ysize + 1) * img_bpl;
+            return -(ysize + 1) * priv->img.bpl;
         /* else fall through... */
       case 5:
       case 9:
-        return -img_bpl;
+        return -priv->img.bpl;
 
       case 3:
         if (y == ysize - 1)
-            return (ysize + 1) * img_bpl;
+            return (ysize + 1) * priv->img.bpl;
         /* else fall through... */
       case 11:
       case 15:
-        return img_bpl;
+        return priv->img.bpl;
 
       case 4:
         if (x == xsize - 1)
@@ -1075,44 +1026,44 @@ static int weave(int offset)
  * point is located exactly on a flow point; when this function returns 1,
  * the flow function that called it should return a 0 offset.
  */
-static int flow_help(int x, int y, int *totdxref, int *totdyref)
+static int flow_help(BlurskPrivate *priv, int x, int y, int *totdxref, int *totdyref)
 {
     int i, h, w;
     double  dx, dy, r2, dxpart, dypart, scale;
 
     /* If first time, then generate random flow points */
-    if (salt == 0)
+    if (priv->blur.salt == 0)
     {
-        salt = 1;
+        priv->blur.salt = 1;
 
         /* It turns out that totally random points don't usually give
          * a very good effect.  So instead we'll divide the window into
          * 9 subsections and put one point in each.  Then we'll add a
          * 10th totally random point.
          */
-        w = img_width / 4;
-        h = img_height / 4;
+        w = priv->img.width / 4;
+        h = priv->img.height / 4;
         for (i = 0; i < 9; i++)
         {
-            randval[i * 2] = (i % 3) * w + rand_0_to(w) + w/2;
-            randval[i * 2 + 1] = (i / 3) * h + rand_0_to(h) + h/2;
+            priv->blur.randval[i * 2] = (i % 3) * w + rand_0_to(priv, w) + w/2;
+            priv->blur.randval[i * 2 + 1] = (i / 3) * h + rand_0_to(priv, h) + h/2;
         }
-        randval[18] = rand_0_to(img_width);
-        randval[19] = rand_0_to(img_height);
+        priv->blur.randval[18] = rand_0_to(priv, priv->img.width);
+        priv->blur.randval[19] = rand_0_to(priv, priv->img.height);
     }
 
     /* Add the flow factor from each flow point */
     dx = dy = 0.0;
-    scale = (double)(img_width + img_height) / 300.0;
+    scale = (double)(priv->img.width + priv->img.height) / 300.0;
     for (i = 0; i < 20; i += 2)
     {
         /* if point is exactly on a flow point, then don't move. */
-        if (x == randval[i] && y == randval[i + 1])
+        if (x == priv->blur.randval[i] && y == priv->blur.randval[i + 1])
             return 1;
 
         /* Compute a flow vector from this point */
-        dxpart = (double)(randval[i] - x);
-        dypart = (double)(randval[i + 1] - y);
+        dxpart = (double)(priv->blur.randval[i] - x);
+        dypart = (double)(priv->blur.randval[i + 1] - y);
         r2 = sqrt(dxpart * dxpart + dypart * dypart + 15.0) / scale;
         dxpart /= r2;
         dypart /= r2;
@@ -1130,50 +1081,50 @@ static int flow_help(int x, int y, int *totdxref, int *totdyref)
     }
 
     /* Convert the flow vectors to ints, with salt */
-    if (++salt > 81) salt = 1;
-    *totdxref = dx + (double)(salt % 9 - 4) / 4.0;
-    *totdyref = dy + (double)((salt - 1) / 9 - 4) / 4.0;
+    if (++priv->blur.salt > 81) priv->blur.salt = 1;
+    *totdxref = dx + (double)(priv->blur.salt % 9 - 4) / 4.0;
+    *totdyref = dy + (double)((priv->blur.salt - 1) / 9 - 4) / 4.0;
     return 0;
 }
 
-static int flow(int offset)
+static int flow(BlurskPrivate *priv, int offset)
 {
     int x, y;
     int dx, dy;
 
     /* Convert offset to x & y coordinates */
-    x = offset % img_bpl;
-    y = offset / img_bpl;
+    x = offset % priv->img.bpl;
+    y = offset / priv->img.bpl;
 
     /* Compute the flow vector */
-    if (flow_help(x, y, &dx, &dy))
+    if (flow_help(priv, x, y, &dx, &dy))
         return 0;
 
     /* Convert flow vector to an offset, and return it */
-    return dy * img_bpl + dx;
+    return dy * priv->img.bpl + dx;
 }
 
-static int flowaround(int offset)
+static int flowaround(BlurskPrivate *priv, int offset)
 {
     int x, y;
     int dx, dy;
 
     /* Convert offset to x & y coordinates */
-    x = offset % img_bpl;
-    y = offset / img_bpl;
+    x = offset % priv->img.bpl;
+    y = offset / priv->img.bpl;
 
     /* Compute the flow vector */
-    if (flow_help(x, y, &dx, &dy))
+    if (flow_help(priv, x, y, &dx, &dy))
         return 0;
 
     /* For the "Medium CPU" setting, we need to tweak the aspect ratio. */
-    if (*config.cpu_speed == 'M')
+    if (*priv->config.cpu_speed == 'M')
         dx <<= 1; /* really dy because of the following swap */
 
     /* Convert flow vector to an offset, and return it.  Note that we
      * swap dx & dy, and negate dy, to achieve a spin effect.
      */
-    return dx * img_bpl - dy;
+    return dx * priv->img.bpl - dy;
 }
 
 
@@ -1182,7 +1133,7 @@ static int flowaround(int offset)
  */
 static struct styles {
     char    *name;
-    int (*stylefunc)(int offset);
+    int (*stylefunc)(BlurskPrivate *priv, int offset);
     lower_t lower;      /* when to move the signal lower in window? */
     int nrandoms;   /* qty of random numbers in randval[] */
     int blurintostencil;/* TRUE if motion should stop at stencil */
@@ -1239,13 +1190,12 @@ int blur(priv, beat, quiet)
 {
     int     i, j, k;
     int     transition, transfrom;
-    static int  blur_phase = 0, blur_phase2 = 0;
-    void        (*blurfunc)(void);
+    void        (*blurfunc)(BlurskPrivate *priv);
     struct timeval now, start;
     int     newspectrum;    /* boolean: is new signal_style a spectrum? */
 
     /* convert "transition speed" to a number */
-    switch (*config.transition_speed)
+    switch (*priv->config.transition_speed)
     {
       case 'S': transition = 1 + MAXTRANSITION / 200;   break;
       case 'M': transition = 1 + MAXTRANSITION / 50;    break;
@@ -1254,73 +1204,73 @@ int blur(priv, beat, quiet)
     }
 
     /* if size has changed, then start a transition */
-    if (img_width != blurwidth || img_height != blurheight)
+    if (priv->img.width != priv->blur.width || priv->img.height != priv->blur.height)
     {
         /* remember the new size */
-        blurwidth = img_width;
-        blurheight = img_height;
-        blurxcenter = blurwidth / 2;
-        blurycenter = blurheight / 2;
-        blurlast = img_height * img_bpl;
+        priv->blur.width = priv->img.width;
+        priv->blur.height = priv->img.height;
+        priv->blur.xcenter = priv->blur.width / 2;
+        priv->blur.ycenter = priv->blur.height / 2;
+        priv->blur.last = priv->img.height * priv->img.bpl;
 
         /* this counts as a style change, but do it instantly */
-        transition = styletransition = MAXTRANSITION;
-        stylekeeprandom = 0;
+        transition = priv->blur.styletransition = MAXTRANSITION;
+        priv->blur.stylekeeprandom = 0;
     }
 
     /* If "Random", and we aren't in a transition, then that counts as
      * a blur change (so we continually transition from one random blur
      * style to another).
      */
-    if (!strcmp(config.blur_style, "Random quiet"))
+    if (!strcmp(priv->config.blur_style, "Random quiet"))
     {
         if (quiet)
-            *stylename = '\0';
+            *priv->blur.stylename = '\0';
     }
-    else if ((!strncmp(config.blur_style, "Random", 6)
-            || !strncmp(config.blur_style, "Flow", 4)
-            || !strncmp(config.blur_style, "Wobble", 6))
-        && styletransition < 0
-        && --stylekeeprandom < 0)
+    else if ((!strncmp(priv->config.blur_style, "Random", 6)
+            || !strncmp(priv->config.blur_style, "Flow", 4)
+            || !strncmp(priv->config.blur_style, "Wobble", 6))
+        && priv->blur.styletransition < 0
+        && --priv->blur.stylekeeprandom < 0)
     {
-        *stylename = '\0';
+        *priv->blur.stylename = '\0';
     }
 
     /* If blur style or stencil has changed, then switch to new style &
      * stencil, and start a transition to make it take effect.
      */
-    newspectrum = (*config.signal_style == 'M'   /* Mono spectrum */
-            || *config.signal_style == 'S'); /* Stereo spectrum */
-    if (strcmp(config.blur_style, stylename)
-     || strcmp(config.blur_stencil, stencilname)
-     || strcmp(config.blur_when, blurname)
-     || newspectrum != isspectrum)
+    newspectrum = (*priv->config.signal_style == 'M'   /* Mono spectrum */
+            || *priv->config.signal_style == 'S'); /* Stereo spectrum */
+    if (strcmp(priv->config.blur_style, priv->blur.stylename)
+     || strcmp(priv->config.blur_stencil, priv->blur.stencilname)
+     || strcmp(priv->config.blur_when, priv->blur.blurname)
+     || newspectrum != priv->blur.isspectrum)
     {
         /* store the new info */
-        strcpy(stylename, config.blur_style);
-        strcpy(stencilname, config.blur_stencil);
-        strcpy(blurname, config.blur_when);
-        isspectrum = newspectrum;
+        strcpy(priv->blur.stylename, priv->config.blur_style);
+        strcpy(priv->blur.stencilname, priv->config.blur_stencil);
+        strcpy(priv->blur.blurname, priv->config.blur_when);
+        priv->blur.isspectrum = newspectrum;
 
         /* find the setup function for this style */
-        if (!strcmp(config.blur_style, "Random quiet"))
+        if (!strcmp(priv->config.blur_style, "Random quiet"))
         {
-            i = rand_0_to(QTY(styles));
-            stylekeeprandom = 0;
+            i = rand_0_to(priv, QTY(styles));
+            priv->blur.stylekeeprandom = 0;
         }
-        else if (!strcmp(config.blur_style, "Random slow"))
+        else if (!strcmp(priv->config.blur_style, "Random slow"))
         {
-            i = rand_0_to(QTY(styles));
-            stylekeeprandom = KEEP_RANDOM_SLOW;
+            i = rand_0_to(priv, QTY(styles));
+            priv->blur.stylekeeprandom = KEEP_RANDOM_SLOW;
         }
-        else if (!strcmp(config.blur_style, "Random"))
+        else if (!strcmp(priv->config.blur_style, "Random"))
         {
-            i = rand_0_to(QTY(styles));
-            stylekeeprandom = KEEP_RANDOM;
+            i = rand_0_to(priv, QTY(styles));
+            priv->blur.stylekeeprandom = KEEP_RANDOM;
         }
         else
         {
-            for (i = 0; i < QTY(styles) && strcmp(styles[i].name, stylename); i++)
+            for (i = 0; i < QTY(styles) && strcmp(styles[i].name, priv->blur.stylename); i++)
             {
             }
         }
@@ -1332,60 +1282,60 @@ int blur(priv, beat, quiet)
         }
 
         /* remember the new style setup function */
-        stylefunc = styles[i].stylefunc;
+        priv->blur.stylefunc = styles[i].stylefunc;
 
         /* remember how this motion interacts with stencils */
-        blurintostencil = styles[i].blurintostencil;
+        priv->blur.intostencil = styles[i].blurintostencil;
 
         /* remember how this motion prefers to handle edge/area smooth*/
-        edgesmooth = styles[i].edgesmooth;
+        priv->blur.edgesmooth = styles[i].edgesmooth;
 
         /* reset the transition counter */
-        salt = 0;
-        styletransition = MAXTRANSITION;
+        priv->blur.salt = 0;
+        priv->blur.styletransition = MAXTRANSITION;
 
         /* remember whether this style lowers the signal */
-        styleprevlower = stylelower;
+        priv->blur.styleprevlower = priv->blur.stylelower;
         switch (styles[i].lower)
         {
-          case LOWER_NO:    stylelower = FALSE; break;
-          case LOWER_YES:   stylelower = TRUE;  break;
-          case LOWER_SPECTRUM:  stylelower = isspectrum;break;
+          case LOWER_NO:    priv->blur.stylelower = FALSE; break;
+          case LOWER_YES:   priv->blur.stylelower = TRUE;  break;
+          case LOWER_SPECTRUM:  priv->blur.stylelower = priv->blur.isspectrum;break;
         }
 
         /* if this blur function needs random numbers, generate now */
-        randval[0] = 0;
+        priv->blur.randval[0] = 0;
         for (j = 0; j < styles[i].nrandoms; j++)
-            randval[j] = visual_rand();
+            priv->blur.randval[j] = visual_random_context_int(priv->rcontext);
 
         /* choose a stencil */
-        blur_stencil = bitmap_index(config.blur_stencil);
+        priv->blur.stencil = bitmap_index(priv, priv->config.blur_stencil);
 
         /* choose a blur intensity */
-        if (!strcmp(config.blur_when, "Random blur"))
-            blurchar = "NRFMS"[rand_0_to(5)];
+        if (!strcmp(priv->config.blur_when, "Random blur"))
+            priv->blur.blurchar = "NRFMS"[rand_0_to(priv, 5)];
         else
-            blurchar = *config.blur_when;
+            priv->blur.blurchar = *priv->config.blur_when;
     }
 
     /* Decide which blur function to use */
-    switch (blurchar)
+    switch (priv->blur.blurchar)
     {
       case 'N': /* No blur */
         blurfunc = loopsharp;
         break;
 
       case 'R':     /* Reduced blur */
-        blur_phase = (blur_phase % 5) + 1;
-        switch (blur_phase)
+        priv->blur.phase = (priv->blur.phase % 5) + 1;
+        switch (priv->blur.phase)
         {
           case 1:   blurfunc = loopreduced1;    break;
           case 2:   blurfunc = loopreduced2;    break;
           case 3:   blurfunc = loopreduced4;    break;
           case 4:   blurfunc = loopreduced3;    break;
           default:
-            blur_phase2 = (blur_phase2 & 0x3) + 1;
-            switch (blur_phase2)
+            priv->blur.phase2 = (priv->blur.phase2 & 0x3) + 1;
+            switch (priv->blur.phase2)
             {
               case 1:   blurfunc = loopreduced1;    break;
               case 2:   blurfunc = loopreduced2;    break;
@@ -1413,29 +1363,29 @@ int blur(priv, beat, quiet)
     }
 
     /* If simple motion & not blurring, then we're done */
-    if (styletransition < 0 && stylefunc == simple && blurfunc == loopsharp)
+    if (priv->blur.styletransition < 0 && priv->blur.stylefunc == simple && blurfunc == loopsharp)
     {
         return 0;
     }
 
     /* if in transition, then do some more dithered points */
-    transfrom = styletransition;
+    transfrom = priv->blur.styletransition;
     gettimeofday(&start, NULL);
-    while (transition > 0 && styletransition >= 0)
+    while (transition > 0 && priv->blur.styletransition >= 0)
     {
         transition--;
-        styletransition--;
-        for (i =  dither[styletransition];
-             i < blurlast;
+        priv->blur.styletransition--;
+        for (i =  dither[priv->blur.styletransition];
+             i < priv->blur.last;
              i += MAXTRANSITION)
         {
             /* edges & stencil are always 0, else use stylefunc */
-            if (i % img_bpl < img_width &&
-                (blur_stencil < 0 ||
-                !bitmap_test(blur_stencil, i % img_bpl, i / img_bpl)))
+            if (i % priv->img.bpl < priv->img.width &&
+                (priv->blur.stencil < 0 ||
+                !bitmap_test(priv, priv->blur.stencil, i % priv->img.bpl, i / priv->img.bpl)))
             {
                 /* call stylefunc to find the source delta */
-                j = i + (*stylefunc)(i);
+                j = i + (*priv->blur.stylefunc)(priv, i);
 
                 /* Work around the stencil; i.e., if the source
                  * would be in the stencil then try to move
@@ -1443,14 +1393,14 @@ int blur(priv, beat, quiet)
                  * other side of it.  EXCEPT if no motion then
                  * that would be wasted effort so skip it.
                  */
-                if (j != i && blur_stencil >= 0 && !blurintostencil)
+                if (j != i && priv->blur.stencil >= 0 && !priv->blur.intostencil)
                 {
                     for (k = 10;
                          --k >= 0 &&
                         j >= 0 &&
-                        j <= blurlast &&
-                        bitmap_test(blur_stencil, j % img_bpl, j / img_bpl);
-                         j += (*stylefunc)(j))
+                        j <= priv->blur.last &&
+                        bitmap_test(priv, priv->blur.stencil, j % priv->img.bpl, j / priv->img.bpl);
+                         j += (*priv->blur.stylefunc)(priv, j))
                     {
                     }
                 }
@@ -1458,14 +1408,14 @@ int blur(priv, beat, quiet)
                 /* Verify that the result is reasonable.  It's
                  * easier to check here than in every styelfunc.
                  */
-                if (j < 0 || j > blurlast)
+                if (j < 0 || j > priv->blur.last)
                 {
                     j = i;
                 }
-                img_source[i] = &img_buf[j];
+                priv->img.source[i] = &priv->img.buf[j];
             }
             else
-                img_source[i] = &img_buf[i];
+                priv->img.source[i] = &priv->img.buf[i];
         }
 
         /* Never allow more than MAXUSEC per frame */
@@ -1475,36 +1425,45 @@ int blur(priv, beat, quiet)
     }
 
     /* Give the colormap a chance to transition smoothly too. */
-    color_transition(priv, transfrom, styletransition, MAXTRANSITION);
+    color_transition(priv, transfrom, priv->blur.styletransition, MAXTRANSITION);
 
     /* Perform the blur */
-    if (edgesmooth)
+    if (priv->blur.edgesmooth)
         /* Normal blurring, usually gives stable edges */
-        (*blurfunc)();
+        (*blurfunc)(priv);
     else
     {
         /* Alternate blurring, usually gives smoother areas */
-        static int odd = 1;
-        odd = -odd;
-        img_bpl *= odd;
-        (*blurfunc)();
-        img_bpl *= odd;
+        priv->blur.odd = -priv->blur.odd;
+        priv->img.bpl *= priv->blur.odd;
+        (*blurfunc)(priv);
+        priv->img.bpl *= priv->blur.odd;
     }
-    img_copyback();
+    img_copyback(priv);
 
     /* Return the amount by which the signal should be lowered */
-    if (stylelower && !styleprevlower)
-        return (blurheight * (MAXTRANSITION - styletransition + 1))
+    if (priv->blur.stylelower && !priv->blur.styleprevlower)
+        return (priv->blur.height * (MAXTRANSITION - priv->blur.styletransition + 1))
                 / (6 * MAXTRANSITION);
-    else if (styleprevlower && !stylelower)
-        return (blurheight * (styletransition + 1))
+    else if (priv->blur.styleprevlower && !priv->blur.stylelower)
+        return (priv->blur.height * (priv->blur.styletransition + 1))
                 / (6 * MAXTRANSITION);
-    else if (stylelower && styleprevlower)
-        return blurheight / 6;
+    else if (priv->blur.stylelower && priv->blur.styleprevlower)
+        return priv->blur.height / 6;
     else
         return 0;
 }
 
+/**
+ * Reset the per-instance blur state
+ */
+void blur_init(BlurskPrivate *priv)
+{
+    priv->blur.styletransition = -1;
+    priv->blur.dir = 1;
+    priv->blur.odd = 1;
+}
+
 /**
  * Return the name of the i'th blur style (including "Random") 
  */
@@ -55,26 +55,8 @@
 # include <signal.h>
 #endif
 
-/* To detect rhythms, blursk tracks the loudness of the signal across multiple
- * frames.  This is the maximum number of frames, and should correspond to the
- * slowest rhythm.
- */
-#define BEAT_MAX    200
-
 static void blursk_render_pcm(BlurskPrivate *priv, int16_t *data);
 
-/* This is used for slow motion */
-static int oddeven;
-
-int nspectrums;
-
-static int32_t  beathistory[BEAT_MAX];
-static int  beatbase;
-static int  beatquiet;  /* force "quiet" situation? */
-
-int blurskinfo = FALSE;
-VisSongInfo *songinfo = NULL;
-
 
 /**
  * Return the name of the i'th floater method
@@ -98,63 +80,59 @@ char *floaters_name(int i)
  * thickness value from 0 to 3, and it detects the start of silence for
  * the "Random quiet" setting.
  */
-static int detect_beat(int32_t loudness, int *thickref, int *quietref)
+static int detect_beat(BlurskPrivate *priv, int32_t loudness, int *thickref, int *quietref)
 {
-    static int32_t  aged;       /* smoothed out loudness */
-    static int32_t  lowest;     /* quietest point in current beat */
-    static int  elapsed;    /* frames since last beat */
-    static int  isquiet;    /* was previous frame quiet */
-    static int  prevbeat;   /* period of previous beat */
+    BlurskBeat *b = &priv->beat;
     int     beat, i, j;
     int32_t     total;
     int     sensitivity;
 
     /* Incorporate the current loudness into history */
-    aged = (aged * 7 + loudness) >> 3;
-    elapsed++;
+    b->aged = (b->aged * 7 + loudness) >> 3;
+    b->elapsed++;
 
     /* If silent, then clobber the beat */
-    if (aged < 2000 || elapsed > BEAT_MAX)
+    if (b->aged < 2000 || b->elapsed > BEAT_MAX)
     {
-        elapsed = 0;
-        lowest = aged;
-        memset(beathistory, 0, sizeof beathistory);
+        b->elapsed = 0;
+        b->lowest = b->aged;
+        memset(b->history, 0, sizeof b->history);
     }
-    else if (aged < lowest)
-        lowest = aged;
+    else if (b->aged < b->lowest)
+        b->lowest = b->aged;
 
     /* Beats are detected by looking for a sudden loudness after a lull.
      * They are also limited to occur no more than once every 15 frames,
      * so the beat flashes don't get too annoying.
      */
-    j = (beatbase + elapsed) % BEAT_MAX;
-    beathistory[j] = loudness - aged;
+    j = (b->base + b->elapsed) % BEAT_MAX;
+    b->history[j] = loudness - b->aged;
     beat = FALSE;
-    if (elapsed > 15 && aged > 2000 && loudness * 4 > aged * 5)
+    if (b->elapsed > 15 && b->aged > 2000 && loudness * 4 > b->aged * 5)
     {
         /* Compute the average loudness change, assuming this is beat */
-        for (i = BEAT_MAX / elapsed, total = 0;
+        for (i = BEAT_MAX / b->elapsed, total = 0;
              --i > 0;
-             j = (j + BEAT_MAX - elapsed) % BEAT_MAX)
+             j = (j + BEAT_MAX - b->elapsed) % BEAT_MAX)
         {
-            total += beathistory[j];
+            total += b->history[j];
         }
-        total = total * elapsed / BEAT_MAX;
+        total = total * b->elapsed / BEAT_MAX;
 
         /* Tweak the sensitivity to emphasize a consistent rhythm */
-        sensitivity = config.beat_sensitivity;
-        i = 3 - abs(elapsed - prevbeat)/2;
+        sensitivity = priv->config.beat_sensitivity;
+        i = 3 - abs(b->elapsed - b->prevbeat)/2;
         if (i > 0)
             sensitivity += i;
 
         /* If average change is significantly positive, this is a beat.
          */
-        if (total * sensitivity > aged)
+        if (total * sensitivity > b->aged)
         {
-            prevbeat = elapsed;
-            beatbase = (beatbase + elapsed) % BEAT_MAX;
-            lowest = aged;
-            elapsed = 0;
+            b->prevbeat = b->elapsed;
+            b->base = (b->base + b->elapsed) % BEAT_MAX;
+            b->lowest = b->aged;
+            b->elapsed = 0;
             beat = TRUE;
         }
     }
@@ -163,13 +141,13 @@ static int detect_beat(int32_t loudness, int *thickref, int *quietref)
      * loudness and the aged loudness.  Thus, a sudden increase in volume
      * will produce a thick line, regardless of rhythm.
      */
-    if (aged < 1500)
+    if (b->aged < 1500)
         *thickref = 0;
-    else if (!config.thick_on_beats)
+    else if (!priv->config.thick_on_beats)
         *thickref = 1;
     else
     {
-        *thickref = loudness * 2 / aged;
+        *thickref = loudness * 2 / b->aged;
         if (*thickref > 3)
             *thickref = 3;
     }
@@ -181,33 +159,31 @@ static int detect_beat(int32_t loudness, int *thickref, int *quietref)
      * periods -- that sort of thing happens during many fade edits, so
      * we have to account for it.
      */
-    if (beatquiet || aged < (isquiet ? 1500 : 500))
+    if (b->quiet || b->aged < (b->isquiet ? 1500 : 500))
     {
         /* Quiet now -- is this the start of quiet? */
-        *quietref = !isquiet;
-        isquiet = TRUE;
-        beatquiet = FALSE;
+        *quietref = !b->isquiet;
+        b->isquiet = TRUE;
+        b->quiet = FALSE;
     }
     else
     {
         *quietref = FALSE;
-        isquiet = FALSE;
+        b->isquiet = FALSE;
     }
 
     /* return the result */
     return beat;
 }
 
-static void drawfloaters(int beat)
+static void drawfloaters(BlurskPrivate *priv, int beat)
 {
-    static int prevfloaters;
-    static struct {int x, y, age; uint8_t color;} floater[10];
-    static int oddeven;
+    BlurskFloaters *f = &priv->floaters;
     int nfloaters;
     int i, j, delta, dx, dy;
 
     /* choose the number of floaters */
-    switch (*config.floaters)
+    switch (*priv->config.floaters)
     {
       case 'N': /* No floaters */
         nfloaters = 0;
@@ -218,25 +194,25 @@ static void drawfloaters(int beat)
         break;
 
       case 'S': /* Slow */
-        oddeven++;
+        f->oddeven++;
         /* fall through... */
 
       default: /* Slow/Fast/Retro floaters */
-        nfloaters = 1 + img_width * img_height / 20000;
-        if (nfloaters > 10)
-            nfloaters = 10;
+        nfloaters = 1 + priv->img.width * priv->img.height / 20000;
+        if (nfloaters > MAXFLOATERS)
+            nfloaters = MAXFLOATERS;
     }
 
     /* for each floater... */
     for (i = 0; i < nfloaters; i++)
     {
         /* if Dots, new, old, beat, or off-screen... */
-        if (*config.floaters == 'D'
-         || i >= prevfloaters
-         || floater[i].age++ > 80 + i * 13
+        if (*priv->config.floaters == 'D'
+         || i >= f->prevfloaters
+         || f->floater[i].age++ > 80 + i * 13
          || beat
-         || floater[i].x < 0 || floater[i].x >= img_width
-         || floater[i].y < 0 || floater[i].y >= img_height)
+         || f->floater[i].x < 0 || f->floater[i].x >= priv->img.width
+         || f->floater[i].y < 0 || f->floater[i].y >= priv->img.height)
         {
             /* Pretend motion is 0.  This will cause blursk to
              * choose a new position, later in this function.
@@ -246,22 +222,22 @@ static void drawfloaters(int beat)
         else
         {
             /* find the real motion */
-            j = floater[i].y * img_bpl + floater[i].x;
-            delta = &img_buf[j] - img_source[j];
+            j = f->floater[i].y * priv->img.bpl + f->floater[i].x;
+            delta = &priv->img.buf[j] - priv->img.source[j];
         }
 
         /* if motion isn't 0, then move the floater */
         if (delta != 0)
         {
             /* decompose the delta into dx & dy.  Watch signs! */
-            dx = (j + delta) % img_bpl - floater[i].x;
-            dy = (j + delta) / img_bpl - floater[i].y;
+            dx = (j + delta) % priv->img.bpl - f->floater[i].x;
+            dy = (j + delta) / priv->img.bpl - f->floater[i].y;
 
             /* move the floater */
-            switch (*config.floaters)
+            switch (*priv->config.floaters)
             {
               case 'S': /* Slow floaters */
-                if ((oddeven ^ i) & 0x1)
+                if ((f->oddeven ^ i) & 0x1)
                     dx = dy = 0;
                 break;
 
@@ -275,45 +251,43 @@ static void drawfloaters(int beat)
                 dy = -dy;
                 break;
             }
-            floater[i].x += dx;
-            floater[i].y += dy;
+            f->floater[i].x += dx;
+            f->floater[i].y += dy;
         }
 
         /* if no motion, or motion carries it off the screen, then
          * choose a new random position & contrasting color.
          */
         if (delta == 0
-         || floater[i].x < 0 || floater[i].x >= img_width
-         || floater[i].y < 0 || floater[i].y >= img_height)
+         || f->floater[i].x < 0 || f->floater[i].x >= priv->img.width
+         || f->floater[i].y < 0 || f->floater[i].y >= priv->img.height)
         {
             /* choose a new random position */
-            floater[i].x = rand_0_to(img_width - 9) + 2;
-            floater[i].y = rand_0_to(img_height - 9) + 2;
-            if (IMG_PIXEL(floater[i].x, floater[i].y) > 0x80)
-                floater[i].color = 0;
+            f->floater[i].x = rand_0_to(priv, priv->img.width - 9) + 2;
+            f->floater[i].y = rand_0_to(priv, priv->img.height - 9) + 2;
+            if (IMG_PIXEL(priv, f->floater[i].x, f->floater[i].y) > 0x80)
+                f->floater[i].color = 0;
             else
-                floater[i].color = 0xfe;
-            floater[i].age = 0;
+                f->floater[i].color = 0xfe;
+            f->floater[i].age = 0;
         }
 
         /* draw the floater */
-        render_dot(floater[i].x, floater[i].y, floater[i].color);
+        render_dot(priv, f->floater[i].x, f->floater[i].y, f->floater[i].color);
     }
-    prevfloaters = nfloaters;
+    f->prevfloaters = nfloaters;
 }
 
 /* This detects libvisual songinfo events and updates title when appropriate.
  * It should be called once for each frame.
  */
 
-static unsigned char *show_info(unsigned char *img, int height, int bpl)
+static unsigned char *show_info(BlurskPrivate *priv, unsigned char *img, int height, int bpl)
 {
+    BlurskInfo *info = &priv->info;
+    VisSongInfo *songinfo = info->songinfo;
     int pos, length;
     time_t now;
-    static int prevpos;
-    static char buf[1000];
-    static time_t start, then;
-    static int persistent = FALSE;
     char showinfo;
     char posstr[32], lenstr[32];
 
@@ -321,51 +295,51 @@ static unsigned char *show_info(unsigned char *img, int height, int bpl)
         return img;
 
     time(&now);
-    if(now != then)
+    if(now != info->then)
     {
-        then = now;
+        info->then = now;
         pos = visual_songinfo_get_elapsed (songinfo);
 
         convert_ms_to_timestamp(posstr, pos);
         length = visual_songinfo_get_length(songinfo);
         convert_ms_to_timestamp(lenstr, length);
-        if(pos != prevpos)
+        if(pos != info->prevpos)
         {
-            prevpos = pos;
-            beatquiet = TRUE;
+            info->prevpos = pos;
+            priv->beat.quiet = TRUE;
             switch(visual_songinfo_get_type(songinfo))
             {
                 case VISUAL_SONGINFO_TYPE_SIMPLE:
-                    if(config.show_timestamp)
+                    if(priv->config.show_timestamp)
                     {
                         if(lenstr != NULL)
-                            sprintf(buf, "{%s/%s} %s", posstr, lenstr, visual_songinfo_get_simple_name(songinfo));
+                            sprintf(info->buf, "{%s/%s} %s", posstr, lenstr, visual_songinfo_get_simple_name(songinfo));
                         else
-                            sprintf(buf, "(%s) %s", posstr, visual_songinfo_get_simple_name(songinfo));
+                            sprintf(info->buf, "(%s) %s", posstr, visual_songinfo_get_simple_name(songinfo));
                         break;
                     }
                     else
                     {
-                        sprintf(buf, "%s", visual_songinfo_get_simple_name (songinfo));
+                        sprintf(info->buf, "%s", visual_songinfo_get_simple_name (songinfo));
                     }
 
                 case VISUAL_SONGINFO_TYPE_ADVANCED:
-                    if(config.show_timestamp)
+                    if(priv->config.show_timestamp)
                     {
                         if(strcmp(visual_songinfo_get_artist(songinfo), "(null)") == 0)
                         {
                             if(length >= 0)
-                                sprintf(buf, "{%s/%s} %s", posstr, lenstr, visual_songinfo_get_song(songinfo));
+                                sprintf(info->buf, "{%s/%s} %s", posstr, lenstr, visual_songinfo_get_song(songinfo));
                             else
-                                sprintf(buf, "(%s) %s", posstr, visual_songinfo_get_song(songinfo));
+                                sprintf(info->buf, "(%s) %s", posstr, visual_songinfo_get_song(songinfo));
                         }
                         else
                         {
                             if(length >= 0)
-                                sprintf(buf, "{%s/%s} %s by %s", posstr, lenstr,
+                                sprintf(info->buf, "{%s/%s} %s by %s", posstr, lenstr,
                                     visual_songinfo_get_song(songinfo), visual_songinfo_get_artist(songinfo));
                             else
-                                sprintf(buf, "(%s) %s by %s", posstr,
+                                sprintf(info->buf, "(%s) %s by %s", posstr,
                                     visual_songinfo_get_song(songinfo), visual_songinfo_get_artist(songinfo));
                         }
                     }
@@ -374,11 +348,11 @@ static unsigned char *show_info(unsigned char *img, int height, int bpl)
                         if(strcmp(visual_songinfo_get_artist(songinfo), "(null)") == 0)
                         {
                             if(strcmp(visual_songinfo_get_song(songinfo), "(null)") != 0)
-                                sprintf(buf, "%s", visual_songinfo_get_song(songinfo));
+                                sprintf(info->buf, "%s", visual_songinfo_get_song(songinfo));
                         }
                         else
                         {
-                            sprintf(buf, "%s by %s", visual_songinfo_get_song(songinfo), visual_songinfo_get_artist(songinfo));
+                            sprintf(info->buf, "%s by %s", visual_songinfo_get_song(songinfo), visual_songinfo_get_artist(songinfo));
                         }
                     }
                     break;
@@ -390,18 +364,18 @@ static unsigned char *show_info(unsigned char *img, int height, int bpl)
         }
     }
 
-    showinfo = *config.show_info;
-    if(blurskinfo || persistent)
+    showinfo = *priv->config.show_info;
+    if(info->newsong || info->persistent)
     {
         if(showinfo == 'N')
             return img;
 
-        if(blurskinfo)
+        if(info->newsong)
         {
-            start = now;
-            persistent = TRUE;
+            info->start = now;
+            info->persistent = TRUE;
         }
-        blurskinfo = FALSE;
+        info->newsong = FALSE;
     }
 
     /* If not supposed to show text, then we're done */
@@ -409,9 +383,9 @@ static unsigned char *show_info(unsigned char *img, int height, int bpl)
         case 'N': /* Never show info */
             return img;
         case 'T': /* 4 second info */
-            if(now - start > config.info_timeout)
+            if(now - info->start > priv->config.info_timeout)
             {
-                persistent = FALSE;
+                info->persistent = FALSE;
                 return img;
             }
         case 'A': /* Always show info */
@@ -425,14 +399,14 @@ static unsigned char *show_info(unsigned char *img, int height, int bpl)
      * (which is very common!) normally leaves the image in the main buffer.
      * We need to detect this, and copy the image before we draw the text.
      */
-    if (img != img_tmp)
+    if (img != priv->img.tmp)
     {
-        memcpy(img_tmp, img, img_chunks * 8);
-        img = img_tmp;
+        memcpy(priv->img.tmp, img, priv->img.chunks * 8);
+        img = priv->img.tmp;
     }
 
     /* draw the text */
-    textdraw(img, height, bpl, "Center", buf);
+    textdraw(priv, img, height, bpl, "Center", info->buf);
     return img;
 }
 
@@ -458,19 +432,19 @@ static void update_image(BlurskPrivate *priv, int32_t loudness, int ndata, int16
 
 
     /* Detect whether this is a beat, and choose a line thickness */
-    beat = detect_beat(loudness, &thick, &quiet);
+    beat = detect_beat(priv, loudness, &thick, &quiet);
 
     /* Perform the blurring.  This also affects whether the center of the
      * signal will be moved lower in the window.
      */
-    center = img_height/2 + blur(priv, beat, quiet);
+    center = priv->img.height/2 + blur(priv, beat, quiet);
 
     /* Perform the fade or solid flash */
-    if (beat && !strcmp(config.flash_style, "Full flash"))
+    if (beat && !strcmp(priv->config.flash_style, "Full flash"))
         i = 60;
     else
     {
-        switch (config.fade_speed[0])
+        switch (priv->config.fade_speed[0])
         {
           case 'S': i = -1; break;  /* Slow */
           case 'M': i = -3; break;  /* Medium */
@@ -480,15 +454,15 @@ static void update_image(BlurskPrivate *priv, int32_t loudness, int ndata, int16
         }
     }
     if (i != 0)
-        loopfade(i);
+        loopfade(priv, i);
 
     /* special processing for "Invert" & bitmap logo flashes */
     if (beat)
     {
-        if (!strcmp(config.flash_style, "Invert flash"))
-            img_invert();
-        else if ((i = bitmap_index(config.flash_style)) >= 0)
-            bitmap_flash(i);
+        if (!strcmp(priv->config.flash_style, "Invert flash"))
+            img_invert(priv);
+        else if ((i = bitmap_index(priv, priv->config.flash_style)) >= 0)
+            bitmap_flash(priv, i);
     }
 
     /* Maybe change hue on beats */
@@ -496,33 +470,33 @@ static void update_image(BlurskPrivate *priv, int32_t loudness, int ndata, int16
         color_beat(priv);
 
     /* Add the signal data to the image */
-    render(thick, center, ndata, data);
+    render(priv, thick, center, ndata, data);
 
     /* Add floaters */
-    drawfloaters(beat);
+    drawfloaters(priv, beat);
 
     /* shift the "ripple effect" from one frame to another */
-    img_rippleshift += 3; /* cyclic, since img_rippleshift is a unsigned char */
+    priv->img.rippleshift += 3; /* cyclic, since rippleshift is an unsigned char */
 
     /* Apply the overall effect, if any */
-    if (!strcmp(config.overall_effect, "Bump effect"))
+    if (!strcmp(priv->config.overall_effect, "Bump effect"))
     {
-        priv->rgb_buf = img_bump(&width, &height, &bpl);
+        priv->rgb_buf = img_bump(priv, &width, &height, &bpl);
     }
-    else if (!strcmp(config.overall_effect, "Anti-fade effect"))
+    else if (!strcmp(priv->config.overall_effect, "Anti-fade effect"))
     {
-        priv->rgb_buf = img_travel(&width, &height, &bpl);
+        priv->rgb_buf = img_travel(priv, &width, &height, &bpl);
     }
-    else if (!strcmp(config.overall_effect, "Ripple effect"))
+    else if (!strcmp(priv->config.overall_effect, "Ripple effect"))
     {
-        priv->rgb_buf = img_ripple(&width, &height, &bpl);
+        priv->rgb_buf = img_ripple(priv, &width, &height, &bpl);
     }
     else /* "Normal effect" */
     {
-        priv->rgb_buf = img_expand(&width, &height, &bpl);
+        priv->rgb_buf = img_expand(priv, &width, &height, &bpl);
     }
 
-    priv->rgb_buf = show_info(priv->rgb_buf, height, bpl);
+    priv->rgb_buf = show_info(priv, priv->rgb_buf, height, bpl);
 
     /* Allow the background color to change */
     color_bg(priv, ndata, data);
@@ -538,8 +512,8 @@ static void blursk_render_pcm(BlurskPrivate *priv, int16_t *data)
     int32_t loudness, delta_sum;
 
     /* If slow motion, then ignore odd-numbered frames */
-    oddeven = !oddeven;
-    if (config.slow_motion && oddeven)
+    priv->oddeven = !priv->oddeven;
+    if (priv->config.slow_motion && priv->oddeven)
         return;
 
     /* Find the maximum and minimum, with the restriction that
@@ -576,11 +550,11 @@ static void blursk_render_pcm(BlurskPrivate *priv, int16_t *data)
 }
 
 
-void blursk_event_newsong(VisSongInfo *newsong)
+void blursk_event_newsong(BlurskPrivate *priv, VisSongInfo *newsong)
 {
     visual_return_if_fail(newsong != NULL);
-    visual_songinfo_copy(songinfo, newsong);
-    blurskinfo = TRUE;
+    visual_songinfo_copy(priv->info.songinfo, newsong);
+    priv->info.newsong = TRUE;
 }
 
 void __blursk_render_pcm (BlurskPrivate *priv, int16_t *pcmbuf) {
@@ -588,31 +562,32 @@ void __blursk_render_pcm (BlurskPrivate *priv, int16_t *pcmbuf) {
 }
 
 void __blursk_init (BlurskPrivate *priv) {
+    blur_init(priv);
     color_genmap(priv, FALSE);
-    img_resize(priv, config.width, config.height);
-    songinfo = visual_songinfo_new(VISUAL_SONGINFO_TYPE_NULL);
+    img_resize(priv, priv->config.width, priv->config.height);
+    priv->info.songinfo = visual_songinfo_new(VISUAL_SONGINFO_TYPE_NULL);
 }
 
 void __blursk_cleanup (BlurskPrivate *priv) {
-    img_cleanup();
-    visual_songinfo_free(songinfo);
+    img_cleanup(priv);
+    visual_songinfo_free(priv->info.songinfo);
 
     /* cleanup config strings */
-    visual_mem_free(config.color_style);
-    visual_mem_free(config.signal_color);
-    visual_mem_free(config.background);
-    visual_mem_free(config.blur_style);
-    visual_mem_free(config.transition_speed);
-    visual_mem_free(config.blur_when);
-    visual_mem_free(config.blur_stencil);
-    visual_mem_free(config.fade_speed);
-    visual_mem_free(config.signal_style);
-    visual_mem_free(config.plot_style);
-    visual_mem_free(config.flash_style);
-    visual_mem_free(config.overall_effect);
-    visual_mem_free(config.floaters);
-    visual_mem_free(config.cpu_speed);
-    visual_mem_free(config.show_info);
+    visual_mem_free(priv->config.color_style);
+    visual_mem_free(priv->config.signal_color);
+    visual_mem_free(priv->config.background);
+    visual_mem_free(priv->config.blur_style);
+    visual_mem_free(priv->config.transition_speed);
+    visual_mem_free(priv->config.blur_when);
+    visual_mem_free(priv->config.blur_stencil);
+    visual_mem_free(priv->config.fade_speed);
+    visual_mem_free(priv->config.signal_style);
+    visual_mem_free(priv->config.plot_style);
+    visual_mem_free(priv->config.flash_style);
+    visual_mem_free(priv->config.overall_effect);
+    visual_mem_free(priv->config.floaters);
+    visual_mem_free(priv->config.cpu_speed);
+    visual_mem_free(priv->config.show_info);
 
 }
 
@@ -77,33 +77,11 @@ typedef struct
         double  hue, saturation, value;
 } hsv_t;
 
-/* This is where Blursk stores its version of the colors */
-uint32_t colors[256];
-
-/* This function pointer refers to a function which can be called to compute
- * the value of a given cell in color_map.  It is only called when setting up
- * the color_map; it is *not* called for every frame.
- */
-static int32_t (*stylefunc)(int32_t);
-
-/* These are the R/G/B components of the base color */
-static int32_t red, green, blue;
-
-/* This is a random color, which is used for the "Colored background" setting */
-static int32_t tored, togreen, toblue;
-static int tonew;
-static int32_t fromred, fromgreen, fromblue;
-static int32_t bgred, bggreen, bgblue;
-static char bgletter; /* first letter of chosen bkgnd, after "Random" */
-
-static int  transition_bound;
-
 /*---------------------------------------------------------------------------*/
 
 /* Convert a color from RGB format to HSV format */
-static hsv_t *rgb_to_hsv(int32_t rgb)
+static void rgb_to_hsv(int32_t rgb, hsv_t *hsv)
 {
-    static hsv_t    hsv;    /* HSV value (saved between invocations */
     double      r, g, b;/* the RGB components, in range 0.0 - 1.0 */
     double      max, min;/* extremes from r, g, b */
     double      delta;  /* difference between max and min */
@@ -126,41 +104,38 @@ static hsv_t *rgb_to_hsv(int32_t rgb)
     }
 
     /* compute "value" */
-    hsv.value = max;
+    hsv->value = max;
 
     /* compute "saturation" */
-    hsv.saturation = (max > 0.0) ? (max - min) / max : 0;
+    hsv->saturation = (max > 0.0) ? (max - min) / max : 0;
 
     /* compute "hue".  This is the hard one */
     delta = max - min;
     if (delta <= 0.001)
     {
         /* gray - any hue will work */
-        hsv.hue = 0.0;
+        hsv->hue = 0.0;
     }
     else
     {
         /* divide hexagonal color wheel into three sectors */
         if (max == r)
             /* color is between yellow and magenta */
-            hsv.hue = (g - b) / delta;
+            hsv->hue = (g - b) / delta;
         else if (max == g)
             /* color is between cyan and yellow */
-            hsv.hue = 2.0 + (b - r) / delta;
+            hsv->hue = 2.0 + (b - r) / delta;
         else /* max == b */
             /* color is between magenta and cyan */
-            hsv.hue = 4.0 + (r - g) / delta;
+            hsv->hue = 4.0 + (r - g) / delta;
 
         /* convert hue to degrees */
-        hsv.hue *= 60.0;
+        hsv->hue *= 60.0;
 
         /* make sure hue is not negative */
-        if (hsv.hue < 0.0)
-            hsv.hue += 360.0;
+        if (hsv->hue < 0.0)
+            hsv->hue += 360.0;
     }
-
-    /* return the computed color */
-    return &hsv;
 }
 
 
@@ -222,44 +197,44 @@ static int32_t hsv_to_rgb(hsv_t *hsv)
  */
 
 
-static int32_t dimming(int32_t i)
+static int32_t dimming(BlurskPrivate *priv, int32_t i)
 {
-    return (((int32_t)(i * red / 256) << 16)
-        | ((int32_t)(i * green / 256) << 8)
-        | ((int32_t)(i * blue / 256))
+    return (((int32_t)(i * priv->color_map.red / 256) << 16)
+        | ((int32_t)(i * priv->color_map.green / 256) << 8)
+        | ((int32_t)(i * priv->color_map.blue / 256))
         | ((255 - i) << 24));
 }
 
-static int32_t brightening(int32_t i)
+static int32_t brightening(BlurskPrivate *priv, int32_t i)
 {
     i = 255 - i;
 
-    return (((int32_t)(i * red / 256) << 16)
-        | ((int32_t)(i * green / 256) << 8)
-        | ((int32_t)(i * blue / 256))
+    return (((int32_t)(i * priv->color_map.red / 256) << 16)
+        | ((int32_t)(i * priv->color_map.green / 256) << 8)
+        | ((int32_t)(i * priv->color_map.blue / 256))
         | ((255 - i) << 24));
 }
 
-static int32_t milky(int32_t i)
+static int32_t milky(BlurskPrivate *priv, int32_t i)
 {
     int32_t r, g, b, tmp, k;
     if (i < 128)
     {
-        r = i * red / 128;
-        g = i * green / 128;
-        b = i * blue / 128;
+        r = i * priv->color_map.red / 128;
+        g = i * priv->color_map.green / 128;
+        b = i * priv->color_map.blue / 128;
         k = (127 - i) << 25;
     }
     else
     {
         tmp = 255 - i;
-        r = 255 - (255 - red) * tmp / 128;
-        g = 255 - (255 - green) * tmp / 128;
-        b = 255 - (255 - blue) * tmp / 128;
+        r = 255 - (255 - priv->color_map.red) * tmp / 128;
+        g = 255 - (255 - priv->color_map.green) * tmp / 128;
+        b = 255 - (255 - priv->color_map.blue) * tmp / 128;
         k = 0;
     }
     tmp = (r << 16) | (g << 8) | b;
-    if (*config.overall_effect == 'B') /* "Bump effect" */
+    if (*priv->config.overall_effect == 'B') /* "Bump effect" */
     {
 #if 0
         if (i == 128)
@@ -282,38 +257,38 @@ static int32_t milky(int32_t i)
     return tmp | k;
 }
 
-static int32_t cloud(int32_t i)
+static int32_t cloud(BlurskPrivate *priv, int32_t i)
 {
     int32_t faded;  /* r/g/b level of gray version of color */
     int32_t r, g, b, k;
 
     /* Compute the gray version */
-    faded = (red * 4 + green * 5 + blue * 3) / 12;
+    faded = (priv->color_map.red * 4 + priv->color_map.green * 5 + priv->color_map.blue * 3) / 12;
 
     /* handle a few specific colors */
-    if (i == 128 && *config.overall_effect == 'B') /* "Bump effect" */
+    if (i == 128 && *priv->config.overall_effect == 'B') /* "Bump effect" */
     {
         /* Use the given color */
-        r = red;
-        g = green;
-        b = blue;
+        r = priv->color_map.red;
+        g = priv->color_map.green;
+        b = priv->color_map.blue;
         k = 0;
     }
-    else if ((i == 129 || i == 127) && *config.overall_effect == 'B') /* "Bump effect" */
+    else if ((i == 129 || i == 127) && *priv->config.overall_effect == 'B') /* "Bump effect" */
     {
         /* Use a faded version of the color */
-        r = (red + faded) / 2;
-        g = (green + faded) / 2;
-        b = (blue + faded) / 2;
+        r = (priv->color_map.red + faded) / 2;
+        g = (priv->color_map.green + faded) / 2;
+        b = (priv->color_map.blue + faded) / 2;
         k = 0;
     }
     else if (i > 192)
     {
         /* transition between the given color and white */
         i -= 192;
-        r = (red * i + 255 * (63 - i)) / 64;
-        g = (green * i + 255 * (63 - i)) / 64;
-        b = (blue * i + 255 * (63 - i)) / 64;
+        r = (priv->color_map.red * i + 255 * (63 - i)) / 64;
+        g = (priv->color_map.green * i + 255 * (63 - i)) / 64;
+        b = (priv->color_map.blue * i + 255 * (63 - i)) / 64;
         k = 0;
     }
     else if (i > 128)
@@ -334,15 +309,15 @@ static int32_t cloud(int32_t i)
     return (r << 16) | (g << 8) | b | k;
 }
 
-static int32_t metal(int32_t i)
+static int32_t metal(BlurskPrivate *priv, int32_t i)
 {
     int32_t r, g, b, k;
 
     if (i < 128)
     {
-        r = red;
-        g = green;
-        b = blue;
+        r = priv->color_map.red;
+        g = priv->color_map.green;
+        b = priv->color_map.blue;
     }
     else
     {
@@ -360,7 +335,7 @@ static int32_t metal(int32_t i)
     return ((r << 16) | (g << 8) | b | k);
 }
 
-static int32_t layers(int32_t i)
+static int32_t layers(BlurskPrivate *priv, int32_t i)
 {
     int32_t k;
 
@@ -382,20 +357,20 @@ static int32_t layers(int32_t i)
     }
 
     /* set this color */
-    return (((int32_t)(i * red / 256) << 16)
-        | ((int32_t)(i * green / 256) << 8)
-        | ((int32_t)(i * blue / 256))
+    return (((int32_t)(i * priv->color_map.red / 256) << 16)
+        | ((int32_t)(i * priv->color_map.green / 256) << 8)
+        | ((int32_t)(i * priv->color_map.blue / 256))
         | (k << 26));
 }
 
-static int32_t colorlayers(int32_t i)
+static int32_t colorlayers(BlurskPrivate *priv, int32_t i)
 {
     int32_t tmp, r, g, b, k;
 
     /* shift the hue */
-    r = red;
-    g = green;
-    b = blue;
+    r = priv->color_map.red;
+    g = priv->color_map.green;
+    b = priv->color_map.blue;
     switch (i & 0xc0)
     {
       case 0x00:
@@ -437,14 +412,14 @@ static int32_t colorlayers(int32_t i)
         | k << 26);
 }
 
-static int32_t colorstandoff(int32_t i)
+static int32_t colorstandoff(BlurskPrivate *priv, int32_t i)
 {
     int32_t tmp, r, g, b, k;
 
     /* shift the hue */
-    r = red;
-    g = green;
-    b = blue;
+    r = priv->color_map.red;
+    g = priv->color_map.green;
+    b = priv->color_map.blue;
     switch (i & 0xc0)
     {
       case 0x00:
@@ -485,13 +460,13 @@ static int32_t colorstandoff(int32_t i)
         | k << 27);
 }
 
-static int32_t flame(int32_t i)
+static int32_t flame(BlurskPrivate *priv, int32_t i)
 {
     hsv_t   hsv;
     int32_t k;
 
     /* Get the base color */
-    hsv = *rgb_to_hsv(config.color);
+    rgb_to_hsv(priv->config.color, &hsv);
 
     /* Change the hue, and maybe brightness, depending on i */
     hsv.hue += (255 - i) / 4;
@@ -510,13 +485,13 @@ static int32_t flame(int32_t i)
     return hsv_to_rgb(&hsv) | (k << 26);
 }
 
-static int32_t rainbow(int32_t i)
+static int32_t rainbow(BlurskPrivate *priv, int32_t i)
 {
     hsv_t   hsv;
     int32_t k;
 
     /* Get the base color */
-    hsv = *rgb_to_hsv(config.color);
+    rgb_to_hsv(priv->config.color, &hsv);
 
     /* Change the hue, and maybe brightness, depending on i */
     hsv.hue += 2 * (255 - i);
@@ -534,7 +509,7 @@ static int32_t rainbow(int32_t i)
     return hsv_to_rgb(&hsv) | k;
 }
 
-static int32_t standoff(int32_t i)
+static int32_t standoff(BlurskPrivate *priv, int32_t i)
 {
     int k;
 
@@ -558,22 +533,22 @@ static int32_t standoff(int32_t i)
     }
 
     /* set this color */
-    return (((int32_t)(i * red / 256) << 16)
-        | ((int32_t)(i * green / 256) << 8)
-        | ((int32_t)(i * blue / 256))
+    return (((int32_t)(i * priv->color_map.red / 256) << 16)
+        | ((int32_t)(i * priv->color_map.green / 256) << 8)
+        | ((int32_t)(i * priv->color_map.blue / 256))
         | (k << 24));
 }
 
-static int32_t threshold(int32_t i)
+static int32_t threshold(BlurskPrivate *priv, int32_t i)
 {
     /* always return the base color.  This is only interesting when it
      * is modified via contour lines, or by the standard rule that color
      * 0 is always black.
      */
-    return config.color;
+    return priv->config.color;
 }
 
-static int32_t stripes(int32_t i)
+static int32_t stripes(BlurskPrivate *priv, int32_t i)
 {
     int32_t tmp, k;
 
@@ -599,13 +574,13 @@ static int32_t stripes(int32_t i)
     }
 
     /* set this color */
-    return (((int32_t)(tmp * red / 256) << 16)
-        | ((int32_t)(tmp * green / 256) << 8)
-        | ((int32_t)(tmp * blue / 256))
+    return (((int32_t)(tmp * priv->color_map.red / 256) << 16)
+        | ((int32_t)(tmp * priv->color_map.green / 256) << 8)
+        | ((int32_t)(tmp * priv->color_map.blue / 256))
         | (k << 26));
 }
 
-static int32_t colorstripes(int32_t i)
+static int32_t colorstripes(BlurskPrivate *priv, int32_t i)
 {
     int32_t r, g, b, k, tmp;
     static int32_t brightness[] = {0, 64, 128, 192, 254, 254, 254, 254, 254, 254, 254, 254, 254, 192, 128, 64};
@@ -615,21 +590,21 @@ static int32_t colorstripes(int32_t i)
     switch (i & 0xc0)
     {
       case 0x40:
-        r = (green * tmp + red * (0x3f - tmp)) >> 6;
-        g = (blue * tmp + green * (0x3f - tmp)) >> 6;
-        b = (red * tmp + blue * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
         break;
 
       case 0x80:
-        r = (blue * tmp + green * (0x3f - tmp)) >> 6;
-        g = (red * tmp + blue * (0x3f - tmp)) >> 6;
-        b = (green * tmp + red * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
         break;
 
       default:
-        r = (red * tmp + blue * (0x3f - tmp)) >> 6;
-        g = (green * tmp + red * (0x3f - tmp)) >> 6;
-        b = (blue * tmp + green * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
     }
 
     /* compute the brightness and k */
@@ -655,7 +630,7 @@ static int32_t colorstripes(int32_t i)
         | (k << 26));
 }
 
-static int32_t colorbands(int32_t i)
+static int32_t colorbands(BlurskPrivate *priv, int32_t i)
 {
     int32_t r, g, b, k, tmp;
 
@@ -664,21 +639,21 @@ static int32_t colorbands(int32_t i)
     switch (i & 0xc0)
     {
       case 0x40:
-        r = (green * tmp + red * (0x3f - tmp)) >> 6;
-        g = (blue * tmp + green * (0x3f - tmp)) >> 6;
-        b = (red * tmp + blue * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
         break;
 
       case 0x80:
-        r = (blue * tmp + green * (0x3f - tmp)) >> 6;
-        g = (red * tmp + blue * (0x3f - tmp)) >> 6;
-        b = (green * tmp + red * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
         break;
 
       default:
-        r = (red * tmp + blue * (0x3f - tmp)) >> 6;
-        g = (green * tmp + red * (0x3f - tmp)) >> 6;
-        b = (blue * tmp + green * (0x3f - tmp)) >> 6;
+        r = (priv->color_map.red * tmp + priv->color_map.blue * (0x3f - tmp)) >> 6;
+        g = (priv->color_map.green * tmp + priv->color_map.red * (0x3f - tmp)) >> 6;
+        b = (priv->color_map.blue * tmp + priv->color_map.green * (0x3f - tmp)) >> 6;
     }
 
     /* compute the brightness & k */
@@ -700,7 +675,7 @@ static int32_t colorbands(int32_t i)
         | (k << 26));
 }
 
-static int32_t graying(int32_t i)
+static int32_t graying(BlurskPrivate *priv, int32_t i)
 {
     int32_t faded, tmp;
 
@@ -708,7 +683,7 @@ static int32_t graying(int32_t i)
      * make it slightly dimmer than the base color, because it seems to
      * look better that way.
      */
-    faded = (red * 4 + green * 5 + blue * 3) / 16;
+    faded = (priv->color_map.red * 4 + priv->color_map.green * 5 + priv->color_map.blue * 3) / 16;
 
     /* colormap is divided into two phases: fading and dimming */
     if (i < 64)
@@ -721,16 +696,16 @@ static int32_t graying(int32_t i)
         /* full brightness, but fading to gray */
         i -= 64;
         tmp = 192 - i;
-        return (((i * red + tmp * faded) / 192) << 16)
-            | (((i * green + tmp * faded) / 192) << 8)
-            | ((i * blue + tmp * faded) / 192);
+        return (((i * priv->color_map.red + tmp * faded) / 192) << 16)
+            | (((i * priv->color_map.green + tmp * faded) / 192) << 8)
+            | ((i * priv->color_map.blue + tmp * faded) / 192);
     }
 }
 
-static int32_t noise(int32_t i)
+static int32_t noise(BlurskPrivate *priv, int32_t i)
 {
-    if (rand_0_to(256) < i)
-        return config.color;
+    if (rand_0_to(priv, 256) < i)
+        return priv->config.color;
     else
         return 0xff000000;
 }
@@ -739,7 +714,7 @@ static int32_t noise(int32_t i)
 static struct colorstyles
 {
     char     *name;
-    int32_t (*func)(int32_t);
+    int32_t (*func)(BlurskPrivate *priv, int32_t i);
     int good_for_bump;
 } colorstyles[17] =
 {
@@ -765,12 +740,12 @@ static struct colorstyles
 /* Compute the color of a single cell in the colormap.  This uses (*stylefunc)()
  * and also checks the other relevant options.
  */
-static int32_t cell(int i)
+static int32_t cell(BlurskPrivate *priv, int i)
 {
     int32_t c;
 
     /* The white_signal option forces color 255 to be white */
-    if (i == 255 && *config.signal_color == 'W')
+    if (i == 255 && *priv->config.signal_color == 'W')
         return 0x00ffffff;
 
     /* The last three cells are always the background color */
@@ -781,7 +756,7 @@ static int32_t cell(int i)
      * better if we also have a half-white/half-colored value on
      * either side of it; notice the tricky way we accomplish that.
      */
-    if (config.contour_lines)
+    if (priv->config.contour_lines)
     {
         switch ((i + 8) & 0x1f)
         {
@@ -796,73 +771,73 @@ static int32_t cell(int i)
           case 0x02:
           case 0x1d:
             /* mixed white & computed color*/
-            c = (*stylefunc)(i);
+            c = (*priv->color_map.stylefunc)(priv, i);
             c = (((c & 0xfefefe) + 0xfefefe) / 2);
             break;
 
           default:
             /* Just compute the color */
-            c = (*stylefunc)(i);
+            c = (*priv->color_map.stylefunc)(priv, i);
         }
     }
     else
-        c = (*stylefunc)(i);
+        c = (*priv->color_map.stylefunc)(priv, i);
 
     /* Return the color */
     return c;
 }
 
-static void choosebg(int do_random)
+static void choosebg(BlurskPrivate *priv, int do_random)
 {
     /* "Random", then choose a background */
     if (do_random)
     {
-        if (!strncmp(config.background, "Random", 6))
-            bgletter = "BWDSCF"[rand_0_to(6)];
+        if (!strncmp(priv->config.background, "Random", 6))
+            priv->color_map.bgletter = "BWDSCF"[rand_0_to(priv, 6)];
         else
-            bgletter = *config.background;
+            priv->color_map.bgletter = *priv->config.background;
     }
 
     /* Choose new background color.  Note that we don't handle
      * "Flash bkgnd" here.
      */
-    switch (bgletter)
+    switch (priv->color_map.bgletter)
     {
       case 'W': /* White bkgnd */
-        tored = togreen = toblue = 230;
+        priv->color_map.tored = priv->color_map.togreen = priv->color_map.toblue = 230;
         break;
 
       case 'D': /* Dark bkgnd */
-        tored = red / 2;
-        togreen = green / 2;
-        toblue = blue / 2;
+        priv->color_map.tored = priv->color_map.red / 2;
+        priv->color_map.togreen = priv->color_map.green / 2;
+        priv->color_map.toblue = priv->color_map.blue / 2;
         break;
 
       case 'S': /* Shift bkgnd */
-        tored = blue;
-        togreen = red;
-        toblue = green;
+        priv->color_map.tored = priv->color_map.blue;
+        priv->color_map.togreen = priv->color_map.red;
+        priv->color_map.toblue = priv->color_map.green;
         break;
 
       case 'C': /* Color bkgnd */
         if (do_random)
         {
-            tored = rand_0_to(255);
-            togreen = rand_0_to(255);
-            toblue = rand_0_to(255);
+            priv->color_map.tored = rand_0_to(priv, 255);
+            priv->color_map.togreen = rand_0_to(priv, 255);
+            priv->color_map.toblue = rand_0_to(priv, 255);
         }
         else
         {
-            tored = fromred;
-            togreen = fromgreen;
-            toblue = fromblue;
+            priv->color_map.tored = priv->color_map.fromred;
+            priv->color_map.togreen = priv->color_map.fromgreen;
+            priv->color_map.toblue = priv->color_map.fromblue;
         }
         break;
 
       default: /* Black bkgnd, and also fake Flash bkgnd */
-        tored = togreen = toblue = 0;
+        priv->color_map.tored = priv->color_map.togreen = priv->color_map.toblue = 0;
     }
-    tonew = TRUE;
+    priv->color_map.tonew = TRUE;
 }
 
 
@@ -888,34 +863,34 @@ void color_transition(
     if (from == scale)
     {
         /* Previous transition must be complete, I guess */
-        fromred = tored;
-        fromgreen = togreen;
-        fromblue = toblue;
+        priv->color_map.fromred = priv->color_map.tored;
+        priv->color_map.fromgreen = priv->color_map.togreen;
+        priv->color_map.fromblue = priv->color_map.toblue;
 
-        choosebg(TRUE);
+        choosebg(priv, TRUE);
     }
 
     /* Do the background color transition */
     if (to <= 0)
     {
-        bgred = tored;
-        bggreen = togreen;
-        bgblue = toblue;
+        priv->color_map.bgred = priv->color_map.tored;
+        priv->color_map.bggreen = priv->color_map.togreen;
+        priv->color_map.bgblue = priv->color_map.toblue;
     }
     else
     {
-        bgred = (tored * (scale - to) + fromred * to) / scale;
-        bggreen = (togreen * (scale - to) + fromgreen * to) / scale;
-        bgblue = (toblue * (scale - to) + fromblue * to) / scale;
+        priv->color_map.bgred = (priv->color_map.tored * (scale - to) + priv->color_map.fromred * to) / scale;
+        priv->color_map.bggreen = (priv->color_map.togreen * (scale - to) + priv->color_map.fromgreen * to) / scale;
+        priv->color_map.bgblue = (priv->color_map.toblue * (scale - to) + priv->color_map.fromblue * to) / scale;
     }
 
     /* if colorstyle isn't "random" then do nothing more */
-    if (strcmp(config.color_style, "Random"))
+    if (strcmp(priv->config.color_style, "Random"))
         return;
 
     /* if from==scale then choose a new random color style */
     if (from == scale)
-        stylefunc = colorstyles[rand_0_to(QTY(colorstyles))].func;
+        priv->color_map.stylefunc = colorstyles[rand_0_to(priv, QTY(colorstyles))].func;
 
     /* scale the numbers to match the size of the color table */
     from = from * 255 / scale;
@@ -924,12 +899,12 @@ void color_transition(
     /* recompute ONLY the affected cells */
     for (; from > to; from--)
     {
-        colors[from] = cell(from);
-        visual_color_set_from_uint32(&pal_colors[from], colors[from]);
+        priv->color_map.colors[from] = cell(priv, from);
+        visual_color_set_from_uint32(&pal_colors[from], priv->color_map.colors[from]);
     }
 
     /* Adjust the background, and then activate the new colormap.  */
-    tonew = TRUE;
+    priv->color_map.tonew = TRUE;
     color_bg(priv, 0, NULL);
 
     /* Remember the lower bound of the transition.  Other color changes
@@ -938,7 +913,7 @@ void color_transition(
      * hue or contour change will be effected for the remaining color
      * cells as a natural consequence of the transition.)
      */
-    transition_bound = to;
+    priv->color_map.transition_bound = to;
 }
 
 
@@ -952,49 +927,49 @@ void color_genmap(BlurskPrivate *priv, int do_random)
     int32_t i;
 
     /* Decompose the dominant color into R/G/B components */
-    red = (int32_t)(config.color / 0x10000);
-    green = (int32_t)((config.color % 0x10000)/0x100);
-    blue = (int32_t)(config.color % 0x100);
+    priv->color_map.red = (int32_t)(priv->config.color / 0x10000);
+    priv->color_map.green = (int32_t)((priv->config.color % 0x10000)/0x100);
+    priv->color_map.blue = (int32_t)(priv->config.color % 0x100);
 
     /* Choose a new background, if appropriate */
-    choosebg(do_random);
-    bgred = fromred = tored;
-    bggreen = fromgreen = togreen;
-    bgblue = fromblue = toblue;
-    tonew = TRUE;
+    choosebg(priv, do_random);
+    priv->color_map.bgred = priv->color_map.fromred = priv->color_map.tored;
+    priv->color_map.bggreen = priv->color_map.fromgreen = priv->color_map.togreen;
+    priv->color_map.bgblue = priv->color_map.fromblue = priv->color_map.toblue;
+    priv->color_map.tonew = TRUE;
 
     /* Find the name in the colorstyles[] table */
-    if ((do_random || !stylefunc) && !strcmp(config.color_style, "Random"))
+    if ((do_random || !priv->color_map.stylefunc) && !strcmp(priv->config.color_style, "Random"))
     {
         /* Choose a "Random" colorstyle */
-        stylefunc = colorstyles[rand_0_to(QTY(colorstyles))].func;
+        priv->color_map.stylefunc = colorstyles[rand_0_to(priv, QTY(colorstyles))].func;
     }
-    else if (!stylefunc || strcmp(config.color_style, "Random"))
+    else if (!priv->color_map.stylefunc || strcmp(priv->config.color_style, "Random"))
     {
         /* Use the named colorstyle */
         for (i = 0;
              i < QTY(colorstyles)
-            && strcmp(colorstyles[i].name, config.color_style);
+            && strcmp(colorstyles[i].name, priv->config.color_style);
              i++)
         {
         }
         if (i >= QTY(colorstyles))
             i = 0;
-        stylefunc = colorstyles[i].func;
+        priv->color_map.stylefunc = colorstyles[i].func;
 
         /* Transitions only affect "Random" colorstyle, not this one */
-        transition_bound = 0;
+        priv->color_map.transition_bound = 0;
     }
 
     /* Generate the basic colormap */
-    for (i = 255; i >= transition_bound; i--)
+    for (i = 255; i >= priv->color_map.transition_bound; i--)
     {
-        colors[i] = cell(i);
-        visual_color_set_from_uint32(&pal_colors[i], colors[i]);
+        priv->color_map.colors[i] = cell(priv, i);
+        visual_color_set_from_uint32(&pal_colors[i], priv->color_map.colors[i]);
     }
 
     /* Adjust the background, and then activate the new colormap.  */
-    tonew = TRUE;
+    priv->color_map.tonew = TRUE;
     color_bg(priv, 0, NULL);
 }
 
@@ -1010,33 +985,32 @@ void color_bg(BlurskPrivate *priv, int ndata, int16_t *data)
     int16_t max, min;
     int32_t totdelta;
     int32_t newcolors[256];
-    static int32_t fallr, fallg, fallb;
 
     /* if we aren't doing "Flash bkgnd" and we've reached our final color,
      * then do nothing
      */
-    if (bgletter != 'F'
-     && bgred == tored && bggreen == togreen && bgblue == toblue)
+    if (priv->color_map.bgletter != 'F'
+     && priv->color_map.bgred == priv->color_map.tored && priv->color_map.bggreen == priv->color_map.togreen && priv->color_map.bgblue == priv->color_map.toblue)
     {
-        if (!tonew)
+        if (!priv->color_map.tonew)
             return;
-        tonew = FALSE;
+        priv->color_map.tonew = FALSE;
     }
 
     /* force colors[0] to be the background color */
-    colors[0] = 0xff000000;
+    priv->color_map.colors[0] = 0xff000000;
 
     /* compute the RGB background color, based on data */
-    if (bgletter != 'F' || ndata == 0)
+    if (priv->color_map.bgletter != 'F' || ndata == 0)
     {
         /* Use the transition colors */
-        bgr = bgred;
-        bgg = bggreen;
-        bgb = bgblue;
+        bgr = priv->color_map.bgred;
+        bgg = priv->color_map.bggreen;
+        bgb = priv->color_map.bgblue;
     }
     else /* "Flash bkgnd" */
     {
-        if (nspectrums == 0)
+        if (priv->nspectrums == 0)
         {
             /* data is samples */
 
@@ -1069,7 +1043,7 @@ void color_bg(BlurskPrivate *priv, int ndata, int16_t *data)
              * suffers from being backward -- which looks cool
              * in a graph, but would hurt us here.
              */
-            if (nspectrums == 2)
+            if (priv->nspectrums == 2)
                 ndata /= 2, data += ndata;
 
             /* the lower frequencies are used for red, middle
@@ -1098,9 +1072,9 @@ void color_bg(BlurskPrivate *priv, int ndata, int16_t *data)
         /* during transition from colored to flash, we never want to
          * be darker than the old color.
          */
-        if (bgr < bgred) bgr = bgred;
-        if (bgg < bggreen) bgg = bggreen;
-        if (bgb < bgblue) bgb = bgblue;
+        if (bgr < priv->color_map.bgred) bgr = priv->color_map.bgred;
+        if (bgg < priv->color_map.bggreen) bgg = priv->color_map.bggreen;
+        if (bgb < priv->color_map.bgblue) bgb = priv->color_map.bgblue;
 
         /* clamp the background color values to be within 0...255.  Also
          * try to avoid dark gray backgrounds by ignoring values < 30
@@ -1113,25 +1087,25 @@ void color_bg(BlurskPrivate *priv, int ndata, int16_t *data)
         else if (bgb > 255) bgb = 255;
 
         /* limit the fall-off speed */
-        if (bgr < fallr)
-            bgr = fallr;
-        fallr = bgr - ((bgr + 15) >> 4);
-        if (bgg < fallg)
-            bgg = fallg;
-        fallg = bgg - ((bgg + 15) >> 4);
-        if (bgb < fallb)
-            bgb = fallb;
-        fallb = bgb - ((bgb + 15) >> 4);
+        if (bgr < priv->color_map.fallr)
+            bgr = priv->color_map.fallr;
+        priv->color_map.fallr = bgr - ((bgr + 15) >> 4);
+        if (bgg < priv->color_map.fallg)
+            bgg = priv->color_map.fallg;
+        priv->color_map.fallg = bgg - ((bgg + 15) >> 4);
+        if (bgb < priv->color_map.fallb)
+            bgb = priv->color_map.fallb;
+        priv->color_map.fallb = bgb - ((bgb + 15) >> 4);
     }
 
     /* build a new colormap, derived from the black-background one */
     for (i = 0; i < 256; i++)
     {
         /* extract the bg brightness.  If 0, then copy unchanged */
-        k = (colors[i] >> 24) & 0xff;
+        k = (priv->color_map.colors[i] >> 24) & 0xff;
         if (k == 0)
         {
-            newcolors[i] = colors[i];
+            newcolors[i] = priv->color_map.colors[i];
             visual_color_set_from_uint32(&pal_colors[i], newcolors[i]);
             continue;
         }
@@ -1140,7 +1114,7 @@ void color_bg(BlurskPrivate *priv, int ndata, int16_t *data)
         bg = (((bgr * k) << 8) & 0x00ff0000)
            | ( (bgg * k)       & 0x0000ff00)
            | (((bgb * k) >> 8) & 0x000000ff);
-        newcolors[i] = colors[i] + bg;
+        newcolors[i] = priv->color_map.colors[i] + bg;
         visual_color_set_from_uint32(&pal_colors[i], newcolors[i]);
     }
 }
@@ -1195,15 +1169,15 @@ void color_beat(BlurskPrivate *priv)
     hsv_t   hsv;
 
     /* if hue_on_beats isn't set, then do nothing */
-    if (!config.hue_on_beats)
+    if (!priv->config.hue_on_beats)
         return;
 
     /* Compute a new base color.  Tell the config window about it. */
-    hsv = *rgb_to_hsv(config.color);
+    rgb_to_hsv(priv->config.color, &hsv);
     hsv.hue += 60.0;
     if (hsv.hue > 360.0)
         hsv.hue -= 360.0;
-    config.color = hsv_to_rgb(&hsv);
+    priv->config.color = hsv_to_rgb(&hsv);
 
     /* regenerate color map */
     color_genmap(priv, FALSE);
@@ -121,7 +121,7 @@ void config_default(BlurskConfig *conf)
  */
 void config_string_genstring(BlurskPrivate *priv)
 {
-    char *string = paste_genstring();
+    char *string = paste_genstring(priv);
 
     VisParamList *params = visual_plugin_get_params(priv->plugin);
 
@@ -244,7 +244,7 @@ static void _change_config_string(BlurskPrivate *priv, char **string, VisParam *
         *string = visual_strdup(visual_param_get_value_string(p));
 
         /* parse the string */
-        c = paste_parsestring(*string);
+        c = paste_parsestring(priv, *string);
 
         /* use this configuration */
         _config_load_preset(priv, c);
@@ -647,30 +647,30 @@ void config_change_param(BlurskPrivate *priv, VisParam *p)
         void (*postchange)(BlurskPrivate *priv);
     } parms[] =
     {
-        {"color", &config.color, NULL, (void *) _change_color, __color_genmap},
-        {"color_style", &config.color_style, (void *) _color_style_validate, (void *) _change_string, __color_genmap},
-        {"signal_color", &config.signal_color, (void *) _color_signal_validate, (void *) _change_string, NULL},
-        {"contour_lines", &config.contour_lines, NULL, (void *) _change_bool, NULL},
-        {"hue_on_beats", &config.hue_on_beats, NULL, (void *) _change_bool, NULL},
-        {"slow_motion", &config.slow_motion, NULL, (void *) _change_bool, NULL},
-        {"thick_on_beats", &config.thick_on_beats, NULL, (void *) _change_bool, NULL},
-        {"background", &config.background, (void *) _color_background_validate, (void *) _change_string, NULL},
-        {"blur_style", &config.blur_style, (void *) _blur_style_validate, (void *) _change_string, NULL},
-        {"transition_speed", &config.transition_speed, (void *) _blur_transition_speed_validate, (void *) _change_string, NULL},
-        {"blur_when", &config.blur_when, (void *) _blur_when_validate, (void *) _change_string, NULL},
-        {"blur_stencil", &config.blur_stencil, NULL, (void *) _change_string, NULL},
-        {"fade_speed", &config.fade_speed, (void *) _fade_speed_validate, (void *) _change_string, NULL},
-        {"signal_style", &config.signal_style, (void *) _signal_style_validate, (void *) _change_string, NULL},
-        {"plot_style", &config.plot_style, (void *) _plot_style_validate, (void *) _change_string, NULL},
-        {"flash_style", &config.flash_style, (void *) _flash_style_validate, (void *) _change_string, NULL},
-        {"overall_effect", &config.overall_effect, (void *) _overall_effect_validate, (void *) _change_string, NULL},
-        {"floaters", &config.floaters, (void *) _floaters_validate, (void *) _change_string, NULL},
-        {"cpu_speed", &config.cpu_speed, (void *) _cpu_speed_validate, (void *) _change_string, NULL},
-        {"beat_sensitivity", &config.beat_sensitivity, NULL, (void *) _change_int, NULL},
-        {"config_string", &config.config_string, NULL, (void *) _change_config_string, NULL},
-        {"show_info", &config.show_info, (void *) _show_info_validate, (void *) _change_string, NULL},
-        {"info_timeout", &config.info_timeout, NULL, (void *) _change_int, NULL},
-        {"show_timestamp", &config.show_timestamp, NULL, (void *) _change_bool, NULL}
+        {"color", &priv->config.color, NULL, (void *) _change_color, __color_genmap},
+        {"color_style", &priv->config.color_style, (void *) _color_style_validate, (void *) _change_string, __color_genmap},
+        {"signal_color", &priv->config.signal_color, (void *) _color_signal_validate, (void *) _change_string, NULL},
+        {"contour_lines", &priv->config.contour_lines, NULL, (void *) _change_bool, NULL},
+        {"hue_on_beats", &priv->config.hue_on_beats, NULL, (void *) _change_bool, NULL},
+        {"slow_motion", &priv->config.slow_motion, NULL, (void *) _change_bool, NULL},
+        {"thick_on_beats", &priv->config.thick_on_beats, NULL, (void *) _change_bool, NULL},
+        {"background", &priv->config.background, (void *) _color_background_validate, (void *) _change_string, NULL},
+        {"blur_style", &priv->config.blur_style, (void *) _blur_style_validate, (void *) _change_string, NULL},
+        {"transition_speed", &priv->config.transition_speed, (void *) _blur_transition_speed_validate, (void *) _change_string, NULL},
+        {"blur_when", &priv->config.blur_when, (void *) _blur_when_validate, (void *) _change_string, NULL},
+        {"blur_stencil", &priv->config.blur_stencil, NULL, (void *) _change_string, NULL},
+        {"fade_speed", &priv->config.fade_speed, (void *) _fade_speed_validate, (void *) _change_string, NULL},
+        {"signal_style", &priv->config.signal_style, (void *) _signal_style_validate, (void *) _change_string, NULL},
+        {"plot_style", &priv->config.plot_style, (void *) _plot_style_validate, (void *) _change_string, NULL},
+        {"flash_style", &priv->config.flash_style, (void *) _flash_style_validate, (void *) _change_string, NULL},
+        {"overall_effect", &priv->config.overall_effect, (void *) _overall_effect_validate, (void *) _change_string, NULL},
+        {"floaters", &priv->config.floaters, (void *) _floaters_validate, (void *) _change_string, NULL},
+        {"cpu_speed", &priv->config.cpu_speed, (void *) _cpu_speed_validate, (void *) _change_string, NULL},
+        {"beat_sensitivity", &priv->config.beat_sensitivity, NULL, (void *) _change_int, NULL},
+        {"config_string", &priv->config.config_string, NULL, (void *) _change_config_string, NULL},
+        {"show_info", &priv->config.show_info, (void *) _show_info_validate, (void *) _change_string, NULL},
+        {"info_timeout", &priv->config.info_timeout, NULL, (void *) _change_int, NULL},
+        {"show_timestamp", &priv->config.show_timestamp, NULL, (void *) _change_bool, NULL}
     };
 
 
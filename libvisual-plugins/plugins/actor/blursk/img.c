@@ -45,29 +45,6 @@
 #include "actor_blursk.h"
 #include "blursk.h"
 
-/* These global variables store image information */
-uint8_t     *img_buf;   /* base of the current image buffer */
-uint8_t     *img_tmp;   /* base of another image buffer, for temp operations */
-uint8_t     **img_source;   /* an array of pixel pointers, for blur motion */
-unsigned int    img_height; /* height of the current image */
-unsigned int    img_width;  /* width of the current image */
-unsigned int    img_bpl;    /* bytes per line of the current image */
-unsigned int    img_chunks; /* number of 8-pixel chunks in the image */
-
-unsigned int    img_physheight; /* height of the current window */
-unsigned int    img_physwidth;  /* width of the current window */
-uint8_t img_rippleshift;/* ripple map cycling counter */
-
-/* These are the base addresses of allocated memory, so we can free the old
- * images when we resize to a new image.
- */
-static uint8_t   *base_buf;
-static uint8_t   *base_tmp;
-static uint8_t   **base_source;
-
-/* This stores the state of the "cpu_speed" option when bufs were allocated */
-static char speed;
-
 /* Allocate buffers for an image with a given size.  Initialize the buffers.
  * This function should be called during initialization, and again any time the
  * window size or "cpu_speed" option changes.
@@ -78,17 +55,17 @@ void img_resize(BlurskPrivate *priv, int physwidth, int physheight)
     uint8_t *buf, **source;
     int tmp_factor;
 
-    /* If same size & cpu speed, then do nothing */
-    if (physwidth == img_physwidth && physheight == img_physheight
-     && *config.cpu_speed == speed)
+    /* If same size & cpu img.speed, then do nothing */
+    if (physwidth == priv->img.physwidth && physheight == priv->img.physheight
+     && *priv->config.cpu_speed == priv->img.speed)
         return;
 
     /* free the old memory, if any */
-    if (base_buf)
+    if (priv->img.base_buf)
     {
-        visual_mem_free(base_buf);
-        visual_mem_free(base_tmp);
-        visual_mem_free(base_source);
+        visual_mem_free(priv->img.base_buf);
+        visual_mem_free(priv->img.base_tmp);
+        visual_mem_free(priv->img.base_source);
     }
 
     /* Store the width, height, and bytes-per-line of the new image size.
@@ -97,101 +74,101 @@ void img_resize(BlurskPrivate *priv, int physwidth, int physheight)
      * causes even-byte dithering to have a checkerboard pattern instead
      * of vertical lines (so dithering looks better).
      */
-    img_physheight = physheight;
-    img_physwidth = physwidth;
-    speed =  *config.cpu_speed;
-    switch (speed)
+    priv->img.physheight = physheight;
+    priv->img.physwidth = physwidth;
+    priv->img.speed =  *priv->config.cpu_speed;
+    switch (priv->img.speed)
     {
       case 'F': /* Fast CPU */
-        img_height = physheight;
-        img_width = physwidth;
+        priv->img.height = physheight;
+        priv->img.width = physwidth;
         tmp_factor = 1;
         break;
 
       case 'M': /* Medium CPU */
-        img_height = physheight;
-        img_width = (physwidth + 1) / 2;
+        priv->img.height = physheight;
+        priv->img.width = (physwidth + 1) / 2;
         tmp_factor = 2;
         break;
 
       default: /* Slow CPU */
-        img_height = (physheight + 1) / 2;
-        img_width = (physwidth + 1) / 2;
+        priv->img.height = (physheight + 1) / 2;
+        priv->img.width = (physwidth + 1) / 2;
         tmp_factor = 4;
     }
-    //img_bpl = ((img_width) & ~1) + 1;
-    img_bpl = img_width;
+    //priv->img.bpl = ((priv->img.width) & ~1) + 1;
+    priv->img.bpl = priv->img.width;
 
     /* Compute the number of chunks.  This is the number of 8-pixel groups
      * that are needed to cover all visible pixels.
      */
-    img_chunks = (img_height * img_bpl + 7) >> 3;
+    priv->img.chunks = (priv->img.height * priv->img.bpl + 7) >> 3;
 
     /* Compute the number of pixels to allocate.  This should include
      * two extra rasters above and two below the image.  It should also
      * include enough extra bytes so that the base of the visible image
      * is on an 8-byte boundary.
      */
-    size = ((img_height + 4) * img_bpl + 7) & ~7;
+    size = ((priv->img.height + 4) * priv->img.bpl + 7) & ~7;
 
     /* allocate the memory */
-    base_buf = (uint8_t *)visual_mem_malloc(size * sizeof(uint8_t));
-    base_tmp = (uint8_t *)visual_mem_malloc(size * tmp_factor * sizeof(uint8_t));
-    base_source = (uint8_t **)visual_mem_malloc(size * sizeof(uint8_t *));
+    priv->img.base_buf = (uint8_t *)visual_mem_malloc(size * sizeof(uint8_t));
+    priv->img.base_tmp = (uint8_t *)visual_mem_malloc(size * tmp_factor * sizeof(uint8_t));
+    priv->img.base_source = (uint8_t **)visual_mem_malloc(size * sizeof(uint8_t *));
 
     /* Initialize the memory */
-    memset(base_buf, 0, size);
-    for (buf = base_buf, source = base_source; size != 0; size--)
+    memset(priv->img.base_buf, 0, size);
+    for (buf = priv->img.base_buf, source = priv->img.base_source; size != 0; size--)
         *source++ = buf++;
 
     /* Set the image pointer bases to the start of the visible pixels */
-    size = (img_bpl * 2 + 7) & ~7;
-    img_buf = base_buf + size;
-    img_tmp = base_tmp + tmp_factor * size;
-    img_source = base_source + size;
+    size = (priv->img.bpl * 2 + 7) & ~7;
+    priv->img.buf = priv->img.base_buf + size;
+    priv->img.tmp = priv->img.base_tmp + tmp_factor * size;
+    priv->img.source = priv->img.base_source + size;
 
-    priv->rgb_buf = img_buf;
+    priv->rgb_buf = priv->img.buf;
 }
 
-void img_cleanup()
+void img_cleanup(BlurskPrivate *priv)
 {
-    if(base_buf) 
+    if(priv->img.base_buf) 
     {
-        visual_mem_free(base_buf);
-        visual_mem_free(base_tmp);
-        visual_mem_free(base_source);
-        base_buf = NULL;
-        base_tmp = NULL;
-        base_source = NULL;
+        visual_mem_free(priv->img.base_buf);
+        visual_mem_free(priv->img.base_tmp);
+        visual_mem_free(priv->img.base_source);
+        priv->img.base_buf = NULL;
+        priv->img.base_tmp = NULL;
+        priv->img.base_source = NULL;
     }
 }
 
-/* Copy the visible parts of img_tmp into img_buf, without disturbing the
- * border pixels.  The image in img_tmp is assumed to be the same size as the
- * one in img_buf, regardless of the cpu_speed option.
+/* Copy the visible parts of img.tmp into img.buf, without disturbing the
+ * border pixels.  The image in img.tmp is assumed to be the same size as the
+ * one in img.buf, regardless of the cpu_speed option.
  */
-void img_copyback(void)
+void img_copyback(BlurskPrivate *priv)
 {
     int i;
     uint8_t *src, *dst;
 
-    for (i = img_height, src = img_tmp, dst = img_buf;
+    for (i = priv->img.height, src = priv->img.tmp, dst = priv->img.buf;
          --i >= 0;
-         src += img_bpl, dst += img_bpl)
+         src += priv->img.bpl, dst += priv->img.bpl)
     {
-        memcpy(dst, src, img_width);
+        memcpy(dst, src, priv->img.width);
     }
 }
 
 
-/* Invert the visible pixels in img_buf, but not the border pixels */
-void img_invert(void)
+/* Invert the visible pixels in img.buf, but not the border pixels */
+void img_invert(BlurskPrivate *priv)
 {
     uint8_t *pixel;
     int y, x;
 
-    for (y = img_height, pixel = img_buf; --y >= 0; pixel += img_bpl - img_width)
-        for (x = img_width; --x >= 0; pixel++)
+    for (y = priv->img.height, pixel = priv->img.buf; --y >= 0; pixel += priv->img.bpl - priv->img.width)
+        for (x = priv->img.width; --x >= 0; pixel++)
             /* Invert the pixel in such a way that 255 is mapped
              * back to 255.  This makes the "white signal" color
              * flag look better.
@@ -200,51 +177,51 @@ void img_invert(void)
 }
 
 
-/* Expand the image in img_buf into img_tmp */
-uint8_t *img_expand(int *widthref, int *heightref, int *bplref)
+/* Expand the image in img.buf into img.tmp */
+uint8_t *img_expand(BlurskPrivate *priv, int *widthref, int *heightref, int *bplref)
 {
     int i, bpl;
     uint8_t *src, *dst;
 
-    switch (speed)
+    switch (priv->img.speed)
     {
       case 'F': /* Fast */
-        /* No copying necessary, just return img_buf */
-        *widthref = img_width;
-        *heightref = img_height;
-        *bplref = img_bpl;
-        return img_buf;
+        /* No copying necessary, just return img.buf */
+        *widthref = priv->img.width;
+        *heightref = priv->img.height;
+        *bplref = priv->img.bpl;
+        return priv->img.buf;
 
       case 'M': /* Medium */
-        /* Expand img_buf into img_tmp */
-        loopinterp();
-        *widthref = img_physwidth;
-        *heightref = img_physheight;
-        *bplref = img_bpl * 2;
-        return img_tmp;
+        /* Expand img.buf into img.tmp */
+        loopinterp(priv);
+        *widthref = priv->img.physwidth;
+        *heightref = priv->img.physheight;
+        *bplref = priv->img.bpl * 2;
+        return priv->img.tmp;
 
       default: /* Medium or Fast */
-        /* Expand img_buf into img_tmp */
-        loopinterp();
+        /* Expand img.buf into img.tmp */
+        loopinterp(priv);
 
         /* Double up every raster line */
-        bpl = 2 * img_bpl;
-        src = &img_tmp[(img_height - 1) * bpl];
-        dst = &img_tmp[(img_physheight - 1) * bpl];
-        for (i = img_height; --i >= 0; )
+        bpl = 2 * priv->img.bpl;
+        src = &priv->img.tmp[(priv->img.height - 1) * bpl];
+        dst = &priv->img.tmp[(priv->img.physheight - 1) * bpl];
+        for (i = priv->img.height; --i >= 0; )
         {
-            memcpy(dst, src, img_physwidth);
+            memcpy(dst, src, priv->img.physwidth);
             dst -= bpl;
-            memcpy(dst, src, img_physwidth);
+            memcpy(dst, src, priv->img.physwidth);
             dst -= bpl;
             src -= bpl;
         }
 
         /* Return it */
-        *widthref = img_physwidth;
-        *heightref = img_physheight;
+        *widthref = priv->img.physwidth;
+        *heightref = priv->img.physheight;
         *bplref = bpl;
-        return img_tmp;
+        return priv->img.tmp;
     }
 }
 
@@ -252,27 +229,27 @@ uint8_t *img_expand(int *widthref, int *heightref, int *bplref)
 /* This transforms a normal image into a "bump effect" image.  It also expands
  * the image like img_expand() if necessary.
  */
-uint8_t *img_bump(int *widthref, int *heightref, int *bplref)
+uint8_t *img_bump(BlurskPrivate *priv, int *widthref, int *heightref, int *bplref)
 {
     uint8_t *dst, *src, *end;
     int delta, bpl, i;
 
-    switch (speed)
+    switch (priv->img.speed)
     {
       case 'F': /* Fast CPU */
         /* Can't generate shadows for the first few pixels, so just use
          * a generic flat background.  And hope nobody notices.
          */
-        delta = 3 * img_bpl + 2;
-        memset(img_tmp, 128, delta);
+        delta = 3 * priv->img.bpl + 2;
+        memset(priv->img.tmp, 128, delta);
 
         /* The remaining ones can have shadows.  Lift the "white_signal"
          * test outside the loop, for efficiency.
          */
-        src = img_buf + delta;
-        dst = img_tmp + delta;
-        end = img_tmp + img_height * img_bpl;
-        if (*config.signal_color == 'W')
+        src = priv->img.buf + delta;
+        dst = priv->img.tmp + delta;
+        end = priv->img.tmp + priv->img.height * priv->img.bpl;
+        if (*priv->config.signal_color == 'W')
         {
             for (; dst < end; dst++, src++)
             {
@@ -291,25 +268,25 @@ uint8_t *img_bump(int *widthref, int *heightref, int *bplref)
         }
 
         /* return the image size */
-        *widthref = img_width;
-        *heightref = img_height;
-        *bplref = img_bpl;
-        return img_tmp;
+        *widthref = priv->img.width;
+        *heightref = priv->img.height;
+        *bplref = priv->img.bpl;
+        return priv->img.tmp;
 
       default: /* Medium CPU or Slow CPU */
         /* Can't generate shadows for the first few pixels, so just use
          * a generic flat background.  And hope nobody notices.
          */
-        delta = 3 * img_bpl + 2;
-        memset(img_tmp, 128, delta * 2);
+        delta = 3 * priv->img.bpl + 2;
+        memset(priv->img.tmp, 128, delta * 2);
 
         /* The remaining ones can have shadows.  Lift the "white_signal"
          * test outside the loop, for efficiency.
          */
-        src = img_buf + delta;
-        dst = img_tmp + delta * 2;
-        end = img_tmp + img_height * img_bpl * 2;
-        if (*config.signal_color == 'W')
+        src = priv->img.buf + delta;
+        dst = priv->img.tmp + delta * 2;
+        end = priv->img.tmp + priv->img.height * priv->img.bpl * 2;
+        if (*priv->config.signal_color == 'W')
         {
             for (; dst < end; dst += 2, src++)
             {
@@ -328,61 +305,61 @@ uint8_t *img_bump(int *widthref, int *heightref, int *bplref)
         }
 
         /* For "Slow CPU", we also need to double the height */
-        if (speed == 'S')
+        if (priv->img.speed == 'S')
         {
-            bpl = 2 * img_bpl;
-            src = &img_tmp[(img_height - 1) * bpl];
-            dst = &img_tmp[(img_physheight - 1) * bpl];
-            for (i = img_height; --i >= 0; )
+            bpl = 2 * priv->img.bpl;
+            src = &priv->img.tmp[(priv->img.height - 1) * bpl];
+            dst = &priv->img.tmp[(priv->img.physheight - 1) * bpl];
+            for (i = priv->img.height; --i >= 0; )
             {
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
                 src -= bpl;
             }
         }
 
         /* return the physical size */
-        *widthref = img_physwidth;
-        *heightref = img_physheight;
-        *bplref = img_bpl * 2;
-        return img_tmp;
+        *widthref = priv->img.physwidth;
+        *heightref = priv->img.physheight;
+        *bplref = priv->img.bpl * 2;
+        return priv->img.tmp;
     }
 }
 
 /* This transforms a normal image into a "travel effect" image.  It also
  * expands the image like img_expand() if necessary.
  */
-uint8_t *img_travel(int *widthref, int *heightref, int *bplref)
+uint8_t *img_travel(BlurskPrivate *priv, int *widthref, int *heightref, int *bplref)
 {
     uint8_t *dst, *src;
     int bpl, i;
-    static uint8_t shift;
+    uint8_t shift;
 
-    /* Compute colormap shift factor, based on fade speed and whether this
+    /* Compute colormap shift factor, based on fade img.speed and whether this
      * function is called for every frame, or just alternate frames.
      */
-    switch (*config.fade_speed)
+    switch (*priv->config.fade_speed)
     {
       case 'N': i = 0;  break;
       case 'S': i = 1;  break;
       case 'M': i = 3;  break;
       default:  i = 9;  break;
     }
-    shift = (shift + i) & 0xff;
+    shift = priv->img.travelshift = (priv->img.travelshift + i) & 0xff;
 
     /* Copy the image, expanding it for lower CPU speeds */
-    switch (speed)
+    switch (priv->img.speed)
     {
       case 'F': /* Fast CPU */
         /* The remaining ones can have shadows.  Lift the "white_signal"
          * test outside the loop, for efficiency.
          */
-        src = img_buf;
-        dst = img_tmp;
-        i = img_chunks;
-        if (*config.signal_color == 'W')
+        src = priv->img.buf;
+        dst = priv->img.tmp;
+        i = priv->img.chunks;
+        if (*priv->config.signal_color == 'W')
         {
             for (i <<= 3; --i >= 0; dst++, src++)
             {
@@ -418,19 +395,19 @@ uint8_t *img_travel(int *widthref, int *heightref, int *bplref)
         }
 
         /* return the image size */
-        *widthref = img_width;
-        *heightref = img_height;
-        *bplref = img_bpl;
-        return img_tmp;
+        *widthref = priv->img.width;
+        *heightref = priv->img.height;
+        *bplref = priv->img.bpl;
+        return priv->img.tmp;
 
       default: /* Medium CPU or Slow CPU */
         /* The remaining ones can have shadows.  Lift the "white_signal"
          * test outside the loop, for efficiency.
          */
-        src = img_buf;
-        dst = img_tmp;
-        i = img_chunks;
-        if (*config.signal_color == 'W')
+        src = priv->img.buf;
+        dst = priv->img.tmp;
+        i = priv->img.chunks;
+        if (*priv->config.signal_color == 'W')
         {
             for (i <<= 3; --i >= 0; dst += 2, src++)
             {
@@ -474,33 +451,33 @@ uint8_t *img_travel(int *widthref, int *heightref, int *bplref)
         }
 
         /* For "Slow CPU", we also need to double the height */
-        if (speed == 'S')
+        if (priv->img.speed == 'S')
         {
-            bpl = 2 * img_bpl;
-            src = &img_tmp[(img_height - 1) * bpl];
-            dst = &img_tmp[(img_physheight - 1) * bpl];
-            for (i = img_height; --i >= 0; )
+            bpl = 2 * priv->img.bpl;
+            src = &priv->img.tmp[(priv->img.height - 1) * bpl];
+            dst = &priv->img.tmp[(priv->img.physheight - 1) * bpl];
+            for (i = priv->img.height; --i >= 0; )
             {
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
                 src -= bpl;
             }
         }
 
         /* return the physical size */
-        *widthref = img_physwidth;
-        *heightref = img_physheight;
-        *bplref = img_bpl * 2;
-        return img_tmp;
+        *widthref = priv->img.physwidth;
+        *heightref = priv->img.physheight;
+        *bplref = priv->img.bpl * 2;
+        return priv->img.tmp;
     }
 }
 
 /* This transforms a normal image into a "Ripple effect" image.  It also
  * expands the image like img_expand() if necessary.
  */
-uint8_t *img_ripple(int *widthref, int *heightref, int *bplref)
+uint8_t *img_ripple(BlurskPrivate *priv, int *widthref, int *heightref, int *bplref)
 {
     uint8_t *dst, *src;
     int bpl, i;
@@ -509,15 +486,15 @@ uint8_t *img_ripple(int *widthref, int *heightref, int *bplref)
     /* Compute the mapping table */
     for (i = QTY(tbl); --i >= 0; )
     {
-        tbl[i] = i + (uint8_t)((double)((QTY(tbl)/2 - abs(QTY(tbl)/2 - i)) >> 1) * sin((double)(i + img_rippleshift) / 10.0));
+        tbl[i] = i + (uint8_t)((double)((QTY(tbl)/2 - abs(QTY(tbl)/2 - i)) >> 1) * sin((double)(i + priv->img.rippleshift) / 10.0));
     }
 
     /* Copy the image, expanding it for lower CPU speeds */
-    switch (speed)
+    switch (priv->img.speed)
     {
       case 'F': /* Fast CPU */
         /* copy the image, computing deltas */
-        for (src = img_buf, dst = img_tmp, i = img_chunks;
+        for (src = priv->img.buf, dst = priv->img.tmp, i = priv->img.chunks;
              --i >= 0;
              )
         {
@@ -532,13 +509,13 @@ uint8_t *img_ripple(int *widthref, int *heightref, int *bplref)
         }
 
         /* return the image size */
-        *widthref = img_width;
-        *heightref = img_height;
-        *bplref = img_bpl;
-        return img_tmp;
+        *widthref = priv->img.width;
+        *heightref = priv->img.height;
+        *bplref = priv->img.bpl;
+        return priv->img.tmp;
 
       default: /* Medium CPU or Slow CPU */
-        for (src = img_buf, dst = img_tmp, i = img_chunks;
+        for (src = priv->img.buf, dst = priv->img.tmp, i = priv->img.chunks;
              --i >= 0;
              )
         {
@@ -553,25 +530,25 @@ uint8_t *img_ripple(int *widthref, int *heightref, int *bplref)
         }
 
         /* For "Slow CPU", we also need to double the height */
-        if (speed == 'S')
+        if (priv->img.speed == 'S')
         {
-            bpl = 2 * img_bpl;
-            src = &img_tmp[(img_height - 1) * bpl];
-            dst = &img_tmp[(img_physheight - 1) * bpl];
-            for (i = img_height; --i >= 0; )
+            bpl = 2 * priv->img.bpl;
+            src = &priv->img.tmp[(priv->img.height - 1) * bpl];
+            dst = &priv->img.tmp[(priv->img.physheight - 1) * bpl];
+            for (i = priv->img.height; --i >= 0; )
             {
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
-                memcpy(dst, src, img_physwidth);
+                memcpy(dst, src, priv->img.physwidth);
                 dst -= bpl;
                 src -= bpl;
             }
         }
 
         /* return the physical size */
-        *widthref = img_physwidth;
-        *heightref = img_physheight;
-        *bplref = img_bpl * 2;
-        return img_tmp;
+        *widthref = priv->img.physwidth;
+        *heightref = priv->img.physheight;
+        *bplref = priv->img.bpl * 2;
+        return priv->img.tmp;
     }
 }
@@ -68,15 +68,15 @@
         bpl = -bpl;
 
 
-void loopblur(void)
+void loopblur(BlurskPrivate *priv)
 {
-    unsigned int i = img_chunks;
-    int bpl = img_bpl;
+    unsigned int i = priv->img.chunks;
+    int bpl = priv->img.bpl;
     unsigned char *dest, *src, **srcref;
 
-    i = img_chunks;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         BLUR
@@ -91,16 +91,16 @@ void loopblur(void)
     } while (--i != 0);
 }
 
-void loopsmear(void)
+void loopsmear(BlurskPrivate *priv)
 {
-    unsigned int i = img_chunks;
-    int bpl = img_bpl;
+    unsigned int i = priv->img.chunks;
+    int bpl = priv->img.bpl;
     unsigned char *dest, *src, *orig, **srcref, pix;
 
-    i = img_chunks;
-    dest = img_tmp;
-    srcref = img_source;
-    orig = img_buf;
+    i = priv->img.chunks;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
+    orig = priv->img.buf;
     do
     {
         SMEAR
@@ -115,16 +115,16 @@ void loopsmear(void)
     } while (--i != 0);
 }
 
-void loopmelt(void)
+void loopmelt(BlurskPrivate *priv)
 {
-    unsigned int i = img_chunks;
-    int bpl = img_bpl;
+    unsigned int i = priv->img.chunks;
+    int bpl = priv->img.bpl;
     unsigned char *dest, *src, *orig, **srcref, pix;
 
-    i = img_chunks;
-    dest = img_tmp;
-    srcref = img_source;
-    orig = img_buf;
+    i = priv->img.chunks;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
+    orig = priv->img.buf;
     do
     {
         MELT
@@ -140,14 +140,14 @@ void loopmelt(void)
 }
 
 
-void loopsharp(void)
+void loopsharp(BlurskPrivate *priv)
 {
     unsigned int i;
     unsigned char *dest, **srcref;
 
-    i = img_chunks;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         SHARP
@@ -162,16 +162,16 @@ void loopsharp(void)
     } while (--i != 0);
 }
 
-void loopreduced1(void)
+void loopreduced1(BlurskPrivate *priv)
 {
     unsigned int i;
     int bpl;
     unsigned char *dest, *src, **srcref;
 
-    i = img_chunks;
-    bpl = img_bpl;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    bpl = priv->img.bpl;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         BLUR
@@ -185,16 +185,16 @@ void loopreduced1(void)
     } while (--i != 0);
 }
 
-void loopreduced2(void)
+void loopreduced2(BlurskPrivate *priv)
 {
     unsigned int i;
     int bpl;
     unsigned char *dest, *src, **srcref;
 
-    i = img_chunks;
-    bpl = img_bpl;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    bpl = priv->img.bpl;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         SHARP
@@ -209,16 +209,16 @@ void loopreduced2(void)
     } while (--i != 0);
 }
 
-void loopreduced3(void)
+void loopreduced3(BlurskPrivate *priv)
 {
     unsigned int i;
     int bpl;
     unsigned char *dest, *src, **srcref;
 
-    i = img_chunks;
-    bpl = img_bpl;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    bpl = priv->img.bpl;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         SHARP
@@ -233,16 +233,16 @@ void loopreduced3(void)
     } while (--i != 0);
 }
 
-void loopreduced4(void)
+void loopreduced4(BlurskPrivate *priv)
 {
     unsigned int i;
     int bpl;
     unsigned char *dest, *src, **srcref;
 
-    i = img_chunks;
-    bpl = img_bpl;
-    dest = img_tmp;
-    srcref = img_source;
+    i = priv->img.chunks;
+    bpl = priv->img.bpl;
+    dest = priv->img.tmp;
+    srcref = priv->img.source;
     do
     {
         SHARP
@@ -257,7 +257,7 @@ void loopreduced4(void)
     } while (--i != 0);
 }
 
-void loopfade(int change)
+void loopfade(BlurskPrivate *priv, int change)
 {
     register unsigned char *ptr;
     unsigned char   limit;
@@ -267,8 +267,8 @@ void loopfade(int change)
     if (change < 0)
     {
         change = -change;
-        ptr = img_buf;
-        i = img_chunks;
+        ptr = priv->img.buf;
+        i = priv->img.chunks;
         do
         {
             if (*ptr > change) *ptr -= change; else *ptr = 0;
@@ -292,8 +292,8 @@ void loopfade(int change)
     else
     {
         limit = 255 - change;
-        ptr = img_buf;
-        i = img_chunks;
+        ptr = priv->img.buf;
+        i = priv->img.chunks;
         do
         {
             if (*ptr < limit) *ptr += change; else *ptr = 255;
@@ -317,17 +317,17 @@ void loopfade(int change)
 }
 
 /* Interpolate between pixels, doubling the image width.  It is assumed that
- * the source is in img_buf, the destination is img_tmp, and img_tmp is large
+ * the source is in img.buf, the destination is img.tmp, and img.tmp is large
  * enough to hold the double-width image.
  */
-void loopinterp(void)
+void loopinterp(BlurskPrivate *priv)
 {
-    unsigned int i = img_chunks;
+    unsigned int i = priv->img.chunks;
     unsigned char *dest, *src, prev;
 
-    i = img_chunks;
-    dest = img_tmp;
-    src = img_buf;
+    i = priv->img.chunks;
+    dest = priv->img.tmp;
+    src = priv->img.buf;
     do
     {
         prev = *dest++ = *src++;
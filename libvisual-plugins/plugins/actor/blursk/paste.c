@@ -33,10 +33,9 @@
 
 
 /* Convert the leading words in a value into a single letter and '.' */
-static char *abbreviate(char *value)
+static char *abbreviate(char *abbr, char *value)
 {
     char        full[40];   /* full value */
-    static char abbr[40];   /* abbreviated value */
     char        *word;
 
     /* Strip off a trailing "stencil" or "flash" word */
@@ -62,12 +61,13 @@ static void genfield(
     ...)            /* NULL-terminated list of hardcoded items */
 {
     char    str[40];    /* abbreviated value */
+    char    abbr[40];   /* abbreviated form of each possible value */
     char    *value;
     int i,len, found;
     va_list ap;
 
     /* generate the abbreviated version of the string */
-    strcpy(str, abbreviate(current));
+    abbreviate(str, current);
 
     /* compare to other values, to see how short we can make this */
     va_start(ap, namefunc);
@@ -83,7 +83,7 @@ static void genfield(
     for (found = FALSE, len = 1; value; )
     {
         /* abbreviate this possible value */
-        value = abbreviate(value);
+        value = abbreviate(abbr, value);
 
         /* if this is the initial value, remember that. */
         if (!strcmp(value, str))
@@ -114,43 +114,43 @@ static void genfield(
 
 
 /* return a string which describes the current configuration */
-char *paste_genstring(void)
+char *paste_genstring(BlurskPrivate *priv)
 {
-    static char buf[100];
+    char    *buf = priv->paste.buf;
     char    *str;
     
     /* start with the color, as a decimal number */
-    sprintf(buf, "%d", config.color);
+    sprintf(buf, "%d", priv->config.color);
     str = buf + strlen(buf);
 
     /* Add the color options */
-    genfield(&str, config.color_style, color_name, NULL);
-    genfield(&str, config.fade_speed, NULL, "No fade", "Slow fade",
+    genfield(&str, priv->config.color_style, color_name, NULL);
+    genfield(&str, priv->config.fade_speed, NULL, "No fade", "Slow fade",
         "Medium fade", "Fast fade", NULL);
-    genfield(&str, config.signal_color, NULL, "Normal signal",
+    genfield(&str, priv->config.signal_color, NULL, "Normal signal",
         "White signal", "Cycling signal", NULL);
-    *str++ = config.contour_lines ? 'Y' : 'N';
-    *str++ = config.hue_on_beats ? 'Y' : 'N';
-    genfield(&str, config.background, color_background_name, NULL);
+    *str++ = priv->config.contour_lines ? 'Y' : 'N';
+    *str++ = priv->config.hue_on_beats ? 'Y' : 'N';
+    genfield(&str, priv->config.background, color_background_name, NULL);
     *str++ = '/';
 
     /* Add the blur options */
-    genfield(&str, config.blur_style, blur_name, NULL);
-    genfield(&str, config.transition_speed, NULL, "Slow switch",
+    genfield(&str, priv->config.blur_style, blur_name, NULL);
+    genfield(&str, priv->config.transition_speed, NULL, "Slow switch",
         "Medium switch", "Fast switch", NULL);
-    genfield(&str, config.blur_when, blur_when_name, NULL);
-    genfield(&str, config.blur_stencil, bitmap_stencil_name, NULL);
-    *str++ = config.slow_motion ? 'Y': 'N';
+    genfield(&str, priv->config.blur_when, blur_when_name, NULL);
+    genfield(&str, priv->config.blur_stencil, bitmap_stencil_name, NULL);
+    *str++ = priv->config.slow_motion ? 'Y': 'N';
     *str++ = '/';
 
     /* Add the effects options */
-    genfield(&str, config.signal_style, signal_style_name, NULL);
-    genfield(&str, config.plot_style, render_plotname, NULL);
-    *str++ = config.thick_on_beats ? 'Y' : 'N';
-    genfield(&str, config.flash_style, bitmap_flash_name, NULL);
-    genfield(&str, config.overall_effect, NULL, "Normal effect",
+    genfield(&str, priv->config.signal_style, signal_style_name, NULL);
+    genfield(&str, priv->config.plot_style, render_plotname, NULL);
+    *str++ = priv->config.thick_on_beats ? 'Y' : 'N';
+    genfield(&str, priv->config.flash_style, bitmap_flash_name, NULL);
+    genfield(&str, priv->config.overall_effect, NULL, "Normal effect",
         "Bump effect", "Anti-fade effect", "Ripple effect", NULL);
-    genfield(&str, config.floaters, floaters_name, NULL);
+    genfield(&str, priv->config.floaters, floaters_name, NULL);
     *str = '\0';
     return buf;
 }
@@ -175,6 +175,7 @@ static char *parsefield(
     ...)            /* NULL-terminated list of hardcoded items */
 {
     char    *value, *abbr;
+    char    abbrbuf[40];
     int i,len;
     char    *found;
     va_list ap;
@@ -205,7 +206,7 @@ static char *parsefield(
     for (found = NULL; value; )
     {
         /* abbreviate this possible value */
-        abbr = abbreviate(value);
+        abbr = abbreviate(abbrbuf, value);
 
         /* if this is the value value, remember that. */
         if (!found && !strncmp(abbr, *field, len))
@@ -263,19 +264,15 @@ static int parsebool(
 }
 
 /* parse a configuration string & set the current configuration accordingly */
-BlurskConfig *paste_parsestring(char *str)
+BlurskConfig *paste_parsestring(BlurskPrivate *priv, char *str)
 {
     char        *afternumber;
     uint32_t     newcolor;
-    static BlurskConfig c;
-    static int first_call = TRUE;
+    BlurskConfig *c = &priv->paste.parsed;
 
-    if(first_call)
-    {
-        memset(&c, 0, sizeof(BlurskConfig));    
-        config_default(&c);
-        first_call = FALSE;
-    }
+    /* start from the defaults on first call */
+    if(!c->color_style)
+        config_default(c);
 
     /* skip leading whitespace */
     while (isspace(*str))
@@ -296,57 +293,57 @@ BlurskConfig *paste_parsestring(char *str)
 
     /* no color parsed? */
     if (afternumber == str)
-        return &c;
+        return c;
 
-    c.color = newcolor;
+    c->color = newcolor;
     str = afternumber;
 
     /* parse the color options */
-    c.color_style = parsefield(&str, c.color_style, color_name,NULL);
-    c.fade_speed = parsefield(&str, c.fade_speed, NULL, "No fade",
+    c->color_style = parsefield(&str, c->color_style, color_name,NULL);
+    c->fade_speed = parsefield(&str, c->fade_speed, NULL, "No fade",
         "Slow fade", "Medium fade", "Fast fade", NULL);
-    c.signal_color = parsefield(&str, c.signal_color, NULL,
+    c->signal_color = parsefield(&str, c->signal_color, NULL,
         "Normal signal", "White signal", "Cycling signal", NULL);
-    c.contour_lines = parsebool(&str, c.contour_lines);
-    c.hue_on_beats = parsebool(&str, c.hue_on_beats);
-    c.background = parsefield(&str, c.background,
+    c->contour_lines = parsebool(&str, c->contour_lines);
+    c->hue_on_beats = parsebool(&str, c->hue_on_beats);
+    c->background = parsefield(&str, c->background,
         color_background_name, NULL);
     if (!str)
-        return &c;
+        return c;
     while (*str && *str != '/')
         str++;
     if (*str == '/')
         str++;
 
     /* parse the blur options */
-    c.blur_style = parsefield(&str, c.blur_style, blur_name, NULL);
-    c.transition_speed = parsefield(&str, c.transition_speed, NULL,
+    c->blur_style = parsefield(&str, c->blur_style, blur_name, NULL);
+    c->transition_speed = parsefield(&str, c->transition_speed, NULL,
         "Slow switch", "Medium switch", "Fast switch", NULL);
-    c.blur_when = parsefield(&str, c.blur_when, blur_when_name, NULL);
-    c.blur_stencil = parsefield(&str, c.blur_stencil,
+    c->blur_when = parsefield(&str, c->blur_when, blur_when_name, NULL);
+    c->blur_stencil = parsefield(&str, c->blur_stencil,
         bitmap_stencil_name, NULL);
-    c.slow_motion = parsebool(&str, c.slow_motion);
+    c->slow_motion = parsebool(&str, c->slow_motion);
     if (!str)
-        return &c;
+        return c;
     while (*str && *str != '/')
         str++;
     if (*str == '/')
         str++;
 
     /* parse the effects options */
-    c.signal_style = parsefield(&str, c.signal_style, signal_style_name,
+    c->signal_style = parsefield(&str, c->signal_style, signal_style_name,
         NULL);
-    c.plot_style = parsefield(&str, c.plot_style, render_plotname,
+    c->plot_style = parsefield(&str, c->plot_style, render_plotname,
         NULL);
-    c.thick_on_beats = parsebool(&str, c.thick_on_beats);
-    c.flash_style = parsefield(&str, c.flash_style,
+    c->thick_on_beats = parsebool(&str, c->thick_on_beats);
+    c->flash_style = parsefield(&str, c->flash_style,
         bitmap_flash_name, NULL);
-    c.overall_effect = parsefield(&str, c.overall_effect, NULL,
+    c->overall_effect = parsefield(&str, c->overall_effect, NULL,
         "Normal effect", "Bump effect", "Anti-fade effect",
         "Ripple effect", NULL);
-    c.floaters = parsefield(&str, c.floaters, floaters_name, NULL);
+    c->floaters = parsefield(&str, c->floaters, floaters_name, NULL);
 
-    return &c;
+    return c;
 }
 
 
@@ -26,19 +26,15 @@
 #include <string.h>
 #include <ctype.h>
 
-static int textheight;  /* height of the tallest character, plus 1 */
-static int frame;   /* frame counter, used for color-cycling */
-static int textbg;  /* background color for text */
-
 /* this is a map of the shapes for 0-9, A-Z, and a few punctuation characters.
  * A space char indicates that the pixel should be unchanged, a period that it
  * should be set to white, and and 'x' that it should be set to black.  White
  * is used to outline the black symbols, so they can be read even on dark
  * backgrounds.  Single-character strings mark the start of each character,
- * and NULL marks the end of the list.  After run-time initialization, the
- * single-character strings are converted to NULLs.
+ * and NULL marks the end of the list.  The table is shared between instances
+ * and never modified; each instance keeps its own map into it.
  */
-static char *shapes[] = {
+static const char *shapes[] = {
     "_",
     "    ",
 
@@ -667,17 +663,15 @@ static char *shapes[] = {
 };
 
 
-static char **chmap[127];
-
-static int row;
-static int big;
+/* A shape ends at the next single-character marker, or at the final NULL */
+#define SHAPE_ROW(shape, y) ((shape)[y] && (shape)[y][1])
 
-static void textinit()
+static void textinit(BlurskPrivate *priv)
 {
     int i, h;
 
     /* if already initialized, then do nothing */
-    if (!shapes[0])
+    if (priv->text.height)
         return;
 
     /* scan shapes for the characters defined there */
@@ -687,27 +681,26 @@ static void textinit()
         if (!shapes[i][1])
         {
             /* was previous char the tallest? */
-            if (h >= textheight)
-                textheight = h;
+            if (h >= priv->text.height)
+                priv->text.height = h;
             h = 0;
 
             /* remember the shape */
-            chmap[(int)shapes[i][0]] = &shapes[i + 1];
-            shapes[i] = NULL;
+            priv->text.chmap[(int)shapes[i][0]] = &shapes[i + 1];
         }
     }
 }
 
 
-static unsigned char *normaltext(unsigned char *cursor, int bpl, char **shape, int color)
+static unsigned char *normaltext(BlurskPrivate *priv, unsigned char *cursor, int bpl, const char **shape, int color)
 {
     int x, y;
 
     for (x = 0; shape[0][x]; x++, cursor++)
-        for (y = 0; shape[y]; y++)
+        for (y = 0; SHAPE_ROW(shape, y); y++)
             switch (shape[y][x])
             {
-              case '.': cursor[y * bpl] = textbg; break;
+              case '.': cursor[y * bpl] = priv->text.bg; break;
               case 'x': cursor[y * bpl] = color; break;
             }
 
@@ -715,18 +708,18 @@ static unsigned char *normaltext(unsigned char *cursor, int bpl, char **shape, i
 }
 
 
-static unsigned char *bigtext(unsigned char *cursor, int bpl, char **shape, int color)
+static unsigned char *bigtext(BlurskPrivate *priv, unsigned char *cursor, int bpl, const char **shape, int color)
 {
     int x, y;
     unsigned char   *raster;
 
     for (x = 0; shape[0][x]; x++, cursor += 2)
-        for (y = 0, raster = cursor; shape[y]; y++, raster += 2 * bpl)
+        for (y = 0, raster = cursor; SHAPE_ROW(shape, y); y++, raster += 2 * bpl)
             switch (shape[y][x])
             {
               case '.':
                 raster[0] = raster[1] = raster[bpl]
-                    = raster[bpl + 1] = textbg;
+                    = raster[bpl + 1] = priv->text.bg;
                 break;
 
               case 'x':
@@ -740,9 +733,9 @@ static unsigned char *bigtext(unsigned char *cursor, int bpl, char **shape, int
 
 
 /* Find the number of chars in words that fit */
-static int fitwords(int maxwidth, char *text, int *width)
+static int fitwords(BlurskPrivate *priv, int maxwidth, char *text, int *width)
 {
-    int scale = big ? 2 : 1;
+    int scale = priv->text.big ? 2 : 1;
     int i, w, last, lastw, ch;
     int fudgefactor = 0;
 
@@ -765,7 +758,7 @@ static int fitwords(int maxwidth, char *text, int *width)
 
           default:
             /* ignore if it can't be shown */
-            if (ch < 0 || ch > 126 || !chmap[ch])
+            if (ch < 0 || ch > 126 || !priv->text.chmap[ch])
                 break;
 
             /* if end of word, remember it */
@@ -782,7 +775,7 @@ static int fitwords(int maxwidth, char *text, int *width)
                 fudgefactor = 0;
 
             /* add the width of this character */
-            w += scale * strlen(chmap[ch][0]);
+            w += scale * strlen(priv->text.chmap[ch][0]);
         }
     }
     if (!text[i])
@@ -800,11 +793,11 @@ static int fitwords(int maxwidth, char *text, int *width)
 }
 
 
-static void textdrawrow(unsigned char *img, int height, int bpl, char *side, char *text, int max, int rowwidth)
+static void textdrawrow(BlurskPrivate *priv, unsigned char *img, int height, int bpl, char *side, char *text, int max, int rowwidth)
 {
     int big = FALSE;
     unsigned char   *cursor;
-    int bpt = bpl * (textheight / 2);
+    int bpt = bpl * (priv->text.height / 2);
     int hasbig;
     int rowheight;
     int i, ch, color;
@@ -821,12 +814,12 @@ static void textdrawrow(unsigned char *img, int height, int bpl, char *side, cha
     }
 
     /* if too high, then skip it */
-    rowheight = (hasbig ? textheight * 2 : textheight);
-    if (row + rowheight >= height)
+    rowheight = (hasbig ? priv->text.height * 2 : priv->text.height);
+    if (priv->text.row + rowheight >= height)
         return;
 
     /* choose the starting position for this row */
-    cursor = img + row * bpl;
+    cursor = img + priv->text.row * bpl;
     switch (*side)
     {
       case 'R':
@@ -860,11 +853,11 @@ static void textdrawrow(unsigned char *img, int height, int bpl, char *side, cha
             big = FALSE;
             continue;
         }
-        if (ch < 0 || ch > 126 || !chmap[ch])
+        if (ch < 0 || ch > 126 || !priv->text.chmap[ch])
             continue;
 
         /* choose a color */
-        color = (( frame - i) * 3) & 0xff;
+        color = (( priv->text.frame - i) * 3) & 0xff;
         if (color < 128)
             color = color ^ 0xff;
 
@@ -872,17 +865,17 @@ static void textdrawrow(unsigned char *img, int height, int bpl, char *side, cha
         if (big)
         {
             cursor -= bpt;
-            cursor = bigtext(cursor, bpl, chmap[ch], color);
+            cursor = bigtext(priv, cursor, bpl, priv->text.chmap[ch], color);
             cursor += bpt;
         }
         else
         {
-            cursor = normaltext(cursor, bpl, chmap[ch], color);
+            cursor = normaltext(priv, cursor, bpl, priv->text.chmap[ch], color);
         }
     }
 
     /* increment row by the height of this text row */
-    row += (hasbig ? textheight * 2 : textheight);
+    priv->text.row += (hasbig ? priv->text.height * 2 : priv->text.height);
 }
 
 /* Convert time in ms to useful string */
@@ -894,27 +887,27 @@ void convert_ms_to_timestamp(char *buf, int time)
 }
 
 /* Draw text into an image.  */
-void textdraw(unsigned char *img, int height, int bpl, char *side, char *text)
+void textdraw(BlurskPrivate *priv, unsigned char *img, int height, int bpl, char *side, char *text)
 {
     int max, twidth;
 
     /* parse the font table, if necessary */
-    textinit();
+    textinit(priv);
 
     /* initialize */
-    frame++;
-    row = 0;
-    big = FALSE;
-    textbg = (*config.overall_effect == 'B' ? 0x80 : 0);
+    priv->text.frame++;
+    priv->text.row = 0;
+    priv->text.big = FALSE;
+    priv->text.bg = (*priv->config.overall_effect == 'B' ? 0x80 : 0);
 
     /* for each row of text... */
     while (text)
     {
         /* find out how much can fit on this row */
-        max = fitwords(bpl - 3, text, &twidth);
+        max = fitwords(priv, bpl - 3, text, &twidth);
 
         /* draw it */
-        textdrawrow(img, height, bpl, side, text, max, twidth);
+        textdrawrow(priv, img, height, bpl, side, text, max, twidth);
 
         /* move to start of next row */
         text += max;
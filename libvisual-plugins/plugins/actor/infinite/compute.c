@@ -123,7 +123,7 @@ static void _inf_generate_sector(InfinitePrivate *priv, int g,int f,int p1,int p
 {
 	int fin=debut+step;
 	const int prop_transmitted=249;
-	const int b_add=g*priv->plugwidth*priv->plugheight; 
+	t_interpol *field=&vector_field[g];
 	t_coord c;
 
 
@@ -143,7 +143,7 @@ static void _inf_generate_sector(InfinitePrivate *priv, int g,int f,int p1,int p
 			add=c.x+c.y*priv->plugwidth;
 			x=(int)(a.x);
 			y=(int)(a.y);
-			vector_field[b_add+add].coord=(x<<16)|y;
+			field->offset[add]=y*priv->plugwidth+x;
 
 			fpy=a.y-floor(a.y);
 			rw=(int)((a.x-floor(a.x))*prop_transmitted);
@@ -152,20 +152,36 @@ static void _inf_generate_sector(InfinitePrivate *priv, int g,int f,int p1,int p
 			w2=rw-w4;
 			w3=(int)(fpy*lw);
 			w1=lw-w3; 
-			vector_field[b_add+add].weight=(w1<<24)|(w2<<16)|(w3<<8)|w4;
+			field->weight[0][add]=w1;
+			field->weight[1][add]=w2;
+			field->weight[2][add]=w3;
+			field->weight[3][add]=w4;
 		}
 }
 
-void _inf_generate_vector_field(InfinitePrivate *priv, t_interpol* vector_field) 
+typedef struct {
+	InfinitePrivate *priv;
+	t_interpol *vector_field;
+} _inf_generate_job;
+
+static void _inf_generate_rows(int first_row, int last_row, void *data)
 {
+	_inf_generate_job *job = data;
 	int f;
-	int i,p1,p2;
-    
-	for (f=0;f<NB_FCT;f++) {
-		p1=2;
-		p2=2;
-		for (i=0;i<priv->plugheight;i+=10)
-			_inf_generate_sector(priv, f,f,p1,p2,i,10,vector_field);
-	}
+
+	for (f=0;f<NB_FCT;f++)
+		_inf_generate_sector(job->priv, f,f,2,2,first_row,last_row-first_row,job->vector_field);
 }
 
+void _inf_generate_vector_field(InfinitePrivate *priv, t_interpol* vector_field) 
+{
+	_inf_generate_job job;
+
+	job.priv = priv;
+	job.vector_field = vector_field;
+
+	/* Every pixel of every field is evaluated with trigonometry, far more
+	 * work than the 20 bytes it stores, so the cost is overstated to get
+	 * the rows split even at small sizes */
+	visual_run_row_bands (priv->plugheight, priv->plugwidth * NB_FCT * 20 * 16, _inf_generate_rows, &job);
+}
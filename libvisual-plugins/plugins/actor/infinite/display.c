@@ -4,6 +4,12 @@
 #include <stdlib.h>
 #include <math.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "renderer.h"
 #include "display.h"
 #include "main.h"
@@ -55,134 +61,96 @@ void _inf_change_color(InfinitePrivate *priv, int t2,int t1,int w)
 	}
 }
 
+/* Gathers the four corners of count pixels into separate planes */
+static inline void _inf_gather_corners(InfinitePrivate *priv, const uint32_t *offset, int count,
+		uint8_t *tl, uint8_t *tr, uint8_t *bl, uint8_t *br)
+{
+	int i;
+
+	for (i=0;i<count;i++) {
+		const uint8_t *ptr_pix = priv->surface1 + offset[i];
+
+		tl[i] = ptr_pix[0];
+		tr[i] = ptr_pix[1];
+		bl[i] = ptr_pix[priv->plugwidth];
+		br[i] = ptr_pix[priv->plugwidth + 1];
+	}
+}
+
+/* The weights of a pixel add up to 249, so the weighted sum of the corners
+ * always fits in 16 bits. */
 static void _inf_compute_surface(InfinitePrivate *priv, t_interpol* vector_field)
 {
-	int i,j;
-	int add_dest=0,add_src;
-	t_interpol *interpol;
-	register uint8_t* ptr_pix;
-	int color = 0;
+	int add_dest=0;
+	int size=priv->plugwidth*priv->plugheight;
+	const uint32_t *offset=vector_field->offset;
+	const uint8_t *w1=vector_field->weight[0];
+	const uint8_t *w2=vector_field->weight[1];
+	const uint8_t *w3=vector_field->weight[2];
+	const uint8_t *w4=vector_field->weight[3];
 	uint8_t* ptr_swap;
 
-	/* FIXME OK we're going to take a different approach:
-	 * have a whole set of interpolate buffers:
-	 * every buffer containing one element, the different weights, the upper and lower part of
-	 * the interpolation coords etc, with this setup it's MUCH easier to vectorize it damn hard.
-	 */
-
-	/* FIXME ok this sucked, is een mislukte actie geweest zie ik, omdat ik mmx regs te kort kwam
-	 * zat ik met restore problemen, waardoor het uiteindelijk even snel werd, moet de hele blur routine
-	 * van deze plugin from scratch doen... */
-	if (0) {
-#if 0
-#if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64)
-		int add_src2[2];
-		uint8_t *ptr_pix2[2];
-		int plugwidth = priv->plugwidth;
-		uint8_t *ptr_surf = priv->surface1;
-		int aflag = 0xffff;
-
-		/* Prep general used regs, mm6 as empty (un)packer, mm7 to contain plugwidth for packed words
-		 * and we use mm5 to contain 0x0000ffff0000ffff */
-		__asm __volatile
-			("\n\t movd %[plugw], %%mm6"
-			 "\n\t movd %[plugw], %%mm7"
-			 "\n\t movd %[aflag], %%mm5"
-			 "\n\t movd %[aflag], %%mm4"
-
-			 "\n\t psllq $32, %%mm6"
-			 "\n\t por %%mm6, %%mm7"
-
-			 "\n\t psllq $32, %%mm4"
-			 "\n\t por %%mm4, %%mm5"
-
-			 "\n\t pxor %%mm6, %%mm6"
-			 "\n\t pxor %%mm4, %%mm4"
-			 :: [plugw] "m" (plugwidth)
-			 , [aflag] "m" (aflag));
-
-		for (j = 0; j < priv->plugheight; j++) {
-			for (i = 0; i < priv->plugwidth; i += 2) {
-				int coords[2];
-
-				interpol = (vector_field += 2); // load 4 from.
-
-				coords[0] = interpol[0].coord;
-				coords[1] = interpol[1].coord;
-
-//				return;
-//				add_src = (interpol->coord & 0xFFFF) * priv->plugwidth + (interpol->coord >> 16); // pack and do in mmx!
-
-//				ptr_pix = priv->surface1 + add_src; // pack and do in mmx!
-
-				/* Do in two pieces! (first coords 0, 1, then 2, 3) */
-				__asm __volatile (
-						"\n\t movq %[interpol], %%mm0"	/* Start loading in the babies */
-						"\n\t movq %[interpol], %%mm1"
-
-						"\n\t psrld $16, %%mm0" /* the >> 16 coord elems */
-						"\n\t pand %%mm5, %%mm1" /* 0xffff coord elems */
-						"\n\t pmullw %%mm7, %%mm1" /* multiply with plugwidth */
-						"\n\t paddd %%mm0, %%mm1" /* Ading >> 16 coords. mm1 now contains the right addsrc offset */
-
-						"\n\t movd %[surf1], %%mm0"
-						"\n\t movd %[surf1], %%mm4"
-						"\n\t psllq $32, %%mm0"
-						"\n\t por %%mm4, %%mm0" /* Contains the ptr_surf 2 times */
-						"\n\t paddd %%mm1, %%mm0" /* Now contains the right ptr_pix2 value */
-
-						"\n\t movq %%mm0, %[pix]"
-						:: [interpol] "m" (*(coords))
-						, [addsrc2] "m" (add_src2)
-						, [surf1] "m" (ptr_surf)
-						, [pix] "m" (*ptr_pix2));
-				int color1 = 0, color2 = 0;
-/*				int color1 = (*(ptr_pix2[0])
-						+ *(ptr_pix2[0] + 1)
-						+ *(ptr_pix2[0] + priv->plugwidth)
-						+ *(ptr_pix2[0] + priv->plugwidth + 1));
-
-				int color2 = (*(ptr_pix2[1])
-						+ *(ptr_pix2[1] + 1)
-						+ *(ptr_pix2[1] + priv->plugwidth)
-						+ *(ptr_pix2[1] + priv->plugwidth + 1));
-*/
-				priv->surface2[add_dest] = color1;
-				priv->surface2[add_dest + 1] = color2;
-
-				add_dest += 2;
-			}
-		}
+#if defined(__SSE2__)
+	{
+		const __m128i zero = _mm_setzero_si128 ();
 
-		__asm __volatile
-			("emms");
-#endif /* #if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64) */
-#endif /* #if 0 */
-	} else {
-		for (j=0;j<priv->plugheight;j++) {
-			for (i=0;i<priv->plugwidth;i++) {
-				interpol = &vector_field[add_dest];
-				add_src = (interpol->coord & 0xffff) * priv->plugwidth + (interpol->coord >> 16);
-				ptr_pix = priv->surface1 + add_src;;
-
-				/* FIXME it does buffer overread here now and then */
-
-				color= (*(ptr_pix) *                       (interpol->weight >> 24)
-					+*(ptr_pix + 1) *                   ((interpol->weight & 0xFFFFFF) >> 16)
-					+*(ptr_pix + priv->plugwidth) *     ((interpol->weight & 0xFFFF) >> 8)
-					+*(ptr_pix + priv->plugwidth + 1) * (interpol->weight & 0xFF)) >> 8;
-/*
-				color= (*(ptr_pix) // *                       (interpol->weight >> 24)
-					+*(ptr_pix + 1) // *                   ((interpol->weight & 0xFFFFFF) >> 16)
-					+*(ptr_pix + priv->plugwidth) // *     ((interpol->weight & 0xFFFF) >> 8)
-					+*(ptr_pix + priv->plugwidth + 1)); // * (interpol->weight & 0xFF)) >> 8;
-
-*/				priv->surface2[add_dest]=color;
-				add_dest++;
-			}
+		for (;add_dest+16<=size;add_dest+=16) {
+			uint8_t tl[16], tr[16], bl[16], br[16];
+			__m128i c1, c2, c3, c4, k1, k2, k3, k4, lo, hi;
+
+			_inf_gather_corners (priv, offset + add_dest, 16, tl, tr, bl, br);
+
+			c1 = _mm_loadu_si128 ((const __m128i *) tl);
+			c2 = _mm_loadu_si128 ((const __m128i *) tr);
+			c3 = _mm_loadu_si128 ((const __m128i *) bl);
+			c4 = _mm_loadu_si128 ((const __m128i *) br);
+
+			k1 = _mm_loadu_si128 ((const __m128i *) (w1 + add_dest));
+			k2 = _mm_loadu_si128 ((const __m128i *) (w2 + add_dest));
+			k3 = _mm_loadu_si128 ((const __m128i *) (w3 + add_dest));
+			k4 = _mm_loadu_si128 ((const __m128i *) (w4 + add_dest));
+
+			lo = _mm_add_epi16 (
+				_mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (c1, zero), _mm_unpacklo_epi8 (k1, zero)),
+				               _mm_mullo_epi16 (_mm_unpacklo_epi8 (c2, zero), _mm_unpacklo_epi8 (k2, zero))),
+				_mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (c3, zero), _mm_unpacklo_epi8 (k3, zero)),
+				               _mm_mullo_epi16 (_mm_unpacklo_epi8 (c4, zero), _mm_unpacklo_epi8 (k4, zero))));
+
+			hi = _mm_add_epi16 (
+				_mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (c1, zero), _mm_unpackhi_epi8 (k1, zero)),
+				               _mm_mullo_epi16 (_mm_unpackhi_epi8 (c2, zero), _mm_unpackhi_epi8 (k2, zero))),
+				_mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (c3, zero), _mm_unpackhi_epi8 (k3, zero)),
+				               _mm_mullo_epi16 (_mm_unpackhi_epi8 (c4, zero), _mm_unpackhi_epi8 (k4, zero))));
+
+			_mm_storeu_si128 ((__m128i *) (priv->surface2 + add_dest),
+			                  _mm_packus_epi16 (_mm_srli_epi16 (lo, 8), _mm_srli_epi16 (hi, 8)));
 		}
 	}
+#elif defined(__ARM_NEON)
+	for (;add_dest+8<=size;add_dest+=8) {
+		uint8_t tl[8], tr[8], bl[8], br[8];
+		uint16x8_t sum;
 
+		_inf_gather_corners (priv, offset + add_dest, 8, tl, tr, bl, br);
+
+		sum = vmull_u8 (vld1_u8 (tl), vld1_u8 (w1 + add_dest));
+		sum = vmlal_u8 (sum, vld1_u8 (tr), vld1_u8 (w2 + add_dest));
+		sum = vmlal_u8 (sum, vld1_u8 (bl), vld1_u8 (w3 + add_dest));
+		sum = vmlal_u8 (sum, vld1_u8 (br), vld1_u8 (w4 + add_dest));
+
+		vst1_u8 (priv->surface2 + add_dest, vshrn_n_u16 (sum, 8));
+	}
+#endif
+
+	/* FIXME it does buffer overread here now and then */
+	for (;add_dest<size;add_dest++) {
+		const uint8_t *ptr_pix = priv->surface1 + offset[add_dest];
+
+		priv->surface2[add_dest] = (ptr_pix[0] * w1[add_dest]
+			+ ptr_pix[1] * w2[add_dest]
+			+ ptr_pix[priv->plugwidth] * w3[add_dest]
+			+ ptr_pix[priv->plugwidth + 1] * w4[add_dest]) >> 8;
+	}
 
 	ptr_swap=priv->surface1;
 	priv->surface1=priv->surface2;
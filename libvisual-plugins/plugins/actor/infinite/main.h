@@ -19,9 +19,11 @@ typedef struct t_complex {
 	float x,y;
 } t_complex;
 
+/* Vector field of one effect, stored as separate planes so the blur can
+ * process several pixels at once */
 typedef struct t_interpol {
-	uint32_t coord ;  //coordinates of the top left pixel.
-	uint32_t weight; //32 bits = 4*8= weights of the four corners
+	uint32_t *offset;    //source offset of the top left pixel.
+	uint8_t  *weight[4]; //weights of the top left, top right, bottom left and bottom right corners
 } t_interpol;
 
 typedef struct t_effect {
@@ -59,6 +61,7 @@ typedef struct {
 
 	t_effect current_effect;
 	t_interpol *vector_field;
+	uint8_t *vector_field_planes;
 } InfinitePrivate;
 
 #endif /* _INF_MAIN_H */
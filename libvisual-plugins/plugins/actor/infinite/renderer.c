@@ -17,9 +17,11 @@
 
 void _inf_init_renderer(InfinitePrivate *priv)
 {
-	int allocsize;
+	int size;
+	int f;
+	uint8_t *plane;
 
-	allocsize = ((priv->plugwidth * priv->plugheight) + (priv->plugwidth * 2)) * NB_FCT * sizeof(t_interpol);
+	size = priv->plugwidth * priv->plugheight;
 
 	priv->teff = 500;
 	priv->tcol = 100;
@@ -29,8 +31,22 @@ void _inf_init_renderer(InfinitePrivate *priv)
 	_inf_load_effects(priv);
 	_inf_load_random_effect(priv, &priv->current_effect);
 
-	priv->vector_field = (t_interpol*) visual_mem_malloc0(allocsize);
-	visual_mem_set (priv->vector_field, 0, allocsize);
+	/* One offset and four weight planes per effect */
+	priv->vector_field = visual_mem_new0 (t_interpol, NB_FCT);
+	priv->vector_field_planes = visual_mem_malloc0 (size * (sizeof (uint32_t) + 4) * NB_FCT);
+
+	plane = priv->vector_field_planes;
+	for (f = 0; f < NB_FCT; f++) {
+		int i;
+
+		priv->vector_field[f].offset = (uint32_t *) plane;
+		plane += size * sizeof (uint32_t);
+
+		for (i = 0; i < 4; i++) {
+			priv->vector_field[f].weight[i] = plane;
+			plane += size;
+		}
+	}
 
 	_inf_generate_vector_field(priv, priv->vector_field);
 }
@@ -38,7 +54,7 @@ void _inf_init_renderer(InfinitePrivate *priv)
 
 void _inf_renderer(InfinitePrivate *priv)
 {
-	_inf_blur(priv, &priv->vector_field[priv->plugwidth*priv->plugheight*priv->current_effect.num_effect]);
+	_inf_blur(priv, &priv->vector_field[priv->current_effect.num_effect]);
 	_inf_spectral(priv, &priv->current_effect, priv->pcm_data);
 	_inf_curve(priv, &priv->current_effect);
 
@@ -65,5 +81,6 @@ void _inf_close_renderer(InfinitePrivate *priv)
 	visual_mem_free(priv->surface1);
 	visual_mem_free(priv->surface2);
 	visual_mem_free(priv->vector_field);
+	visual_mem_free(priv->vector_field_planes);
 }
 
@@ -31,78 +31,94 @@
 #include "def.h"
 #include "jess.h"
 
-void create_tables(JessPrivate *priv)
+static inline uint32_t table_offset(JessPrivate *priv, float n_fx, float n_fy)
+{
+	int x, y;
+
+	x = (int) (n_fx + priv->xres2);
+	y = (int) (n_fy + priv->yres2);
+
+	if (x < 0 || x >= priv->resx  || y < 0 || y >= priv->resy )
+	{
+		x = 0;
+		y = 0;
+	}
+
+	return x + y * priv->resx;
+}
+
+/* Fills all four tables for a band of rows in one pass, so every row is only
+ * walked once and bands can be handed to separate threads. */
+static void create_tables_band(int first_row, int last_row, void *data)
 {
-	int i, j, k, x, y;
+	JessPrivate *priv = data;
+	int i, j;
 	float n_fx, n_fy;
 	int resy, resx;
 
 	resy = priv->resy;
 	resx = priv->resx;
 
-	for (k=1; k<5; k++)
+	for (i = first_row; i < last_row; i++)
 	{
-		for (i = 0; i < priv->resy; i++)
+		uint32_t *row1 = priv->table1 + i * resx;
+		uint32_t *row2 = priv->table2 + i * resx;
+		uint32_t *row3 = priv->table3 + i * resx;
+		uint32_t *row4 = priv->table4 + i * resx;
+		float fy = (float) i - priv->yres2;
+
+		for (j = 0; j < resx; j++)
 		{
-			for (j = 0; j < priv->resx; j++)
-			{
-				n_fx = (float) j - priv->xres2;
-				n_fy = (float) i - priv->yres2;
-
-				switch(k)
-				{
-					case 1:
-						rot_hyperbolic_radial (&n_fx, &n_fy, -PI / 5, 0.001, 0,
-								RESFACTY (50)) ;
-						rot_hyperbolic_radial (&n_fx, &n_fy, PI / 2, 0.004,
-								RESFACTX (200), RESFACTY (-30)) ;
-						rot_hyperbolic_radial (&n_fx, &n_fy, PI / 5, 0.001,
-								RESFACTX (-150), RESFACTY (-30)) ;
-						rot_hyperbolic_radial (&n_fx, &n_fy, PI / 30, 0.0001, 0, 0) ;
-						break;
-					case 2:
-						rot_cos_radial(&n_fx,&n_fy, 2*PI/75, 0.01,000,000) ; 
-						break;
-					case 3:
-						homothetie_hyperbolic(&n_fx, &n_fy, 0.0005,0,0) ; 
-						break;
-					case 4:
-						noize(priv, &n_fx, &n_fy, 0*5.0);
-						/*	  rot_hyperbolic_radial (&n_fx, &n_fy, PI / 30, 0.00010, 0, 0) ;  */
-						/*	  homothetie_hyperbolic(&n_fx, &n_fy, -0.0002,0,0) ;  */
-						/* 	  homothetie_cos_radial(&n_fx, &n_fy, 0.01,-10,10) ;  */
-						break;
-				}
-
-				x = (int) (n_fx + priv->xres2);
-				y = (int) (n_fy + priv->yres2);
-
-				if (x < 0 || x >= priv->resx  || y < 0 || y >= priv->resy )
-				{
-					x = 0;
-					y = 0;
-				}
-
-				switch(k)
-				{
-					case 1:
-						priv->table1[i * resx + j] = x + y * resx;
-						break;
-					case 2:
-						priv->table2[i * resx + j] = x + y * resx;
-						break;
-					case 3:
-						priv->table3[i * resx + j] = x + y * resx;
-						break;
-					case 4:
-						priv->table4[i * resx + j] = x + y * resx;
-						break;
-				}
-			}
+			float fx = (float) j - priv->xres2;
+
+			n_fx = fx;
+			n_fy = fy;
+			rot_hyperbolic_radial (&n_fx, &n_fy, -PI / 5, 0.001, 0,
+					RESFACTY (50)) ;
+			rot_hyperbolic_radial (&n_fx, &n_fy, PI / 2, 0.004,
+					RESFACTX (200), RESFACTY (-30)) ;
+			rot_hyperbolic_radial (&n_fx, &n_fy, PI / 5, 0.001,
+					RESFACTX (-150), RESFACTY (-30)) ;
+			rot_hyperbolic_radial (&n_fx, &n_fy, PI / 30, 0.0001, 0, 0) ;
+			row1[j] = table_offset (priv, n_fx, n_fy);
+
+			n_fx = fx;
+			n_fy = fy;
+			rot_cos_radial(&n_fx,&n_fy, 2*PI/75, 0.01,000,000) ; 
+			row2[j] = table_offset (priv, n_fx, n_fy);
+
+			n_fx = fx;
+			n_fy = fy;
+			homothetie_hyperbolic(&n_fx, &n_fy, 0.0005,0,0) ; 
+			row3[j] = table_offset (priv, n_fx, n_fy);
+
+			n_fx = fx;
+			n_fy = fy;
+			noize(priv, &n_fx, &n_fy, 0*5.0);
+			/*	  rot_hyperbolic_radial (&n_fx, &n_fy, PI / 30, 0.00010, 0, 0) ;  */
+			/*	  homothetie_hyperbolic(&n_fx, &n_fy, -0.0002,0,0) ;  */
+			/* 	  homothetie_cos_radial(&n_fx, &n_fy, 0.01,-10,10) ;  */
+			row4[j] = table_offset (priv, n_fx, n_fy);
 		}
 	}
 }
 
+void create_tables(JessPrivate *priv)
+{
+	int i, draws;
+
+	/* Each pixel is far more work than its 16 bytes of tables suggest, so
+	 * the cost is overstated to get the rows split even at small sizes */
+	visual_run_row_bands (priv->resy, priv->resx * 16 * 16, create_tables_band, priv);
+
+	/* noize() used to draw two numbers per pixel here. The draws are skipped
+	 * so the bands can run concurrently, but still taken afterwards to keep
+	 * the random stream where the effects expect it. */
+	draws = 2 * priv->resx * priv->resy;
+	for (i = 0; i < draws; i++)
+		visual_random_context_int (priv->rcontext);
+}
+
 void rot_hyperbolic_radial(float *n_fx,float *n_fy,float d_alpha, float rad_factor, float cx, float cy)
 {
 	float r2,dx = *n_fx-cx, dy = *n_fy-cy,cosal, sinal;
@@ -153,8 +169,17 @@ void homothetie_cos_radial(float *n_fx,float *n_fy, float rad_factor, float cx,
 	*n_fy = cy + dy*cosrad;  
 }
 
+/* The random context is not shared across threads, so a zero intensity
+ * (which create_tables uses) must not draw from it. create_tables takes
+ * the draws itself once the tables are done. */
 void noize(JessPrivate *priv, float *n_fx,float *n_fy, float intensity)
 {
+	if (intensity == 0)
+	{
+		*n_fy -= 5;
+		return;
+	}
+
 	*n_fx +=2*(visual_random_context_float(priv->rcontext)-0.5)*intensity;
 	*n_fy +=2*(visual_random_context_float(priv->rcontext)-0.5)*intensity-5;
 }
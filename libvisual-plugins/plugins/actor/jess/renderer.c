@@ -28,6 +28,10 @@
 #include <math.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "def.h"
 #include "struct.h"
 #include "distorsion.h"
@@ -280,88 +284,135 @@ void fade(float variable, uint8_t * dim)
 	}
 }
 
+/* How far ahead of the current pixel the source of a table lookup is
+ * prefetched. The tables are read in order, but the buffer reads they point
+ * at jump around. */
+#define DEFORM_PREFETCH 32
+
+#if defined(__GNUC__)
+#define deform_prefetch(addr) __builtin_prefetch ((addr), 0, 0)
+#else
+#define deform_prefetch(addr)
+#endif
+
+static void render_deformation_8(JessPrivate *priv, const uint32_t *tab)
+{
+	uint8_t *pix = priv->pixel;
+	const uint8_t *buf = priv->buffer;
+	int size = priv->resx * priv->resy;
+	int i = 0;
+
+	for (; i + DEFORM_PREFETCH < size; i++)
+	{
+		deform_prefetch (buf + tab[i + DEFORM_PREFETCH]);
+		pix[i] = buf[tab[i]];
+	}
+
+	for (; i < size; i++)
+		pix[i] = buf[tab[i]];
+}
+
+/* Moves whole pixels rather than three separate bytes; only the alpha byte
+ * of the target is kept, as before. */
+static void render_deformation_32(JessPrivate *priv, const uint32_t *tab)
+{
+	uint8_t *pix = priv->pixel;
+	const uint32_t *buf = (const uint32_t *) priv->buffer;
+	int size = priv->resx * priv->resy;
+	int i = 0;
+
+#if defined(__SSE2__)
+	const __m128i color_mask = _mm_set1_epi32 (0x00ffffff);
+
+	for (; i + 4 + DEFORM_PREFETCH < size; i += 4)
+	{
+		__m128i *dest = (__m128i *) (pix + i * 4);
+		__m128i src;
+
+		deform_prefetch (buf + tab[i + DEFORM_PREFETCH]);
+		deform_prefetch (buf + tab[i + DEFORM_PREFETCH + 2]);
+
+		src = _mm_set_epi32 (buf[tab[i + 3]], buf[tab[i + 2]], buf[tab[i + 1]], buf[tab[i]]);
+
+		_mm_storeu_si128 (dest, _mm_or_si128 (_mm_and_si128 (src, color_mask),
+		                                      _mm_andnot_si128 (color_mask, _mm_loadu_si128 (dest))));
+	}
+#endif
+
+	for (; i < size; i++)
+	{
+		const uint8_t *aux = (const uint8_t *) (buf + tab[i]);
+
+		pix[i * 4]     = aux[0];
+		pix[i * 4 + 1] = aux[1];
+		pix[i * 4 + 2] = aux[2];
+	}
+}
+
 void render_deformation(JessPrivate *priv, int defmode)
 {
-	intptr_t bmax;
-	uint32_t *tab1 = NULL, *tab2, *tab3, *tab4, i;
-	uint8_t *pix = priv->pixel, *aux;
+	const uint32_t *tab;
 
 	/**************** BUFFER DEFORMATION ****************/
-	if (priv->video == 8)
+	switch(defmode)
 	{
-		tab1 = priv->table1;
-		tab2 = priv->table2;
-		tab3 = priv->table3;
-		tab4 = priv->table4;
-		bmax = priv->resx * priv->resy + (intptr_t) priv->pixel;
-
-		switch(defmode)
-		{
-			case 0:
+		case 0:
+			if (priv->video == 8)
 				visual_mem_copy(priv->pixel, priv->buffer, priv->resx * priv->resy);
-				break;
-			case 1:
-				for (pix = priv->pixel; pix < (uint8_t *) bmax ; pix++)
-					*pix = *(priv->buffer + *(tab1++)) ;
-				break;
-			case 2:
-				for (pix = priv->pixel; pix < (uint8_t *) bmax; pix++)
-					*pix = *(priv->buffer + *(tab2++)) ;
-				break;
-			case 3:
-				for (pix = priv->pixel; pix < (uint8_t *) bmax; pix++)
-					*pix = *(priv->buffer + *(tab3++)) ;
-				break;
-			case 4:
-				for (pix = priv->pixel; pix < (uint8_t *) bmax; pix++)
-					*pix = *(priv->buffer + *(tab4++)) ;
-				break;   
-			default:
-		
-				break;
-		}
+			else
+				visual_mem_copy(priv->pixel, priv->buffer, priv->pitch * priv->resy);
+			return;
+		case 1:
+			tab = priv->table1;
+			break;
+		case 2:
+			tab = priv->table2;
+			break;
+		case 3:
+			tab = priv->table3;
+			break;
+		case 4:
+			tab = priv->table4;
+			break;
+		default:
+			return;
 	}
+
+	if (priv->video == 8)
+		render_deformation_8 (priv, tab);
 	else
+		render_deformation_32 (priv, tab);
+}
+
+#if defined(__SSE2__)
+/* Adds the right, lower and lower right neighbours to every byte from pix
+ * on, in 8 byte steps that begin before end. Neighbours always lie ahead of
+ * the bytes being written, so they are still unmodified when read. */
+static void render_blur_sse2(uint8_t *pix, const uint8_t *end, int step, int pitch)
+{
+	for (; pix + 8 < end; pix += 16)
 	{
-		pix = priv->pixel;
+		__m128i sum = _mm_add_epi8 (_mm_loadu_si128 ((const __m128i *) pix),
+		                            _mm_loadu_si128 ((const __m128i *) (pix + step)));
 
-		bmax = priv->resx * priv->resy;
-		switch(defmode)
-		{
-			case 0:
-				visual_mem_copy(priv->pixel, priv->buffer, priv->pitch * priv->resy);
-				return;
-				break;
-			case 1:
-				tab1 = priv->table1;
-				break;
-			case 2:
-				tab1 = priv->table2;
-				break;
-			case 3:
-				tab1 = priv->table3;
-				break;
-			case 4:
-				tab1 = priv->table4;
-				break;
-
-			default:
-		
-				break;
-		}
-		for (i = 0; i < priv->resy * priv->resx; i++)
-		{
-			aux  =  (uint8_t *) ((*(tab1) << 2 ) + (intptr_t) priv->buffer);
-			*(pix++) = *(aux++) ;
-			*(pix++) = *(aux++);  
-			*(pix++) = *(aux);  
-			
-			pix++;
+		sum = _mm_add_epi8 (sum, _mm_loadu_si128 ((const __m128i *) (pix + pitch)));
+		sum = _mm_add_epi8 (sum, _mm_loadu_si128 ((const __m128i *) (pix + pitch + step)));
 
-			tab1++;
-		}
+		_mm_storeu_si128 ((__m128i *) pix, sum);
+	}
+
+	if (pix < end)
+	{
+		__m128i sum = _mm_add_epi8 (_mm_loadl_epi64 ((const __m128i *) pix),
+		                            _mm_loadl_epi64 ((const __m128i *) (pix + step)));
+
+		sum = _mm_add_epi8 (sum, _mm_loadl_epi64 ((const __m128i *) (pix + pitch)));
+		sum = _mm_add_epi8 (sum, _mm_loadl_epi64 ((const __m128i *) (pix + pitch + step)));
+
+		_mm_storel_epi64 ((__m128i *) pix, sum);
 	}
 }
+#endif
 
 void render_blur(JessPrivate *priv, int blur)
 {
@@ -388,6 +439,12 @@ void render_blur(JessPrivate *priv, int blur)
 	{
 		bmax = priv->resx * (priv->resy-1) + (intptr_t) priv->pixel;
 
+#if defined(__SSE2__)
+		if (visual_cpu_has_sse2 ()) {
+			/* Same 8 byte steps as the MMX version, two at a time */
+			render_blur_sse2 (priv->pixel, (uint8_t *) bmax - 9, 1, priv->resx);
+		} else
+#endif
 		if (visual_cpu_has_mmx ()) {
 #if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64)
 			__asm __volatile
@@ -426,6 +483,11 @@ void render_blur(JessPrivate *priv, int blur)
 		pitch_4 = priv->pitch+4;
 		bmax = priv->pitch*(priv->resy-1) + (intptr_t) priv->pixel;
 
+#if defined(__SSE2__)
+		if (visual_cpu_has_sse2 ()) {
+			render_blur_sse2 (priv->pixel, (uint8_t *) bmax - 12, 4, priv->pitch);
+		} else
+#endif
 		if (visual_cpu_has_mmx ()) {
 #if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64)
 			__asm __volatile
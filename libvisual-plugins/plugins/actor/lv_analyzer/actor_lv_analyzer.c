@@ -42,6 +42,13 @@ typedef struct
 	int width, height;
 	VisBuffer *pcm_buffer;
 	VisBuffer *freq_buffer;
+
+	/* Layout of the last frame drawn, which later frames only update */
+	int *bar_tops;
+	int drawn_bars;
+	int drawn_bar_space;
+	int drawn_width, drawn_height, drawn_pitch;
+	void *drawn_pixels;
 } AnalyzerPrivate;
 
 static int         lv_analyzer_init        (VisPluginData *plugin);
@@ -143,6 +150,7 @@ static void lv_analyzer_cleanup (VisPluginData *plugin)
 		
 	visual_palette_free (priv->pal);
 
+	visual_mem_free (priv->bar_tops);
 	visual_mem_free (priv);
 }
 
@@ -310,6 +318,33 @@ static VisPalette *lv_analyzer_palette (VisPluginData *plugin)
 	return priv->pal;
 }
 
+static inline int bar_top (VisVideo *video, float amplitude)
+{
+	int video_height = visual_video_get_height (video);
+	int y = (1.0 - amplitude) * video_height;
+
+	if (y < 0)
+		return 0;
+
+	return y < video_height ? y : video_height;
+}
+
+static inline void clear_bar (VisVideo *video, int x, int width, int y, int y_end)
+{
+	int video_pitch = visual_video_get_pitch (video);
+	uint8_t *row;
+
+	if (y >= y_end)
+		return;
+
+	row = (uint8_t *) visual_video_get_pixel_ptr (video, x, y);
+
+	for (; y < y_end; y++) {
+		visual_mem_set (row, 0, width);
+		row += video_pitch;
+	}
+}
+
 static inline void draw_bar (VisVideo *video, int x, int width, float amplitude)
 {
 	/* NOTES:
@@ -318,7 +353,7 @@ static inline void draw_bar (VisVideo *video, int x, int width, float amplitude)
 	*/
 	int video_height = visual_video_get_height (video);
 	int video_pitch	 = visual_video_get_pitch (video);
-	int y = (1.0 - amplitude) * video_height;
+	int y = bar_top (video, amplitude);
 
 	if (y >= video_height) 
 		return;
@@ -354,12 +389,50 @@ static void lv_analyzer_render (VisPluginData *plugin, VisVideo *video, VisAudio
 	int width  = (visual_video_get_width (video) - spaces) / priv->bars;
 	int x	   = ((visual_video_get_width (video) - spaces) % priv->bars) / 2;
 
-	visual_video_fill_color (video, NULL);
+	int video_height = visual_video_get_height (video);
+
+	/* Redraw everything when the layout or the video changes, otherwise
+	 * only touch the bars and report them as damage */
+	int redraw = priv->drawn_bars      != priv->bars
+	          || priv->drawn_bar_space != priv->bar_space
+	          || priv->drawn_width     != visual_video_get_width (video)
+	          || priv->drawn_height    != video_height
+	          || priv->drawn_pitch     != visual_video_get_pitch (video)
+	          || priv->drawn_pixels    != visual_video_get_pixels (video);
+
+	if (redraw) {
+		visual_video_fill_color (video, NULL);
+
+		visual_mem_free (priv->bar_tops);
+		priv->bar_tops = visual_mem_new0 (int, priv->bars);
+
+		priv->drawn_bars      = priv->bars;
+		priv->drawn_bar_space = priv->bar_space;
+		priv->drawn_width     = visual_video_get_width (video);
+		priv->drawn_height    = video_height;
+		priv->drawn_pitch     = visual_video_get_pitch (video);
+		priv->drawn_pixels    = visual_video_get_pixels (video);
+	} else {
+		visual_video_set_undamaged (video);
+	}
 
 	float *freq = (float *) visual_buffer_get_data (priv->freq_buffer);
 
 	for(int i = 0; i < priv->bars; i++) {
+		int top = bar_top (video, freq[i]);
+
+		if (!redraw) {
+			int old_top = priv->bar_tops[i];
+
+			clear_bar (video, x, width, old_top, top);
+
+			int damage_top = old_top < top ? old_top : top;
+			visual_video_add_damage_by_values (video, x, damage_top, width, video_height - damage_top);
+		}
+
 		draw_bar (video, x, width, freq[i]);
+		priv->bar_tops[i] = top;
+
 		x += width + priv->bar_space;
 	}
 }
@@ -22,18 +22,64 @@
 #include "config.h"
 #include "gettext.h"
 #include "oinksie.h"
+#include <pthread.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
+/* Describes how the second engine is blended onto the first one. Each output
+ * channel c is computed as ((a * (d - s)) >> 8) + s, with d the first engine's
+ * color, s the second engine's color and a assembled per channel from a
+ * constant and the blue channels of d, s and the freshly blended result. */
+typedef struct {
+	uint16_t             constant[4];
+	uint16_t             dmask[4];
+	uint16_t             smask[4];
+	uint16_t             rmask[4];
+} OinksieBlend;
+
 typedef struct {
 	OinksiePrivate       priv1;
 	OinksiePrivate       priv2;
 
 	int                  color_mode;
 
-	VisVideoComposeFunc	 currentcomp;
+	const OinksieBlend  *currentblend;
+
+	/* Intermediate 8-bit frames of both engines in 32-bit mode, kept
+	 * across frames and only reallocated on resize */
+	uint8_t             *buf1;
+	uint8_t             *buf2;
+	int                  buf_width;
+	int                  buf_height;
+
+	/* Renders the second engine alongside the first in 32-bit mode. Started
+	 * once at init on machines with more than one core, and woken for each
+	 * frame through worker_cond. */
+	pthread_t            worker;
+	pthread_mutex_t      worker_mutex;
+	pthread_cond_t       worker_cond;
+	int                  worker_running;
+	int                  worker_busy;
+	int                  worker_quit;
 } OinksiePrivContainer;
 
+static const OinksieBlend blend_modes[] = {
+	/* Fair blended */
+	{ { 128, 128, 128, 0 }, { 0, 0, 0, 0 },      { 0, 0, 0, 0 },      { 0, 0, 0, 0 } },
+	/* Turbulent temperature */
+	{ { 0, 128, 0, 0 },     { 0xffff, 0, 0, 0 }, { 0, 0, 0, 0 },      { 0, 0, 0, 0 } },
+	/* Acid summer (the blended blue channel equals the source one) */
+	{ { 0, 128, 0, 0 },     { 0, 0, 0, 0 },      { 0, 0, 0xffff, 0 }, { 0, 0, 0, 0 } },
+	/* Perfect match */
+	{ { 0, 128, 0, 0 },     { 0xffff, 0, 0, 0 }, { 0, 0, 0xffff, 0 }, { 0, 0, 0, 0 } },
+	/* Sanity edge */
+	{ { 0, 0, 0, 0 },       { 0xffff, 0, 0, 0 }, { 0, 0xffff, 0, 0 }, { 0, 0, 0xffff, 0 } }
+};
+
 static int         act_oinksie_init        (VisPluginData *plugin);
 static void        act_oinksie_cleanup     (VisPluginData *plugin);
 static void        act_oinksie_requisition (VisPluginData *plugin, int *width, int *height);
@@ -45,11 +91,16 @@ static void        act_oinksie_render      (VisPluginData *plugin, VisVideo *vid
 static void act_oinksie_set_color_mode (OinksiePrivContainer *self, int mode);
 static void act_oinksie_set_acid_palette (OinksiePrivContainer *self, int palette);
 
-static void compose_blend1_32_c (VisVideo *dest, VisVideo *src);
-static void compose_blend2_32_c (VisVideo *dest, VisVideo *src);
-static void compose_blend3_32_c (VisVideo *dest, VisVideo *src);
-static void compose_blend4_32_c (VisVideo *dest, VisVideo *src);
-static void compose_blend5_32_c (VisVideo *dest, VisVideo *src);
+static void act_oinksie_buffers_realloc (OinksiePrivContainer *self, int width, int height);
+static void act_oinksie_render_engine (OinksiePrivate *priv);
+static void *act_oinksie_worker (void *data);
+static void act_oinksie_palette_expand (uint32_t *colors, VisPalette *pal);
+
+static void compose_palette_blend_32 (VisVideo *video,
+                                      const uint8_t *buf1, const uint32_t *pal1,
+                                      const uint8_t *buf2, const uint32_t *pal2,
+                                      int width, int height,
+                                      const OinksieBlend *blend);
 
 const VisPluginInfo *get_plugin_info (void)
 {
@@ -118,6 +169,8 @@ static int act_oinksie_init (VisPluginData *plugin)
 	priv->priv2.pal_cur = visual_palette_new (256);
 	priv->priv2.pal_old = visual_palette_new (256);
 
+	/* Both engines are set up from the plugin's random context, in the same
+	 * order as always, so the first engine's random stream is unchanged */
 	VisRandomContext *rcontext = visual_plugin_get_random_context (plugin);
 	priv->priv1.rcontext = rcontext;
 	priv->priv2.rcontext = rcontext;
@@ -125,9 +178,24 @@ static int act_oinksie_init (VisPluginData *plugin)
 	oinksie_init (&priv->priv1, 64, 64);
 	oinksie_init (&priv->priv2, 64, 64);
 
+	/* The second engine then renders from its own context, so it can run on
+	 * another thread. Its seed comes from the system generator, like the
+	 * plugin's own seed, and draws nothing from the first engine's context. */
+	priv->priv2.rcontext = visual_random_context_new (visual_rand ());
+
 	act_oinksie_set_color_mode (priv, 1);
 	act_oinksie_set_acid_palette (priv, 0);
 
+	pthread_mutex_init (&priv->worker_mutex, NULL);
+	pthread_cond_init (&priv->worker_cond, NULL);
+
+	if (visual_cpu_get_num_cores () > 1) {
+		priv->worker_running = pthread_create (&priv->worker, NULL, act_oinksie_worker, priv) == 0;
+
+		if (!priv->worker_running)
+			visual_log (VISUAL_LOG_WARNING, "Cannot start render thread, rendering both engines in turn");
+	}
+
 	return TRUE;
 }
 
@@ -135,6 +203,18 @@ static void act_oinksie_cleanup (VisPluginData *plugin)
 {
 	OinksiePrivContainer *priv = visual_plugin_get_private (plugin);
 
+	if (priv->worker_running) {
+		pthread_mutex_lock (&priv->worker_mutex);
+		priv->worker_quit = TRUE;
+		pthread_cond_broadcast (&priv->worker_cond);
+		pthread_mutex_unlock (&priv->worker_mutex);
+
+		pthread_join (priv->worker, NULL);
+	}
+
+	pthread_cond_destroy (&priv->worker_cond);
+	pthread_mutex_destroy (&priv->worker_mutex);
+
 	oinksie_quit (&priv->priv1);
 	oinksie_quit (&priv->priv2);
 
@@ -144,6 +224,11 @@ static void act_oinksie_cleanup (VisPluginData *plugin)
 	visual_palette_free (priv->priv2.pal_cur);
 	visual_palette_free (priv->priv2.pal_old);
 
+	visual_random_context_free (priv->priv2.rcontext);
+
+	visual_mem_free (priv->buf1);
+	visual_mem_free (priv->buf2);
+
 	visual_mem_free (priv);
 }
 
@@ -275,44 +360,100 @@ static void act_oinksie_render (VisPluginData *plugin, VisVideo *video, VisAudio
 		int width  = visual_video_get_width (video);
 		int height = visual_video_get_height (video);
 
-		VisVideo *vid1 = visual_video_new_with_buffer (width, height, VISUAL_VIDEO_DEPTH_8BIT);
-		visual_video_set_palette (vid1, oinksie_palette_get (&priv->priv1));
+		uint32_t pal1[256];
+		uint32_t pal2[256];
 
-		VisVideo *vid2 = visual_video_new_with_buffer (width, height, VISUAL_VIDEO_DEPTH_8BIT);
-		visual_video_set_palette (vid2, oinksie_palette_get (&priv->priv2));
+		act_oinksie_buffers_realloc (priv, width, height);
 
-		priv->priv1.drawbuf = visual_video_get_pixels (vid1);
-		priv->priv2.drawbuf = visual_video_get_pixels (vid2);
+		priv->priv1.drawbuf = priv->buf1;
+		priv->priv2.drawbuf = priv->buf2;
 
-		oinksie_sample (&priv->priv1);
-		oinksie_sample (&priv->priv2);
+		act_oinksie_palette_expand (pal1, oinksie_palette_get (&priv->priv1));
+		act_oinksie_palette_expand (pal2, oinksie_palette_get (&priv->priv2));
 
-		oinksie_render (&priv->priv1);
-		oinksie_render (&priv->priv2);
+		/* Both engines only share read-only tables, run the second one
+		 * alongside the first */
+		if (priv->worker_running) {
+			pthread_mutex_lock (&priv->worker_mutex);
+			priv->worker_busy = TRUE;
+			pthread_cond_broadcast (&priv->worker_cond);
+			pthread_mutex_unlock (&priv->worker_mutex);
+		}
+
+		act_oinksie_render_engine (&priv->priv1);
+
+		if (priv->worker_running) {
+			pthread_mutex_lock (&priv->worker_mutex);
+			while (priv->worker_busy)
+				pthread_cond_wait (&priv->worker_cond, &priv->worker_mutex);
+			pthread_mutex_unlock (&priv->worker_mutex);
+		} else {
+			act_oinksie_render_engine (&priv->priv2);
+		}
+
+		compose_palette_blend_32 (video,
+		                          priv->buf1, pal1,
+		                          priv->buf2, pal2,
+		                          width, height,
+		                          priv->currentblend);
+	}
+}
+
+static void act_oinksie_buffers_realloc (OinksiePrivContainer *self, int width, int height)
+{
+	if (self->buf1 && self->buf_width == width && self->buf_height == height)
+		return;
+
+	visual_mem_free (self->buf1);
+	visual_mem_free (self->buf2);
+
+	self->buf1 = visual_mem_malloc0 (width * height);
+	self->buf2 = visual_mem_malloc0 (width * height);
+
+	self->buf_width  = width;
+	self->buf_height = height;
+}
+
+static void act_oinksie_render_engine (OinksiePrivate *priv)
+{
+	oinksie_sample (priv);
+	oinksie_render (priv);
+}
+
+static void *act_oinksie_worker (void *data)
+{
+	OinksiePrivContainer *priv = data;
+
+	pthread_mutex_lock (&priv->worker_mutex);
 
-		visual_video_blit (video, vid1, 0, 0, FALSE);
+	for (;;) {
+		while (!priv->worker_busy && !priv->worker_quit)
+			pthread_cond_wait (&priv->worker_cond, &priv->worker_mutex);
 
-		visual_video_set_compose_type (vid2, VISUAL_VIDEO_COMPOSE_TYPE_CUSTOM);
-		visual_video_set_compose_function (vid2, priv->currentcomp);
-		visual_video_blit (video, vid2, 0, 0, TRUE);
+		if (priv->worker_quit)
+			break;
 
-		visual_video_unref (vid1);
-		visual_video_unref (vid2);
+		pthread_mutex_unlock (&priv->worker_mutex);
+		act_oinksie_render_engine (&priv->priv2);
+		pthread_mutex_lock (&priv->worker_mutex);
+
+		priv->worker_busy = FALSE;
+		pthread_cond_broadcast (&priv->worker_cond);
 	}
+
+	pthread_mutex_unlock (&priv->worker_mutex);
+
+	return NULL;
 }
 
 static void act_oinksie_set_color_mode (OinksiePrivContainer *self, int mode)
 {
 	self->color_mode = mode;
 
-	switch (self->color_mode) {
-		case 0:	 self->currentcomp = compose_blend1_32_c; break;
-		case 1:	 self->currentcomp = compose_blend2_32_c; break;
-		case 2:	 self->currentcomp = compose_blend3_32_c; break;
-		case 3:	 self->currentcomp = compose_blend4_32_c; break;
-		case 4:	 self->currentcomp = compose_blend5_32_c; break;
-		default: self->currentcomp = compose_blend2_32_c; break;
-	}
+	if (mode >= 0 && mode < (int) (sizeof (blend_modes) / sizeof (blend_modes[0])))
+		self->currentblend = &blend_modes[mode];
+	else
+		self->currentblend = &blend_modes[1];
 }
 
 static void act_oinksie_set_acid_palette (OinksiePrivContainer *self, int palette)
@@ -320,112 +461,127 @@ static void act_oinksie_set_acid_palette (OinksiePrivContainer *self, int palett
 	self->priv1.config.acidpalette = palette;
 }
 
-static void compose_blend1_32_c (VisVideo *dest, VisVideo *src)
+static void act_oinksie_palette_expand (uint32_t *colors, VisPalette *pal)
 {
-	int i, j;
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	uint8_t *srcbuf  = visual_video_get_pixels (src);
-	uint8_t alpha = 128;
-
-	int src_width  = visual_video_get_width	 (src);
-	int src_height = visual_video_get_height (src);
-
-	for (i = 0; i < src_height; i++) {
-		for (j = 0; j < src_width; j++) {
-			destbuf[0] = (alpha * (destbuf[0] - srcbuf[0]) >> 8) + srcbuf[0];
-			destbuf[1] = (alpha * (destbuf[1] - srcbuf[1]) >> 8) + srcbuf[1];
-			destbuf[2] = (alpha * (destbuf[2] - srcbuf[2]) >> 8) + srcbuf[2];
-
-			destbuf += 4;
-			srcbuf  += 4;
-		}
+	VisColor *pal_colors = visual_palette_get_colors (pal);
+	int i;
+
+	for (i = 0; i < 256; i++) {
+		colors[i] = (0xffU << 24) | (pal_colors[i].r << 16) | (pal_colors[i].g << 8) | pal_colors[i].b;
 	}
 }
 
-static void compose_blend2_32_c (VisVideo *dest, VisVideo *src)
+static inline uint8_t blend_channel (int alpha, uint8_t d, uint8_t s)
 {
-	int i, j;
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	uint8_t *srcbuf  = visual_video_get_pixels (src);
-	uint8_t alpha = 128;
-
-	int src_width  = visual_video_get_width	 (src);
-	int src_height = visual_video_get_height (src);
-
-	for (i = 0; i < src_height; i++) {
-		for (j = 0; j < src_width; j++) {
-			destbuf[0] = (destbuf[0] * (destbuf[0] - srcbuf[0]) >> 8) + srcbuf[0];
-			destbuf[1] = (alpha      * (destbuf[1] - srcbuf[1]) >> 8) + srcbuf[1];
-			destbuf[2] = (0          * (destbuf[2] - srcbuf[2]) >> 8) + srcbuf[2];
-
-			destbuf += 4;
-			srcbuf  += 4;
-		}
-	}
+	return (alpha * (d - s) >> 8) + s;
 }
 
-static void compose_blend3_32_c (VisVideo *dest, VisVideo *src)
+static inline uint32_t blend_pixel (uint32_t dest, uint32_t src, const OinksieBlend *blend)
 {
-	int i, j;
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	uint8_t *srcbuf  = visual_video_get_pixels (src);
-	uint8_t alpha = 128;
-
-	int src_width  = visual_video_get_width	 (src);
-	int src_height = visual_video_get_height (src);
-
-	for (i = 0; i < src_height; i++) {
-		for (j = 0; j < src_width; j++) {
-			destbuf[0] = (0          * (destbuf[0] - srcbuf[0]) >> 8) + srcbuf[0];
-			destbuf[1] = (alpha      * (destbuf[1] - srcbuf[1]) >> 8) + srcbuf[1];
-			destbuf[2] = (destbuf[0] * (destbuf[2] - srcbuf[2]) >> 8) + srcbuf[2];
-
-			destbuf += 4;
-			srcbuf  += 4;
-		}
+	const uint8_t *d = (const uint8_t *) &dest;
+	const uint8_t *s = (const uint8_t *) &src;
+	uint32_t result;
+	uint8_t *r = (uint8_t *) &result;
+	int c;
+
+	r[0] = blend_channel (blend->constant[0] | (d[0] & blend->dmask[0]) | (s[0] & blend->smask[0]), d[0], s[0]);
+
+	for (c = 1; c < 3; c++) {
+		int alpha = blend->constant[c]
+		          | (d[0] & blend->dmask[c])
+		          | (s[0] & blend->smask[c])
+		          | (r[0] & blend->rmask[c]);
+
+		r[c] = blend_channel (alpha, d[c], s[c]);
 	}
+
+	r[3] = d[3];
+
+	return result;
 }
 
-static void compose_blend4_32_c (VisVideo *dest, VisVideo *src)
+#if defined(__SSE2__)
+
+/* Blends four pixels at once in 16-bit lanes. Only bits 8..15 of the product
+ * a * (d - s) survive the final truncation to 8 bits, so the low half of the
+ * 16-bit multiply is enough. */
+static inline __m128i blend_pixels_16 (__m128i d, __m128i s, __m128i constant,
+                                       __m128i dmask, __m128i smask, __m128i rmask,
+                                       int use_result)
 {
-	int i, j;
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	uint8_t *srcbuf  = visual_video_get_pixels (src);
-	uint8_t alpha = 128;
-
-	int src_width  = visual_video_get_width	 (src);
-	int src_height = visual_video_get_height (src);
-
-	for (i = 0; i < src_height; i++) {
-		for (j = 0; j < src_width; j++) {
-			destbuf[0] = (destbuf[0] * (destbuf[0] - srcbuf[0]) >> 8) + srcbuf[0];
-			destbuf[1] = (alpha      * (destbuf[1] - srcbuf[1]) >> 8) + srcbuf[1];
-			destbuf[2] = (srcbuf[0]  * (destbuf[2] - srcbuf[2]) >> 8) + srcbuf[2];
-
-			destbuf += 4;
-			srcbuf  += 4;
-		}
+	const __m128i lo = _mm_set1_epi16 (0x00ff);
+
+	__m128i d0 = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (d, 0x00), 0x00);
+	__m128i s0 = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (s, 0x00), 0x00);
+
+	__m128i alpha = _mm_or_si128 (constant,
+	                _mm_or_si128 (_mm_and_si128 (d0, dmask), _mm_and_si128 (s0, smask)));
+
+	__m128i diff = _mm_sub_epi16 (d, s);
+	__m128i r = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (_mm_mullo_epi16 (alpha, diff), 8), s), lo);
+
+	if (use_result) {
+		__m128i r0 = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (r, 0x00), 0x00);
+
+		alpha = _mm_or_si128 (alpha, _mm_and_si128 (r0, rmask));
+		r = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (_mm_mullo_epi16 (alpha, diff), 8), s), lo);
 	}
+
+	return r;
 }
 
-static void compose_blend5_32_c (VisVideo *dest, VisVideo *src)
+#endif /* __SSE2__ */
+
+/* Expands both engines' indexed frames through their palettes and blends
+ * them into the 32-bit target in a single pass. */
+static void compose_palette_blend_32 (VisVideo *video,
+                                      const uint8_t *buf1, const uint32_t *pal1,
+                                      const uint8_t *buf2, const uint32_t *pal2,
+                                      int width, int height,
+                                      const OinksieBlend *blend)
 {
-	int i, j;
+	uint8_t *dest_row = visual_video_get_pixels (video);
+	int pitch = visual_video_get_pitch (video);
+	int x, y;
+
+#if defined(__SSE2__)
+	const __m128i zero     = _mm_setzero_si128 ();
+	const __m128i alpha    = _mm_set1_epi32 (0xff000000);
+	const __m128i constant = _mm_set_epi16 (blend->constant[3], blend->constant[2], blend->constant[1], blend->constant[0],
+	                                        blend->constant[3], blend->constant[2], blend->constant[1], blend->constant[0]);
+	const __m128i dmask    = _mm_set_epi16 (blend->dmask[3], blend->dmask[2], blend->dmask[1], blend->dmask[0],
+	                                        blend->dmask[3], blend->dmask[2], blend->dmask[1], blend->dmask[0]);
+	const __m128i smask    = _mm_set_epi16 (blend->smask[3], blend->smask[2], blend->smask[1], blend->smask[0],
+	                                        blend->smask[3], blend->smask[2], blend->smask[1], blend->smask[0]);
+	const __m128i rmask    = _mm_set_epi16 (blend->rmask[3], blend->rmask[2], blend->rmask[1], blend->rmask[0],
+	                                        blend->rmask[3], blend->rmask[2], blend->rmask[1], blend->rmask[0]);
+	int use_result = (blend->rmask[1] | blend->rmask[2]) != 0;
+#endif
 
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	uint8_t *srcbuf  = visual_video_get_pixels (src);
+	for (y = 0; y < height; y++) {
+		uint32_t *dest = (uint32_t *) dest_row;
 
-    int src_width  = visual_video_get_width  (src);
-    int src_height = visual_video_get_height (src);
+		x = 0;
 
-	for (i = 0; i < src_height; i++) {
-		for (j = 0; j < src_width; j++) {
-			destbuf[0] = (destbuf[0] * (destbuf[0] - srcbuf[0]) >> 8) + srcbuf[0];
-			destbuf[1] = (srcbuf[0]  * (destbuf[1] - srcbuf[1]) >> 8) + srcbuf[1];
-			destbuf[2] = (destbuf[0] * (destbuf[2] - srcbuf[2]) >> 8) + srcbuf[2];
+#if defined(__SSE2__)
+		for (; x + 4 <= width; x += 4) {
+			__m128i d = _mm_set_epi32 (pal1[buf1[x + 3]], pal1[buf1[x + 2]], pal1[buf1[x + 1]], pal1[buf1[x]]);
+			__m128i s = _mm_set_epi32 (pal2[buf2[x + 3]], pal2[buf2[x + 2]], pal2[buf2[x + 1]], pal2[buf2[x]]);
 
-			destbuf += 4;
-			srcbuf  += 4;
+			__m128i rlo = blend_pixels_16 (_mm_unpacklo_epi8 (d, zero), _mm_unpacklo_epi8 (s, zero),
+			                               constant, dmask, smask, rmask, use_result);
+			__m128i rhi = blend_pixels_16 (_mm_unpackhi_epi8 (d, zero), _mm_unpackhi_epi8 (s, zero),
+			                               constant, dmask, smask, rmask, use_result);
+
+			_mm_storeu_si128 ((__m128i *) (dest + x), _mm_or_si128 (_mm_packus_epi16 (rlo, rhi), alpha));
 		}
+#endif
+
+		for (; x < width; x++)
+			dest[x] = blend_pixel (pal1[buf1[x]], pal2[buf2[x]], blend);
+
+		buf1 += width;
+		buf2 += width;
+		dest_row += pitch;
 	}
 }
@@ -37,13 +37,32 @@
 
 #include <libvisual/libvisual.h>
 
+#include <stdlib.h>
+#include <errno.h>
+
 VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
-#define PCM_BUF_SIZE 1024
+/* Period time to start with, and the most it may grow to (in usecs) */
+#define PERIOD_TIME_MIN 25000
+#define PERIOD_TIME_MAX 250000
+
+/* Number of periods in the ring buffer */
+#define PERIODS 4
 
 typedef struct {
 	snd_pcm_t *chandle;
 	int loaded;
+	int use_mmap;                  /* reading through mmap_begin/mmap_commit */
+	unsigned int rate;             /* actual sample rate */
+	unsigned int period_time;      /* requested period time, in usecs */
+	snd_pcm_uframes_t period_size; /* actual period size, in frames */
+	snd_pcm_uframes_t buffer_size; /* actual buffer size, in frames */
+	int16_t *pcm_buffer;           /* read buffer for non-mmap access */
+	unsigned long xruns;
+	unsigned long latency_count;   /* latency statistics, in frames */
+	unsigned long long latency_sum;
+	snd_pcm_sframes_t latency_max;
+	VisTime *capture_time;         /* capture time of the next frame uploaded */
 } alsaPrivate;
 
 static int  inp_alsa_init    (VisPluginData *plugin);
@@ -66,9 +85,10 @@ const VisPluginInfo *get_plugin_info (void)
 		.plugname = "alsa",
 		.name     = "alsa",
 		.author   = "Vitaly V. Bursov <vitalyvb@urk.net>",
-		.version  = "0.1",
+		.version  = "0.3",
 		.about    = N_("ALSA capture plugin"),
-		.help     = N_("Use this plugin to capture PCM data from the ALSA record device"),
+		.help     = N_("Use this plugin to capture PCM data from the ALSA record device. "
+		               "Set $LV_ALSA_DEVICE to capture from a device other than hw:0,0"),
 		.license  = VISUAL_PLUGIN_LICENSE_LGPL,
 
 		.init    = inp_alsa_init,
@@ -79,29 +99,13 @@ const VisPluginInfo *get_plugin_info (void)
 	return &info;
 }
 
-int inp_alsa_init (VisPluginData *plugin)
+static int setup_pcm (alsaPrivate *priv)
 {
 	snd_pcm_hw_params_t *hwparams = NULL;
-	alsaPrivate *priv;
 	unsigned int rate = inp_alsa_var_samplerate;
 	unsigned int exact_rate;
 	unsigned int tmp;
 	int dir = 0;
-	int err;
-
-#if ENABLE_NLS
-	bindtextdomain (GETTEXT_PACKAGE, LOCALE_DIR);
-#endif
-
-	priv = visual_mem_new0 (alsaPrivate, 1);
-	visual_plugin_set_private (plugin, priv);
-
-	if ((err = snd_pcm_open(&priv->chandle, inp_alsa_var_cdevice,
-			SND_PCM_STREAM_CAPTURE, SND_PCM_NONBLOCK)) < 0) {
-		visual_log(VISUAL_LOG_ERROR,
-			    "Record open error: %s", snd_strerror(err));
-		return FALSE;
-	}
 
 	snd_pcm_hw_params_malloc(&hwparams);
 	visual_return_val_if_fail(hwparams != NULL, FALSE);
@@ -113,7 +117,11 @@ int inp_alsa_init (VisPluginData *plugin)
 		return FALSE;
 	}
 
-	if (snd_pcm_hw_params_set_access(priv->chandle, hwparams,
+	/* Prefer reading straight out of the device's ring buffer */
+	priv->use_mmap = snd_pcm_hw_params_set_access(priv->chandle, hwparams,
+					 SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+
+	if (!priv->use_mmap && snd_pcm_hw_params_set_access(priv->chandle, hwparams,
 					 SND_PCM_ACCESS_RW_INTERLEAVED) < 0) {
 		visual_log(VISUAL_LOG_ERROR, "Error setting access");
 		snd_pcm_hw_params_free(hwparams);
@@ -140,13 +148,15 @@ int inp_alsa_init (VisPluginData *plugin)
 		snd_pcm_hw_params_free(hwparams);
 		return FALSE;
 	}
-	if (exact_rate != rate) {
+	if (exact_rate != rate && exact_rate != priv->rate) {
 		visual_log(VISUAL_LOG_INFO,
 			   "The rate %d Hz is not supported by your " \
 			   "hardware.\n" \
 			   "==> Using %d Hz instead", rate, exact_rate);
 	}
 
+	priv->rate = exact_rate;
+
 	if (snd_pcm_hw_params_set_channels(priv->chandle, hwparams,
 					   inp_alsa_var_channels) < 0) {
 		visual_log(VISUAL_LOG_ERROR, "Error setting channels");
@@ -154,16 +164,17 @@ int inp_alsa_init (VisPluginData *plugin)
 		return FALSE;
 	}
 
-	/* Setup a large buffer */
+	/* Keep the period short so uploads see fresh data, with a few
+	 * periods of slack for slow frames */
 
-	tmp = 1000000;
+	tmp = priv->period_time;
 	if (snd_pcm_hw_params_set_period_time_near(priv->chandle, hwparams, &tmp, &dir) < 0){
 		visual_log(VISUAL_LOG_ERROR, "Error setting period time");
 		snd_pcm_hw_params_free(hwparams);
 		return FALSE;
 	}
 
-	tmp = 1000000*4;
+	tmp = priv->period_time * PERIODS;
 	if (snd_pcm_hw_params_set_buffer_time_near(priv->chandle, hwparams, &tmp, &dir) < 0){
 		visual_log(VISUAL_LOG_ERROR, "Error setting buffer time");
 		snd_pcm_hw_params_free(hwparams);
@@ -177,17 +188,65 @@ int inp_alsa_init (VisPluginData *plugin)
 		return FALSE;
 	}
 
+	snd_pcm_hw_params_get_period_size(hwparams, &priv->period_size, &dir);
+	snd_pcm_hw_params_get_buffer_size(hwparams, &priv->buffer_size);
+
+	snd_pcm_hw_params_free(hwparams);
+
+	if (!priv->use_mmap) {
+		visual_mem_free(priv->pcm_buffer);
+		priv->pcm_buffer = visual_mem_malloc(priv->period_size * inp_alsa_var_channels * sizeof(int16_t));
+	}
+
+	visual_log(VISUAL_LOG_DEBUG,
+		   "Capturing with %s access, %lu frame periods, %lu frame buffer",
+		   priv->use_mmap ? "mmap" : "read",
+		   (unsigned long) priv->period_size, (unsigned long) priv->buffer_size);
+
 	if (snd_pcm_prepare(priv->chandle) < 0) {
 		visual_log(VISUAL_LOG_ERROR, "Failed to prepare interface");
-		snd_pcm_hw_params_free(hwparams);
 		return FALSE;
 	}
 
-	snd_pcm_hw_params_free(hwparams);
+	/* Capture through mmap does not start by itself */
+	if (snd_pcm_start(priv->chandle) < 0) {
+		visual_log(VISUAL_LOG_ERROR, "Failed to start capture");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+int inp_alsa_init (VisPluginData *plugin)
+{
+	alsaPrivate *priv;
+	const char *device;
+	int err;
+
+#if ENABLE_NLS
+	bindtextdomain (GETTEXT_PACKAGE, LOCALE_DIR);
+#endif
+
+	priv = visual_mem_new0 (alsaPrivate, 1);
+	visual_plugin_set_private (plugin, priv);
+
+	priv->capture_time = visual_time_new ();
+
+	device = getenv("LV_ALSA_DEVICE");
+	if (device == NULL || *device == '\0')
+		device = inp_alsa_var_cdevice;
+
+	if ((err = snd_pcm_open(&priv->chandle, device,
+			SND_PCM_STREAM_CAPTURE, SND_PCM_NONBLOCK)) < 0) {
+		visual_log(VISUAL_LOG_ERROR,
+			    "Record open error: %s", snd_strerror(err));
+		return FALSE;
+	}
 
 	priv->loaded = TRUE;
+	priv->period_time = PERIOD_TIME_MIN;
 
-	return TRUE;
+	return setup_pcm(priv);
 }
 
 void inp_alsa_cleanup (VisPluginData *plugin)
@@ -195,45 +254,184 @@ void inp_alsa_cleanup (VisPluginData *plugin)
 	alsaPrivate *priv = visual_plugin_get_private (plugin);
 
 	if (priv->loaded) {
+		if (priv->latency_count > 0) {
+			visual_log(VISUAL_LOG_INFO,
+				   "Capture latency: %.1f ms average, %.1f ms max, %lu overruns",
+				   1000.0 * priv->latency_sum / priv->latency_count / priv->rate,
+				   1000.0 * priv->latency_max / priv->rate,
+				   priv->xruns);
+		}
+
 		snd_pcm_close(priv->chandle);
-    }
+	}
 
+	visual_time_free (priv->capture_time);
+	visual_mem_free (priv->pcm_buffer);
 	visual_mem_free (priv);
 }
 
+static int recover_pcm (alsaPrivate *priv, int err)
+{
+	if (err == -EAGAIN)
+		return TRUE;
+
+	if (err == -EPIPE) {
+		priv->xruns++;
+
+		/* Uploads are not keeping up, give them more slack */
+		if (priv->period_time < PERIOD_TIME_MAX) {
+			priv->period_time *= 2;
+			if (priv->period_time > PERIOD_TIME_MAX)
+				priv->period_time = PERIOD_TIME_MAX;
+
+			visual_log(VISUAL_LOG_WARNING,
+				   "ALSA: Buffer Overrun, raising period time to %u us",
+				   priv->period_time);
+
+			snd_pcm_drop(priv->chandle);
+
+			return setup_pcm(priv);
+		}
+
+		visual_log(VISUAL_LOG_WARNING, "ALSA: Buffer Overrun");
+
+		err = snd_pcm_prepare(priv->chandle);
+	} else if (err == -ESTRPIPE) {
+		/* Try again on the next upload while still suspended */
+		err = snd_pcm_resume(priv->chandle);
+		if (err == -EAGAIN)
+			return TRUE;
+
+		if (err < 0)
+			err = snd_pcm_prepare(priv->chandle);
+	}
+
+	if (err < 0) {
+		visual_log(VISUAL_LOG_ERROR,
+			   "Failed to recover interface: %s", snd_strerror(err));
+		return FALSE;
+	}
+
+	if (snd_pcm_state(priv->chandle) == SND_PCM_STATE_PREPARED)
+		snd_pcm_start(priv->chandle);
+
+	return TRUE;
+}
+
+/* capture_usecs is the capture time of the first frame, or 0 if unknown */
+static void upload_frames (alsaPrivate *priv, VisAudio *audio, void *data, snd_pcm_uframes_t frames, uint64_t capture_usecs)
+{
+	VisBuffer *buffer;
+	VisAudioSampleRateType rate = visual_audio_sample_rate_from_length(priv->rate);
+
+	buffer = visual_buffer_new_wrap_data (data, frames * inp_alsa_var_channels * sizeof(int16_t), FALSE);
+
+	if (capture_usecs > 0) {
+		visual_time_set (priv->capture_time,
+				 capture_usecs / VISUAL_USECS_PER_SEC,
+				 (capture_usecs % VISUAL_USECS_PER_SEC) * VISUAL_NSECS_PER_USEC);
+
+		visual_audio_input_with_time (audio, buffer, rate,
+				VISUAL_AUDIO_SAMPLE_FORMAT_S16, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO,
+				priv->capture_time);
+	} else {
+		visual_audio_input (audio, buffer, rate,
+				VISUAL_AUDIO_SAMPLE_FORMAT_S16, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+	}
+
+	visual_buffer_unref (buffer);
+}
+
+/* Capture time of a frame uploaded after some others */
+static uint64_t frame_capture_time (alsaPrivate *priv, uint64_t first_usecs, snd_pcm_uframes_t offset)
+{
+	if (first_usecs == 0)
+		return 0;
+
+	return first_usecs + (uint64_t) offset * VISUAL_USECS_PER_SEC / priv->rate;
+}
+
 int inp_alsa_upload (VisPluginData *plugin, VisAudio *audio)
 {
 	alsaPrivate *priv = visual_plugin_get_private (plugin);
 
-	int16_t data[PCM_BUF_SIZE];
-	int rcnt;
+	snd_pcm_sframes_t avail;
+	snd_pcm_sframes_t delay;
+	snd_pcm_uframes_t uploaded = 0;
+	uint64_t first_usecs = 0;
+
+	/* Never blocks: takes whatever has been captured since the last
+	 * upload and returns */
+
+	avail = snd_pcm_avail_update(priv->chandle);
+	if (avail < 0)
+		return recover_pcm(priv, avail);
 
-	do {
-		rcnt = snd_pcm_readi(priv->chandle, data, PCM_BUF_SIZE / 2);
+	/* Age of the oldest captured frame not read yet */
+	if (snd_pcm_delay(priv->chandle, &delay) == 0 && delay >= 0) {
+		uint64_t now_usecs;
 
-		if (rcnt > 0) {
-			VisBuffer *buffer;
+		priv->latency_sum += delay;
+		priv->latency_count++;
 
-			buffer = visual_buffer_new_wrap_data (data, rcnt*2*sizeof(int16_t), FALSE);
+		if (delay > priv->latency_max)
+			priv->latency_max = delay;
 
-			visual_audio_input (audio, buffer, VISUAL_AUDIO_SAMPLE_RATE_44100,
-					VISUAL_AUDIO_SAMPLE_FORMAT_S16, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+		visual_time_get_now (priv->capture_time);
+		now_usecs = visual_time_to_usecs (priv->capture_time);
 
-			visual_buffer_unref (buffer);
+		first_usecs = now_usecs - (uint64_t) delay * VISUAL_USECS_PER_SEC / priv->rate;
+	}
+
+	if (priv->use_mmap) {
+		while (avail > 0) {
+			const snd_pcm_channel_area_t *areas;
+			snd_pcm_uframes_t offset;
+			snd_pcm_uframes_t frames = avail;
+			snd_pcm_sframes_t committed;
+			int err;
+
+			/* frames comes back as the contiguous run before the
+			 * buffer wraps around */
+			err = snd_pcm_mmap_begin(priv->chandle, &areas, &offset, &frames);
+			if (err < 0)
+				return recover_pcm(priv, err);
+
+			upload_frames(priv, audio,
+				(uint8_t *) areas[0].addr + (areas[0].first + offset * areas[0].step) / 8,
+				frames, frame_capture_time(priv, first_usecs, uploaded));
+
+			uploaded += frames;
+
+			committed = snd_pcm_mmap_commit(priv->chandle, offset, frames);
+			if (committed < 0 || (snd_pcm_uframes_t) committed != frames)
+				return recover_pcm(priv, committed < 0 ? committed : -EPIPE);
+
+			avail -= frames;
 		}
+	} else {
+		while (avail > 0) {
+			snd_pcm_uframes_t count = avail;
+			snd_pcm_sframes_t rcnt;
+
+			if (count > priv->period_size)
+				count = priv->period_size;
+
+			rcnt = snd_pcm_readi(priv->chandle, priv->pcm_buffer, count);
+			if (rcnt < 0)
+				return recover_pcm(priv, rcnt);
 
-		if (rcnt < 0) {
-			if (rcnt == -EPIPE) {
-				visual_log(VISUAL_LOG_WARNING, "ALSA: Buffer Overrun");
+			if (rcnt == 0)
+				break;
 
-				if (snd_pcm_prepare(priv->chandle) < 0) {
-					visual_log(VISUAL_LOG_ERROR,
-							"Failed to prepare interface");
-					return FALSE;
-				}
-			}
+			upload_frames(priv, audio, priv->pcm_buffer, rcnt,
+				frame_capture_time(priv, first_usecs, uploaded));
+
+			uploaded += rcnt;
+
+			avail -= rcnt;
 		}
-	} while (rcnt > 0);
+	}
 
 	return TRUE;
 }
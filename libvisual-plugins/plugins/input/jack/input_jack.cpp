@@ -25,6 +25,10 @@
 #include <jack/jack.h>
 #include <libvisual/libvisual.h>
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstring>
 
 VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
@@ -32,20 +36,105 @@ VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
 namespace {
 
-  typedef std::vector<int16_t> Buffer;
+  // Number of ports captured. Two for left and right.
+  unsigned int const max_channels = 2;
+
+  // Frames held per channel. This is a power of 2, with room for several
+  // periods of JACK's largest buffer size (8192 frames).
+  std::size_t const ring_frames = 65536;
+
+  // Wait-free single producer, single consumer ring of planar float frames.
+  // The JACK process thread writes and the render thread reads. All memory
+  // is allocated up front so the process callback never allocates.
+  class FrameRing
+  {
+  public:
+
+      FrameRing ()
+          : m_data  (max_channels * ring_frames)
+          , m_write (0)
+          , m_read  (0)
+      {}
+
+      // Producer side. Writes as many frames as there is room for, and
+      // returns that number.
+      std::size_t write (float const* const* planes, std::size_t frames)
+      {
+          auto write = m_write.load (std::memory_order_relaxed);
+          auto read  = m_read.load (std::memory_order_acquire);
+
+          frames = std::min (frames, ring_frames - (write - read));
+
+          auto offset = write & (ring_frames - 1);
+          auto first  = std::min (frames, ring_frames - offset);
+
+          for (unsigned int c = 0; c < max_channels; c++) {
+              float* plane = &m_data[c * ring_frames];
+
+              std::memcpy (plane + offset, planes[c], first * sizeof (float));
+              std::memcpy (plane, planes[c] + first, (frames - first) * sizeof (float));
+          }
+
+          m_write.store (write + frames, std::memory_order_release);
+
+          return frames;
+      }
+
+      // Consumer side. Returns the number of frames in the contiguous run
+      // starting at the read position, and their location in each channel.
+      std::size_t peek (float const** planes) const
+      {
+          auto read  = m_read.load (std::memory_order_relaxed);
+          auto write = m_write.load (std::memory_order_acquire);
+
+          auto offset = read & (ring_frames - 1);
+
+          for (unsigned int c = 0; c < max_channels; c++) {
+              planes[c] = &m_data[c * ring_frames + offset];
+          }
+
+          return std::min (write - read, ring_frames - offset);
+      }
+
+      // Position of the next frame written, counted from the first
+      std::size_t get_write_position () const
+      {
+          return m_write.load (std::memory_order_relaxed);
+      }
+
+      // Position of the next frame read, counted from the first
+      std::size_t get_read_position () const
+      {
+          return m_read.load (std::memory_order_relaxed);
+      }
+
+      // Consumer side. Releases frames returned by peek() to the producer.
+      void consume (std::size_t frames)
+      {
+          m_read.store (m_read.load (std::memory_order_relaxed) + frames, std::memory_order_release);
+      }
+
+  private:
+
+      std::vector<float>       m_data;
+      std::atomic<std::size_t> m_write;
+      std::atomic<std::size_t> m_read;
+  };
 
   struct JackPrivate {
-      jack_client_t* client;
-      jack_port_t*   input_port;
-      bool           shutdown;
-      jack_nframes_t buffer_size;
-      jack_nframes_t sample_rate;
-      Buffer         buffer;
+      jack_client_t*               client;
+      jack_port_t*                 input_ports[max_channels];
+      unsigned int                 channels;
+      std::atomic<bool>            shutdown;
+      std::atomic<jack_nframes_t>  sample_rate;
+      jack_nframes_t               upload_rate;
+      std::atomic<unsigned long>   dropped_frames;
+      std::atomic<int64_t>         capture_epoch;  // capture time of ring frame 0 in usecs, or 0 if not known yet
+      std::unique_ptr<FrameRing>   ring;
   };
 
   int  process_callback     (jack_nframes_t nframes, void* arg);
   void shutdown_callback    (void* arg);
-  int  buffer_size_callback (jack_nframes_t nframes, void* arg);
   int  sample_rate_callback (jack_nframes_t nframes, void* arg);
 
   int  inp_jack_init    (VisPluginData* plugin);
@@ -66,7 +155,7 @@ VisPluginInfo const* get_plugin_info ()
     info.plugname = "jack";
     info.name     = "JACK input";
     info.author   = "Dennis Smit <ds@nerds-incorporated.org>";
-    info.version  = "0.1";
+    info.version  = "0.3";
     info.about    = N_("Jackit capture plugin");
     info.help     =  N_("Use this plugin to capture PCM data from jackd");
     info.license  = VISUAL_PLUGIN_LICENSE_LGPL;
@@ -89,6 +178,13 @@ namespace {
       JackPrivate* priv = new JackPrivate;
       visual_plugin_set_private (plugin, priv);
 
+      priv->channels = 0;
+      priv->upload_rate = 0;
+      priv->shutdown = false;
+      priv->dropped_frames = 0;
+      priv->capture_epoch  = 0;
+      priv->ring.reset (new FrameRing);
+
       jack_options_t options = JackNullOption;
       jack_status_t  status;
 
@@ -106,22 +202,22 @@ namespace {
       }
 
       // Initialize audio settings
-      priv->buffer_size = jack_get_buffer_size (priv->client);
       priv->sample_rate = jack_get_sample_rate (priv->client);
-      priv->buffer.resize (priv->buffer_size * 2);
-      priv->shutdown = false;
 
       // Setup callbacks
       jack_set_process_callback (priv->client, process_callback, priv);
       jack_on_shutdown (priv->client, shutdown_callback, priv);
       jack_set_sample_rate_callback (priv->client, sample_rate_callback, priv);
-      jack_set_buffer_size_callback (priv->client, buffer_size_callback, priv);
 
-      // Create an input port to receive data on
-      priv->input_port = jack_port_register (priv->client, "input", JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
-      if (!priv->input_port) {
-          visual_log (VISUAL_LOG_ERROR, "No more JACK input port available");
-          return FALSE;
+      // Create input ports to receive data on
+      char const* port_names[max_channels] = { "input_left", "input_right" };
+
+      for (unsigned int i = 0; i < max_channels; i++) {
+          priv->input_ports[i] = jack_port_register (priv->client, port_names[i], JACK_DEFAULT_AUDIO_TYPE, JackPortIsInput, 0);
+          if (!priv->input_ports[i]) {
+              visual_log (VISUAL_LOG_ERROR, "No more JACK input port available");
+              return FALSE;
+          }
       }
 
       // Activate this client. From here on JACK will start invoking
@@ -143,16 +239,19 @@ namespace {
           visual_log (VISUAL_LOG_INFO, "%s", *port);
       }
 
-      // Receive our input from the first capture port
-      if (jack_connect (priv->client, ports[0], jack_port_name (priv->input_port))) {
-          visual_log (VISUAL_LOG_ERROR, "Cannot connect input port");
-          free (ports);
-          return FALSE;
+      // Receive our input from the first capture ports, one per channel
+      for (unsigned int i = 0; i < max_channels && ports[i]; i++) {
+          if (jack_connect (priv->client, ports[i], jack_port_name (priv->input_ports[i]))) {
+              visual_log (VISUAL_LOG_ERROR, "Cannot connect input port");
+              break;
+          }
+
+          priv->channels++;
       }
 
       free (ports);
 
-      return TRUE;
+      return priv->channels > 0;
   }
 
   void inp_jack_cleanup (VisPluginData* plugin)
@@ -175,31 +274,58 @@ namespace {
           return FALSE;
       }
 
-      LV::BufferPtr buffer = LV::Buffer::wrap (priv->buffer.data(), priv->buffer.size() * sizeof(int16_t), false);
-      audio->input (buffer,
-                    VISUAL_AUDIO_SAMPLE_RATE_44100,
-                    VISUAL_AUDIO_SAMPLE_FORMAT_S16,
-                    VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+      auto dropped = priv->dropped_frames.exchange (0);
+      if (dropped > 0) {
+          visual_log (VISUAL_LOG_WARNING, "Dropped %lu frames of JACK input", dropped);
+      }
+
+      jack_nframes_t sample_rate = priv->sample_rate;
 
-      return TRUE;
-  }
+      auto rate = visual_audio_sample_rate_from_length (sample_rate);
+      if (rate == VISUAL_AUDIO_SAMPLE_RATE_NONE && sample_rate != priv->upload_rate) {
+          visual_log (VISUAL_LOG_WARNING, "Unsupported JACK sample rate %u, input will not be resampled", sample_rate);
+      }
 
-  int buffer_size_callback (jack_nframes_t nframes, void* arg)
-  {
-      JackPrivate* priv = static_cast<JackPrivate*> (arg);
+      priv->upload_rate = sample_rate;
 
-      // Buffer size changed, adjust buffer accordingly
-      priv->buffer_size = nframes;
-      priv->buffer.resize (priv->buffer_size * 2);
+      // Frames wrapping around the end of the ring take two passes. The
+      // samples are copied out by LV::Audio before being released.
+      float const* planes[max_channels];
 
-      return 0;
+      auto capture_epoch = priv->capture_epoch.load (std::memory_order_relaxed);
+
+      while (std::size_t frames = priv->ring->peek (planes)) {
+          // Zero lets LV::Audio estimate the capture time
+          LV::Time capture_time;
+
+          if (capture_epoch != 0) {
+              auto position = priv->ring->get_read_position ();
+              capture_time = LV::Time::from_usecs (capture_epoch + int64_t (position * VISUAL_USECS_PER_SEC / sample_rate));
+          }
+
+          if (priv->channels == 1) {
+              auto buffer = LV::Buffer::wrap (const_cast<float*> (planes[0]), frames * sizeof (float), false);
+              audio->input (buffer, rate, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_MONO, capture_time);
+          } else {
+              std::vector<LV::BufferPtr> buffers {
+                  LV::Buffer::wrap (const_cast<float*> (planes[0]), frames * sizeof (float), false),
+                  LV::Buffer::wrap (const_cast<float*> (planes[1]), frames * sizeof (float), false)
+              };
+
+              audio->input_planar (buffers, rate, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT,
+                                   { VISUAL_AUDIO_CHANNEL_LEFT, VISUAL_AUDIO_CHANNEL_RIGHT }, capture_time);
+          }
+
+          priv->ring->consume (frames);
+      }
+
+      return TRUE;
   }
 
   int sample_rate_callback (jack_nframes_t nframes, void* arg)
   {
       JackPrivate* priv = static_cast<JackPrivate*> (arg);
 
-      // FIXME: Update sample rate setting in inp_jack_upload()
       priv->sample_rate = nframes;
 
       return 0;
@@ -209,20 +335,34 @@ namespace {
   {
       JackPrivate* priv = static_cast<JackPrivate*> (arg);
 
-      jack_default_audio_sample_t* in =
-          static_cast<jack_default_audio_sample_t*> (jack_port_get_buffer (priv->input_port, nframes));
+      // Runs on the JACK realtime thread: no allocation, no locking.
+      // Ports that are not connected deliver silence.
+      float const* planes[max_channels];
 
-      // FIXME: As we're only receiving audio data from a single input
-      // port, we need to duplicate it across both left and right
-      // channels. VisAudio does not accept mono inputs yet.
+      for (unsigned int i = 0; i < max_channels; i++) {
+          planes[i] = static_cast<jack_default_audio_sample_t const*> (jack_port_get_buffer (priv->input_ports[i], nframes));
+      }
 
-      // FIXME: Float inputs do not appear to work at the moment
-      // either, so we convert the data to signed 16-bit here as well.
+      auto written = priv->ring->write (planes, nframes);
 
-      for (unsigned int i = 0; i < nframes; i++) {
-          priv->buffer[i << 1] = priv->buffer[(i << 1) + 1] = int16_t (in[i] * 32767);
+      if (written < nframes) {
+          priv->dropped_frames.fetch_add (nframes - written, std::memory_order_relaxed);
       }
 
+      // Date the ring so the render thread can tell when any frame in it
+      // was captured. The last frame written was captured at the start of
+      // this cycle, less the latency of the capture ports.
+      jack_latency_range_t latency;
+      jack_port_get_latency_range (priv->input_ports[0], JackCaptureLatency, &latency);
+
+      jack_nframes_t sample_rate = priv->sample_rate.load (std::memory_order_relaxed);
+
+      auto now_usecs  = int64_t (LV::Time::now ().to_usecs ());
+      auto end_frames = priv->ring->get_write_position () + latency.max;
+
+      priv->capture_epoch.store (now_usecs - int64_t (end_frames * VISUAL_USECS_PER_SEC / sample_rate),
+                                 std::memory_order_relaxed);
+
       return 0;
   }
 
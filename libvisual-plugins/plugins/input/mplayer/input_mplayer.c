@@ -36,12 +36,20 @@
 
 #include <libvisual/libvisual.h>
 
+#include "lv_shm_ring.h"
+
 VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
 #ifndef SHARED_FILE
 #define SHARED_FILE ".mplayer/mplayer-af_export" /**< default file name, relative to $HOME */
 #endif /* SHARED_FILE */
 
+#ifndef SHARED_RING_FILE
+#define SHARED_RING_FILE ".mplayer/mplayer-lv_ring" /**< default ring file name, relative to $HOME */
+#endif /* SHARED_RING_FILE */
+
+#define SHARED_RING_ENV "LV_SHM_RING_FILE" /**< environment variable overriding the ring file */
+
 typedef struct {
 	int nch;                  /**< number of channels */
 	int bs;                   /**< buffer size */
@@ -52,13 +60,27 @@ typedef struct {
 	int fd;                    /**< file descriptor to mmaped area */
 	char *sharedfile;          /**< shared file name */
 	mplayer_data_t *mmap_area; /**< mmap()'ed area */
+	unsigned long long count;  /**< sample counter at the last upload */
 	int loaded;                /**< plugin state */
+
+	int use_ring;              /**< reading from a shared memory ring instead */
+	LVShmRing ring;            /**< shared memory ring */
+	void *ring_block;          /**< block read from the ring */
+	VisAudioSampleRateType ring_rate;
+	VisAudioSampleFormatType ring_format;
+	VisAudioSampleChannelType ring_channels;
+	uint64_t ring_dropped;     /**< dropped blocks already reported */
+	VisTime *capture_time;     /**< capture time of the block being uploaded */
 } mplayer_priv_t;
 
 static int  inp_mplayer_init    (VisPluginData *plugin);
 static void inp_mplayer_cleanup (VisPluginData *plugin);
 static int  inp_mplayer_upload  (VisPluginData *plugin, VisAudio *audio);
 
+static char *get_home_path (const char *file);
+static int   open_ring     (mplayer_priv_t *priv);
+static void  close_ring    (mplayer_priv_t *priv);
+
 const VisPluginInfo *get_plugin_info( void )
 {
 	static VisInputPlugin input = {
@@ -71,9 +93,10 @@ const VisPluginInfo *get_plugin_info( void )
 		.plugname = "mplayer",
 		.name     = "mplayer",
 		.author   = "Gustavo Sverzut Barbieri <gsbarbieri@users.sourceforge.net>",
-		.version  = "1.19",
+		.version  = "1.21",
 		.about    = N_("Use data exported from MPlayer"),
-		.help     = N_("This plugin uses data exported from 'mplayer -af export'"),
+		.help     = N_("This plugin uses data exported from 'mplayer -af export', "
+		               "or from a shared memory ring named by $" SHARED_RING_ENV),
 		.license  = VISUAL_PLUGIN_LICENSE_LGPL,
 
 		.init     = inp_mplayer_init,
@@ -95,13 +118,13 @@ static int inp_mplayer_init( VisPluginData *plugin )
 	priv = visual_mem_new0(mplayer_priv_t, 1);
 	visual_plugin_set_private (plugin, priv);
 
-	priv->sharedfile = visual_mem_malloc0( sizeof( char ) *
-			( strlen( SHARED_FILE ) +
-			  strlen( getenv( "HOME" ) ) + 2 ) );
+	priv->capture_time = visual_time_new ();
 
-	strcpy( priv->sharedfile, getenv( "HOME" ) );
-	strcat( priv->sharedfile, "/" );
-	strcat( priv->sharedfile, SHARED_FILE );
+	/* Prefer a shared memory ring if a producer has set one up */
+	if ( open_ring( priv ) )
+		return TRUE;
+
+	priv->sharedfile = get_home_path( SHARED_FILE );
 
 	visual_return_val_if_fail( priv->sharedfile != NULL, FALSE );
 
@@ -158,15 +181,118 @@ static int inp_mplayer_init( VisPluginData *plugin )
 		return FALSE;
 	}
 
+	priv->count  = priv->mmap_area->count;
 	priv->loaded = TRUE;
 
 	return TRUE;
 }
 
+static char *get_home_path( const char *file )
+{
+	const char *home = getenv( "HOME" );
+	char *path;
+
+	if ( home == NULL )
+		return NULL;
+
+	path = visual_mem_malloc0( strlen( home ) + strlen( file ) + 2 );
+
+	strcpy( path, home );
+	strcat( path, "/" );
+	strcat( path, file );
+
+	return path;
+}
+
+static int open_ring( mplayer_priv_t *priv )
+{
+	const char *env = getenv( SHARED_RING_ENV );
+	LVShmRingHeader *header;
+
+	if ( env != NULL && *env != '\0' )
+	{
+		priv->sharedfile = visual_mem_malloc0( strlen( env ) + 1 );
+		strcpy( priv->sharedfile, env );
+	}
+	else
+		priv->sharedfile = get_home_path( SHARED_RING_FILE );
+
+	if ( priv->sharedfile == NULL || lv_shm_ring_open( &priv->ring, priv->sharedfile ) != 0 )
+	{
+		if ( env != NULL )
+		{
+			visual_log( VISUAL_LOG_WARNING,
+					"Could not open ring '%s': %s",
+					priv->sharedfile, strerror( errno ) );
+		}
+
+		visual_mem_free( priv->sharedfile );
+		priv->sharedfile = NULL;
+
+		return FALSE;
+	}
+
+	header = priv->ring.header;
+
+	priv->ring_rate   = visual_audio_sample_rate_from_length( header->sample_rate );
+	priv->ring_format = header->format;
+
+	if ( header->channels == 1 )
+		priv->ring_channels = VISUAL_AUDIO_SAMPLE_CHANNEL_MONO;
+	else if ( header->channels == 2 )
+		priv->ring_channels = VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO;
+	else
+		priv->ring_channels = VISUAL_AUDIO_SAMPLE_CHANNEL_NONE;
+
+	if ( priv->ring_channels == VISUAL_AUDIO_SAMPLE_CHANNEL_NONE ||
+			header->format == VISUAL_AUDIO_SAMPLE_FORMAT_NONE ||
+			header->format >= VISUAL_AUDIO_SAMPLE_FORMAT_LAST )
+	{
+		visual_log( VISUAL_LOG_WARNING,
+				"Ring '%s' holds unsupported data (%u channels, format %u), ignoring it",
+				priv->sharedfile, header->channels, header->format );
+
+		lv_shm_ring_close( &priv->ring );
+		visual_mem_free( priv->sharedfile );
+		priv->sharedfile = NULL;
+
+		return FALSE;
+	}
+
+	if ( priv->ring_rate == VISUAL_AUDIO_SAMPLE_RATE_NONE )
+	{
+		visual_log( VISUAL_LOG_WARNING,
+				"Unsupported ring sample rate %u, input will not be resampled",
+				header->sample_rate );
+	}
+
+	/* The ring only ever reads as much as the slot size it was opened with */
+	priv->ring_block = visual_mem_malloc( priv->ring.slot_size );
+	priv->use_ring   = TRUE;
+
+	visual_log( VISUAL_LOG_INFO, "Reading audio from ring '%s'", priv->sharedfile );
+
+	return TRUE;
+}
+
+static void close_ring( mplayer_priv_t *priv )
+{
+	lv_shm_ring_close( &priv->ring );
+
+	visual_mem_free( priv->ring_block );
+	priv->ring_block = NULL;
+
+	visual_mem_free( priv->sharedfile );
+	priv->sharedfile = NULL;
+}
+
 static void inp_mplayer_cleanup( VisPluginData *plugin )
 {
 	mplayer_priv_t *priv = visual_plugin_get_private (plugin);
 
+	if ( priv->use_ring && priv->ring_block != NULL )
+		close_ring( priv );
+
 	if ( priv->loaded == 1 )
 	{
 		void *mmap_area  = (void*)priv->mmap_area;
@@ -197,6 +323,7 @@ static void inp_mplayer_cleanup( VisPluginData *plugin )
 		}
 	}
 
+	visual_time_free( priv->capture_time );
 	visual_mem_free( priv->sharedfile );
 	visual_mem_free( priv );
 }
@@ -204,8 +331,80 @@ static void inp_mplayer_cleanup( VisPluginData *plugin )
 static int inp_mplayer_upload( VisPluginData *plugin, VisAudio *audio )
 {
 	mplayer_priv_t *priv = visual_plugin_get_private (plugin);
+	VisBuffer *buffer;
+
+	if ( priv->use_ring )
+	{
+		uint32_t size;
+		uint64_t timestamp;
+		int result;
+
+		/* The ring could not be reopened after the producer replaced it */
+		if ( priv->ring_block == NULL )
+			return TRUE;
+
+		/* Take every block written since the last upload, and nothing else */
+		while ( ( result = lv_shm_ring_read( &priv->ring, priv->ring_block, &size, &timestamp ) ) > 0 )
+		{
+			buffer = visual_buffer_new_wrap_data( priv->ring_block, size, FALSE );
+
+			/* Ring timestamps are on the same clock as VisTime */
+			if ( timestamp != 0 )
+			{
+				visual_time_set( priv->capture_time,
+				                 timestamp / VISUAL_USECS_PER_SEC,
+				                 ( timestamp % VISUAL_USECS_PER_SEC ) * VISUAL_NSECS_PER_USEC );
+
+				visual_audio_input_with_time( audio, buffer,
+				                              priv->ring_rate,
+				                              priv->ring_format,
+				                              priv->ring_channels,
+				                              priv->capture_time );
+			}
+			else
+			{
+				visual_audio_input( audio, buffer,
+				                    priv->ring_rate,
+				                    priv->ring_format,
+				                    priv->ring_channels );
+			}
+
+			visual_buffer_unref( buffer );
+		}
+
+		if ( priv->ring.dropped != priv->ring_dropped )
+		{
+			visual_log( VISUAL_LOG_WARNING, "Dropped %llu blocks of ring input",
+					(unsigned long long) ( priv->ring.dropped - priv->ring_dropped ) );
+			priv->ring_dropped = priv->ring.dropped;
+		}
+
+		/* A restarted producer puts a new ring file in place */
+		if ( result < 0 )
+		{
+			visual_log( VISUAL_LOG_INFO, "Ring '%s' was replaced, reopening it", priv->sharedfile );
+
+			close_ring( priv );
+
+			priv->ring_dropped = 0;
+
+			if ( !open_ring( priv ) )
+				visual_log( VISUAL_LOG_WARNING, "Could not reopen the ring, no more input will be read" );
+		}
+
+		return TRUE;
+	}
+
+	/*
+	 * The export file holds a single buffer, with MPlayer's sample counter
+	 * as its sequence number. Skip it if MPlayer has not written since.
+	 */
+	if ( priv->mmap_area->count == priv->count )
+		return TRUE;
+
+	priv->count = priv->mmap_area->count;
 
-	VisBuffer *buffer = visual_buffer_new_wrap_data ( (uint8_t *)priv->mmap_area + sizeof( mplayer_data_t ), 2048, FALSE );
+	buffer = visual_buffer_new_wrap_data ( (uint8_t *)priv->mmap_area + sizeof( mplayer_data_t ), 2048, FALSE );
 	visual_audio_input (audio, buffer,
 	                    VISUAL_AUDIO_SAMPLE_RATE_44100,
 	                    VISUAL_AUDIO_SAMPLE_FORMAT_S16,
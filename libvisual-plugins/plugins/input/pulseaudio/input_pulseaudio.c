@@ -35,6 +35,7 @@ pa_sample_spec sample_spec = {
 typedef struct {
     pa_simple *simple;
     int16_t pcm_data[SAMPLES*2];
+    VisTime *capture_time;
 } pulseaudio_priv_t;
 
 static int  inp_pulseaudio_init    (VisPluginData *plugin);
@@ -53,7 +54,7 @@ const VisPluginInfo *get_plugin_info( void ) {
         .plugname = "pulseaudio",
         .name     = "Pulseaudio input plugin",
         .author   = "Scott Sibley <scott@starlon.net>",
-        .version  = "1.0",
+        .version  = "1.1",
         .about    = "Use input data from pulseaudio",
         .help     = "",
         .license  = VISUAL_PLUGIN_LICENSE_GPL,
@@ -76,6 +77,8 @@ static int inp_pulseaudio_init( VisPluginData *plugin ) {
     pulseaudio_priv_t *priv = visual_mem_new0(pulseaudio_priv_t, 1);
     visual_plugin_set_private(plugin, priv);
 
+    priv->capture_time = visual_time_new();
+
     VisParamList *params = visual_plugin_get_params (plugin);
     visual_param_list_add_many (params,
                                 visual_param_new_string ("device",
@@ -108,6 +111,7 @@ static void inp_pulseaudio_cleanup( VisPluginData *plugin )
 
     pa_simple_free(priv->simple);
 
+    visual_time_free(priv->capture_time);
     visual_mem_free (priv);
 }
 
@@ -167,10 +171,32 @@ int inp_pulseaudio_upload( VisPluginData *plugin, VisAudio *audio )
 
     VisBuffer *visbuffer = visual_buffer_new_wrap_data (priv->pcm_data, sizeof(priv->pcm_data), FALSE);
 
-    visual_audio_input(audio, visbuffer,
-                       VISUAL_AUDIO_SAMPLE_RATE_44100,
-                       VISUAL_AUDIO_SAMPLE_FORMAT_S16,
-                       VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+    /* The last frame read was captured the stream latency ago, and the
+     * first a buffer's duration before that */
+    pa_usec_t latency = pa_simple_get_latency(priv->simple, &error);
+
+    if (latency != (pa_usec_t) -1) {
+        visual_time_get_now(priv->capture_time);
+
+        uint64_t capture_usecs = visual_time_to_usecs(priv->capture_time)
+                               - latency
+                               - (uint64_t) SAMPLES * VISUAL_USECS_PER_SEC / sample_spec.rate;
+
+        visual_time_set(priv->capture_time,
+                        capture_usecs / VISUAL_USECS_PER_SEC,
+                        (capture_usecs % VISUAL_USECS_PER_SEC) * VISUAL_NSECS_PER_USEC);
+
+        visual_audio_input_with_time(audio, visbuffer,
+                                     VISUAL_AUDIO_SAMPLE_RATE_44100,
+                                     VISUAL_AUDIO_SAMPLE_FORMAT_S16,
+                                     VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO,
+                                     priv->capture_time);
+    } else {
+        visual_audio_input(audio, visbuffer,
+                           VISUAL_AUDIO_SAMPLE_RATE_44100,
+                           VISUAL_AUDIO_SAMPLE_FORMAT_S16,
+                           VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+    }
 
     visual_buffer_unref (visbuffer);
 
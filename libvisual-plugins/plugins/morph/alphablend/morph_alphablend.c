@@ -31,8 +31,6 @@ static int  lv_morph_alpha_init    (VisPluginData *plugin);
 static void lv_morph_alpha_cleanup (VisPluginData *plugin);
 static void lv_morph_alpha_apply   (VisPluginData *plugin, float progress, VisAudio *audio, VisVideo *dest, VisVideo *src1, VisVideo *src2);
 
-static inline void alpha_blend_buffer (uint8_t *dest, uint8_t *src1, uint8_t *src2, int size, int depth, float alpha);
-
 const VisPluginInfo *get_plugin_info (void)
 {
 	static VisMorphPlugin morph = {
@@ -50,7 +48,7 @@ const VisPluginInfo *get_plugin_info (void)
 		.plugname = "alphablend",
 		.name     = "alphablend morph",
 		.author   = "Dennis Smit <ds@nerds-incorporated.org>",
-		.version  = "0.1",
+		.version  = "0.2",
 		.about    = N_("An alphablend morph plugin"),
 		.help     = N_("This morph plugin morphs between two video sources using the alphablend method"),
 		.license  = VISUAL_PLUGIN_LICENSE_LGPL,
@@ -80,33 +78,5 @@ static void lv_morph_alpha_cleanup (VisPluginData *plugin)
 
 static void lv_morph_alpha_apply (VisPluginData *plugin, float progress, VisAudio *audio, VisVideo *dest, VisVideo *src1, VisVideo *src2)
 {
-	alpha_blend_buffer (visual_video_get_pixels (dest),
-	                    visual_video_get_pixels (src1),
-	                    visual_video_get_pixels (src2),
-	                    visual_video_get_size (dest),
-	                    visual_video_get_depth (dest),
-	                    progress);
-}
-
-static inline void alpha_blend_buffer (uint8_t *dest, uint8_t *src1, uint8_t *src2, int size, int depth, float alpha)
-{
-	uint8_t a = alpha * (1/255.0);
-
-	switch (depth) {
-		case VISUAL_VIDEO_DEPTH_8BIT:
-			visual_alpha_blend_8 (dest, src1, src2, size, a);
-			break;
-
-		case VISUAL_VIDEO_DEPTH_16BIT:
-			visual_alpha_blend_16 (dest, src1, src2, size, a);
-			break;
-
-		case VISUAL_VIDEO_DEPTH_24BIT:
-			visual_alpha_blend_24 (dest, src1, src2, size, a);
-			break;
-
-		case VISUAL_VIDEO_DEPTH_32BIT:
-			visual_alpha_blend_32 (dest, src1, src2, size, a);
-			break;
-	}
+	visual_morph_kernel_crossfade (dest, src1, src2, progress);
 }
@@ -58,7 +58,7 @@ const VisPluginInfo *get_plugin_info ()
     info.plugname = "checkers";
     info.name     = "Checkerboard morph";
     info.author   = "Scott Sibley <sisibley@gmail.com>";
-    info.version  = "0.1";
+    info.version  = "0.2";
     info.about    = N_("A checkers in/out morph plugin");
     info.help     = N_("This morph plugin adds a checkerboard effect..");
     info.license  = VISUAL_PLUGIN_LICENSE_LGPL;
@@ -105,24 +105,8 @@ namespace {
           priv->timer.start ();
       }
 
-      dest->fill_color (LV::Color::black ());
-
-      int dest_width  = visual_video_get_width (dest);
-      int dest_height = visual_video_get_height (dest);
-
-      int tile_width  = dest_width  / n_tile_cols;
-      int tile_height = dest_height / n_tile_rows;
-
-      for (int row = 0, y = 0; y < dest_height; row++, y += tile_height) {
-          for (int col = 0, x = 0; x < dest_width; col++, x += tile_width) {
-              LV::Rect region {x, y, tile_width, tile_height};
-
-              auto src  = (row + col + priv->flip) & 1 ? src1 : src2;
-              auto tile = LV::Video::create_sub (src, region);
-
-              dest->blit (tile, x, y, false);
-          }
-      }
+      // Tiles where (row + col + flip) is odd show src1
+      visual_morph_kernel_checkers (dest, src1, src2, n_tile_rows, n_tile_cols, !priv->flip);
   }
 
 } // anonymous namespace
@@ -27,13 +27,8 @@
 
 VISUAL_PLUGIN_API_VERSION_VALIDATOR
 
-typedef struct {
-	uint16_t b:5, g:6, r:5;
-} _color16;
-
 typedef struct {
 	VisPalette *whitepal;
-	uint8_t replacetable[256];
 } FlashPrivate;
 
 static int  lv_morph_flash_init    (VisPluginData *plugin);
@@ -41,10 +36,6 @@ static void lv_morph_flash_cleanup (VisPluginData *plugin);
 static void lv_morph_flash_apply   (VisPluginData *plugin, float progress, VisAudio *audio, VisVideo *dest, VisVideo *src1, VisVideo *src2);
 static void lv_morph_flash_palette (VisPluginData *plugin, float progress, VisAudio *audio, VisPalette *pal, VisVideo *src1, VisVideo *src2);
 
-static void replacetable_generate_24 (FlashPrivate *priv, float progress);
-static void flash_8 (FlashPrivate *priv, float progress, VisVideo *dest, VisVideo *src1, VisVideo *src2);
-static void flash_24 (FlashPrivate *priv, float progress, VisVideo *dest, VisVideo *src1, VisVideo *src2);
-
 const VisPluginInfo *get_plugin_info (void)
 {
 	static VisMorphPlugin morph = {
@@ -63,7 +54,7 @@ const VisPluginInfo *get_plugin_info (void)
 		.plugname = "flash",
 		.name     = "flash morph",
 		.author   = "Dennis Smit <ds@nerds-incorporated.org>",
-		.version  = "0.1",
+		.version  = "0.2",
 		.about    = N_("An flash in and out morph plugin"),
 		.help     = N_("This morph plugin morphs between two video sources using a bright flash"),
 		.license  = VISUAL_PLUGIN_LICENSE_LGPL,
@@ -128,69 +119,6 @@ static void lv_morph_flash_palette (VisPluginData *plugin, float progress, VisAu
 
 static void lv_morph_flash_apply (VisPluginData *plugin, float progress, VisAudio *audio, VisVideo *dest, VisVideo *src1, VisVideo *src2)
 {
-	FlashPrivate *priv = visual_plugin_get_private (plugin);
-
-	switch (visual_video_get_depth (dest)) {
-		case VISUAL_VIDEO_DEPTH_8BIT:
-			flash_8 (priv, progress, dest, src1, src2);
-			break;
-
-		case VISUAL_VIDEO_DEPTH_16BIT:
-
-			break;
-
-		case VISUAL_VIDEO_DEPTH_24BIT:
-			replacetable_generate_24 (priv, progress);
-			flash_24 (priv, progress, dest, src1, src2);
-			break;
-
-		case VISUAL_VIDEO_DEPTH_32BIT:
-			replacetable_generate_24 (priv, progress);
-			flash_24 (priv, progress, dest, src1, src2);
-			break;
-
-		default:
-			break;
-	}
-}
-
-static void replacetable_generate_24 (FlashPrivate *priv, float progress)
-{
-	int i;
-
-	for (i = 0; i < 256; i++) {
-		if (progress < 0.5)
-			priv->replacetable[i] = i + (((255.00 - i) / 100.00) * ((progress * 2) * 100));
-		else
-			priv->replacetable[i] = i + (((255.00 - i) / 100.00) * ((1.0 - ((progress - 0.5) * 2)) * 100));
-	}
-
-}
-
-static void flash_8 (FlashPrivate *priv, float progress, VisVideo *dest, VisVideo *src1, VisVideo *src2)
-{
-	if (progress < 0.5)
-		visual_mem_copy (visual_video_get_pixels (dest), visual_video_get_pixels (src1), visual_video_get_size (src1));
-	else
-		visual_mem_copy (visual_video_get_pixels (dest), visual_video_get_pixels (src2), visual_video_get_size (src2));
-}
-
-static void flash_24 (FlashPrivate *priv, float progress, VisVideo *dest, VisVideo *src1, VisVideo *src2)
-{
-	uint8_t *scrbuf;
-	uint8_t *destbuf = visual_video_get_pixels (dest);
-	int size;
-	int i;
-
-	if (progress < 0.5) {
-		scrbuf = visual_video_get_pixels (src1);
-		size = visual_video_get_size (src1);
-	} else {
-		scrbuf = visual_video_get_pixels (src2);
-		size = visual_video_get_size (src2);
-	}
-
-	for (i = 0; i < size; i++)
-		destbuf[i] = priv->replacetable[scrbuf[i]];
+	/* Indexed video flashes through lv_morph_flash_palette() */
+	visual_morph_kernel_flash (dest, src1, src2, progress);
 }
-
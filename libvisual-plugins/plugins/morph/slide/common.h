@@ -5,18 +5,11 @@
 #include "gettext.h"
 #include <libvisual/libvisual.h>
 
-typedef enum {
-	SLIDE_LEFT,
-	SLIDE_RIGHT,
-	SLIDE_DOWN,
-	SLIDE_UP
-} SlideType;
-
 typedef struct {
-	SlideType slide_type;
+	VisMorphSlideDirection direction;
 } SlidePrivate;
 
-int  lv_morph_slide_init    (VisPluginData *plugin, SlideType type);
+int  lv_morph_slide_init    (VisPluginData *plugin, VisMorphSlideDirection direction);
 void lv_morph_slide_cleanup (VisPluginData *plugin);
 void lv_morph_slide_apply   (VisPluginData *plugin, float progress, VisAudio *audio, VisVideo *dest, VisVideo *src1, VisVideo *src2);
 
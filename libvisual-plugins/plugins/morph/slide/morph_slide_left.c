@@ -35,7 +35,7 @@ const VisPluginInfo *get_plugin_info (void)
         .plugname = "slide_left",
         .name     = "Slide left morph",
         .author   = "Dennis Smit <ds@nerds-incorporated.org>",
-        .version  = "0.1",
+        .version  = "0.2",
         .about    = N_("A slide in/out morph plugin"),
         .help     = N_("This morph plugin morphs between two video sources by sliding one in and the other out"),
         .license  = VISUAL_PLUGIN_LICENSE_LGPL,
@@ -50,5 +50,5 @@ const VisPluginInfo *get_plugin_info (void)
 
 static int lv_morph_slide_init_left (VisPluginData *plugin)
 {
-    return lv_morph_slide_init (plugin, SLIDE_LEFT);
+    return lv_morph_slide_init (plugin, VISUAL_MORPH_SLIDE_LEFT);
 }
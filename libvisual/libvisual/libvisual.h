@@ -49,12 +49,14 @@
 #include <libvisual/lv_libvisual.h>
 #include <libvisual/lv_songinfo.h>
 #include <libvisual/lv_morph.h>
+#include <libvisual/lv_morph_kernels.h>
 #include <libvisual/lv_random.h>
 #include <libvisual/lv_rectangle.h>
 #include <libvisual/lv_gl.h>
 #include <libvisual/lv_math.h>
 #include <libvisual/lv_alpha_blend.h>
 #include <libvisual/lv_plugin_registry.h>
+#include <libvisual/lv_profiler.h>
 #include <libvisual/lv_util.h>
 
 #endif /* LV_LIBVISUAL_H */
@@ -24,10 +24,45 @@
 #include "lv_actor.h"
 #include "lv_common.h"
 #include "lv_plugin_registry.h"
+#include "lv_profiler.h"
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace LV {
 
+  namespace {
+
+    // FIXME: Hack to initialize songinfo. It lives in the plugin's
+    // VisActorPlugin, which all instances of the plugin share, so it is
+    // counted by the actors using it and freed with the last of them,
+    // before the plugin can be unloaded.
+    std::mutex                                        songinfo_mutex;
+    std::unordered_map<VisActorPlugin*, unsigned int> songinfo_users;
+
+    void acquire_songinfo (VisActorPlugin* actor_plugin)
+    {
+        std::lock_guard<std::mutex> lock (songinfo_mutex);
+
+        if (songinfo_users[actor_plugin]++ == 0) {
+            actor_plugin->songinfo = new SongInfo {SONG_INFO_TYPE_NULL};
+        }
+    }
+
+    void release_songinfo (VisActorPlugin* actor_plugin)
+    {
+        std::lock_guard<std::mutex> lock (songinfo_mutex);
+
+        if (--songinfo_users[actor_plugin] == 0) {
+            delete actor_plugin->songinfo;
+            actor_plugin->songinfo = nullptr;
+
+            songinfo_users.erase (actor_plugin);
+        }
+    }
+
+  } // anonymous namespace
+
   class Actor::Impl
   {
   public:
@@ -57,7 +92,7 @@ namespace LV {
   Actor::Impl::~Impl ()
   {
       if (plugin) {
-          delete get_actor_plugin ()->songinfo;
+          release_songinfo (get_actor_plugin ());
           visual_plugin_unload (plugin);
       }
   }
@@ -98,8 +133,7 @@ namespace LV {
           throw std::runtime_error {"Failed to load actor plugin"};
       }
 
-      // FIXME: Hack to initialize songinfo
-      m_impl->get_actor_plugin ()->songinfo = new SongInfo {SONG_INFO_TYPE_NULL};
+      acquire_songinfo (m_impl->get_actor_plugin ());
   }
 
   Actor::~Actor ()
@@ -245,6 +279,13 @@ namespace LV {
       auto const& to_convert = m_impl->to_convert;
       auto const& to_scale   = m_impl->to_scale;
 
+      auto name = visual_plugin_get_info (plugin)->plugname;
+
+      auto render = [&] (VideoPtr const& target) {
+          ProfileScope scope {VISUAL_PROFILE_STAGE_RENDER, name};
+          actor_plugin->render (m_impl->plugin, target.get (), const_cast<Audio*> (&audio));
+      };
+
       if (video->get_depth () != VISUAL_VIDEO_DEPTH_GL) {
           auto palette = get_palette ();
 
@@ -257,16 +298,23 @@ namespace LV {
               }
 
               // Render first
-              actor_plugin->render (m_impl->plugin, to_convert.get (), const_cast<Audio*> (&audio));
+              to_convert->clear_damage ();
+              render (to_convert);
+
+              ProfileScope scope {VISUAL_PROFILE_STAGE_CONVERT, name};
 
               if (to_scale) {
                   // Convert depth, then scale
                   to_scale->convert_depth (to_convert);
+                  to_scale->copy_damage (to_convert);
+
                   video->scale (to_scale, VISUAL_VIDEO_SCALE_NEAREST);
+                  video->copy_damage (to_scale);
               }
               else {
                   // Convert depth only
                   video->convert_depth (to_convert);
+                  video->copy_damage (to_convert);
               }
           } else {
               // No depth conversion
@@ -278,8 +326,12 @@ namespace LV {
                   }
 
                   // Render, then scale
-                  actor_plugin->render (m_impl->plugin, to_scale.get (), const_cast<Audio*> (&audio));
+                  to_scale->clear_damage ();
+                  render (to_scale);
+
+                  ProfileScope scope {VISUAL_PROFILE_STAGE_CONVERT, name};
                   video->scale (to_scale, VISUAL_VIDEO_SCALE_NEAREST);
+                  video->copy_damage (to_scale);
               } else {
                   // Setup any palette
                   if (palette) {
@@ -287,12 +339,13 @@ namespace LV {
                   }
 
                   // Render directly to video target
-                  actor_plugin->render (m_impl->plugin, video.get (), const_cast<Audio*> (&audio));
+                  video->clear_damage ();
+                  render (video);
               }
           }
       } else {
           // Render directly to video target (OpenGL)
-          actor_plugin->render (m_impl->plugin, video.get (), const_cast<Audio*> (&audio));
+          render (video);
       }
   }
 
@@ -0,0 +1,63 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_alpha_blend.h"
+#include "lv_common.h"
+#include "private/lv_video_blend.hpp"
+
+void visual_alpha_blend_8 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha)
+{
+    LV::VideoBlend::get ().blend_bytes (dest, src1, src2, size, alpha);
+}
+
+void visual_alpha_blend_16 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha)
+{
+    LV::VideoBlend::get ().blend_rgb565 (reinterpret_cast<uint16_t*> (dest),
+                                         reinterpret_cast<uint16_t const*> (src1),
+                                         reinterpret_cast<uint16_t const*> (src2),
+                                         size / 2, alpha);
+}
+
+void visual_alpha_blend_24 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha)
+{
+    LV::VideoBlend::get ().blend_bytes (dest, src1, src2, size * 3, alpha);
+}
+
+void visual_alpha_blend_32 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha)
+{
+    LV::VideoBlend::get ().blend_bytes (dest, src1, src2, size * 4, alpha);
+}
+
+const char *visual_alpha_blend_get_variant (void)
+{
+    return LV::VideoBlend::get ().name;
+}
+
+const char *visual_alpha_blend_get_variant_name (unsigned int index)
+{
+    return LV::VideoBlend::get_variant_name (index);
+}
+
+int visual_alpha_blend_set_variant (const char *name)
+{
+    visual_return_val_if_fail (name != NULL, FALSE);
+
+    return LV::VideoBlend::select (name);
+}
@@ -12,6 +12,31 @@ LV_API void visual_alpha_blend_16 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_
 LV_API void visual_alpha_blend_24 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha);
 LV_API void visual_alpha_blend_32 (uint8_t *LV_RESTRICT dest, const uint8_t *LV_RESTRICT src1, const uint8_t *LV_RESTRICT src2, visual_size_t size, uint8_t alpha);
 
+/**
+ * Returns the name of the kernel variant used for alpha blending and
+ * blitting, such as "c", "sse2" or "avx2".
+ */
+LV_API const char *visual_alpha_blend_get_variant (void);
+
+/**
+ * Returns the name of the nth variant this CPU supports, slowest first.
+ *
+ * @param index index of the variant
+ *
+ * @return name of the variant, or NULL past the last one
+ */
+LV_API const char *visual_alpha_blend_get_variant_name (unsigned int index);
+
+/**
+ * Switches alpha blending and blitting to another variant. The fastest one
+ * is picked by visual_init(); this is meant for testing and benchmarking.
+ *
+ * @param name name of the variant
+ *
+ * @return TRUE on success, FALSE if this CPU does not support it
+ */
+LV_API int visual_alpha_blend_set_variant (const char *name);
+
 LV_END_DECLS
 
 #endif /* _LV_ALPHA_BLEND_H */
@@ -23,20 +23,27 @@
 
 #include "config.h"
 #include "lv_audio.h"
+#include "private/lv_audio_analyser.hpp"
 #include "private/lv_audio_convert.hpp"
+#include "private/lv_audio_resampler.hpp"
+#include "private/lv_audio_stft.hpp"
 #include "private/lv_audio_stream.hpp"
 #include "lv_common.h"
 #include "lv_fourier.h"
 #include "lv_math.h"
 #include "lv_time.h"
 #include "lv_util.hpp"
+#include <algorithm>
 #include <cstdarg>
+#include <cstdint>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
 namespace LV {
 
   class AudioChannel;
+  class AudioChannelSTFT;
 
   typedef std::unique_ptr<AudioChannel> AudioChannelPtr;
 
@@ -45,12 +52,53 @@ namespace LV {
   public:
 
       typedef std::unordered_map<std::string, AudioChannelPtr> ChannelList;
+      typedef std::unordered_map<std::string, std::string> AliasList;
 
-      ChannelList channels;
+      ChannelList             channels;
+      AliasList               aliases;
+      VisAudioSampleRateType  rate;
+      VisAudioResampleQuality resample_quality;
+      AudioAnalyser           analyser;
 
-      void upload_to_channel (std::string const& name, BufferConstPtr const& samples, Time const& timestamp);
+      // Guards the state queries update lazily (the analyser and the
+      // channel transforms), as actors may query concurrently
+      std::mutex              analysis_mutex;
+
+      // Ring of recent capture-to-render latencies, in milliseconds
+      std::vector<float>      latencies;
+      unsigned int            latency_count;
+
+      Impl ();
+
+      void upload_to_channel (std::string const& name,
+                              BufferConstPtr const& samples,
+                              VisAudioSampleRateType samples_rate,
+                              Time const& timestamp);
+
+      // Uploads float samples from a buffer the caller keeps. They are
+      // only copied when the resampler does not already write them out.
+      void upload_borrowed_to_channel (std::string const& name,
+                                       BufferConstPtr const& samples,
+                                       VisAudioSampleRateType samples_rate,
+                                       Time const& timestamp);
 
       AudioChannel* get_channel (std::string const& name) const;
+
+      // Makes a channel name refer to the samples of another channel
+      void alias_channel (std::string const& name, std::string const& target);
+
+      void reset_resamplers ();
+
+      // Brings a channel's short-time Fourier transform up to its latest
+      // complete hop
+      AudioChannelSTFT& update_stft (AudioChannel& channel,
+                                     unsigned int frame_size,
+                                     unsigned int hop_size,
+                                     VisAudioWindowType window);
+
+  private:
+
+      BufferConstPtr resample (AudioChannel& channel, BufferConstPtr const& samples, VisAudioSampleRateType samples_rate);
   };
 
   class AudioChannel
@@ -60,6 +108,15 @@ namespace LV {
       std::string name;
       AudioStream stream;
 
+      // Converts input to the stream rate, created on first use
+      std::unique_ptr<AudioResampler> resampler;
+
+      // Number of samples written to the stream so far
+      std::uint64_t samples_written;
+
+      // Transforms asked for so far, kept for reuse across queries
+      std::vector<std::unique_ptr<AudioChannelSTFT>> transforms;
+
       explicit AudioChannel (std::string const& name);
 
       ~AudioChannel ();
@@ -68,11 +125,68 @@ namespace LV {
       AudioChannel (AudioChannel const&) = delete;
       AudioChannel& operator= (AudioChannel const&) = delete;
 
-      void add_samples (BufferConstPtr const& samples, Time const& timestamp);
+      void add_samples (BufferConstPtr const& samples, Time const& timestamp, unsigned int rate);
+
+      AudioChannelSTFT& get_stft (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window);
+  };
+
+  class AudioChannelSTFT
+  {
+  public:
+
+      AudioSTFT          stft;
+      VisAudioWindowType window;
+
+      // Sample count at the end of the last frame transformed
+      std::uint64_t frame_end;
+
+      // Holds a frame and the samples that arrived after it
+      BufferPtr samples;
+
+      std::vector<AudioBandMatrix> band_matrices;
+
+      AudioChannelSTFT (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window);
+
+      AudioBandMatrix const& get_band_matrix (VisAudioBandScale scale,
+                                              unsigned int band_count,
+                                              float min_freq,
+                                              float max_freq,
+                                              unsigned int rate);
   };
 
   namespace {
 
+    // Band matrices kept per transform. Callers rarely ask for more than
+    // one or two layouts.
+    unsigned int const max_band_matrices = 4;
+
+    // Number of frames latency statistics are kept for
+    unsigned int const max_latencies = 512;
+
+    // Returns the capture time of input, estimating it if not given
+    Time get_capture_time (Time const& capture_time, std::size_t frame_count, VisAudioSampleRateType rate)
+    {
+        if (capture_time != Time ())
+            return capture_time;
+
+        auto now = Time::now ();
+
+        auto length = visual_audio_sample_rate_get_length (rate);
+        if (length == 0)
+            return now;
+
+        // The samples have only just arrived, so the first was captured
+        // their duration ago
+        return now - Time::from_usecs (frame_count * VISUAL_USECS_PER_SEC / length);
+    }
+
+    // Allocates a buffer without clearing it, for samples that are about to
+    // be written over entirely
+    BufferPtr create_sample_buffer (std::size_t size)
+    {
+        return Buffer::wrap (visual_mem_malloc (size), size, true);
+    }
+
     void sample_buffer_mix (BufferPtr const& dest, BufferPtr const& src, float multiplier)
     {
         visual_return_if_fail (dest->get_size () == src->get_size ());
@@ -88,23 +202,166 @@ namespace LV {
 
   } // anonymous
 
-  void Audio::Impl::upload_to_channel (std::string const& name, BufferConstPtr const& samples, Time const& timestamp)
+  Audio::Impl::Impl ()
+      : rate             (VISUAL_AUDIO_SAMPLE_RATE_44100)
+      , resample_quality (VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH)
+      , analyser         (visual_audio_sample_rate_get_length (rate))
+      , latencies        (max_latencies)
+      , latency_count    (0)
+  {
+      // empty
+  }
+
+  void Audio::Impl::upload_to_channel (std::string const& name,
+                                       BufferConstPtr const& samples,
+                                       VisAudioSampleRateType samples_rate,
+                                       Time const& timestamp)
   {
-      if (!get_channel (name)) {
+      // Samples of its own replace any alias
+      aliases.erase (name);
+
+      if (!channels.count (name)) {
           channels[name] = make_unique<AudioChannel> (name);
       }
 
-      channels[name]->add_samples (samples, timestamp);
+      auto& channel = *channels[name];
+
+      auto stream_samples = resample (channel, samples, samples_rate);
+
+      // The resampler's delay of a few samples is not accounted for
+      channel.add_samples (stream_samples, timestamp, visual_audio_sample_rate_get_length (rate));
+
+      // Feed the left and right channels to the analyser
+      if (name == VISUAL_AUDIO_CHANNEL_LEFT || name == VISUAL_AUDIO_CHANNEL_RIGHT) {
+          unsigned int index = name == VISUAL_AUDIO_CHANNEL_RIGHT;
+
+          if (index == 1)
+              analyser.set_channel_count (2);
+
+          analyser.write (index,
+                          static_cast<float const*> (stream_samples->get_data ()),
+                          stream_samples->get_size () / sizeof (float));
+      }
+  }
+
+  void Audio::Impl::upload_borrowed_to_channel (std::string const& name,
+                                                BufferConstPtr const& samples,
+                                                VisAudioSampleRateType samples_rate,
+                                                Time const& timestamp)
+  {
+      if (samples_rate == rate || samples_rate == VISUAL_AUDIO_SAMPLE_RATE_NONE) {
+          // The stream holds on to what it is given
+          auto copy = create_sample_buffer (samples->get_size ());
+          copy->put (samples, 0);
+
+          upload_to_channel (name, copy, samples_rate, timestamp);
+      } else {
+          upload_to_channel (name, samples, samples_rate, timestamp);
+      }
+  }
+
+  BufferConstPtr Audio::Impl::resample (AudioChannel& channel, BufferConstPtr const& samples, VisAudioSampleRateType samples_rate)
+  {
+      // Samples of unknown rate are taken to be at the stream rate
+      if (samples_rate == rate || samples_rate == VISUAL_AUDIO_SAMPLE_RATE_NONE) {
+          channel.resampler.reset ();
+          return samples;
+      }
+
+      auto in_rate = visual_audio_sample_rate_get_length (samples_rate);
+
+      if (!channel.resampler
+          || channel.resampler->get_in_rate () != in_rate
+          || channel.resampler->get_quality () != resample_quality) {
+          channel.resampler.reset (new AudioResampler (in_rate, visual_audio_sample_rate_get_length (rate), resample_quality));
+      }
+
+      std::size_t count = samples->get_size () / sizeof (float);
+
+      auto resampled = create_sample_buffer (channel.resampler->get_max_output (count) * sizeof (float));
+
+      count = channel.resampler->process (static_cast<float*> (resampled->get_data ()),
+                                          static_cast<float const*> (samples->get_data ()),
+                                          count);
+
+      resampled->set_size (count * sizeof (float));
+
+      return resampled;
+  }
+
+  void Audio::Impl::reset_resamplers ()
+  {
+      for (auto& entry : channels) {
+          entry.second->resampler.reset ();
+      }
+  }
+
+  AudioChannelSTFT& Audio::Impl::update_stft (AudioChannel& channel,
+                                              unsigned int frame_size,
+                                              unsigned int hop_size,
+                                              VisAudioWindowType window)
+  {
+      auto& transform = channel.get_stft (frame_size, hop_size, window);
+
+      hop_size = transform.stft.get_hop_size ();
+
+      auto written   = channel.samples_written;
+      auto frame_end = written - written % hop_size;
+
+      // Nothing to do until another hop has arrived
+      if (frame_end == transform.frame_end)
+          return transform;
+
+      // After a single hop, only the new samples need to be read and slid
+      // in. Otherwise the frame is read whole.
+      bool single_hop = frame_end - transform.frame_end == hop_size;
+
+      std::size_t lag   = written - frame_end;
+      std::size_t count = (single_hop ? hop_size : frame_size) + lag;
+
+      // Align what the stream holds to the end, leaving silence in front
+      // of the first samples
+      std::size_t available = channel.stream.get_size () / sizeof (float);
+      std::size_t offset = count - std::min (count, available);
+
+      auto data = static_cast<float*> (transform.samples->get_data ());
+      std::fill_n (data, offset, 0.0f);
+
+      if (offset < count) {
+          auto tail = Buffer::wrap (data + offset, (count - offset) * sizeof (float), false);
+          channel.stream.read (tail, tail->get_size ());
+      }
+
+      if (single_hop)
+          transform.stft.push (data);
+      else
+          transform.stft.transform (data);
+
+      transform.frame_end = frame_end;
+
+      return transform;
   }
 
   AudioChannel* Audio::Impl::get_channel (std::string const& name) const
   {
-      auto entry = channels.find (name);
+      auto alias = aliases.find (name);
+
+      auto entry = channels.find (alias != aliases.end () ? alias->second : name);
       return entry != channels.end () ? entry->second.get () : nullptr;
   }
 
+  void Audio::Impl::alias_channel (std::string const& name, std::string const& target)
+  {
+      channels.erase (name);
+      aliases[name] = target;
+
+      if (name == VISUAL_AUDIO_CHANNEL_RIGHT)
+          analyser.set_channel_count (1);
+  }
+
   AudioChannel::AudioChannel (std::string const& name_)
-      : name (name_)
+      : name            (name_)
+      , samples_written (0)
   {}
 
   AudioChannel::~AudioChannel ()
@@ -112,9 +369,52 @@ namespace LV {
       // empty
   }
 
-  void AudioChannel::add_samples (BufferConstPtr const& samples, Time const& timestamp)
+  void AudioChannel::add_samples (BufferConstPtr const& samples, Time const& timestamp, unsigned int rate)
+  {
+      stream.write (samples, timestamp, rate);
+
+      samples_written += samples->get_size () / sizeof (float);
+  }
+
+  AudioChannelSTFT& AudioChannel::get_stft (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window)
+  {
+      for (auto& transform : transforms) {
+          if (transform->stft.get_frame_size () == frame_size
+              && transform->stft.get_hop_size () == hop_size
+              && transform->window == window) {
+              return *transform;
+          }
+      }
+
+      transforms.emplace_back (new AudioChannelSTFT (frame_size, hop_size, window));
+
+      return *transforms.back ();
+  }
+
+  AudioChannelSTFT::AudioChannelSTFT (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window_)
+      : stft      (frame_size, hop_size, window_)
+      , window    (window_)
+      , frame_end (0)
+      , samples   (Buffer::create ((frame_size + stft.get_hop_size ()) * sizeof (float)))
+  {}
+
+  AudioBandMatrix const& AudioChannelSTFT::get_band_matrix (VisAudioBandScale scale,
+                                                            unsigned int band_count,
+                                                            float min_freq,
+                                                            float max_freq,
+                                                            unsigned int rate)
   {
-      stream.write (samples, timestamp);
+      for (auto const& matrix : band_matrices) {
+          if (matrix.matches (scale, band_count, min_freq, max_freq))
+              return matrix;
+      }
+
+      if (band_matrices.size () >= max_band_matrices)
+          band_matrices.erase (band_matrices.begin ());
+
+      band_matrices.emplace_back (scale, band_count, min_freq, max_freq, stft.get_spectrum_size (), rate);
+
+      return band_matrices.back ();
   }
 
   Audio::Audio ()
@@ -140,6 +440,75 @@ namespace LV {
       return *this;
   }
 
+  void Audio::set_sample_rate (VisAudioSampleRateType rate)
+  {
+      visual_return_if_fail (rate > VISUAL_AUDIO_SAMPLE_RATE_NONE && rate < VISUAL_AUDIO_SAMPLE_RATE_LAST);
+
+      m_impl->rate = rate;
+      m_impl->reset_resamplers ();
+
+      // Band layouts depend on the rate
+      for (auto& entry : m_impl->channels) {
+          entry.second->transforms.clear ();
+      }
+
+      m_impl->analyser.reset (visual_audio_sample_rate_get_length (rate));
+  }
+
+  VisAudioSampleRateType Audio::get_sample_rate () const
+  {
+      return m_impl->rate;
+  }
+
+  void Audio::set_resample_quality (VisAudioResampleQuality quality)
+  {
+      m_impl->resample_quality = quality;
+      m_impl->reset_resamplers ();
+  }
+
+  VisAudioResampleQuality Audio::get_resample_quality () const
+  {
+      return m_impl->resample_quality;
+  }
+
+  unsigned int Audio::get_onset_count () const
+  {
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      m_impl->analyser.update ();
+
+      return m_impl->analyser.get_onset_count ();
+  }
+
+  float Audio::get_onset_strength () const
+  {
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      m_impl->analyser.update ();
+
+      return m_impl->analyser.get_onset_strength ();
+  }
+
+  float Audio::get_tempo () const
+  {
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      m_impl->analyser.update ();
+
+      return m_impl->analyser.get_tempo ();
+  }
+
+  float Audio::get_band_energy (unsigned int band) const
+  {
+      visual_return_val_if_fail (band < VISUAL_AUDIO_ANALYSIS_BAND_COUNT, 0.0f);
+
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      m_impl->analyser.update ();
+
+      return m_impl->analyser.get_band_energy (band);
+  }
+
   bool Audio::get_sample (BufferPtr const& buffer, std::string const& channel_name)
   {
       auto channel = m_impl->get_channel (channel_name);
@@ -154,6 +523,75 @@ namespace LV {
       return true;
   }
 
+  bool Audio::get_sample_at (BufferPtr const& buffer, std::string const& channel_name, Time const& time)
+  {
+      auto channel = m_impl->get_channel (channel_name);
+
+      if (!channel) {
+          buffer->fill (0);
+          return false;
+      }
+
+      // Nothing was captured by then
+      if (channel->stream.read_at (buffer, buffer->get_size (), time) == 0)
+          buffer->fill (0);
+
+      return true;
+  }
+
+  Time Audio::get_end_time (std::string const& channel_name) const
+  {
+      auto channel = m_impl->get_channel (channel_name);
+
+      return channel ? channel->stream.get_end_time () : Time ();
+  }
+
+  void Audio::record_latency ()
+  {
+      Time end;
+
+      for (auto const& entry : m_impl->channels) {
+          auto channel_end = entry.second->stream.get_end_time ();
+
+          if (channel_end > end)
+              end = channel_end;
+      }
+
+      if (end == Time ())
+          return;
+
+      auto latency = (Time::now ().to_secs () - end.to_secs ()) * 1000.0;
+
+      auto& latencies = m_impl->latencies;
+      latencies[m_impl->latency_count % latencies.size ()] = latency;
+      m_impl->latency_count++;
+  }
+
+  VisAudioLatencyStats Audio::get_latency_stats () const
+  {
+      VisAudioLatencyStats stats {};
+
+      auto count = std::min (std::size_t (m_impl->latency_count), m_impl->latencies.size ());
+      if (count == 0)
+          return stats;
+
+      std::vector<float> sorted (m_impl->latencies.begin (), m_impl->latencies.begin () + count);
+      std::sort (sorted.begin (), sorted.end ());
+
+      auto percentile = [&] (float p) {
+          return sorted[std::min (count - 1, std::size_t (p * count))];
+      };
+
+      stats.count  = count;
+      stats.min    = sorted.front ();
+      stats.median = percentile (0.5f);
+      stats.p90    = percentile (0.9f);
+      stats.p99    = percentile (0.99f);
+      stats.max    = sorted.back ();
+
+      return stats;
+  }
+
   void Audio::get_sample_mixed_simple (BufferPtr const& buffer, unsigned int channels, ...)
   {
       va_list args;
@@ -240,17 +678,87 @@ namespace LV {
       visual_math_simd_mul_floats_float (data, data, multiplier, datasize);
   }
 
+  void Audio::get_spectrum_stft (BufferPtr const&   buffer,
+                                 std::string const& channel_name,
+                                 unsigned int       frame_size,
+                                 unsigned int       hop_size,
+                                 VisAudioWindowType window,
+                                 bool               normalised)
+  {
+      visual_return_if_fail (frame_size >= 2);
+
+      auto channel = m_impl->get_channel (channel_name);
+
+      if (!channel) {
+          buffer->fill (0);
+          return;
+      }
+
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      auto& transform = m_impl->update_stft (*channel, frame_size, hop_size, window);
+
+      std::size_t size = std::min (std::size_t (transform.stft.get_spectrum_size ()),
+                                   buffer->get_size () / sizeof (float));
+
+      auto data = static_cast<float*> (buffer->get_data ());
+
+      if (normalised)
+          DFT::log_scale_standard (data, transform.stft.get_spectrum (), size);
+      else
+          std::copy_n (transform.stft.get_spectrum (), size, data);
+
+      std::fill (data + size, data + buffer->get_size () / sizeof (float), 0.0f);
+  }
+
+  void Audio::get_spectrum_bands (BufferPtr const&   buffer,
+                                  std::string const& channel_name,
+                                  unsigned int       frame_size,
+                                  unsigned int       hop_size,
+                                  VisAudioWindowType window,
+                                  VisAudioBandScale  scale,
+                                  float              min_freq,
+                                  float              max_freq,
+                                  bool               normalised)
+  {
+      visual_return_if_fail (frame_size >= 2);
+      visual_return_if_fail (min_freq < max_freq);
+
+      auto channel = m_impl->get_channel (channel_name);
+
+      if (!channel) {
+          buffer->fill (0);
+          return;
+      }
+
+      std::lock_guard<std::mutex> lock (m_impl->analysis_mutex);
+
+      auto& transform = m_impl->update_stft (*channel, frame_size, hop_size, window);
+
+      unsigned int band_count = buffer->get_size () / sizeof (float);
+
+      auto const& matrix = transform.get_band_matrix (scale, band_count, min_freq, max_freq,
+                                                      visual_audio_sample_rate_get_length (m_impl->rate));
+
+      matrix.apply (static_cast<float*> (buffer->get_data ()), transform.stft.get_spectrum ());
+
+      if (normalised)
+          normalise_spectrum (buffer);
+  }
+
   void Audio::get_spectrum_for_sample (BufferPtr const& buffer, BufferConstPtr const& sample, bool normalised)
   {
       DFT dft (buffer->get_size () / sizeof (float),
                sample->get_size () / sizeof (float));
 
       // Fourier analyze the pcm data
-      dft.perform (static_cast<float*> (buffer->get_data ()),
-                   static_cast<float*> (sample->get_data ()));
-
-      if (normalised)
-          normalise_spectrum (buffer);
+      if (normalised) {
+          dft.perform_log_scaled (static_cast<float*> (buffer->get_data ()),
+                                  static_cast<float*> (sample->get_data ()));
+      } else {
+          dft.perform (static_cast<float*> (buffer->get_data ()),
+                       static_cast<float*> (sample->get_data ()));
+      }
   }
 
   void Audio::get_spectrum_for_sample (BufferPtr const& buffer, BufferConstPtr const& sample, bool normalised, float multiplier)
@@ -273,33 +781,22 @@ namespace LV {
   void Audio::input (BufferPtr const&          buffer,
                      VisAudioSampleRateType    rate,
                      VisAudioSampleFormatType  format,
-                     VisAudioSampleChannelType channeltype)
+                     VisAudioSampleChannelType channeltype,
+                     Time const&               capture_time)
   {
-      auto timestamp = Time::now ();
-
-      auto sample_count = buffer->get_size () / visual_audio_sample_format_get_size (format);
-
-      auto converted_buffer = Buffer::create (sample_count * sizeof (float));
-
-      AudioConvert::convert_samples (converted_buffer,
-                                     VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT,
-                                     buffer,
-                                     format);
-
       switch (channeltype) {
+          case VISUAL_AUDIO_SAMPLE_CHANNEL_MONO: {
+              // Store the samples once and let the right channel share them
+              input (buffer, rate, format, VISUAL_AUDIO_CHANNEL_LEFT, capture_time);
+              m_impl->alias_channel (VISUAL_AUDIO_CHANNEL_RIGHT, VISUAL_AUDIO_CHANNEL_LEFT);
+              return;
+          }
           case VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO: {
-              auto samples1 = Buffer::create (sample_count/2 * sizeof (float));
-              auto samples2 = Buffer::create (sample_count/2 * sizeof (float));
-
-              AudioConvert::deinterleave_stereo_samples (samples1, samples2, converted_buffer, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT);
-
-              m_impl->upload_to_channel (VISUAL_AUDIO_CHANNEL_LEFT, samples1, timestamp);
-              m_impl->upload_to_channel (VISUAL_AUDIO_CHANNEL_RIGHT, samples2, timestamp);
-
+              input_interleaved (buffer, rate, format, { VISUAL_AUDIO_CHANNEL_LEFT, VISUAL_AUDIO_CHANNEL_RIGHT }, capture_time);
               return;
           }
           default: {
-              visual_log (VISUAL_LOG_CRITICAL, "Only stereo input is currently supported");
+              visual_log (VISUAL_LOG_CRITICAL, "Unsupported channel type");
               return;
           }
       }
@@ -308,20 +805,91 @@ namespace LV {
   void Audio::input (BufferPtr const&         buffer,
                      VisAudioSampleRateType   rate,
                      VisAudioSampleFormatType format,
-                     std::string const&       channel_name)
+                     std::string const&       channel_name,
+                     Time const&              capture_time)
   {
-      auto timestamp = Time::now ();
-
       auto sample_count = buffer->get_size () / visual_audio_sample_format_get_size (format);
 
-      auto converted_buffer = Buffer::create (sample_count * sizeof (float));
+      auto timestamp = get_capture_time (capture_time, sample_count, rate);
+
+      if (format == VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT) {
+          m_impl->upload_borrowed_to_channel (channel_name, buffer, rate, timestamp);
+          return;
+      }
+
+      auto converted_buffer = create_sample_buffer (sample_count * sizeof (float));
 
       AudioConvert::convert_samples (converted_buffer,
                                      VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT,
                                      buffer,
                                      format);
 
-      m_impl->upload_to_channel (channel_name, converted_buffer, timestamp);
+      m_impl->upload_to_channel (channel_name, converted_buffer, rate, timestamp);
+  }
+
+  void Audio::input_interleaved (BufferConstPtr const&           buffer,
+                                 VisAudioSampleRateType          rate,
+                                 VisAudioSampleFormatType        format,
+                                 std::vector<std::string> const& channel_names,
+                                 Time const&                     capture_time)
+  {
+      visual_return_if_fail (!channel_names.empty ());
+
+      auto channel_count = channel_names.size ();
+      auto frame_count   = buffer->get_size () / (visual_audio_sample_format_get_size (format) * channel_count);
+
+      auto timestamp = get_capture_time (capture_time, frame_count, rate);
+
+      if (channel_count == 2) {
+          // Convert and deinterleave straight into the channel buffers
+          auto samples1 = create_sample_buffer (frame_count * sizeof (float));
+          auto samples2 = create_sample_buffer (frame_count * sizeof (float));
+
+          AudioConvert::convert_deinterleave_stereo_samples (samples1, samples2, buffer, format);
+
+          m_impl->upload_to_channel (channel_names[0], samples1, rate, timestamp);
+          m_impl->upload_to_channel (channel_names[1], samples2, rate, timestamp);
+
+          return;
+      }
+
+      for (unsigned int i = 0; i < channel_count; i++) {
+          auto samples = create_sample_buffer (frame_count * sizeof (float));
+
+          AudioConvert::convert_channel_samples (samples, buffer, format, i, channel_count);
+
+          m_impl->upload_to_channel (channel_names[i], samples, rate, timestamp);
+      }
+  }
+
+  void Audio::input_planar (std::vector<BufferPtr> const&   buffers,
+                            VisAudioSampleRateType          rate,
+                            VisAudioSampleFormatType        format,
+                            std::vector<std::string> const& channel_names,
+                            Time const&                     capture_time)
+  {
+      visual_return_if_fail (buffers.size () == channel_names.size ());
+
+      if (buffers.empty ())
+          return;
+
+      // Stamp every channel alike
+      auto frame_count = buffers[0]->get_size () / visual_audio_sample_format_get_size (format);
+      auto timestamp   = get_capture_time (capture_time, frame_count, rate);
+
+      for (unsigned int i = 0; i < buffers.size (); i++) {
+          if (format == VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT) {
+              m_impl->upload_borrowed_to_channel (channel_names[i], buffers[i], rate, timestamp);
+              continue;
+          }
+
+          auto sample_count = buffers[i]->get_size () / visual_audio_sample_format_get_size (format);
+          auto samples      = create_sample_buffer (sample_count * sizeof (float));
+
+          AudioConvert::convert_samples (samples, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, buffers[i], format);
+
+          m_impl->upload_to_channel (channel_names[i], samples, rate, timestamp);
+      }
   }
 
 } // LV namespace
@@ -338,12 +906,29 @@ visual_size_t visual_audio_sample_rate_get_length (VisAudioSampleRateType rate)
         32000,  // VISUAL_AUDIO_SAMPLE_RATE_32000
         44100,  // VISUAL_AUDIO_SAMPLE_RATE_44100
         48000,  // VISUAL_AUDIO_SAMPLE_RATE_48000
-        96000   // VISUAL_AUDIO_SAMPLE_RATE_96000
+        96000,  // VISUAL_AUDIO_SAMPLE_RATE_96000
+        11025,  // VISUAL_AUDIO_SAMPLE_RATE_11025
+        22050,  // VISUAL_AUDIO_SAMPLE_RATE_22050
+        88200,  // VISUAL_AUDIO_SAMPLE_RATE_88200
+        176400, // VISUAL_AUDIO_SAMPLE_RATE_176400
+        192000  // VISUAL_AUDIO_SAMPLE_RATE_192000
     };
 
     return ratelengthtable[rate];
 }
 
+VisAudioSampleRateType visual_audio_sample_rate_from_length (visual_size_t length)
+{
+    for (int i = VISUAL_AUDIO_SAMPLE_RATE_NONE + 1; i < VISUAL_AUDIO_SAMPLE_RATE_LAST; i++) {
+        auto rate = VisAudioSampleRateType (i);
+
+        if (visual_audio_sample_rate_get_length (rate) == length)
+            return rate;
+    }
+
+    return VISUAL_AUDIO_SAMPLE_RATE_NONE;
+}
+
 visual_size_t visual_audio_sample_format_get_size (VisAudioSampleFormatType format)
 {
     visual_return_val_if_fail (format < VISUAL_AUDIO_SAMPLE_FORMAT_LAST, 0);
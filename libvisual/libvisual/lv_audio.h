@@ -25,6 +25,7 @@
 #define _LV_AUDIO_H
 
 #include <libvisual/lv_buffer.h>
+#include <libvisual/lv_time.h>
 
 /**
  * @defgroup VisAudio VisAudio
@@ -34,6 +35,13 @@
 #define VISUAL_AUDIO_CHANNEL_LEFT  "left"
 #define VISUAL_AUDIO_CHANNEL_RIGHT "right"
 
+/**
+ * Number of frequency bands the stream is analysed in. Their upper edges
+ * are 60, 150, 400, 1000, 2500, 6000 and 12000 Hz, the last band runs up
+ * to the Nyquist frequency.
+ */
+#define VISUAL_AUDIO_ANALYSIS_BAND_COUNT 8
+
 typedef enum {
     VISUAL_AUDIO_SAMPLE_RATE_NONE = 0,
     VISUAL_AUDIO_SAMPLE_RATE_8000,
@@ -43,6 +51,11 @@ typedef enum {
     VISUAL_AUDIO_SAMPLE_RATE_44100,
     VISUAL_AUDIO_SAMPLE_RATE_48000,
     VISUAL_AUDIO_SAMPLE_RATE_96000,
+    VISUAL_AUDIO_SAMPLE_RATE_11025,
+    VISUAL_AUDIO_SAMPLE_RATE_22050,
+    VISUAL_AUDIO_SAMPLE_RATE_88200,
+    VISUAL_AUDIO_SAMPLE_RATE_176400,
+    VISUAL_AUDIO_SAMPLE_RATE_192000,
     VISUAL_AUDIO_SAMPLE_RATE_LAST
 } VisAudioSampleRateType;
 
@@ -60,13 +73,53 @@ typedef enum {
 
 typedef enum {
     VISUAL_AUDIO_SAMPLE_CHANNEL_NONE = 0,
-    VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO
+    VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO,
+    VISUAL_AUDIO_SAMPLE_CHANNEL_MONO
 } VisAudioSampleChannelType;
 
+/**
+ * Quality of the sample rate conversion done on input.
+ */
+typedef enum {
+    VISUAL_AUDIO_RESAMPLE_QUALITY_LOW = 0, /**< Linear interpolation, for slow targets */
+    VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH     /**< Windowed sinc filter */
+} VisAudioResampleQuality;
+
+/**
+ * Window applied to each frame of a short-time Fourier transform.
+ */
+typedef enum {
+    VISUAL_AUDIO_WINDOW_RECTANGULAR = 0, /**< No windowing */
+    VISUAL_AUDIO_WINDOW_HANN,            /**< Hann window */
+    VISUAL_AUDIO_WINDOW_BLACKMAN         /**< Blackman window, lower leakage and wider peaks than Hann */
+} VisAudioWindowType;
+
+/**
+ * Frequency scale spectrum bands are equally spaced on.
+ */
+typedef enum {
+    VISUAL_AUDIO_BAND_SCALE_LOG = 0, /**< Logarithmic, equal width in octaves */
+    VISUAL_AUDIO_BAND_SCALE_BARK,    /**< Bark critical band scale */
+    VISUAL_AUDIO_BAND_SCALE_MEL      /**< Mel scale */
+} VisAudioBandScale;
+
+/**
+ * Capture-to-render latency over recently rendered frames, in milliseconds.
+ */
+typedef struct {
+    unsigned int count;  /**< number of frames measured */
+    float        min;
+    float        median;
+    float        p90;    /**< 90th percentile */
+    float        p99;    /**< 99th percentile */
+    float        max;
+} VisAudioLatencyStats;
+
 #ifdef __cplusplus
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <cstdarg>
 
 namespace LV {
@@ -74,7 +127,8 @@ namespace LV {
   /**
    * Multi-channel audio stream class.
    *
-   * @note Samples are stored as 32-bit floating point PCM at 44.1kHz.
+   * @note Samples are stored as 32-bit floating point PCM at the stream's
+   *       sample rate, 44.1kHz by default. Input at other rates is resampled.
    */
   class LV_API Audio
   {
@@ -157,6 +211,60 @@ namespace LV {
 
       void get_spectrum (BufferPtr const& buffer, std::size_t sample_count, std::string const& channel_name, bool normalised, float multiplier);
 
+      /**
+       * Returns the amplitude spectrum of the latest frame of a short-time
+       * Fourier transform of a channel.
+       *
+       * Frames overlap and start every hop_size samples. A frame is only
+       * transformed once, so asking again before another hop of samples
+       * has arrived returns the same spectrum without another transform.
+       *
+       * @note The output spectrum will be truncated to fit the user-supplied buffer.
+       *
+       * @param[out] buffer  buffer to hold the amplitude spectrum of frame_size / 2 bins (32-bit floats)
+       * @param channel_name name of channel
+       * @param frame_size   number of samples in a frame
+       * @param hop_size     number of samples between the start of two frames, at most frame_size
+       * @param window       window applied to each frame
+       * @param normalised   normalise ampltitudes to [0.0, 1.0]
+       */
+      void get_spectrum_stft (BufferPtr const&   buffer,
+                              std::string const& channel_name,
+                              unsigned int       frame_size,
+                              unsigned int       hop_size,
+                              VisAudioWindowType window,
+                              bool               normalised);
+
+      /**
+       * Returns the amplitude spectrum of the latest frame of a short-time
+       * Fourier transform of a channel, summed into frequency bands.
+       *
+       * There is one band for every float in the buffer. Bands are
+       * overlapping triangular filters whose centres are equally spaced on
+       * the given scale between min_freq and max_freq, and each holds the
+       * weighted average amplitude of the bins it covers. Bands too narrow
+       * to cover a bin take the amplitude of the nearest one.
+       *
+       * @param[out] buffer  buffer to hold the band amplitudes (32-bit floats)
+       * @param channel_name name of channel
+       * @param frame_size   number of samples in a frame
+       * @param hop_size     number of samples between the start of two frames, at most frame_size
+       * @param window       window applied to each frame
+       * @param scale        frequency scale of the bands
+       * @param min_freq     lowest frequency in Hz
+       * @param max_freq     highest frequency in Hz, limited to half the sample rate
+       * @param normalised   normalise ampltitudes to [0.0, 1.0]
+       */
+      void get_spectrum_bands (BufferPtr const&   buffer,
+                               std::string const& channel_name,
+                               unsigned int       frame_size,
+                               unsigned int       hop_size,
+                               VisAudioWindowType window,
+                               VisAudioBandScale  scale,
+                               float              min_freq,
+                               float              max_freq,
+                               bool               normalised);
+
       /**
        * Returns the amplitude spectrum of a set of samples.
        *
@@ -172,18 +280,122 @@ namespace LV {
 
       static void normalise_spectrum (BufferPtr const& buffer);
 
+      /**
+       * Sets the sample rate samples are stored at.
+       *
+       * @note Changing the rate discards the resampling state of every
+       *       channel, but keeps the samples already stored.
+       *
+       * @param rate sample rate
+       */
+      void set_sample_rate (VisAudioSampleRateType rate);
+
+      /**
+       * Returns the sample rate samples are stored at.
+       */
+      VisAudioSampleRateType get_sample_rate () const;
+
+      /**
+       * Sets the quality of the sample rate conversion of input.
+       *
+       * @param quality resampling quality
+       */
+      void set_resample_quality (VisAudioResampleQuality quality);
+
+      /**
+       * Returns the quality of the sample rate conversion of input.
+       */
+      VisAudioResampleQuality get_resample_quality () const;
+
+      /**
+       * Returns the number of onsets (beats) detected in the stream so far.
+       *
+       * The left and right channels are mixed down and analysed once as
+       * input arrives, so this and the other analysis functions are cheap
+       * to call from any number of actors. An onset has occurred when the
+       * count differs from the one last seen.
+       *
+       * @return number of onsets
+       */
+      unsigned int get_onset_count () const;
+
+      /**
+       * Returns the strength of the most recent spectral flux relative to
+       * the onset threshold. Values above 1.0 are over the threshold.
+       */
+      float get_onset_strength () const;
+
+      /**
+       * Returns the estimated tempo of the stream in beats per minute,
+       * between 60 and 180, or 0 if there is no clear tempo.
+       */
+      float get_tempo () const;
+
+      /**
+       * Returns the mean power of a frequency band in the most recently
+       * analysed frame.
+       *
+       * @param band band index, less than VISUAL_AUDIO_ANALYSIS_BAND_COUNT
+       *
+       * @return band energy
+       */
+      float get_band_energy (unsigned int band) const;
+
+      /**
+       * Returns the samples of a channel that end with the one captured at
+       * a given time, for aligning audio with video shown at a later time.
+       *
+       * @note Times past the latest sample give the latest samples.
+       *
+       * @param[out] buffer  buffer to hold the samples (32-bit floating point PCM)
+       * @param channel_name name of channel
+       * @param time         capture time of the last sample wanted
+       *
+       * @return true if the channel exists, false otherwise
+       */
+      bool get_sample_at (BufferPtr const& buffer, std::string const& channel_name, Time const& time);
+
+      /**
+       * Returns the capture time just past the latest sample of a channel.
+       * Its difference from the current time is how old the samples are.
+       *
+       * @param channel_name name of channel
+       *
+       * @return capture time, or zero if the channel has no samples
+       */
+      Time get_end_time (std::string const& channel_name) const;
+
+      /**
+       * Records the current capture-to-render latency: the age of the
+       * latest samples of any channel. Call it once per rendered frame.
+       */
+      void record_latency ();
+
+      /**
+       * Returns percentiles of the latencies recorded over the last 512
+       * frames.
+       */
+      VisAudioLatencyStats get_latency_stats () const;
+
       /**
        * Adds an interleaved set of samples to the stream.
        *
+       * @note Mono samples are stored in the left channel, and the right
+       *       channel is made to refer to them.
+       *
        * @param buffer       buffer containing the input samples
        * @param rate         sampling rate
        * @param format       sample format
        * @param channel_type channel format
+       * @param capture_time time the first sample was captured. If zero, it
+       *                     is taken to be the time of input, less the
+       *                     duration of the samples.
        */
       void input (BufferPtr const& buffer,
                   VisAudioSampleRateType rate,
                   VisAudioSampleFormatType format,
-                  VisAudioSampleChannelType channel_type);
+                  VisAudioSampleChannelType channel_type,
+                  Time const& capture_time = Time ());
 
       /**
        * Adds a set of channel samples to the stream.
@@ -192,11 +404,46 @@ namespace LV {
        * @param rate         sampling rate
        * @param format       sample format
        * @param channel_name name of channel
+       * @param capture_time time the first sample was captured, see above
        */
       void input (BufferPtr const& buffer,
                   VisAudioSampleRateType rate,
                   VisAudioSampleFormatType format,
-                  std::string const& channel_name);
+                  std::string const& channel_name,
+                  Time const& capture_time = Time ());
+
+      /**
+       * Adds an interleaved set of samples with any number of channels to
+       * the stream.
+       *
+       * @param buffer        buffer containing the input samples
+       * @param rate          sampling rate
+       * @param format        sample format
+       * @param channel_names names of the channels, in the order they are
+       *                      interleaved
+       * @param capture_time  time the first sample was captured, see input()
+       */
+      void input_interleaved (BufferConstPtr const& buffer,
+                              VisAudioSampleRateType rate,
+                              VisAudioSampleFormatType format,
+                              std::vector<std::string> const& channel_names,
+                              Time const& capture_time = Time ());
+
+      /**
+       * Adds separate sets of samples for any number of channels to the
+       * stream.
+       *
+       * @param buffers       buffers containing the samples of each channel
+       * @param rate          sampling rate
+       * @param format        sample format
+       * @param channel_names names of the channels, one per buffer
+       * @param capture_time  time the first sample was captured, see input()
+       */
+      void input_planar (std::vector<BufferPtr> const& buffers,
+                         VisAudioSampleRateType rate,
+                         VisAudioSampleFormatType format,
+                         std::vector<std::string> const& channel_names,
+                         Time const& capture_time = Time ());
 
   private:
 
@@ -227,6 +474,13 @@ LV_API void visual_audio_get_sample_mixed (VisAudio *audio, VisBuffer *buffer, i
 
 LV_API void visual_audio_get_spectrum (VisAudio *audio, VisBuffer *buffer, int samplelen, const char *channelid, int normalised);
 LV_API void visual_audio_get_spectrum_multiplied (VisAudio *audio, VisBuffer *buffer, int samplelen, const char *channelid, int normalised, float multiplier);
+LV_API void visual_audio_get_spectrum_stft (VisAudio *audio, VisBuffer *buffer, const char *channelid,
+                                            unsigned int frame_size, unsigned int hop_size,
+                                            VisAudioWindowType window, int normalised);
+LV_API void visual_audio_get_spectrum_bands (VisAudio *audio, VisBuffer *buffer, const char *channelid,
+                                             unsigned int frame_size, unsigned int hop_size,
+                                             VisAudioWindowType window, VisAudioBandScale scale,
+                                             float min_freq, float max_freq, int normalised);
 LV_API void visual_audio_get_spectrum_for_sample (VisBuffer *buffer, VisBuffer *sample, int normalised);
 LV_API void visual_audio_get_spectrum_for_sample_multiplied (VisBuffer *buffer, VisBuffer *sample, int normalised, float multiplier);
 
@@ -236,15 +490,51 @@ LV_API void visual_audio_input (VisAudio *audio,
                                 VisAudioSampleFormatType format,
                                 VisAudioSampleChannelType channeltype);
 
+LV_API void visual_audio_input_with_time (VisAudio *audio,
+                                          VisBuffer *buffer,
+                                          VisAudioSampleRateType rate,
+                                          VisAudioSampleFormatType format,
+                                          VisAudioSampleChannelType channeltype,
+                                          VisTime *capture_time);
+
 LV_API void visual_audio_input_channel (VisAudio *audio,
                                         VisBuffer *buffer,
                                         VisAudioSampleRateType rate,
                                         VisAudioSampleFormatType format,
                                         const char *channelid);
 
+LV_API void visual_audio_input_interleaved (VisAudio *audio,
+                                            VisBuffer *buffer,
+                                            VisAudioSampleRateType rate,
+                                            VisAudioSampleFormatType format,
+                                            unsigned int channels,
+                                            const char **channelids);
+
+LV_API void visual_audio_input_planar (VisAudio *audio,
+                                       VisBuffer **buffers,
+                                       VisAudioSampleRateType rate,
+                                       VisAudioSampleFormatType format,
+                                       unsigned int channels,
+                                       const char **channelids);
+
+LV_API void visual_audio_set_sample_rate (VisAudio *audio, VisAudioSampleRateType rate);
+LV_API VisAudioSampleRateType visual_audio_get_sample_rate (VisAudio *audio);
+LV_API void visual_audio_set_resample_quality (VisAudio *audio, VisAudioResampleQuality quality);
+LV_API VisAudioResampleQuality visual_audio_get_resample_quality (VisAudio *audio);
+
+LV_API unsigned int visual_audio_get_onset_count    (VisAudio *audio);
+LV_API float        visual_audio_get_onset_strength (VisAudio *audio);
+LV_API float        visual_audio_get_tempo          (VisAudio *audio);
+LV_API float        visual_audio_get_band_energy    (VisAudio *audio, unsigned int band);
+
+LV_API int  visual_audio_get_sample_at      (VisAudio *audio, VisBuffer *buffer, const char *channelid, VisTime *time_);
+LV_API void visual_audio_record_latency     (VisAudio *audio);
+LV_API void visual_audio_get_latency_stats  (VisAudio *audio, VisAudioLatencyStats *stats);
+
 LV_API void visual_audio_normalise_spectrum (VisBuffer *buffer);
 
 LV_API visual_size_t visual_audio_sample_rate_get_length (VisAudioSampleRateType rate);
+LV_API VisAudioSampleRateType visual_audio_sample_rate_from_length (visual_size_t length);
 LV_API visual_size_t visual_audio_sample_format_get_size (VisAudioSampleFormatType format);
 LV_API int visual_audio_sample_format_is_signed (VisAudioSampleFormatType format);
 
@@ -25,6 +25,20 @@ void visual_audio_input (VisAudio                  *self,
     self->input (LV::BufferPtr (buffer), rate, format, channeltype);
 }
 
+void visual_audio_input_with_time (VisAudio                  *self,
+                                   VisBuffer                 *buffer,
+                                   VisAudioSampleRateType     rate,
+                                   VisAudioSampleFormatType   format,
+                                   VisAudioSampleChannelType  channeltype,
+                                   VisTime                   *capture_time)
+{
+    visual_return_if_fail (self         != nullptr);
+    visual_return_if_fail (buffer       != nullptr);
+    visual_return_if_fail (capture_time != nullptr);
+
+    self->input (LV::BufferPtr (buffer), rate, format, channeltype, *capture_time);
+}
+
 void visual_audio_input_channel (VisAudio                 *self,
                                  VisBuffer                *buffer,
                                  VisAudioSampleRateType    rate,
@@ -37,6 +51,39 @@ void visual_audio_input_channel (VisAudio                 *self,
     self->input (LV::BufferPtr (buffer), rate, format, channelid);
 }
 
+void visual_audio_input_interleaved (VisAudio                 *self,
+                                     VisBuffer                *buffer,
+                                     VisAudioSampleRateType    rate,
+                                     VisAudioSampleFormatType  format,
+                                     unsigned int              channels,
+                                     const char              **channelids)
+{
+    visual_return_if_fail (self       != nullptr);
+    visual_return_if_fail (buffer     != nullptr);
+    visual_return_if_fail (channelids != nullptr);
+
+    std::vector<std::string> names (channelids, channelids + channels);
+
+    self->input_interleaved (LV::BufferPtr (buffer), rate, format, names);
+}
+
+void visual_audio_input_planar (VisAudio                 *self,
+                                VisBuffer               **buffers,
+                                VisAudioSampleRateType    rate,
+                                VisAudioSampleFormatType  format,
+                                unsigned int              channels,
+                                const char              **channelids)
+{
+    visual_return_if_fail (self       != nullptr);
+    visual_return_if_fail (buffers    != nullptr);
+    visual_return_if_fail (channelids != nullptr);
+
+    std::vector<LV::BufferPtr> planes (buffers, buffers + channels);
+    std::vector<std::string>   names  (channelids, channelids + channels);
+
+    self->input_planar (planes, rate, format, names);
+}
+
 int visual_audio_get_sample (VisAudio *self, VisBuffer *buffer, const char *channel_name)
 {
     visual_return_val_if_fail (self   != nullptr, FALSE);
@@ -45,6 +92,30 @@ int visual_audio_get_sample (VisAudio *self, VisBuffer *buffer, const char *chan
     return self->get_sample (LV::BufferPtr (buffer), channel_name);
 }
 
+int visual_audio_get_sample_at (VisAudio *self, VisBuffer *buffer, const char *channel_name, VisTime *time_)
+{
+    visual_return_val_if_fail (self   != nullptr, FALSE);
+    visual_return_val_if_fail (buffer != nullptr, FALSE);
+    visual_return_val_if_fail (time_  != nullptr, FALSE);
+
+    return self->get_sample_at (LV::BufferPtr (buffer), channel_name, *time_);
+}
+
+void visual_audio_record_latency (VisAudio *self)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->record_latency ();
+}
+
+void visual_audio_get_latency_stats (VisAudio *self, VisAudioLatencyStats *stats)
+{
+    visual_return_if_fail (self  != nullptr);
+    visual_return_if_fail (stats != nullptr);
+
+    *stats = self->get_latency_stats ();
+}
+
 void visual_audio_get_sample_mixed_simple (VisAudio *self, VisBuffer *buffer, unsigned int channels, ...)
 {
     visual_return_if_fail (self   != nullptr);
@@ -85,6 +156,28 @@ void visual_audio_get_spectrum_multiplied (VisAudio *self, VisBuffer *buffer, in
     self->get_spectrum (LV::BufferPtr (buffer), samplelen, channel_name, normalised, multiplier);
 }
 
+void visual_audio_get_spectrum_stft (VisAudio *self, VisBuffer *buffer, const char *channel_name,
+                                     unsigned int frame_size, unsigned int hop_size,
+                                     VisAudioWindowType window, int normalised)
+{
+    visual_return_if_fail (self   != nullptr);
+    visual_return_if_fail (buffer != nullptr);
+
+    self->get_spectrum_stft (LV::BufferPtr (buffer), channel_name, frame_size, hop_size, window, normalised);
+}
+
+void visual_audio_get_spectrum_bands (VisAudio *self, VisBuffer *buffer, const char *channel_name,
+                                      unsigned int frame_size, unsigned int hop_size,
+                                      VisAudioWindowType window, VisAudioBandScale scale,
+                                      float min_freq, float max_freq, int normalised)
+{
+    visual_return_if_fail (self   != nullptr);
+    visual_return_if_fail (buffer != nullptr);
+
+    self->get_spectrum_bands (LV::BufferPtr (buffer), channel_name, frame_size, hop_size, window,
+                              scale, min_freq, max_freq, normalised);
+}
+
 void visual_audio_get_spectrum_for_sample (VisBuffer *buffer, VisBuffer *sample, int normalised)
 {
     visual_return_if_fail (buffer != nullptr);
@@ -101,6 +194,62 @@ void visual_audio_get_spectrum_for_sample_multiplied (VisBuffer *buffer, VisBuff
     LV::Audio::get_spectrum_for_sample (LV::BufferPtr (buffer), LV::BufferPtr (sample), normalised, multiplier);
 }
 
+void visual_audio_set_sample_rate (VisAudio *self, VisAudioSampleRateType rate)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->set_sample_rate (rate);
+}
+
+VisAudioSampleRateType visual_audio_get_sample_rate (VisAudio *self)
+{
+    visual_return_val_if_fail (self != nullptr, VISUAL_AUDIO_SAMPLE_RATE_NONE);
+
+    return self->get_sample_rate ();
+}
+
+void visual_audio_set_resample_quality (VisAudio *self, VisAudioResampleQuality quality)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->set_resample_quality (quality);
+}
+
+VisAudioResampleQuality visual_audio_get_resample_quality (VisAudio *self)
+{
+    visual_return_val_if_fail (self != nullptr, VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH);
+
+    return self->get_resample_quality ();
+}
+
+unsigned int visual_audio_get_onset_count (VisAudio *self)
+{
+    visual_return_val_if_fail (self != nullptr, 0);
+
+    return self->get_onset_count ();
+}
+
+float visual_audio_get_onset_strength (VisAudio *self)
+{
+    visual_return_val_if_fail (self != nullptr, 0.0f);
+
+    return self->get_onset_strength ();
+}
+
+float visual_audio_get_tempo (VisAudio *self)
+{
+    visual_return_val_if_fail (self != nullptr, 0.0f);
+
+    return self->get_tempo ();
+}
+
+float visual_audio_get_band_energy (VisAudio *self, unsigned int band)
+{
+    visual_return_val_if_fail (self != nullptr, 0.0f);
+
+    return self->get_band_energy (band);
+}
+
 void visual_audio_normalise_spectrum (VisBuffer *buffer)
 {
     visual_return_if_fail (buffer != nullptr);
@@ -24,6 +24,14 @@
 #include "config.h"
 #include "lv_bin.h"
 #include "lv_common.h"
+#include "lv_libvisual.h"
+#include "lv_profiler.h"
+#include "private/lv_thread_rng.hpp"
+#include "private/lv_worker_thread.hpp"
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
 
 namespace LV {
 
@@ -45,6 +53,16 @@ namespace LV {
       bool         morphing;
       Time         morphtime;
 
+      // Renders the incoming actor while the outgoing one renders on the
+      // calling thread, if enabled with set_concurrent_morph()
+      bool                          concurrent_morph;
+      std::unique_ptr<WorkerThread> morph_worker;
+
+      // Actor being loaded in the background by switch_actor_async(),
+      // handed back by the worker once it is ready
+      std::future<ActorPtr>         preload;
+      std::unique_ptr<WorkerThread> preload_worker;
+
       VisBinDepth   depthpreferred;    /* Prefered depth, highest or lowest */
       VisVideoDepth depthflag;         /* Supported depths */
       VisVideoDepth depthold;          /* Previous depth */
@@ -62,6 +80,13 @@ namespace LV {
 
 	  void set_actor (ActorPtr const& actor);
 	  void set_input (InputPtr const& input);
+
+      // Waits for any background load to finish and drops its actor
+      void cancel_preload ();
+
+      // Returns true if an actor of the named plugin is running or being
+      // morphed from
+      bool is_plugin_running (std::string const& name) const;
   };
 
   VisVideoDepth Bin::Impl::get_suitable_depth (VisVideoDepth depthflag)
@@ -91,6 +116,7 @@ namespace LV {
       : use_morph       (false)
       , morphing        (false)
       , morphtime       (4, 0)
+      , concurrent_morph (false)
       , depthpreferred  (VISUAL_BIN_DEPTH_HIGHEST)
       , depthflag       (VISUAL_VIDEO_DEPTH_NONE)
       , depthold        (VISUAL_VIDEO_DEPTH_NONE)
@@ -118,6 +144,25 @@ namespace LV {
       input = new_input;
   }
 
+  void Bin::Impl::cancel_preload ()
+  {
+      if (!preload.valid ())
+          return;
+
+      // Taking the actor out releases it on this thread
+      preload.get ();
+  }
+
+  bool Bin::Impl::is_plugin_running (std::string const& name) const
+  {
+      for (auto const& running : { actor, actmorph }) {
+          if (running && name == visual_plugin_get_info (running->get_plugin ())->plugname)
+              return true;
+      }
+
+      return false;
+  }
+
   Bin::Bin ()
       : m_impl (new Impl)
   {
@@ -367,15 +412,87 @@ namespace LV {
       visual_log (VISUAL_LOG_DEBUG, "switching to a new actor: %s, old actor: %s",
 				  actor_name.c_str (), visual_plugin_get_info (m_impl->actor->get_plugin ())->plugname);
 
-      if (m_impl->actmorph) {
-          m_impl->actmorph.reset ();
-          m_impl->actmorphvideo.reset ();
-      }
+      /* A later switch overrides one still loading */
+      m_impl->cancel_preload ();
 
       /* Create a new managed actor */
       auto actor = LV::Actor::load (actor_name);
       visual_return_if_fail (actor);
 
+      begin_switch (actor);
+  }
+
+  void Bin::switch_actor_async (std::string const& actor_name, unsigned int warmup_frames)
+  {
+      visual_return_if_fail (m_impl->actor);
+
+      /* Loading ahead needs the size the bin renders at. A second instance
+       * of a running plugin would also set up alongside the first, while
+       * they share the plugin's globals. */
+      if (!m_impl->actvideo
+          || !visual_plugin_is_realized (m_impl->actor->get_plugin ())
+          || m_impl->is_plugin_running (actor_name)) {
+          switch_actor (actor_name);
+          return;
+      }
+
+      visual_log (VISUAL_LOG_DEBUG, "preloading a new actor: %s", actor_name.c_str ());
+
+      m_impl->cancel_preload ();
+
+      if (!m_impl->preload_worker)
+          m_impl->preload_worker.reset (new WorkerThread);
+
+      int width  = m_impl->actvideo->get_width ();
+      int height = m_impl->actvideo->get_height ();
+
+      /* The preload draws its random numbers from a generator of its own,
+       * seeded here so that the render thread's sequence does not depend
+       * on how far the preload has got */
+      auto seed = RandomSeed (LV::rand ());
+
+      auto task = std::make_shared<std::packaged_task<ActorPtr ()>> ([actor_name, width, height, warmup_frames, seed] {
+          ThreadRngScope rng_scope {seed};
+
+          auto actor = LV::Actor::load (actor_name);
+          if (!actor)
+              return actor;
+
+          /* GL actors can only be set up with the render thread's context */
+          if (!visual_video_depth_is_supported (actor->get_supported_depths (), VISUAL_VIDEO_DEPTH_GL)) {
+              auto depth = visual_video_depth_get_highest_nogl (actor->get_supported_depths ());
+
+              actor->realize ();
+              actor->set_video (LV::Video::create (width, height, depth));
+              actor->video_negotiate (depth, false, false);
+
+              /* Rendering handles the resize event, which is where most
+               * actors build their tables */
+              Audio silence;
+
+              for (unsigned int i = 0; i < warmup_frames; i++)
+                  actor->run (silence);
+          }
+
+          return actor;
+      });
+
+      m_impl->preload = task->get_future ();
+      m_impl->preload_worker->submit ([task] { (*task) (); });
+  }
+
+  bool Bin::is_switch_pending () const
+  {
+      return m_impl->preload.valid ();
+  }
+
+  void Bin::begin_switch (ActorPtr const& actor)
+  {
+      if (m_impl->actmorph) {
+          m_impl->actmorph.reset ();
+          m_impl->actmorphvideo.reset ();
+      }
+
       auto video = LV::Video::create ();
       video->copy_attrs(m_impl->actvideo);
 
@@ -459,7 +576,8 @@ namespace LV {
 
           visual_log (VISUAL_LOG_INFO, "Target depth selected: %d", depth);
 
-          video->set_pitch(video->get_width() * (visual_video_depth_bpp(depth) >> 3));
+          /* The video may have been forced to the old depth above */
+          video->set_pitch(video->get_width() * video->get_bpp());
 
           video->allocate_buffer();
       }
@@ -602,11 +720,45 @@ namespace LV {
       m_impl->morphtime = time;
   }
 
+  void Bin::set_concurrent_morph (bool concurrent)
+  {
+      m_impl->concurrent_morph = concurrent;
+
+      if (!concurrent)
+          m_impl->morph_worker.reset ();
+  }
+
   void Bin::run ()
   {
       visual_return_if_fail (m_impl->actor);
       visual_return_if_fail (m_impl->input);
 
+      ProfileScope scope {VISUAL_PROFILE_STAGE_FRAME, visual_plugin_get_info (m_impl->actor->get_plugin ())->plugname};
+
+      /* Start switching to an actor loaded by switch_actor_async() once it
+       * is ready */
+      if (m_impl->preload.valid ()
+          && m_impl->preload.wait_for (std::chrono::seconds (0)) == std::future_status::ready) {
+          auto actor = m_impl->preload.get ();
+
+          if (actor) {
+              auto const& warmup_video = actor->get_video ();
+
+              /* The actor only needs another resize event if the bin
+               * video changed size while it was loading */
+              bool resized = !warmup_video
+                  || warmup_video->get_width ()  != m_impl->actvideo->get_width ()
+                  || warmup_video->get_height () != m_impl->actvideo->get_height ();
+
+              begin_switch (actor);
+
+              if (visual_plugin_is_realized (actor->get_plugin ()))
+                  actor->video_negotiate (m_impl->depthforced, !resized, true);
+          } else {
+              visual_log (VISUAL_LOG_ERROR, "Failed to preload actor, not switching");
+          }
+      }
+
       m_impl->input->run ();
 
       /* If we have a direct switch, do this BEFORE we run the actor,
@@ -643,15 +795,39 @@ namespace LV {
 
       auto const& audio = m_impl->input->get_audio ();
 
-      m_impl->actor->run (audio);
+      bool blending = m_impl->morphing && m_impl->use_morph &&
+                      m_impl->actmorph->get_video ()->get_depth () != VISUAL_VIDEO_DEPTH_GL &&
+                      m_impl->actor->get_video ()->get_depth () != VISUAL_VIDEO_DEPTH_GL;
 
-      if (m_impl->morphing) {
-          if (m_impl->use_morph &&
-              m_impl->actmorph->get_video ()->get_depth () != VISUAL_VIDEO_DEPTH_GL &&
-              m_impl->actor->get_video ()->get_depth () != VISUAL_VIDEO_DEPTH_GL) {
+      /* Instances of a plugin share its globals and its song info, so two
+       * of the same plugin always take turns */
+      bool concurrent = blending && m_impl->concurrent_morph &&
+                        std::strcmp (visual_plugin_get_info (m_impl->actor->get_plugin ())->plugname,
+                                     visual_plugin_get_info (m_impl->actmorph->get_plugin ())->plugname) != 0;
+
+      if (concurrent) {
+          /* Both actors draw into their own videos and only read the
+           * audio, so the incoming one can render alongside */
+          if (!m_impl->morph_worker)
+              m_impl->morph_worker.reset (new WorkerThread);
+
+          auto const& actmorph = m_impl->actmorph;
+          m_impl->morph_worker->submit ([&actmorph, &audio] { actmorph->run (audio); });
 
+          m_impl->actor->run (audio);
+
+          m_impl->morph_worker->wait ();
+      } else {
+          m_impl->actor->run (audio);
+
+          if (blending)
               m_impl->actmorph->run (audio);
+      }
 
+      m_impl->input->record_latency ();
+
+      if (m_impl->morphing) {
+          if (blending) {
               if (!m_impl->morph) {
                   switch_finalize ();
                   return;
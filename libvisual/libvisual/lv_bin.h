@@ -89,12 +89,54 @@ namespace LV {
 
 	  void switch_actor (std::string const& actname);
 
+	  /**
+	   * Switches to a new actor without stalling rendering.
+	   *
+	   * The actor is loaded, realized and negotiated on a background
+	   * thread, and then renders a few frames of silence offscreen so that
+	   * its first frames on screen are not slowed by setting up. run()
+	   * starts the switch at the first frame after the actor is ready.
+	   *
+	   * GL actors are only loaded in the background. They are realized
+	   * during run() as with switch_actor().
+	   *
+	   * The new actor is set up while the current one keeps rendering on
+	   * the calling thread. Random numbers it draws through visual_rand()
+	   * come from a generator of the background thread's own, seeded from
+	   * the system-wide one by this call, so the render thread's sequence
+	   * is unchanged. Any other state shared between different plugins
+	   * must be safe to use from two threads. As instances of one plugin
+	   * may share global state, this falls back to switch_actor() while an
+	   * actor of the same plugin is running.
+	   *
+	   * This also falls back to switch_actor() if the bin has not been
+	   * realized with a video yet.
+	   *
+	   * @param actname       name of actor plugin
+	   * @param warmup_frames number of frames to render offscreen
+	   */
+	  void switch_actor_async (std::string const& actname, unsigned int warmup_frames = 1);
+
+	  /**
+	   * Returns true while an actor is loading for switch_actor_async().
+	   */
+	  bool is_switch_pending () const;
+
 	  void switch_finalize ();
 
 	  void use_morph (bool use);
 
 	  void switch_set_time (Time const& time);
 
+	  /**
+	   * Sets whether the outgoing and incoming actors of a morph render
+	   * concurrently. Off by default.
+	   *
+	   * Two actors of the same plugin always take turns. Actors that share
+	   * state outside their plugin should be run with this off.
+	   */
+	  void set_concurrent_morph (bool concurrent);
+
 	  void run ();
 
   private:
@@ -106,6 +148,8 @@ namespace LV {
       // FIXME: Remove
 	  bool connect (ActorPtr const& actor, InputPtr const& input);
 	  void switch_actor (ActorPtr const& actor);
+
+	  void begin_switch (ActorPtr const& actor);
   };
 
 } // LV namespace
@@ -149,8 +193,11 @@ LV_API int visual_bin_depth_changed (VisBin *bin);
 LV_API const VisPalette* visual_bin_get_palette (VisBin *bin);
 
 LV_API void visual_bin_switch_actor (VisBin *bin, const char *name);
+LV_API void visual_bin_switch_actor_async (VisBin *bin, const char *name, unsigned int warmup_frames);
+LV_API int  visual_bin_is_switch_pending (VisBin *bin);
 LV_API void visual_bin_switch_finalize (VisBin *bin);
 LV_API void visual_bin_switch_set_time (VisBin *bin, long sec, long usec);
+LV_API void visual_bin_set_concurrent_morph (VisBin *bin, int concurrent);
 
 LV_API void visual_bin_run (VisBin *bin);
 
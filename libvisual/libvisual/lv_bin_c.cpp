@@ -117,6 +117,20 @@ void visual_bin_switch_actor (VisBin *bin, const char *actname)
     bin->switch_actor (actname);
 }
 
+void visual_bin_switch_actor_async (VisBin *bin, const char *actname, unsigned int warmup_frames)
+{
+    visual_return_if_fail (bin != nullptr);
+
+    bin->switch_actor_async (actname, warmup_frames);
+}
+
+int visual_bin_is_switch_pending (VisBin *bin)
+{
+    visual_return_val_if_fail (bin != nullptr, FALSE);
+
+    return bin->is_switch_pending ();
+}
+
 void visual_bin_switch_finalize (VisBin *bin)
 {
     visual_return_if_fail (bin != nullptr);
@@ -138,6 +152,13 @@ void visual_bin_switch_set_time (VisBin *bin, long sec, long usec)
     bin->switch_set_time (LV::Time (sec, usec * VISUAL_NSECS_PER_USEC));
 }
 
+void visual_bin_set_concurrent_morph (VisBin *bin, int concurrent)
+{
+    visual_return_if_fail (bin != nullptr);
+
+    bin->set_concurrent_morph (concurrent);
+}
+
 void visual_bin_run (VisBin *bin)
 {
     visual_return_if_fail (bin != nullptr);
@@ -82,6 +82,7 @@ typedef struct {
 	int		hasMMX2;
 	int		hasSSE;
 	int		hasSSE2;
+	int		hasAVX2;
 	int		has3DNow;
 	int		has3DNowExt;
 	int		hasAltiVec;
@@ -333,6 +334,30 @@ static void cpuid (unsigned int ax, unsigned int *p)
 		 "=c" (p[2]), "=d" (p[3])
 		 : "0" (ax));
 }
+
+static void cpuid_count (unsigned int ax, unsigned int cx, unsigned int *p)
+{
+	__asm __volatile
+		("movl %%ebx, %%esi\n\t"
+		 "cpuid\n\t"
+		 "xchgl %%ebx, %%esi"
+		 : "=a" (p[0]), "=S" (p[1]),
+		 "=c" (p[2]), "=d" (p[3])
+		 : "0" (ax), "2" (cx));
+}
+
+/* Returns whether the OS saves the SSE and AVX register state */
+static int has_os_avx_support (void)
+{
+	unsigned int eax, edx;
+
+	__asm __volatile
+		("xgetbv"
+		 : "=a" (eax), "=d" (edx)
+		 : "c" (0));
+
+	return (eax & 0x6) == 0x6;
+}
 #endif
 
 static unsigned int get_number_of_cores (void)
@@ -416,6 +441,7 @@ static void print_cpu_info (void)
 	visual_log (VISUAL_LOG_DEBUG, "CPU: MMX2 %d", cpu_caps.hasMMX2);
 	visual_log (VISUAL_LOG_DEBUG, "CPU: SSE %d", cpu_caps.hasSSE);
 	visual_log (VISUAL_LOG_DEBUG, "CPU: SSE2 %d", cpu_caps.hasSSE2);
+	visual_log (VISUAL_LOG_DEBUG, "CPU: AVX2 %d", cpu_caps.hasAVX2);
 	visual_log (VISUAL_LOG_DEBUG, "CPU: 3DNow %d", cpu_caps.has3DNow);
 	visual_log (VISUAL_LOG_DEBUG, "CPU: 3DNowExt %d", cpu_caps.has3DNowExt);
 #elif defined(VISUAL_ARCH_POWERPC)
@@ -455,6 +481,11 @@ void visual_cpu_initialize ()
 # endif /* VISUAL_OS_ANDROID */
 #endif /* VISUAL_ARCH_ARM */
 
+#if defined(__ARM_NEON)
+	/* Code built for NEON cannot run without it */
+	cpu_caps.hasNeon = TRUE;
+#endif
+
 #if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64)
 	/* No cpuid, old 486 or lower */
 	if (!has_cpuid ()) {
@@ -487,6 +518,14 @@ void visual_cpu_initialize ()
 		cacheline = ((regs2[1] >> 8) & 0xFF) * 8;
 		if (cacheline > 0)
 			cpu_caps.cacheline = cacheline;
+
+		/* AVX2 also needs the OS to save the YMM registers (OSXSAVE) */
+		if (regs[0] >= 0x00000007 && TEST_BIT (regs2[2], 27) && has_os_avx_support ()) {
+			unsigned int regs7[4];
+
+			cpuid_count (0x00000007, 0, regs7);
+			cpu_caps.hasAVX2 = TEST_BIT (regs7[1], 5); /* 0x20 */
+		}
 	}
 
 	cpuid (0x80000000, regs);
@@ -566,6 +605,13 @@ int visual_cpu_has_sse2 ()
 	return cpu_caps.hasSSE2;
 }
 
+int visual_cpu_has_avx2 ()
+{
+	visual_return_val_if_fail (cpu_initialized, FALSE);
+
+	return cpu_caps.hasAVX2;
+}
+
 int visual_cpu_has_3dnow ()
 {
 	visual_return_val_if_fail (cpu_initialized, FALSE);
@@ -96,6 +96,15 @@ LV_API int visual_cpu_has_sse (void);
  */
 LV_API int visual_cpu_has_sse2 (void);
 
+/**
+ * Returns whether processor supports AVX2 instructions.
+ *
+ * @note Only valid for x86 processors.
+ *
+ * @return TRUE if AVX2 is supported and enabled by the OS, FALSE otherwise
+ */
+LV_API int visual_cpu_has_avx2 (void);
+
 /**
  * Returns whether processor supports 3DNow!.
  *
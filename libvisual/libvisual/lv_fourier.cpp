@@ -26,6 +26,7 @@
 #include "lv_common.h"
 #include "lv_math.h"
 #include <cmath>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -73,7 +74,8 @@ namespace LV {
 
         typedef std::unordered_map<unsigned int, Entry> Table;
 
-        Table m_cache;
+        Table      m_cache;
+        std::mutex m_mutex;  // DFTs may be set up from several threads
     };
 
     DFTCache dft_cache;
@@ -93,6 +95,9 @@ namespace LV {
 
       Impl (unsigned int samples_out, unsigned int samples_in);
 
+      // Transforms input into real and imag
+      void transform (float const* input);
+
       void perform_brute_force (float const* input);
       void perform_fft_radix2_dit (float const* input);
 
@@ -104,6 +109,10 @@ namespace LV {
 
     DFTCache::Entry const& DFTCache::get_entry (DFTMethod method, unsigned int sample_count)
     {
+        // Entries are never removed, and rehashing leaves references to
+        // them valid, so they can be used after the lock is released
+        std::lock_guard<std::mutex> lock (m_mutex);
+
         auto entry = m_cache.find (sample_count);
         if (entry != m_cache.end ())
             return entry->second;
@@ -228,20 +237,25 @@ namespace LV {
       visual_return_if_fail (output != nullptr);
       visual_return_if_fail (input  != nullptr);
 
-      switch (m_impl->method) {
-          case DFT_METHOD_BRUTE_FORCE:
-              m_impl->perform_brute_force (input);
-              break;
-
-          case DFT_METHOD_FFT:
-              m_impl->perform_fft_radix2_dit (input);
-              break;
-      }
+      m_impl->transform (input);
 
       visual_math_simd_complex_scaled_norm (output, m_impl->real.data (), m_impl->imag.data (),
                                             1.0 / m_impl->sample_count, m_impl->samples_out);
   }
 
+  void DFT::perform_log_scaled (float *output, float const* input)
+  {
+      visual_return_if_fail (output != nullptr);
+      visual_return_if_fail (input  != nullptr);
+
+      m_impl->transform (input);
+
+      visual_math_simd_complex_scaled_norm_log_scale (output, m_impl->real.data (), m_impl->imag.data (),
+                                                      1.0 / m_impl->sample_count,
+                                                      AMP_LOG_SCALE_THRESHOLD0, AMP_LOG_SCALE_DIVISOR,
+                                                      m_impl->samples_out);
+  }
+
   void DFT::log_scale (float *output, float const* input, unsigned int size)
   {
       visual_return_if_fail (output != nullptr);
@@ -263,12 +277,7 @@ namespace LV {
       visual_return_if_fail (output != nullptr);
       visual_return_if_fail (input  != nullptr);
 
-      for (unsigned int i = 0; i < size; i++) {
-          if (input[i] > AMP_LOG_SCALE_THRESHOLD0)
-              output[i] = 1.0f + log (input[i]) / log_scale_divisor;
-          else
-              output[i] = 0.0f;
-      }
+      visual_math_simd_log_scale_floats (output, input, AMP_LOG_SCALE_THRESHOLD0, log_scale_divisor, size);
   }
 
   DFT::Impl::Impl (unsigned int samples_out_, unsigned int samples_in_)
@@ -290,6 +299,19 @@ namespace LV {
           return DFT_METHOD_BRUTE_FORCE;
   }
 
+  void DFT::Impl::transform (float const* input)
+  {
+      switch (method) {
+          case DFT_METHOD_BRUTE_FORCE:
+              perform_brute_force (input);
+              break;
+
+          case DFT_METHOD_FFT:
+              perform_fft_radix2_dit (input);
+              break;
+      }
+  }
+
   void DFT::Impl::perform_brute_force (float const* input)
   {
       DFTCache::Entry const& fcache = dft_cache.get_entry (method, sample_count);
@@ -327,6 +349,9 @@ namespace LV {
             real[i] = input[idx];
         else
             real[i] = 0;
+
+        // Left over from the previous call otherwise
+        imag[i] = 0;
     }
 
     unsigned int dft_size = 2;
@@ -94,6 +94,18 @@ namespace LV {
        */
       void perform (float *output, float const* input);
 
+      /**
+       * Performs a DFT over a set of input samples, and logarithmically
+       * scales the amplitude spectrum in the same pass.
+       *
+       * This is the same as perform() followed by log_scale(), but writes
+       * the output only once.
+       *
+       * @param output Array of output samples
+       * @param input  Array of input samples with values in [-1.0, 1.0]
+       */
+      void perform_log_scaled (float *output, float const* input);
+
       /**
        * Logarithmically scales an amplitude spectrum.
        *
@@ -137,6 +149,7 @@ LV_API VisDFT *visual_dft_new  (unsigned int samples_out, unsigned int samples_i
 LV_API void    visual_dft_free (VisDFT *dft);
 
 LV_API void visual_dft_perform (VisDFT *dft, float *output, float const *input);
+LV_API void visual_dft_perform_log_scaled (VisDFT *dft, float *output, float const *input);
 
 LV_API void visual_dft_log_scale (float *output, float const *input, unsigned int size);
 LV_API void visual_dft_log_scale_standard (float *output, float const *input, unsigned int size);
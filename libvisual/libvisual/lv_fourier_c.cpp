@@ -21,6 +21,13 @@ extern "C" {
       self->perform (output, input);
   }
 
+  void visual_dft_perform_log_scaled (VisDFT *self, float *output, float const *input)
+  {
+      visual_return_if_fail (self != nullptr);
+
+      self->perform_log_scaled (output, input);
+  }
+
   void visual_dft_log_scale (float *output, float const *input, unsigned int size)
   {
       LV::DFT::log_scale (output, input, size);
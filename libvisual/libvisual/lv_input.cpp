@@ -25,6 +25,7 @@
 #include "lv_input.h"
 #include "lv_common.h"
 #include "lv_plugin_registry.h"
+#include "lv_profiler.h"
 #include <stdexcept>
 
 namespace LV {
@@ -117,6 +118,8 @@ namespace LV {
   bool Input::run ()
   {
       if (m_impl->callback) {
+          ProfileScope scope {VISUAL_PROFILE_STAGE_INPUT, "callback"};
+
           m_impl->callback (m_impl->audio);
           return true;
       }
@@ -128,8 +131,15 @@ namespace LV {
           return false;
       }
 
+      ProfileScope scope {VISUAL_PROFILE_STAGE_INPUT, visual_plugin_get_info (m_impl->plugin)->plugname};
+
       input_plugin->upload (m_impl->plugin, &m_impl->audio);
 
       return true;
   }
+
+  void Input::record_latency ()
+  {
+      m_impl->audio.record_latency ();
+  }
 }
@@ -96,6 +96,14 @@ namespace LV {
        */
       bool run ();
 
+      /**
+       * Records the capture-to-render latency of the uploaded samples.
+       * Call it once per rendered frame, after the actors have run.
+       *
+       * @see Audio::record_latency()
+       */
+      void record_latency ();
+
   private:
 
       friend void intrusive_ptr_add_ref (Input const* input);
@@ -33,7 +33,10 @@
 #include "lv_log.h"
 #include "lv_param.h"
 #include "lv_util.h"
+#include "private/lv_profiler.hpp"
+#include "private/lv_thread_rng.hpp"
 #include "private/lv_time_system.hpp"
+#include "private/lv_video_blend.hpp"
 
 #include "gettext.h"
 
@@ -52,6 +55,9 @@ namespace LV
         return RandomSeed (Time::now ().to_usecs ());
     }
 
+    // Generator of the calling thread set by ThreadRngScope, if any
+    thread_local RandomContext* thread_rng = nullptr;
+
   } // anonymous namespace
 
   class System::Impl
@@ -127,7 +133,7 @@ namespace LV
 
   RandomContext& System::get_rng () const
   {
-      return m_impl->rng;
+      return thread_rng ? *thread_rng : m_impl->rng;
   }
 
   void System::set_rng_seed (VisRandomSeed seed)
@@ -135,6 +141,48 @@ namespace LV
       m_impl->rng.set_seed (seed);
   }
 
+  ThreadRngScope::ThreadRngScope (RandomSeed seed)
+      : m_rng      {seed}
+      , m_previous {thread_rng}
+  {
+      thread_rng = &m_rng;
+  }
+
+  ThreadRngScope::~ThreadRngScope ()
+  {
+      thread_rng = m_previous;
+  }
+
+  void System::set_profiling (bool enabled)
+  {
+      Profiler::set_enabled (enabled);
+  }
+
+  bool System::is_profiling () const
+  {
+      return Profiler::is_enabled ();
+  }
+
+  std::vector<ProfileStats> System::get_profile_stats () const
+  {
+      return Profiler::get_stats ();
+  }
+
+  void System::reset_profile_stats ()
+  {
+      Profiler::reset ();
+  }
+
+  bool System::start_profile_trace (std::string const& filename)
+  {
+      return Profiler::start_trace (filename);
+  }
+
+  void System::stop_profile_trace ()
+  {
+      Profiler::stop_trace ();
+  }
+
   System::System (int& argc, char**& argv)
       : m_impl(new Impl)
   {
@@ -151,6 +199,9 @@ namespace LV
       // Initialize Mem system
       visual_mem_initialize ();
 
+      // Pick alpha blending and blitting kernels
+      VideoBlend::initialize ();
+
       // Initialize high-resolution timer system
       TimeSystem::start ();
 
@@ -160,6 +211,10 @@ namespace LV
 
   System::~System ()
   {
+      // Write out any trace still being recorded
+      Profiler::stop_trace ();
+      Profiler::set_enabled (false);
+
       PluginRegistry::destroy ();
       TimeSystem::shutdown ();
   }
@@ -26,6 +26,7 @@
 
 #include <libvisual/lv_param.h>
 #include <libvisual/lv_random.h>
+#include <libvisual/lv_profiler.h>
 
 /**
  * @defgroup Libvisual Libvisual
@@ -37,6 +38,7 @@
 #include <libvisual/lv_singleton.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 //! Libvisual namespace
 namespace LV {
@@ -81,6 +83,9 @@ namespace LV {
 
       /**
        * Returns the system-wide random number generator.
+       *
+       * Threads that libvisual runs work on in the background, such as
+       * Bin::switch_actor_async(), get a generator of their own instead.
        */
       RandomContext& get_rng () const;
 
@@ -91,6 +96,52 @@ namespace LV {
        */
       void set_rng_seed (RandomSeed seed);
 
+      /**
+       * Enables or disables the frame profiler.
+       *
+       * @see VisProfiler
+       *
+       * @param enabled true to enable profiling
+       */
+      void set_profiling (bool enabled);
+
+      /**
+       * Returns whether the frame profiler is enabled.
+       */
+      bool is_profiling () const;
+
+      /**
+       * Returns the timings collected for each stage and plugin since
+       * profiling started or was last reset.
+       *
+       * @return list of timings, ordered by stage and plugin name
+       */
+      std::vector<ProfileStats> get_profile_stats () const;
+
+      /**
+       * Discards all collected timings.
+       */
+      void reset_profile_stats ();
+
+      /**
+       * Starts recording every timing collected into a trace. The trace
+       * is written when recording stops, in the Chrome trace event format
+       * read by chrome://tracing and Perfetto.
+       *
+       * @note Timings are only collected while profiling is enabled.
+       *
+       * @param filename file to write the trace to
+       *
+       * @return true on success, false if the file cannot be written or a
+       *         trace is already being recorded
+       */
+      bool start_profile_trace (std::string const& filename);
+
+      /**
+       * Stops recording a trace and writes it out.
+       */
+      void stop_profile_trace ();
+
   private:
 
       class Impl;
@@ -135,6 +186,9 @@ LV_API void visual_set_rng_seed (VisRandomSeed seed);
 
 LV_API VisRandomContext *visual_get_rng (void);
 
+LV_API void visual_set_profiling (int enabled);
+LV_API int  visual_is_profiling  (void);
+
 // FIXME: Move this into lv_random.h
 static inline uint32_t visual_rand (void)
 {
@@ -44,4 +44,14 @@ extern "C" {
       return &LV::System::instance()->get_rng ();
   }
 
+  void visual_set_profiling (int enabled)
+  {
+      LV::System::instance()->set_profiling (enabled);
+  }
+
+  int visual_is_profiling (void)
+  {
+      return LV::System::instance()->is_profiling ();
+  }
+
 } // extern C
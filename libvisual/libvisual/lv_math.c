@@ -25,7 +25,160 @@
 #include "lv_math.h"
 #include "lv_common.h"
 #include "lv_math_orc.h"
+#include "lv_cpu.h"
 #include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/* Fast natural logarithm
+ *
+ * x is split into m * 2^e with m in [sqrt(1/2), sqrt(2)). Then
+ *
+ *   log(x) = e * log(2) + log(m)
+ *   log(m) = 2 * atanh(s),  s = (m - 1) / (m + 1),  |s| < 0.1716
+ *
+ * and atanh(s) is taken to the s^7 term of its series. The first term left
+ * out is below 2 * 0.1716^9 / 9 = 2.9e-8, and log(2) is split in two to
+ * keep e * log(2) exact, so the error is that of float arithmetic: over all
+ * positive normal floats it is below 4.0e-7 absolute for x in [1/2, 2], and
+ * below 2.5e-7 relative elsewhere.
+ *
+ * Zero, negative, denormal, infinite and NaN inputs give undefined results.
+ * The SIMD versions take the same steps as the scalar one.
+ */
+
+#define FAST_LOG_SQRT2  1.41421356f
+#define FAST_LOG_LN2_HI 0.693359375f
+#define FAST_LOG_LN2_LO -2.12194440e-4f
+#define FAST_LOG_C3     (2.0f / 3.0f)
+#define FAST_LOG_C5     (2.0f / 5.0f)
+#define FAST_LOG_C7     (2.0f / 7.0f)
+
+static inline float fast_log (float x)
+{
+    uint32_t bits;
+    int32_t  e;
+    float    m, s, s2, e_f, poly;
+
+    memcpy (&bits, &x, sizeof (bits));
+
+    e = (int32_t) (bits >> 23) - 127;
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    memcpy (&m, &bits, sizeof (m));
+
+    if (m > FAST_LOG_SQRT2) {
+        m *= 0.5f;
+        e++;
+    }
+
+    s  = (m - 1.0f) / (m + 1.0f);
+    s2 = s * s;
+
+    poly = FAST_LOG_C7;
+    poly = poly * s2 + FAST_LOG_C5;
+    poly = poly * s2 + FAST_LOG_C3;
+    poly = poly * s2 + 2.0f;
+
+    e_f = (float) e;
+
+    return (e_f * FAST_LOG_LN2_LO + s * poly) + e_f * FAST_LOG_LN2_HI;
+}
+
+static inline float fast_log_scale (float x, float threshold, float inv_divisor)
+{
+    return x > threshold ? 1.0f + fast_log (x) * inv_divisor : 0.0f;
+}
+
+#if defined(__SSE2__)
+
+static inline __m128 fast_log_sse2 (__m128 x)
+{
+    __m128i bits = _mm_castps_si128 (x);
+    __m128i e    = _mm_sub_epi32 (_mm_srli_epi32 (bits, 23), _mm_set1_epi32 (127));
+
+    __m128 one = _mm_set1_ps (1.0f);
+    __m128 m   = _mm_castsi128_ps (_mm_or_si128 (_mm_and_si128 (bits, _mm_set1_epi32 (0x007fffff)),
+                                                 _mm_set1_epi32 (0x3f800000)));
+
+    /* Halve m and increment e where m > sqrt(2). The mask is -1 there. */
+    __m128 big = _mm_cmpgt_ps (m, _mm_set1_ps (FAST_LOG_SQRT2));
+    __m128 s, s2, e_f, poly;
+
+    m = _mm_or_ps (_mm_and_ps (big, _mm_mul_ps (m, _mm_set1_ps (0.5f))), _mm_andnot_ps (big, m));
+    e = _mm_sub_epi32 (e, _mm_castps_si128 (big));
+
+    s  = _mm_div_ps (_mm_sub_ps (m, one), _mm_add_ps (m, one));
+    s2 = _mm_mul_ps (s, s);
+
+    poly = _mm_set1_ps (FAST_LOG_C7);
+    poly = _mm_add_ps (_mm_mul_ps (poly, s2), _mm_set1_ps (FAST_LOG_C5));
+    poly = _mm_add_ps (_mm_mul_ps (poly, s2), _mm_set1_ps (FAST_LOG_C3));
+    poly = _mm_add_ps (_mm_mul_ps (poly, s2), _mm_set1_ps (2.0f));
+
+    e_f = _mm_cvtepi32_ps (e);
+
+    return _mm_add_ps (_mm_add_ps (_mm_mul_ps (e_f, _mm_set1_ps (FAST_LOG_LN2_LO)), _mm_mul_ps (s, poly)),
+                       _mm_mul_ps (e_f, _mm_set1_ps (FAST_LOG_LN2_HI)));
+}
+
+static inline __m128 fast_log_scale_sse2 (__m128 x, __m128 threshold, __m128 inv_divisor)
+{
+    __m128 above = _mm_cmpgt_ps (x, threshold);
+    __m128 value = _mm_add_ps (_mm_set1_ps (1.0f), _mm_mul_ps (fast_log_sse2 (x), inv_divisor));
+
+    return _mm_and_ps (above, value);
+}
+
+#endif /* __SSE2__ */
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+static inline float32x4_t fast_log_neon (float32x4_t x)
+{
+    uint32x4_t bits = vreinterpretq_u32_f32 (x);
+    int32x4_t  e    = vsubq_s32 (vreinterpretq_s32_u32 (vshrq_n_u32 (bits, 23)), vdupq_n_s32 (127));
+
+    float32x4_t one = vdupq_n_f32 (1.0f);
+    float32x4_t m   = vreinterpretq_f32_u32 (vorrq_u32 (vandq_u32 (bits, vdupq_n_u32 (0x007fffff)),
+                                                        vdupq_n_u32 (0x3f800000)));
+
+    uint32x4_t  big = vcgtq_f32 (m, vdupq_n_f32 (FAST_LOG_SQRT2));
+    float32x4_t s, s2, e_f, poly;
+
+    m = vbslq_f32 (big, vmulq_n_f32 (m, 0.5f), m);
+    e = vsubq_s32 (e, vreinterpretq_s32_u32 (big));
+
+    s  = vdivq_f32 (vsubq_f32 (m, one), vaddq_f32 (m, one));
+    s2 = vmulq_f32 (s, s);
+
+    /* Separate multiplies and adds, not fused, to match the scalar version */
+    poly = vdupq_n_f32 (FAST_LOG_C7);
+    poly = vaddq_f32 (vmulq_f32 (poly, s2), vdupq_n_f32 (FAST_LOG_C5));
+    poly = vaddq_f32 (vmulq_f32 (poly, s2), vdupq_n_f32 (FAST_LOG_C3));
+    poly = vaddq_f32 (vmulq_f32 (poly, s2), vdupq_n_f32 (2.0f));
+
+    e_f = vcvtq_f32_s32 (e);
+
+    return vaddq_f32 (vaddq_f32 (vmulq_n_f32 (e_f, FAST_LOG_LN2_LO), vmulq_f32 (s, poly)),
+                      vmulq_n_f32 (e_f, FAST_LOG_LN2_HI));
+}
+
+static inline float32x4_t fast_log_scale_neon (float32x4_t x, float32x4_t threshold, float32x4_t inv_divisor)
+{
+    uint32x4_t  above = vcgtq_f32 (x, threshold);
+    float32x4_t value = vaddq_f32 (vdupq_n_f32 (1.0f), vmulq_f32 (fast_log_neon (x), inv_divisor));
+
+    return vreinterpretq_f32_u32 (vandq_u32 (above, vreinterpretq_u32_f32 (value)));
+}
+
+#endif /* __ARM_NEON && __aarch64__ */
 
 int visual_math_is_power_of_2 (int n)
 {
@@ -107,3 +260,90 @@ void visual_math_simd_complex_scaled_norm (float *LV_RESTRICT dest, const float
 {
     simd_complex_scaled_norm (dest, real, imag, k, (int) count);
 }
+
+void visual_math_simd_log_floats (float *dest, const float *src, visual_size_t count)
+{
+    visual_size_t i = 0;
+
+#if defined(__SSE2__)
+    if (visual_cpu_has_sse2 ()) {
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps (dest + i, fast_log_sse2 (_mm_loadu_ps (src + i)));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32 (dest + i, fast_log_neon (vld1q_f32 (src + i)));
+#endif
+
+    for (; i < count; i++)
+        dest[i] = fast_log (src[i]);
+}
+
+void visual_math_simd_log_scale_floats (float *dest, const float *src, float threshold, float divisor, visual_size_t count)
+{
+    float inv_divisor = 1.0f / divisor;
+    visual_size_t i = 0;
+
+#if defined(__SSE2__)
+    if (visual_cpu_has_sse2 ()) {
+        __m128 threshold4   = _mm_set1_ps (threshold);
+        __m128 inv_divisor4 = _mm_set1_ps (inv_divisor);
+
+        for (; i + 4 <= count; i += 4)
+            _mm_storeu_ps (dest + i, fast_log_scale_sse2 (_mm_loadu_ps (src + i), threshold4, inv_divisor4));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    {
+        float32x4_t threshold4   = vdupq_n_f32 (threshold);
+        float32x4_t inv_divisor4 = vdupq_n_f32 (inv_divisor);
+
+        for (; i + 4 <= count; i += 4)
+            vst1q_f32 (dest + i, fast_log_scale_neon (vld1q_f32 (src + i), threshold4, inv_divisor4));
+    }
+#endif
+
+    for (; i < count; i++)
+        dest[i] = fast_log_scale (src[i], threshold, inv_divisor);
+}
+
+void visual_math_simd_complex_scaled_norm_log_scale (float *LV_RESTRICT dest, const float *LV_RESTRICT real, const float *LV_RESTRICT imag,
+                                                     float k, float threshold, float divisor, visual_size_t count)
+{
+    float inv_divisor = 1.0f / divisor;
+    visual_size_t i = 0;
+
+#if defined(__SSE2__)
+    if (visual_cpu_has_sse2 ()) {
+        __m128 k4           = _mm_set1_ps (k);
+        __m128 threshold4   = _mm_set1_ps (threshold);
+        __m128 inv_divisor4 = _mm_set1_ps (inv_divisor);
+
+        for (; i + 4 <= count; i += 4) {
+            __m128 re   = _mm_loadu_ps (real + i);
+            __m128 im   = _mm_loadu_ps (imag + i);
+            __m128 norm = _mm_mul_ps (_mm_sqrt_ps (_mm_add_ps (_mm_mul_ps (re, re), _mm_mul_ps (im, im))), k4);
+
+            _mm_storeu_ps (dest + i, fast_log_scale_sse2 (norm, threshold4, inv_divisor4));
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    {
+        float32x4_t k4           = vdupq_n_f32 (k);
+        float32x4_t threshold4   = vdupq_n_f32 (threshold);
+        float32x4_t inv_divisor4 = vdupq_n_f32 (inv_divisor);
+
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t re   = vld1q_f32 (real + i);
+            float32x4_t im   = vld1q_f32 (imag + i);
+            float32x4_t norm = vmulq_f32 (vsqrtq_f32 (vaddq_f32 (vmulq_f32 (re, re), vmulq_f32 (im, im))), k4);
+
+            vst1q_f32 (dest + i, fast_log_scale_neon (norm, threshold4, inv_divisor4));
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        float norm = sqrtf (real[i] * real[i] + imag[i] * imag[i]) * k;
+        dest[i] = fast_log_scale (norm, threshold, inv_divisor);
+    }
+}
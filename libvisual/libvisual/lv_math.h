@@ -196,6 +196,48 @@ LV_API void visual_math_simd_complex_norm (float *LV_RESTRICT dest, const float
  */
 LV_API void visual_math_simd_complex_scaled_norm (float *LV_RESTRICT dest, const float *LV_RESTRICT real, const float *LV_RESTRICT imag, float k, visual_size_t count);
 
+/**
+ * Calculates the natural logarithm of a list of floats, using SIMD instructions on supported CPUs.
+ *
+ * The logarithm is a fast approximation. Its error is below 4e-7 absolute for values in [0.5, 2.0], and below
+ * 2.5e-7 relative elsewhere. Results are only defined for positive normal floats.
+ *
+ * @param dest  array to hold the results in, may be src itself
+ * @param src   array of positive floats
+ * @param count number of elements
+ */
+LV_API void visual_math_simd_log_floats (float *dest, const float *src, visual_size_t count);
+
+/**
+ * Logarithmically scales a list of floats, using SIMD instructions on supported CPUs. Each value x is replaced by
+ * 1 + log(x) / divisor if it is above the threshold, and by 0 otherwise.
+ *
+ * @see visual_math_simd_log_floats() for the accuracy of the logarithm.
+ *
+ * @param dest      array to hold the results in, may be src itself
+ * @param src       array of floats
+ * @param threshold values at or below this are scaled to 0, must be positive
+ * @param divisor   logarithm divisor
+ * @param count     number of elements
+ */
+LV_API void visual_math_simd_log_scale_floats (float *dest, const float *src, float threshold, float divisor, visual_size_t count);
+
+/**
+ * Calculates the scaled norm of a list of complex numbers and logarithmically scales it, using SIMD instructions
+ * on supported CPUs. This is visual_math_simd_complex_scaled_norm() followed by
+ * visual_math_simd_log_scale_floats(), in a single pass.
+ *
+ * @param dest      array to hold the results in
+ * @param real      array of real parts
+ * @param imag      array of imaginary parts
+ * @param k         const multiplicand
+ * @param threshold norms at or below this are scaled to 0, must be positive
+ * @param divisor   logarithm divisor
+ * @param count     number of elements
+ */
+LV_API void visual_math_simd_complex_scaled_norm_log_scale (float *LV_RESTRICT dest, const float *LV_RESTRICT real, const float *LV_RESTRICT imag,
+                                                            float k, float threshold, float divisor, visual_size_t count);
+
 LV_END_DECLS
 
 /**
@@ -24,6 +24,7 @@
 #include "lv_morph.h"
 #include "lv_common.h"
 #include "lv_plugin_registry.h"
+#include "lv_profiler.h"
 #include <algorithm>
 #include <stdexcept>
 
@@ -160,26 +161,36 @@ namespace LV {
 
       auto morph_plugin = m_impl->get_morph_plugin ();
 
+      ProfileScope scope {VISUAL_PROFILE_STAGE_MORPH, visual_plugin_get_info (m_impl->plugin)->plugname};
+
       // If we're morphing using the timer, start the timer
       if (!m_impl->timer.is_active ()) {
           m_impl->timer.start ();
       }
 
-      if (morph_plugin->palette) {
+      // Palettes only matter to indexed video
+      bool indexed = m_impl->dest->get_depth () == VISUAL_VIDEO_DEPTH_8BIT;
+
+      if (indexed && morph_plugin->palette) {
           morph_plugin->palette (m_impl->plugin, m_impl->progress, const_cast<Audio*> (&audio), m_impl->morphpal, src1.get (), src2.get ());
       }
-      else {
+      else if (indexed && src1->get_depth () == VISUAL_VIDEO_DEPTH_8BIT && src2->get_depth () == VISUAL_VIDEO_DEPTH_8BIT) {
           auto const& src1_pal = src1->get_palette ();
           auto const& src2_pal = src2->get_palette ();
 
-          //if (src1_pal && src2_pal) {
-          m_impl->morphpal->blend (src1_pal, src2_pal, m_impl->progress);
-          //}
+          if (!src1_pal.empty () && src1_pal.size () == src2_pal.size () && src1_pal.size () == m_impl->morphpal->size ()) {
+              m_impl->morphpal->blend (src1_pal, src2_pal, m_impl->progress);
+          }
       }
 
+      // Morphs redraw the whole frame
+      m_impl->dest->clear_damage ();
+
       morph_plugin->apply (m_impl->plugin, m_impl->progress, const_cast<Audio*> (&audio), m_impl->dest.get (), src1.get (), src2.get ());
 
-      m_impl->dest->set_palette (*get_palette ());
+      if (indexed) {
+          m_impl->dest->set_palette (*get_palette ());
+      }
 
       // Update morph progression
 
@@ -0,0 +1,301 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_morph_kernels.h"
+#include "lv_common.h"
+#include "private/lv_morph_kernels.hpp"
+#include "private/lv_video_blend.hpp"
+#include "private/lv_row_bands.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LV {
+
+  void MorphKernels::brighten_bytes (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount)
+  {
+      for (auto i = brighten_bytes_simd (dest, src, count, amount); i < count; i++)
+          dest[i] = VideoBlend::blend_byte (src[i], 0xff, amount);
+  }
+
+  void MorphKernels::brighten_rgb565 (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount)
+  {
+      for (auto i = brighten_rgb565_simd (dest, src, count, amount); i < count; i++)
+          dest[i] = VideoBlend::blend_rgb565 (src[i], 0xffff, amount);
+  }
+
+  namespace {
+
+    inline uint8_t* get_row (Video* video, int y)
+    {
+        return static_cast<uint8_t*> (video->get_pixels ()) + y * video->get_pitch ();
+    }
+
+    inline uint8_t progress_to_weight (float progress)
+    {
+        return uint8_t (std::lround (std::min (std::max (progress, 0.0f), 1.0f) * 255));
+    }
+
+    inline bool is_compatible (Video* dest, Video* src)
+    {
+        return src->get_depth () == dest->get_depth ()
+            && src->get_width () >= dest->get_width ()
+            && src->get_height () >= dest->get_height ();
+    }
+
+    // Copies one video whole, for blends that reach either end
+    void copy_video (Video* dest, Video* src)
+    {
+        std::size_t row_bytes = dest->get_width () * dest->get_bpp ();
+
+        run_row_bands (dest->get_height (), 2 * row_bytes, [=] (int y_begin, int y_end) {
+            for (int y = y_begin; y < y_end; y++)
+                std::memcpy (get_row (dest, y), get_row (src, y), row_bytes);
+        });
+    }
+
+  } // anonymous namespace
+
+} // LV namespace
+
+using LV::MorphKernels;
+using LV::get_row;
+
+void visual_morph_kernel_crossfade (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src1 != nullptr && LV::is_compatible (dest, src1));
+    visual_return_if_fail (src2 != nullptr && LV::is_compatible (dest, src2));
+
+    auto alpha = LV::progress_to_weight (progress);
+
+    if (alpha == 0) {
+        LV::copy_video (dest, src1);
+        return;
+    }
+
+    if (alpha == 255) {
+        LV::copy_video (dest, src2);
+        return;
+    }
+
+    int width = dest->get_width ();
+    std::size_t row_bytes = width * dest->get_bpp ();
+    bool is_rgb565 = dest->get_depth () == VISUAL_VIDEO_DEPTH_16BIT;
+
+    auto blend = &LV::VideoBlend::get ();
+
+    LV::run_row_bands (dest->get_height (), 3 * row_bytes, [=] (int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; y++) {
+            if (is_rgb565) {
+                blend->blend_rgb565 (reinterpret_cast<uint16_t*> (get_row (dest, y)),
+                                     reinterpret_cast<uint16_t const*> (get_row (src1, y)),
+                                     reinterpret_cast<uint16_t const*> (get_row (src2, y)),
+                                     width, alpha);
+            } else {
+                blend->blend_bytes (get_row (dest, y), get_row (src1, y), get_row (src2, y), row_bytes, alpha);
+            }
+        }
+    });
+}
+
+void visual_morph_kernel_slide (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress, VisMorphSlideDirection direction)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src1 != nullptr && LV::is_compatible (dest, src1));
+    visual_return_if_fail (src2 != nullptr && LV::is_compatible (dest, src2));
+
+    progress = std::min (std::max (progress, 0.0f), 1.0f);
+
+    // Right and up run left and down backwards, with the sources swapped
+    if (direction == VISUAL_MORPH_SLIDE_RIGHT || direction == VISUAL_MORPH_SLIDE_UP) {
+        progress = 1.0f - progress;
+        std::swap (src1, src2);
+    }
+
+    int height = dest->get_height ();
+    int bpp    = dest->get_bpp ();
+    std::size_t row_bytes = dest->get_width () * bpp;
+
+    switch (direction) {
+        case VISUAL_MORPH_SLIDE_LEFT:
+        case VISUAL_MORPH_SLIDE_RIGHT: {
+            // The left part of the destination shows the right end of the
+            // second source, the rest the left part of the first
+            std::size_t left_bytes = std::size_t (dest->get_width () * progress) * bpp;
+            std::size_t right_bytes = row_bytes - left_bytes;
+
+            LV::run_row_bands (height, 2 * row_bytes, [=] (int y_begin, int y_end) {
+                for (int y = y_begin; y < y_end; y++) {
+                    auto destbuf = get_row (dest, y);
+
+                    std::memcpy (destbuf, get_row (src2, y) + right_bytes, left_bytes);
+                    std::memcpy (destbuf + left_bytes, get_row (src1, y), right_bytes);
+                }
+            });
+
+            break;
+        }
+
+        case VISUAL_MORPH_SLIDE_UP:
+        case VISUAL_MORPH_SLIDE_DOWN: {
+            // The first source moves up by shift rows, and the top of the
+            // second follows below it
+            int shift = int (height * progress);
+
+            LV::run_row_bands (height, 2 * row_bytes, [=] (int y_begin, int y_end) {
+                for (int y = y_begin; y < y_end; y++) {
+                    int src_y = y + shift;
+                    auto srcbuf = src_y < height ? get_row (src1, src_y) : get_row (src2, src_y - height);
+
+                    std::memcpy (get_row (dest, y), srcbuf, row_bytes);
+                }
+            });
+
+            break;
+        }
+
+        default:
+            visual_log (VISUAL_LOG_WARNING, "Invalid slide direction: %d", direction);
+            break;
+    }
+}
+
+void visual_morph_kernel_column_spans (VisVideo *dest, VisVideo *src1, VisVideo *src2, const int *span_tops, const int *span_bottoms)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src1 != nullptr && LV::is_compatible (dest, src1));
+    visual_return_if_fail (src2 != nullptr && LV::is_compatible (dest, src2));
+    visual_return_if_fail (span_tops != nullptr && span_bottoms != nullptr);
+
+    int width = dest->get_width ();
+    int bpp   = dest->get_bpp ();
+    std::size_t row_bytes = width * bpp;
+
+    // Rows no span starts or ends in are copied whole from one source
+    int all_inside_begin = *std::max_element (span_tops, span_tops + width);
+    int all_inside_end   = *std::min_element (span_bottoms, span_bottoms + width);
+    int any_inside_begin = *std::min_element (span_tops, span_tops + width);
+    int any_inside_end   = *std::max_element (span_bottoms, span_bottoms + width);
+
+    // Other rows are copied as alternating runs of columns inside and
+    // outside their spans, so every access stays within the row
+    LV::run_row_bands (dest->get_height (), 2 * row_bytes, [=] (int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; y++) {
+            auto destbuf = get_row (dest, y);
+            auto srcbuf1 = get_row (src1, y);
+            auto srcbuf2 = get_row (src2, y);
+
+            if (y < any_inside_begin || y >= any_inside_end) {
+                std::memcpy (destbuf, srcbuf1, row_bytes);
+                continue;
+            }
+
+            if (y >= all_inside_begin && y < all_inside_end) {
+                std::memcpy (destbuf, srcbuf2, row_bytes);
+                continue;
+            }
+
+            int x = 0;
+
+            while (x < width) {
+                bool inside = span_tops[x] <= y && y < span_bottoms[x];
+
+                int run_end = x + 1;
+                while (run_end < width && (span_tops[run_end] <= y && y < span_bottoms[run_end]) == inside)
+                    run_end++;
+
+                auto srcbuf = inside ? srcbuf2 : srcbuf1;
+                std::memcpy (destbuf + x * bpp, srcbuf + x * bpp, (run_end - x) * bpp);
+
+                x = run_end;
+            }
+        }
+    });
+}
+
+void visual_morph_kernel_checkers (VisVideo *dest, VisVideo *src1, VisVideo *src2, unsigned int rows, unsigned int cols, int flip)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src1 != nullptr && LV::is_compatible (dest, src1));
+    visual_return_if_fail (src2 != nullptr && LV::is_compatible (dest, src2));
+    visual_return_if_fail (rows > 0 && cols > 0);
+
+    int width  = dest->get_width ();
+    int height = dest->get_height ();
+    int bpp    = dest->get_bpp ();
+
+    int tile_width  = std::max (width  / int (cols), 1);
+    int tile_height = std::max (height / int (rows), 1);
+
+    LV::run_row_bands (height, 2 * width * bpp, [=] (int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; y++) {
+            auto destbuf = get_row (dest, y);
+            auto srcbuf1 = get_row (src1, y);
+            auto srcbuf2 = get_row (src2, y);
+
+            int row = std::min (y / tile_height, int (rows) - 1);
+
+            for (int col = 0; col < int (cols); col++) {
+                int x_begin = col * tile_width;
+                int x_end   = col + 1 < int (cols) ? std::min (x_begin + tile_width, width) : width;
+
+                if (x_begin >= width)
+                    break;
+
+                auto srcbuf = (row + col + (flip ? 1 : 0)) & 1 ? srcbuf2 : srcbuf1;
+                std::memcpy (destbuf + x_begin * bpp, srcbuf + x_begin * bpp, (x_end - x_begin) * bpp);
+            }
+        }
+    });
+}
+
+void visual_morph_kernel_flash (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src1 != nullptr && LV::is_compatible (dest, src1));
+    visual_return_if_fail (src2 != nullptr && LV::is_compatible (dest, src2));
+
+    progress = std::min (std::max (progress, 0.0f), 1.0f);
+
+    auto src    = progress < 0.5f ? src1 : src2;
+    auto amount = LV::progress_to_weight (progress < 0.5f ? progress * 2 : 2 - progress * 2);
+
+    if (dest->get_depth () == VISUAL_VIDEO_DEPTH_8BIT || amount == 0) {
+        LV::copy_video (dest, src);
+        return;
+    }
+
+    int width = dest->get_width ();
+    std::size_t row_bytes = width * dest->get_bpp ();
+    bool is_rgb565 = dest->get_depth () == VISUAL_VIDEO_DEPTH_16BIT;
+
+    LV::run_row_bands (dest->get_height (), 2 * row_bytes, [=] (int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; y++) {
+            if (is_rgb565) {
+                MorphKernels::brighten_rgb565 (reinterpret_cast<uint16_t*> (get_row (dest, y)),
+                                               reinterpret_cast<uint16_t const*> (get_row (src, y)),
+                                               width, amount);
+            } else {
+                MorphKernels::brighten_bytes (get_row (dest, y), get_row (src, y), row_bytes, amount);
+            }
+        }
+    });
+}
@@ -0,0 +1,125 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_MORPH_KERNELS_H
+#define _LV_MORPH_KERNELS_H
+
+#include <libvisual/lvconfig.h>
+#include <libvisual/lv_defines.h>
+#include <libvisual/lv_types.h>
+#include <libvisual/lv_video.h>
+
+/**
+ * @defgroup VisMorphKernels VisMorphKernels
+ * @{
+ *
+ * Pixel kernels shared by the morph plugins.
+ *
+ * All kernels write every pixel of the destination. The sources must have
+ * the destination's dimensions and depth, but each video may have its own
+ * pitch. Large frames are split into bands of rows that are processed
+ * concurrently.
+ */
+
+/**
+ * Direction a slide transition moves in.
+ */
+typedef enum {
+	VISUAL_MORPH_SLIDE_LEFT,  /**< The second source enters from the left edge. */
+	VISUAL_MORPH_SLIDE_RIGHT, /**< The first source leaves through the left edge. */
+	VISUAL_MORPH_SLIDE_UP,    /**< The first source leaves through the bottom edge. */
+	VISUAL_MORPH_SLIDE_DOWN   /**< The first source leaves through the top edge. */
+} VisMorphSlideDirection;
+
+LV_BEGIN_DECLS
+
+/**
+ * Crossfades two videos.
+ *
+ * 8-bit videos have their indices interpolated, which only makes sense
+ * when their palettes are ordered alike.
+ *
+ * @param dest     destination video
+ * @param src1     video shown at progress 0
+ * @param src2     video shown at progress 1
+ * @param progress progress from 0.0 to 1.0
+ */
+LV_API void visual_morph_kernel_crossfade (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress);
+
+/**
+ * Slides one video out while the other slides in.
+ *
+ * @param dest      destination video
+ * @param src1      video shown at progress 0
+ * @param src2      video shown at progress 1
+ * @param progress  progress from 0.0 to 1.0
+ * @param direction direction to slide in
+ */
+LV_API void visual_morph_kernel_slide (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress, VisMorphSlideDirection direction);
+
+/**
+ * Composites a vertical span of one video per column over another.
+ *
+ * Column x of the destination takes rows [span_tops[x], span_bottoms[x])
+ * from src2 and every other row from src1. Spans are clipped to the video
+ * and empty spans are allowed.
+ *
+ * @param dest         destination video
+ * @param src1         background video
+ * @param src2         video shown inside the spans
+ * @param span_tops    first row of each column's span, one entry per column
+ * @param span_bottoms row past the end of each column's span, one entry per column
+ */
+LV_API void visual_morph_kernel_column_spans (VisVideo *dest, VisVideo *src1, VisVideo *src2, const int *span_tops, const int *span_bottoms);
+
+/**
+ * Composites two videos in a checkerboard.
+ *
+ * The destination is divided into rows x cols tiles. The last row and
+ * column of tiles absorb any remainder.
+ *
+ * @param dest destination video
+ * @param src1 video shown in the even tiles
+ * @param src2 video shown in the odd tiles
+ * @param rows number of tile rows
+ * @param cols number of tile columns
+ * @param flip swaps the videos when non-zero
+ */
+LV_API void visual_morph_kernel_checkers (VisVideo *dest, VisVideo *src1, VisVideo *src2, unsigned int rows, unsigned int cols, int flip);
+
+/**
+ * Flashes to white and back, switching videos at the peak.
+ *
+ * The brightness ramps up to white at progress 0.5 and back down. 8-bit
+ * videos are copied as is; the flash is left to their palette.
+ *
+ * @param dest     destination video
+ * @param src1     video shown before progress 0.5
+ * @param src2     video shown from progress 0.5
+ * @param progress progress from 0.0 to 1.0
+ */
+LV_API void visual_morph_kernel_flash (VisVideo *dest, VisVideo *src1, VisVideo *src2, float progress);
+
+LV_END_DECLS
+
+/**
+ * @}
+ */
+
+#endif /* _LV_MORPH_KERNELS_H */
@@ -24,6 +24,7 @@
 #include "config.h"
 #include "lv_palette.h"
 #include "lv_common.h"
+#include <algorithm>
 
 namespace LV {
 
@@ -45,10 +46,13 @@ namespace LV {
 
   void Palette::blend (Palette const& src1, Palette const& src2, float rate)
   {
-      visual_return_if_fail (src1.size () != src2.size ());
-      visual_return_if_fail (size ()      != src1.size ());
+      visual_return_if_fail (src1.size () == src2.size ());
+      visual_return_if_fail (size ()      == src1.size ());
 
-      for (unsigned int i = 0; i < colors.size (); i++) {
+      // The checks above are compiled out of release builds
+      auto count = std::min ({ colors.size (), src1.colors.size (), src2.colors.size () });
+
+      for (unsigned int i = 0; i < count; i++) {
           colors[i].r = src1.colors[i].r + ((src2.colors[i].r - src1.colors[i].r) * rate);
           colors[i].g = src1.colors[i].g + ((src2.colors[i].g - src1.colors[i].g) * rate);
           colors[i].b = src1.colors[i].b + ((src2.colors[i].b - src1.colors[i].b) * rate);
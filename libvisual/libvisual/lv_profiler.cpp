@@ -0,0 +1,61 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_profiler.h"
+#include "lv_common.h"
+#include "private/lv_profiler.hpp"
+#include "private/lv_time_system.hpp"
+
+namespace LV {
+
+  ProfileScope::ProfileScope (VisProfileStage stage, char const* name)
+      : m_stage (VISUAL_PROFILE_STAGE_LAST)
+  {
+      if (!Profiler::is_enabled ())
+          return;
+
+      // The name is copied, as the plugin may be unloaded before the
+      // stage ends
+      m_stage = stage;
+      m_name  = name ? name : "";
+      // Stages are timed on the system clock, even under a virtual clock
+      m_start = TimeSystem::now ();
+  }
+
+  ProfileScope::~ProfileScope ()
+  {
+      if (m_stage != VISUAL_PROFILE_STAGE_LAST)
+          Profiler::record (m_stage, m_name, m_start, TimeSystem::now ());
+  }
+
+} // LV namespace
+
+const char *visual_profile_stage_name (VisProfileStage stage)
+{
+    switch (stage) {
+        case VISUAL_PROFILE_STAGE_FRAME:   return "frame";
+        case VISUAL_PROFILE_STAGE_INPUT:   return "input";
+        case VISUAL_PROFILE_STAGE_RENDER:  return "render";
+        case VISUAL_PROFILE_STAGE_CONVERT: return "convert";
+        case VISUAL_PROFILE_STAGE_MORPH:   return "morph";
+        case VISUAL_PROFILE_STAGE_DISPLAY: return "display";
+        default:                           return nullptr;
+    }
+}
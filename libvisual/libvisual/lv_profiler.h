@@ -0,0 +1,128 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_PROFILER_H
+#define _LV_PROFILER_H
+
+#include <libvisual/lvconfig.h>
+#include <libvisual/lv_defines.h>
+#include <libvisual/lv_types.h>
+#include <libvisual/lv_time.h>
+
+/**
+ * @defgroup VisProfiler VisProfiler
+ * @{
+ *
+ * Frame profiler.
+ *
+ * The stages of the rendering pipeline are timed by scoped timers. While
+ * profiling is enabled, the timings are collected into histograms per
+ * stage and plugin, and optionally into a trace. While it is disabled,
+ * each timer costs a flag check.
+ *
+ * @see LV::System::set_profiling
+ */
+
+/**
+ * Stages of the rendering pipeline.
+ */
+typedef enum {
+    VISUAL_PROFILE_STAGE_FRAME = 0, /**< Whole frame, as rendered by a bin */
+    VISUAL_PROFILE_STAGE_INPUT,     /**< Input plugin upload */
+    VISUAL_PROFILE_STAGE_RENDER,    /**< Actor plugin render */
+    VISUAL_PROFILE_STAGE_CONVERT,   /**< Depth conversion and scaling of actor output */
+    VISUAL_PROFILE_STAGE_MORPH,     /**< Morph plugin */
+    VISUAL_PROFILE_STAGE_DISPLAY,   /**< Display update, timed by applications */
+    VISUAL_PROFILE_STAGE_LAST
+} VisProfileStage;
+
+#ifdef __cplusplus
+
+#include <string>
+
+namespace LV {
+
+  /**
+   * Timings of a stage for one plugin, in microseconds.
+   *
+   * Percentiles are read from a histogram, and are accurate to within
+   * 4%.
+   */
+  struct ProfileStats
+  {
+      VisProfileStage stage;
+      std::string     name;  //!< plugin name
+      uint64_t        count;
+      double          mean;
+      double          p50;
+      double          p95;
+      double          p99;
+      double          max;
+  };
+
+  /**
+   * Times a stage until it goes out of scope.
+   */
+  class LV_API ProfileScope
+  {
+  public:
+
+      /**
+       * Starts timing a stage.
+       *
+       * @param stage stage
+       * @param name  name of the plugin running the stage
+       */
+      ProfileScope (VisProfileStage stage, char const* name);
+
+      ProfileScope (ProfileScope const&) = delete;
+
+      ~ProfileScope ();
+
+      ProfileScope& operator= (ProfileScope const&) = delete;
+
+  private:
+
+      VisProfileStage m_stage;
+      std::string     m_name;
+      Time            m_start;
+  };
+
+} // LV namespace
+
+#endif /* __cplusplus */
+
+LV_BEGIN_DECLS
+
+/**
+ * Returns the name of a stage.
+ *
+ * @param stage stage
+ *
+ * @return name, or NULL if the stage is invalid
+ */
+LV_API const char *visual_profile_stage_name (VisProfileStage stage);
+
+LV_END_DECLS
+
+/**
+ * @}
+ */
+
+#endif /* _LV_PROFILER_H */
@@ -25,6 +25,7 @@
 #include "lv_rectangle.h"
 #include "lv_common.h"
 #include "lv_math.h"
+#include <algorithm>
 
 namespace LV {
 
@@ -92,6 +93,22 @@ namespace LV {
       return result;
   }
 
+  Rect Rect::unite (Rect const& r) const
+  {
+      if (r.empty ())
+          return *this;
+
+      if (empty ())
+          return r;
+
+      int x0 = std::min (x, r.x);
+      int y0 = std::min (y, r.y);
+      int x1 = std::max (x + width,  r.x + r.width);
+      int y1 = std::max (y + height, r.y + r.height);
+
+      return Rect (x0, y0, x1 - x0, y1 - y0);
+  }
+
   void Rect::denormalize_points (float const* fxlist, float const* fylist, int32_t *xlist, int32_t *ylist, unsigned int size) const
   {
       visual_return_if_fail (fxlist != nullptr);
@@ -139,6 +139,16 @@ namespace LV {
        */
       Rect clip (Rect const& r) const;
 
+      /**
+       * Returns the smallest rectangle enclosing this rectangle and
+       * another. Empty rectangles are ignored.
+       *
+       * @param r rectangle to unite with
+       *
+       * @return Bounding rectangle
+       */
+      Rect unite (Rect const& r) const;
+
       /**
        * Normalizes this rectangle to the origin. The top-corner will
        * be set to (0, 0)
@@ -25,9 +25,17 @@
 #include "lv_time.h"
 #include "private/lv_time_system.hpp"
 #include "lv_common.h"
+#include <atomic>
 
 namespace LV {
 
+  namespace {
+
+    std::atomic<bool>    virtual_clock_enabled {false};
+    std::atomic<int64_t> virtual_clock_nsecs   {0};
+
+  } // anonymous namespace
+
   class Timer::Impl
   {
   public:
@@ -39,9 +47,32 @@ namespace LV {
 
   Time Time::now ()
   {
+      if (virtual_clock_enabled) {
+          int64_t nsecs = virtual_clock_nsecs;
+          return Time (nsecs / VISUAL_NSECS_PER_SEC, nsecs % VISUAL_NSECS_PER_SEC);
+      }
+
       return TimeSystem::now ();
   }
 
+  void Time::use_virtual_clock (bool enabled)
+  {
+      virtual_clock_nsecs   = 0;
+      virtual_clock_enabled = enabled;
+  }
+
+  bool Time::is_virtual_clock ()
+  {
+      return virtual_clock_enabled;
+  }
+
+  void Time::advance_virtual_clock (Time const& delta)
+  {
+      visual_return_if_fail (delta.sec >= 0);
+
+      virtual_clock_nsecs += int64_t (delta.sec) * VISUAL_NSECS_PER_SEC + delta.nsec;
+  }
+
   void Time::usleep (uint64_t usecs)
   {
       TimeSystem::usleep (usecs);
@@ -82,8 +82,38 @@ namespace LV {
                        (usecs % VISUAL_USECS_PER_SEC) * VISUAL_NSECS_PER_USEC);
       }
 
+      /**
+       * Returns the current time.
+       *
+       * While the virtual clock is in use, this is the virtual time.
+       *
+       * @see use_virtual_clock
+       */
       static Time now ();
 
+      /**
+       * Replaces the system clock with a virtual clock.
+       *
+       * The virtual clock starts at zero and only moves forward with
+       * advance_virtual_clock(). It makes everything timed with now() and
+       * Timer, such as actor animations, repeat exactly from run to run.
+       *
+       * @param enabled true to use the virtual clock
+       */
+      static void use_virtual_clock (bool enabled);
+
+      /**
+       * Returns whether the virtual clock is in use.
+       */
+      static bool is_virtual_clock ();
+
+      /**
+       * Moves the virtual clock forward.
+       *
+       * @param delta length of time to advance by
+       */
+      static void advance_virtual_clock (Time const& delta);
+
       friend Time operator- (Time const& lhs, Time const& rhs)
       {
           Time diff (lhs);
@@ -246,6 +276,10 @@ LV_API uint64_t visual_time_to_usecs (VisTime *time_);
 
 LV_API void visual_usleep (uint64_t usecs);
 
+LV_API void visual_time_use_virtual_clock     (int enabled);
+LV_API int  visual_time_is_virtual_clock      (void);
+LV_API void visual_time_advance_virtual_clock (VisTime *delta);
+
 LV_API void visual_time_set_from_msecs (VisTime *time_, uint64_t msecs);
 
 LV_API VisTimer *visual_timer_new  (void);
@@ -100,6 +100,23 @@ extern "C" {
       LV::Time::usleep (usecs);
   }
 
+  void visual_time_use_virtual_clock (int enabled)
+  {
+      LV::Time::use_virtual_clock (enabled);
+  }
+
+  int visual_time_is_virtual_clock ()
+  {
+      return LV::Time::is_virtual_clock ();
+  }
+
+  void visual_time_advance_virtual_clock (VisTime *delta)
+  {
+      visual_return_if_fail (delta != nullptr);
+
+      LV::Time::advance_virtual_clock (*delta);
+  }
+
   VisTimer *visual_timer_new ()
   {
       return new LV::Timer;
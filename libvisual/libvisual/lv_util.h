@@ -2,6 +2,7 @@
 #define _LV_UTIL_H
 
 #include <libvisual/lv_defines.h>
+#include <stddef.h>
 
 LV_BEGIN_DECLS
 
@@ -9,6 +10,30 @@ LV_API char *visual_strdup (const char *s);
 
 LV_API const char *visual_truncate_path (const char* filename, unsigned int parts);
 
+/**
+ * Function called on a band of rows by visual_run_row_bands().
+ *
+ * @param y_begin first row of the band
+ * @param y_end   one past the last row of the band
+ * @param data    user data
+ */
+typedef void (*VisRowBandFunc) (int y_begin, int y_end, void *data);
+
+/**
+ * Runs a function over bands of rows, on the library's shared worker
+ * threads when the work is large enough to pay off.
+ *
+ * Bands never overlap, so the function may write to its rows freely. It
+ * may be called from several threads at once, and must not touch state
+ * shared between bands without locking.
+ *
+ * @param height    number of rows
+ * @param row_bytes bytes touched per row, used to judge the cost
+ * @param func      function to call on each band
+ * @param data      user data passed to func
+ */
+LV_API void visual_run_row_bands (int height, size_t row_bytes, VisRowBandFunc func, void *data);
+
 LV_END_DECLS
 
 #endif /* _LV_UTIL_H */
@@ -48,6 +48,50 @@ namespace LV {
             || scale_method == VISUAL_VIDEO_SCALE_BILINEAR;
     }
 
+    // Damage lists longer than this are collapsed into their bounding box
+    constexpr std::size_t max_damage_areas = 32;
+
+    // Checks if two rectangles share a full edge, so their union has no
+    // area outside of either
+    bool rects_join (Rect const& a, Rect const& b)
+    {
+        if (a.y == b.y && a.height == b.height)
+            return a.x + a.width == b.x || b.x + b.width == a.x;
+
+        if (a.x == b.x && a.width == b.width)
+            return a.y + a.height == b.y || b.y + b.height == a.y;
+
+        return false;
+    }
+
+    // Maps the pixel span [begin, end) of a source to the span of
+    // destination pixels sampling it after scaling. Neighbouring source
+    // pixels are included for bilinear filtering, and a pixel of padding
+    // is added each side for rounding in the scalers.
+    void scale_span (int begin, int end, int src_size, int dst_size, int& dst_begin, int& dst_end)
+    {
+        if (src_size == dst_size) {
+            dst_begin = begin;
+            dst_end   = end;
+            return;
+        }
+
+        if (src_size <= 1 || dst_size <= 1) {
+            dst_begin = 0;
+            dst_end   = dst_size;
+            return;
+        }
+
+        int64_t const scale = dst_size - 1;
+        int64_t const range = src_size - 1;
+
+        int64_t first = int64_t (std::max (begin - 1, 0)) * scale / range - 1;
+        int64_t last  = (int64_t (std::min (end + 1, src_size)) * scale + range - 1) / range + 1;
+
+        dst_begin = int (std::max<int64_t> (first, 0));
+        dst_end   = int (std::min<int64_t> (last, dst_size));
+    }
+
   } // anonymous namespace
 
 
@@ -60,6 +104,7 @@ namespace LV {
       , buffer  (Buffer::create ())
       , parent  ()
       , compose_type (VISUAL_VIDEO_COMPOSE_TYPE_NONE)
+      , damage_recorded (false)
   {}
 
   Video::Impl::~Impl ()
@@ -321,6 +366,8 @@ namespace LV {
       m_impl->buffer->set_size (m_impl->pitch * m_impl->height);
 
       m_impl->extents = Rect (width, height);
+
+      clear_damage ();
   }
 
   int Video::get_width () const
@@ -408,7 +455,7 @@ namespace LV {
 
   void Video::set_compose_colorkey (Color const& color)
   {
-      m_impl->colorkey->set (0, 0, 0);
+      m_impl->colorkey = color;
   }
 
   void Video::set_compose_surface (uint8_t alpha)
@@ -423,6 +470,27 @@ namespace LV {
 
   VisVideoComposeFunc Video::get_compose_function (VideoConstPtr const& src, bool alpha)
   {
+      /* Indexed sources on 32-bit targets are expanded while composing */
+      if (m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT && src->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT) {
+          switch (src->m_impl->compose_type) {
+              case VISUAL_VIDEO_COMPOSE_TYPE_NONE:
+              case VISUAL_VIDEO_COMPOSE_TYPE_SRC:
+                  return VideoBlit::blit_overlay_index8_noalpha;
+
+              case VISUAL_VIDEO_COMPOSE_TYPE_COLORKEY:
+                  return VideoBlit::blit_overlay_index8_colorkey;
+
+              case VISUAL_VIDEO_COMPOSE_TYPE_SURFACE:
+                  return VideoBlit::blit_overlay_index8_surfacealpha;
+
+              case VISUAL_VIDEO_COMPOSE_TYPE_SURFACECOLORKEY:
+                  return VideoBlit::blit_overlay_index8_surfacealphacolorkey;
+
+              default:
+                  break;
+          }
+      }
+
       switch (src->m_impl->compose_type) {
           case VISUAL_VIDEO_COMPOSE_TYPE_NONE:
               return VideoBlit::blit_overlay_noalpha;
@@ -532,8 +600,14 @@ namespace LV {
 
       VideoPtr transform;
 
+      /* Indexed to 32-bit compose functions read the source palette directly */
+      bool direct = m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT
+                 && src->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT
+                 && src->m_impl->palette.size () == 256
+                 && VideoBlit::is_index8_compose_function (compose_func);
+
       /* We're not the same depth, converting */
-      if (m_impl->depth != src->m_impl->depth) {
+      if (m_impl->depth != src->m_impl->depth && !direct) {
           transform = create (src->m_impl->width, src->m_impl->height, m_impl->depth);
           transform->convert_depth (src);
       }
@@ -858,6 +932,94 @@ namespace LV {
       }
   }
 
+  void Video::add_damage (Rect const& area)
+  {
+      auto merged = Rect (m_impl->width, m_impl->height).clip (area);
+      if (merged.empty ())
+          return;
+
+      if (!m_impl->damage_recorded)
+          set_undamaged ();
+
+      auto& damage = m_impl->damage;
+
+      // Absorb recorded areas the new one overlaps or extends exactly,
+      // repeating as the merged area grows
+      bool absorbed;
+
+      do {
+          absorbed = false;
+
+          for (std::size_t i = 0; i < damage.size ();) {
+              if (merged.intersects (damage[i]) || rects_join (merged, damage[i])) {
+                  merged = merged.unite (damage[i]);
+
+                  damage[i] = damage.back ();
+                  damage.pop_back ();
+
+                  absorbed = true;
+              } else {
+                  i++;
+              }
+          }
+      } while (absorbed);
+
+      damage.push_back (merged);
+
+      if (damage.size () > max_damage_areas) {
+          Rect bounds;
+
+          for (auto const& rect : damage)
+              bounds = bounds.unite (rect);
+
+          damage.assign (1, bounds);
+      }
+  }
+
+  void Video::set_undamaged ()
+  {
+      m_impl->damage.clear ();
+      m_impl->damage_recorded = true;
+  }
+
+  void Video::clear_damage ()
+  {
+      m_impl->damage.clear ();
+      m_impl->damage_recorded = false;
+  }
+
+  bool Video::has_damage () const
+  {
+      return m_impl->damage_recorded;
+  }
+
+  std::vector<Rect> Video::get_damage () const
+  {
+      if (!m_impl->damage_recorded)
+          return { Rect (m_impl->width, m_impl->height) };
+
+      return m_impl->damage;
+  }
+
+  void Video::copy_damage (VideoConstPtr const& src)
+  {
+      clear_damage ();
+
+      if (!src->m_impl->damage_recorded)
+          return;
+
+      // An empty source list carries over
+      set_undamaged ();
+
+      for (auto const& rect : src->m_impl->damage) {
+          int x0, x1, y0, y1;
+          scale_span (rect.x, rect.x + rect.width,  src->m_impl->width,  m_impl->width,  x0, x1);
+          scale_span (rect.y, rect.y + rect.height, src->m_impl->height, m_impl->height, y0, y1);
+
+          add_damage (Rect (x0, y0, x1 - x0, y1 - y0));
+      }
+  }
+
 } // LV namespace
 
 /* VisVideoDepth functions */
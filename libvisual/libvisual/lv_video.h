@@ -121,6 +121,7 @@ struct _VisVideoAttrOptions {
 #include <libvisual/lv_intrusive_ptr.hpp>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 namespace LV {
 
@@ -449,6 +450,58 @@ namespace LV {
                                           VisVideoDepth        depth,
                                           VisVideoScaleMethod  scale_method);
 
+      /**
+       * Records an area of the video as changed.
+       *
+       * Damage is optional. Until an area is recorded, the entire video is
+       * treated as changed. Areas are clipped to the video, and
+       * overlapping areas are merged. Areas that are empty once clipped
+       * are ignored.
+       *
+       * @param area changed area
+       */
+      void add_damage (Rect const& area);
+
+      /**
+       * Records that nothing in the video changed. Only areas recorded
+       * afterwards with add_damage() are treated as changed.
+       */
+      void set_undamaged ();
+
+      /**
+       * Forgets all recorded damage, so that the entire video is treated
+       * as changed again.
+       */
+      void clear_damage ();
+
+      /**
+       * Returns whether any damage has been recorded since the last call
+       * to clear_damage().
+       *
+       * @return true if damage was recorded, false otherwise
+       */
+      bool has_damage () const;
+
+      /**
+       * Returns the changed areas of the video. The areas do not overlap.
+       *
+       * @return list of changed areas, or one area spanning the entire
+       *         video if no damage was recorded
+       */
+      std::vector<Rect> get_damage () const;
+
+      /**
+       * Replaces the damage of this video with the damage of another,
+       * scaled to this video's dimensions.
+       *
+       * This is for use after this video has been filled from the source
+       * by convert_depth() or scale(). Areas are padded to cover rounding
+       * in the scalers.
+       *
+       * @param src source Video
+       */
+      void copy_damage (VideoConstPtr const& src);
+
   private:
 
       friend class VideoConvert;
@@ -549,11 +602,26 @@ LV_API void visual_video_compose_scale_area (VisVideo *dest, VisRectangle *drect
 LV_API void visual_video_blit (VisVideo *dest, VisVideo *src, int x, int y, int alpha);
 LV_API void visual_video_compose (VisVideo *dest, VisVideo *src, int x, int y, VisVideoComposeFunc compfunc);
 
+/* Compose functions for 8-bit indexed sources on 32-bit destinations. The source is expanded through its palette
+ * while composing, so no intermediate 32-bit frame is created. The compose type picks these automatically.
+ * Called directly, they compose src at the top left of dest, clipped to dest. Sources without a full 256 entry
+ * palette, or of other depths, take the generic path. */
+LV_API void visual_video_compose_index8_noalpha      (VisVideo *dest, VisVideo *src);
+LV_API void visual_video_compose_index8_colorkey     (VisVideo *dest, VisVideo *src);
+LV_API void visual_video_compose_index8_surfacealpha (VisVideo *dest, VisVideo *src);
+LV_API void visual_video_compose_index8_surfacealphacolorkey (VisVideo *dest, VisVideo *src);
+
 LV_API void visual_video_fill_alpha       (VisVideo *video, uint8_t density);
 LV_API void visual_video_fill_alpha_area  (VisVideo *video, uint8_t density, VisRectangle *rect);
 LV_API void visual_video_fill_color       (VisVideo *video, VisColor *color);
 LV_API void visual_video_fill_color_area  (VisVideo *video, VisColor *color, VisRectangle *rect);
 
+LV_API void visual_video_add_damage           (VisVideo *video, VisRectangle *area);
+LV_API void visual_video_add_damage_by_values (VisVideo *video, int x, int y, int width, int height);
+LV_API void visual_video_set_undamaged        (VisVideo *video);
+LV_API void visual_video_clear_damage         (VisVideo *video);
+LV_API int  visual_video_has_damage           (VisVideo *video);
+
 LV_API void visual_video_convert_depth    (VisVideo *dest, VisVideo *src);
 LV_API void visual_video_flip_pixel_bytes (VisVideo *dest, VisVideo *src);
 
@@ -27,6 +27,7 @@
 #include <config.h>
 #include "lv_video.h"
 #include "lv_common.h"
+#include "private/lv_video_blit.hpp"
 
 VisVideo *visual_video_new ()
 {
@@ -386,6 +387,38 @@ void visual_video_compose (VisVideo *self, VisVideo *src, int x, int y, VisVideo
     self->compose (LV::VideoPtr (src), x, y, compose_func);
 }
 
+void visual_video_compose_index8_noalpha (VisVideo *dest, VisVideo *src)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src  != nullptr);
+
+    dest->compose (LV::VideoPtr (src), 0, 0, LV::VideoBlit::blit_overlay_index8_noalpha);
+}
+
+void visual_video_compose_index8_colorkey (VisVideo *dest, VisVideo *src)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src  != nullptr);
+
+    dest->compose (LV::VideoPtr (src), 0, 0, LV::VideoBlit::blit_overlay_index8_colorkey);
+}
+
+void visual_video_compose_index8_surfacealpha (VisVideo *dest, VisVideo *src)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src  != nullptr);
+
+    dest->compose (LV::VideoPtr (src), 0, 0, LV::VideoBlit::blit_overlay_index8_surfacealpha);
+}
+
+void visual_video_compose_index8_surfacealphacolorkey (VisVideo *dest, VisVideo *src)
+{
+    visual_return_if_fail (dest != nullptr);
+    visual_return_if_fail (src  != nullptr);
+
+    dest->compose (LV::VideoPtr (src), 0, 0, LV::VideoBlit::blit_overlay_index8_surfacealphacolorkey);
+}
+
 void visual_video_fill_alpha (VisVideo *self, uint8_t alpha)
 {
     visual_return_if_fail (self != nullptr);
@@ -446,6 +479,42 @@ void visual_video_mirror (VisVideo *self, VisVideo *src, VisVideoMirrorOrient or
     self->mirror (LV::VideoPtr (src), orient);
 }
 
+void visual_video_add_damage (VisVideo *self, VisRectangle *area)
+{
+    visual_return_if_fail (self != nullptr);
+    visual_return_if_fail (area != nullptr);
+
+    self->add_damage (*area);
+}
+
+void visual_video_add_damage_by_values (VisVideo *self, int x, int y, int width, int height)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->add_damage (LV::Rect (x, y, width, height));
+}
+
+void visual_video_set_undamaged (VisVideo *self)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->set_undamaged ();
+}
+
+void visual_video_clear_damage (VisVideo *self)
+{
+    visual_return_if_fail (self != nullptr);
+
+    self->clear_damage ();
+}
+
+int visual_video_has_damage (VisVideo *self)
+{
+    visual_return_val_if_fail (self != nullptr, FALSE);
+
+    return self->has_damage ();
+}
+
 void visual_video_convert_depth (VisVideo *self, VisVideo *src)
 {
     visual_return_if_fail (self != nullptr);
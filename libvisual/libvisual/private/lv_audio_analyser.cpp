@@ -0,0 +1,328 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_audio_analyser.hpp"
+#include "lv_common.h"
+#include "lv_math.h"
+#include <algorithm>
+#include <cmath>
+
+namespace LV {
+
+  namespace {
+
+    // Upper edges of the analysis bands in Hz. The last band runs up to
+    // the Nyquist frequency.
+    float const band_edges_hz[VISUAL_AUDIO_ANALYSIS_BAND_COUNT - 1] = {
+        60.0f, 150.0f, 400.0f, 1000.0f, 2500.0f, 6000.0f, 12000.0f
+    };
+
+    // Gain applied before log compression, log (1 + gain * magnitude)
+    float const compression_gain = 1000.0f;
+
+    // Duration of the flux history the threshold is taken from
+    float const threshold_time = 0.5f;
+
+    // The threshold is this multiple of the median flux, plus a floor that
+    // keeps silence and steady tones from triggering
+    float const threshold_multiplier = 1.5f;
+    float const threshold_floor      = 0.02f;
+
+    // Shortest time between two onsets
+    float const min_onset_interval = 0.1f;
+
+    // Duration of the flux envelope searched for a tempo, how often the
+    // tempo is estimated, and the range of tempos considered
+    float const tempo_window   = 6.0f;
+    float const tempo_interval = 0.25f;
+    float const tempo_min_bpm  = 60.0f;
+    float const tempo_max_bpm  = 180.0f;
+
+    // Fraction of the envelope's energy a period must account for to be
+    // taken as the tempo
+    float const tempo_min_confidence = 0.1f;
+
+  } // anonymous namespace
+
+  AudioAnalyser::AudioAnalyser (unsigned int rate)
+  {
+      reset (rate);
+  }
+
+  void AudioAnalyser::reset (unsigned int rate)
+  {
+      m_rate = rate;
+      m_configured = false;
+      m_channel_count = 1;
+
+      for (auto& pending : m_pending)
+          pending.clear ();
+
+      m_onset_count    = 0;
+      m_onset_strength = 0.0f;
+      m_tempo          = 0.0f;
+
+      std::fill_n (m_band_energies, VISUAL_AUDIO_ANALYSIS_BAND_COUNT, 0.0f);
+  }
+
+  void AudioAnalyser::configure ()
+  {
+      auto rate = m_rate;
+
+      m_configured = true;
+
+      // Keep frames around 20 ms long at any rate
+      m_frame_size = 1024;
+      while (m_frame_size * 48000 < rate * 1024)
+          m_frame_size *= 2;
+
+      m_hop_size = m_frame_size / 2;
+
+      m_hop.assign (m_hop_size, 0.0f);
+      m_log_spectrum.assign (m_frame_size / 2, 0.0f);
+      m_compressed.assign (m_frame_size / 2, 0.0f);
+      m_stft.reset (new AudioSTFT (m_frame_size, m_hop_size, VISUAL_AUDIO_WINDOW_HANN));
+
+      m_band_edges.resize (VISUAL_AUDIO_ANALYSIS_BAND_COUNT + 1);
+      m_band_edges[0] = 1; // skip DC
+      for (unsigned int band = 1; band < VISUAL_AUDIO_ANALYSIS_BAND_COUNT; band++) {
+          auto bin = unsigned (band_edges_hz[band - 1] * m_frame_size / rate + 0.5f);
+          m_band_edges[band] = std::min (std::max (bin, m_band_edges[band - 1]), m_frame_size / 2);
+      }
+      m_band_edges[VISUAL_AUDIO_ANALYSIS_BAND_COUNT] = m_frame_size / 2;
+
+      float hop_rate = float (rate) / m_hop_size;
+
+      m_flux_history.assign (std::max (1u, unsigned (threshold_time * hop_rate)), 0.0f);
+      m_envelope.assign (unsigned (tempo_window * hop_rate), 0.0f);
+      m_envelope_pos    = 0;
+      m_hops            = 0;
+      m_last_onset_hop  = 0;
+      m_above_threshold = false;
+  }
+
+  void AudioAnalyser::set_channel_count (unsigned int count)
+  {
+      count = std::min (std::max (count, 1u), 2u);
+
+      if (count == m_channel_count)
+          return;
+
+      // Start the channels off in step
+      for (auto& pending : m_pending)
+          pending.clear ();
+
+      m_channel_count = count;
+  }
+
+  void AudioAnalyser::write (unsigned int channel, float const* samples, std::size_t count)
+  {
+      if (channel >= m_channel_count)
+          return;
+
+      auto& pending = m_pending[channel];
+      pending.insert (pending.end (), samples, samples + count);
+
+      // Without anyone asking for results, keep no more than a tempo
+      // window's worth of samples around. The channels lose the same
+      // number from the front so they stay in step.
+      std::size_t max_pending = std::size_t (tempo_window * m_rate);
+
+      if (pending.size () > max_pending) {
+          std::size_t excess = pending.size () - max_pending;
+
+          for (unsigned int c = 0; c < m_channel_count; c++) {
+              auto& other = m_pending[c];
+              other.erase (other.begin (), other.begin () + std::min (excess, other.size ()));
+          }
+      }
+  }
+
+  void AudioAnalyser::update ()
+  {
+      if (!m_configured)
+          configure ();
+
+      std::size_t available = m_pending[0].size ();
+      if (m_channel_count == 2)
+          available = std::min (available, m_pending[1].size ());
+
+      std::size_t offset = 0;
+
+      // Slide each hop of mixed down samples into the frame
+      while (available - offset >= m_hop_size) {
+          if (m_channel_count == 2) {
+              float const* left  = m_pending[0].data () + offset;
+              float const* right = m_pending[1].data () + offset;
+
+              for (unsigned int i = 0; i < m_hop_size; i++)
+                  m_hop[i] = 0.5f * (left[i] + right[i]);
+
+              m_stft->push (m_hop.data ());
+          } else {
+              m_stft->push (m_pending[0].data () + offset);
+          }
+
+          offset += m_hop_size;
+
+          analyse_frame ();
+      }
+
+      for (unsigned int c = 0; c < m_channel_count; c++)
+          m_pending[c].erase (m_pending[c].begin (), m_pending[c].begin () + offset);
+  }
+
+  void AudioAnalyser::analyse_frame ()
+  {
+      m_hops++;
+
+      auto const spectrum = m_stft->get_spectrum ();
+
+      // Band energies
+
+      for (unsigned int band = 0; band < VISUAL_AUDIO_ANALYSIS_BAND_COUNT; band++) {
+          auto start = m_band_edges[band];
+          auto end   = m_band_edges[band + 1];
+
+          float energy = 0.0f;
+          for (unsigned int bin = start; bin < end; bin++)
+              energy += spectrum[bin] * spectrum[bin];
+
+          m_band_energies[band] = end > start ? energy / (end - start) : 0.0f;
+      }
+
+      // Spectral flux: the mean rise of the compressed spectrum
+
+      float flux = 0.0f;
+      unsigned int bins = m_frame_size / 2;
+
+      float* compressed = m_compressed.data ();
+      visual_math_simd_mul_floats_float (compressed, spectrum, compression_gain, bins);
+      visual_math_simd_add_floats_float (compressed, compressed, 1.0f, bins);
+      visual_math_simd_log_floats (compressed, compressed, bins);
+
+      for (unsigned int bin = 1; bin < bins; bin++) {
+          float rise = m_compressed[bin] - m_log_spectrum[bin];
+
+          if (rise > 0.0f)
+              flux += rise;
+      }
+
+      flux /= bins - 1;
+
+      m_log_spectrum.swap (m_compressed);
+
+      // Adaptive threshold from the median of the recent flux
+
+      m_flux_sorted.assign (m_flux_history.begin (), m_flux_history.end ());
+      auto middle = m_flux_sorted.begin () + m_flux_sorted.size () / 2;
+      std::nth_element (m_flux_sorted.begin (), middle, m_flux_sorted.end ());
+
+      float threshold = threshold_multiplier * *middle + threshold_floor;
+
+      m_flux_history[m_hops % m_flux_history.size ()] = flux;
+
+      m_onset_strength = flux / threshold;
+
+      // An onset is a rise over the threshold, not too soon after the last
+
+      bool above = flux > threshold;
+      auto min_interval = unsigned (min_onset_interval * m_rate / m_hop_size);
+
+      if (above && !m_above_threshold && (m_onset_count == 0 || m_hops - m_last_onset_hop >= min_interval)) {
+          m_onset_count++;
+          m_last_onset_hop = m_hops;
+      }
+
+      m_above_threshold = above;
+
+      // Tempo
+
+      m_envelope[m_envelope_pos] = flux;
+      m_envelope_pos = (m_envelope_pos + 1) % m_envelope.size ();
+
+      auto interval = std::max (1u, unsigned (tempo_interval * m_rate / m_hop_size));
+      if (m_hops % interval == 0)
+          estimate_tempo ();
+  }
+
+  void AudioAnalyser::estimate_tempo ()
+  {
+      auto size = m_envelope.size ();
+
+      // Unroll the ring with its mean removed
+      std::vector<float> envelope (size);
+
+      float mean = 0.0f;
+      for (auto value : m_envelope)
+          mean += value;
+      mean /= size;
+
+      for (std::size_t i = 0; i < size; i++)
+          envelope[i] = m_envelope[(m_envelope_pos + i) % size] - mean;
+
+      float hop_rate = float (m_rate) / m_hop_size;
+
+      auto min_lag = unsigned (60.0f * hop_rate / tempo_max_bpm);
+      auto max_lag = unsigned (60.0f * hop_rate / tempo_min_bpm + 1.0f);
+
+      if (max_lag + 1 >= size) {
+          m_tempo = 0.0f;
+          return;
+      }
+
+      // Autocorrelation over the lags of interest, with one extra on each
+      // side for interpolation
+      std::vector<float> correlation (max_lag + 2, 0.0f);
+
+      for (unsigned int lag = min_lag - 1; lag <= max_lag + 1; lag++) {
+          float sum = 0.0f;
+          for (std::size_t i = lag; i < size; i++)
+              sum += envelope[i] * envelope[i - lag];
+
+          correlation[lag] = sum;
+      }
+
+      float energy = 0.0f;
+      for (auto value : envelope)
+          energy += value * value;
+
+      unsigned int best = min_lag;
+      for (unsigned int lag = min_lag; lag <= max_lag; lag++) {
+          if (correlation[lag] > correlation[best])
+              best = lag;
+      }
+
+      if (energy <= 0.0f || correlation[best] < tempo_min_confidence * energy) {
+          m_tempo = 0.0f;
+          return;
+      }
+
+      // Refine the peak with a parabola through its neighbours
+      float left   = correlation[best - 1];
+      float centre = correlation[best];
+      float right  = correlation[best + 1];
+      float denom  = left - 2.0f * centre + right;
+      float offset = denom < 0.0f ? 0.5f * (left - right) / denom : 0.0f;
+
+      m_tempo = 60.0f * hop_rate / (best + offset);
+  }
+
+} // LV namespace
@@ -0,0 +1,131 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_AUDIO_ANALYSER_HPP
+#define _LV_AUDIO_ANALYSER_HPP
+
+#include "lv_audio.h"
+#include "lv_audio_stft.hpp"
+#include <memory>
+#include <vector>
+
+namespace LV {
+
+  /**
+   * Onset, band energy and tempo analysis of a stream.
+   *
+   * Samples of up to two channels are written in as they arrive, and only
+   * analysed when results are asked for by update(). Streams nobody asks
+   * about cost no more than a copy of their samples.
+   *
+   * The channels are mixed down. Every hop of samples, a windowed frame is
+   * transformed and its log-compressed spectrum compared with the previous
+   * frame's. The rise in magnitude summed over all bins (the spectral flux)
+   * is an onset when it climbs over an adaptive threshold taken from its
+   * recent median. The tempo is the strongest period in the autocorrelation
+   * of the flux over the last few seconds.
+   */
+  class AudioAnalyser
+  {
+  public:
+
+      explicit AudioAnalyser (unsigned int rate);
+
+      AudioAnalyser (AudioAnalyser const&) = delete;
+
+      AudioAnalyser& operator= (AudioAnalyser const&) = delete;
+
+      /**
+       * Restarts analysis at a new sample rate.
+       */
+      void reset (unsigned int rate);
+
+      /**
+       * Sets the number of channels mixed down, 1 or 2.
+       */
+      void set_channel_count (unsigned int count);
+
+      /**
+       * Writes samples of one channel.
+       */
+      void write (unsigned int channel, float const* samples, std::size_t count);
+
+      /**
+       * Analyses every complete hop of samples written so far in all
+       * channels.
+       */
+      void update ();
+
+      unsigned int get_onset_count () const
+      {
+          return m_onset_count;
+      }
+
+      float get_onset_strength () const
+      {
+          return m_onset_strength;
+      }
+
+      float get_tempo () const
+      {
+          return m_tempo;
+      }
+
+      float get_band_energy (unsigned int band) const
+      {
+          return m_band_energies[band];
+      }
+
+  private:
+
+      unsigned int m_rate;
+      bool         m_configured;
+      unsigned int m_frame_size;
+      unsigned int m_hop_size;
+      unsigned int m_channel_count;
+
+      std::vector<float> m_pending[2];   // samples not yet analysed, per channel
+      std::vector<float> m_hop;          // mixed down samples of the next hop
+      std::vector<float> m_log_spectrum; // compressed spectrum of the previous frame
+      std::vector<float> m_compressed;   // compressed spectrum of the current frame
+      std::unique_ptr<AudioSTFT> m_stft;
+
+      std::vector<unsigned int> m_band_edges;  // first bin of each band, plus one past the last
+
+      std::vector<float> m_flux_history;       // recent flux, for the threshold
+      std::vector<float> m_flux_sorted;        // scratch space for its median
+      std::vector<float> m_envelope;           // flux ring over the tempo window
+      unsigned int       m_envelope_pos;
+      unsigned int       m_hops;
+      unsigned int       m_last_onset_hop;
+      bool               m_above_threshold;
+
+      unsigned int m_onset_count;
+      float        m_onset_strength;
+      float        m_tempo;
+      float        m_band_energies[VISUAL_AUDIO_ANALYSIS_BAND_COUNT];
+
+      void configure ();
+      void analyse_frame ();
+      void estimate_tempo ();
+  };
+
+} // LV namespace
+
+#endif // _LV_AUDIO_ANALYSER_HPP
@@ -113,13 +113,27 @@ namespace {
       }
   }
 
+  // Scale factor and offset for int->float conversions. The range is
+  // widened before adding 1, which would overflow for int32_t.
+  template <typename S>
+  inline float int_to_float_scale ()
+  {
+      return 1.0 / (double (half_range<S> ()) + 1);
+  }
+
+  template <typename S>
+  inline float int_to_float_offset ()
+  {
+      return -zero<S>() * int_to_float_scale<S> ();
+  }
+
   // int->float conversions
   template <typename S>
   typename std::enable_if<std::is_integral<S>::value>::type
   inline convert_sample_array (float* dst, S const* src, std::size_t count)
   {
-      float a = 1.0 / (half_range<S> () + 1);
-      float b = -zero<S>() * a;
+      float a = int_to_float_scale<S> ();
+      float b = int_to_float_offset<S> ();
 
       S const* src_end = src + count;
 
@@ -341,6 +355,84 @@ namespace {
       deinterleave_stereo<float>
   };
 
+  // fused int->float conversion and stereo deinterleaving
+  template <typename S>
+  typename std::enable_if<std::is_integral<S>::value>::type
+  inline convert_deinterleave_stereo_sample_array (float* dest1, float* dest2, S const* src, std::size_t frames)
+  {
+      float a = int_to_float_scale<S> ();
+      float b = int_to_float_offset<S> ();
+
+      for (std::size_t i = 0; i < frames; i++) {
+          dest1[i] = src[2*i]   * a + b;
+          dest2[i] = src[2*i+1] * a + b;
+      }
+  }
+
+  inline void convert_deinterleave_stereo_sample_array (float* dest1, float* dest2, float const* src, std::size_t frames)
+  {
+      for (std::size_t i = 0; i < frames; i++) {
+          dest1[i] = src[2*i];
+          dest2[i] = src[2*i+1];
+      }
+  }
+
+  // int->float conversion of one channel in an interleaved stream
+  template <typename S>
+  typename std::enable_if<std::is_integral<S>::value>::type
+  inline convert_channel_sample_array (float* dest, S const* src, std::size_t frames, unsigned int stride)
+  {
+      float a = int_to_float_scale<S> ();
+      float b = int_to_float_offset<S> ();
+
+      for (std::size_t i = 0; i < frames; i++) {
+          dest[i] = src[i * stride] * a + b;
+      }
+  }
+
+  inline void convert_channel_sample_array (float* dest, float const* src, std::size_t frames, unsigned int stride)
+  {
+      for (std::size_t i = 0; i < frames; i++) {
+          dest[i] = src[i * stride];
+      }
+  }
+
+  template <typename S>
+  void convert_channel (float* dest, void const* src, std::size_t frames, unsigned int stride)
+  {
+      convert_channel_sample_array (dest, static_cast<S const*> (src), frames, stride);
+  }
+
+  typedef void (*ConvertChannelFunc)(float*, void const*, std::size_t, unsigned int);
+
+  ConvertChannelFunc const convert_channel_func_table[] = {
+      convert_channel<uint8_t>,
+      convert_channel<int8_t>,
+      convert_channel<uint16_t>,
+      convert_channel<int16_t>,
+      convert_channel<uint32_t>,
+      convert_channel<int32_t>,
+      convert_channel<float>
+  };
+
+  template <typename S>
+  void convert_deinterleave_stereo (float* dest1, float* dest2, void const* src, std::size_t frames)
+  {
+      convert_deinterleave_stereo_sample_array (dest1, dest2, static_cast<S const*> (src), frames);
+  }
+
+  typedef void (*ConvertDeinterleaveStereoFunc)(float*, float*, void const*, std::size_t);
+
+  ConvertDeinterleaveStereoFunc const convert_deinterleave_stereo_func_table[] = {
+      convert_deinterleave_stereo<uint8_t>,
+      convert_deinterleave_stereo<int8_t>,
+      convert_deinterleave_stereo<uint16_t>,
+      convert_deinterleave_stereo<int16_t>,
+      convert_deinterleave_stereo<uint32_t>,
+      convert_deinterleave_stereo<int32_t>,
+      convert_deinterleave_stereo<float>
+  };
+
 } // anonymous namespace
 
 namespace LV {
@@ -375,4 +467,43 @@ namespace LV {
       deinterleave_stereo_func_table[i] (dbuf1, dbuf2, sbuf, size);
   }
 
+  void AudioConvert::convert_deinterleave_stereo_samples (BufferPtr const&         dest1,
+                                                          BufferPtr const&         dest2,
+                                                          BufferConstPtr const&    src,
+                                                          VisAudioSampleFormatType src_format)
+  {
+      auto dbuf1 = static_cast<float*> (dest1->get_data ());
+      auto dbuf2 = static_cast<float*> (dest2->get_data ());
+      auto sbuf = static_cast<uint8_t const*> (src->get_data ());
+
+      std::size_t sample_size = visual_audio_sample_format_get_size (src_format);
+      std::size_t frames = src->get_size () / (sample_size * 2);
+
+      std::size_t done = convert_deinterleave_stereo_simd (dbuf1, dbuf2, sbuf, frames, src_format);
+
+      int i = int (src_format) - 1;
+
+      convert_deinterleave_stereo_func_table[i] (dbuf1 + done,
+                                                 dbuf2 + done,
+                                                 sbuf + done * sample_size * 2,
+                                                 frames - done);
+  }
+
+  void AudioConvert::convert_channel_samples (BufferPtr const&         dest,
+                                              BufferConstPtr const&    src,
+                                              VisAudioSampleFormatType src_format,
+                                              unsigned int             channel,
+                                              unsigned int             channel_count)
+  {
+      auto dbuf = static_cast<float*> (dest->get_data ());
+      auto sbuf = static_cast<uint8_t const*> (src->get_data ());
+
+      std::size_t sample_size = visual_audio_sample_format_get_size (src_format);
+      std::size_t frames = src->get_size () / (sample_size * channel_count);
+
+      int i = int (src_format) - 1;
+
+      convert_channel_func_table[i] (dbuf, sbuf + channel * sample_size, frames, channel_count);
+  }
+
 } // LV namespace
@@ -39,6 +39,45 @@ namespace LV {
                                                BufferPtr const&         dest2,
                                                BufferConstPtr const&    src,
                                                VisAudioSampleFormatType format);
+
+      /**
+       * Converts interleaved stereo samples to float and splits them into
+       * two channels in a single pass.
+       *
+       * @param dest1      left channel, receives size/2 floats
+       * @param dest2      right channel, receives size/2 floats
+       * @param src        interleaved samples
+       * @param src_format format of src
+       */
+      static void convert_deinterleave_stereo_samples (BufferPtr const&         dest1,
+                                                       BufferPtr const&         dest2,
+                                                       BufferConstPtr const&    src,
+                                                       VisAudioSampleFormatType src_format);
+
+      /**
+       * Converts one channel of interleaved samples to float.
+       *
+       * @param dest          output, receives size/channel_count floats
+       * @param src           interleaved samples
+       * @param src_format    format of src
+       * @param channel       index of the channel to extract
+       * @param channel_count number of interleaved channels
+       */
+      static void convert_channel_samples (BufferPtr const&         dest,
+                                           BufferConstPtr const&    src,
+                                           VisAudioSampleFormatType src_format,
+                                           unsigned int             channel,
+                                           unsigned int             channel_count);
+
+  private:
+
+      // SIMD versions of the above for S16, S32 and float input. These return
+      // the number of frames converted, leaving the rest to the C version.
+      static std::size_t convert_deinterleave_stereo_simd (float*                   dest1,
+                                                          float*                   dest2,
+                                                          void const*              src,
+                                                          std::size_t              frames,
+                                                          VisAudioSampleFormatType src_format);
   };
 
 } // LV namespace
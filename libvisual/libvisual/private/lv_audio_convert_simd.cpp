@@ -0,0 +1,281 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_audio_convert.hpp"
+#include "lv_cpu.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64))
+#include <immintrin.h>
+#define LV_HAVE_AVX2_KERNELS 1
+#define LV_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// The kernels below produce exactly the same floats as the C versions in
+// lv_audio_convert.cpp: signed integers are converted with round-to-nearest
+// and scaled by a power of two.
+
+namespace LV {
+
+  namespace {
+
+    float const s16_scale = 1.0f / 32768.0f;
+    float const s32_scale = 1.0f / 2147483648.0f;
+
+#if defined(LV_HAVE_AVX2_KERNELS)
+
+    // The AVX2 kernels are built for any x86 target and only picked when
+    // the CPU and OS support them
+
+    LV_TARGET_AVX2 std::size_t convert_deinterleave_s16_avx2 (float* dest1, float* dest2, int16_t const* src, std::size_t frames)
+    {
+        auto const scale = _mm256_set1_ps (s16_scale);
+
+        std::size_t i = 0;
+
+        // Each 32-bit lane holds one frame, left in the low half
+        for (; i + 8 <= frames; i += 8) {
+            auto v = _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (src + 2*i));
+
+            auto left  = _mm256_srai_epi32 (_mm256_slli_epi32 (v, 16), 16);
+            auto right = _mm256_srai_epi32 (v, 16);
+
+            _mm256_storeu_ps (dest1 + i, _mm256_mul_ps (_mm256_cvtepi32_ps (left),  scale));
+            _mm256_storeu_ps (dest2 + i, _mm256_mul_ps (_mm256_cvtepi32_ps (right), scale));
+        }
+
+        return i;
+    }
+
+    LV_TARGET_AVX2 inline void deinterleave_ps_avx2 (float* dest1, float* dest2, __m256 a, __m256 b)
+    {
+        // Shuffles work within 128-bit lanes, so the halves need reordering
+        auto left  = _mm256_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0));
+        auto right = _mm256_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1));
+
+        left  = _mm256_castpd_ps (_mm256_permute4x64_pd (_mm256_castps_pd (left),  _MM_SHUFFLE (3, 1, 2, 0)));
+        right = _mm256_castpd_ps (_mm256_permute4x64_pd (_mm256_castps_pd (right), _MM_SHUFFLE (3, 1, 2, 0)));
+
+        _mm256_storeu_ps (dest1, left);
+        _mm256_storeu_ps (dest2, right);
+    }
+
+    LV_TARGET_AVX2 std::size_t convert_deinterleave_s32_avx2 (float* dest1, float* dest2, int32_t const* src, std::size_t frames)
+    {
+        auto const scale = _mm256_set1_ps (s32_scale);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= frames; i += 8) {
+            auto a = _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (src + 2*i));
+            auto b = _mm256_loadu_si256 (reinterpret_cast<__m256i const*> (src + 2*i + 8));
+
+            deinterleave_ps_avx2 (dest1 + i, dest2 + i,
+                                  _mm256_mul_ps (_mm256_cvtepi32_ps (a), scale),
+                                  _mm256_mul_ps (_mm256_cvtepi32_ps (b), scale));
+        }
+
+        return i;
+    }
+
+    LV_TARGET_AVX2 std::size_t deinterleave_float_avx2 (float* dest1, float* dest2, float const* src, std::size_t frames)
+    {
+        std::size_t i = 0;
+
+        for (; i + 8 <= frames; i += 8) {
+            deinterleave_ps_avx2 (dest1 + i, dest2 + i,
+                                  _mm256_loadu_ps (src + 2*i),
+                                  _mm256_loadu_ps (src + 2*i + 8));
+        }
+
+        return i;
+    }
+
+#endif // LV_HAVE_AVX2_KERNELS
+
+#if defined(__SSE2__)
+
+    std::size_t convert_deinterleave_s16_sse2 (float* dest1, float* dest2, int16_t const* src, std::size_t frames)
+    {
+        auto const scale = _mm_set1_ps (s16_scale);
+
+        std::size_t i = 0;
+
+        // Each 32-bit lane holds one frame, left in the low half
+        for (; i + 4 <= frames; i += 4) {
+            auto v = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + 2*i));
+
+            auto left  = _mm_srai_epi32 (_mm_slli_epi32 (v, 16), 16);
+            auto right = _mm_srai_epi32 (v, 16);
+
+            _mm_storeu_ps (dest1 + i, _mm_mul_ps (_mm_cvtepi32_ps (left),  scale));
+            _mm_storeu_ps (dest2 + i, _mm_mul_ps (_mm_cvtepi32_ps (right), scale));
+        }
+
+        return i;
+    }
+
+    inline void deinterleave_ps_sse2 (float* dest1, float* dest2, __m128 a, __m128 b)
+    {
+        _mm_storeu_ps (dest1, _mm_shuffle_ps (a, b, _MM_SHUFFLE (2, 0, 2, 0)));
+        _mm_storeu_ps (dest2, _mm_shuffle_ps (a, b, _MM_SHUFFLE (3, 1, 3, 1)));
+    }
+
+    std::size_t convert_deinterleave_s32_sse2 (float* dest1, float* dest2, int32_t const* src, std::size_t frames)
+    {
+        auto const scale = _mm_set1_ps (s32_scale);
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= frames; i += 4) {
+            auto a = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + 2*i));
+            auto b = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + 2*i + 4));
+
+            deinterleave_ps_sse2 (dest1 + i, dest2 + i,
+                                  _mm_mul_ps (_mm_cvtepi32_ps (a), scale),
+                                  _mm_mul_ps (_mm_cvtepi32_ps (b), scale));
+        }
+
+        return i;
+    }
+
+    std::size_t deinterleave_float_sse2 (float* dest1, float* dest2, float const* src, std::size_t frames)
+    {
+        std::size_t i = 0;
+
+        for (; i + 4 <= frames; i += 4) {
+            deinterleave_ps_sse2 (dest1 + i, dest2 + i,
+                                  _mm_loadu_ps (src + 2*i),
+                                  _mm_loadu_ps (src + 2*i + 4));
+        }
+
+        return i;
+    }
+
+#endif // __SSE2__
+
+#if defined(__ARM_NEON)
+
+    std::size_t convert_deinterleave_s16_neon (float* dest1, float* dest2, int16_t const* src, std::size_t frames)
+    {
+        std::size_t i = 0;
+
+        for (; i + 8 <= frames; i += 8) {
+            auto v = vld2q_s16 (src + 2*i);
+
+            vst1q_f32 (dest1 + i,     vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16  (v.val[0]))), s16_scale));
+            vst1q_f32 (dest1 + i + 4, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (v.val[0]))), s16_scale));
+            vst1q_f32 (dest2 + i,     vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16  (v.val[1]))), s16_scale));
+            vst1q_f32 (dest2 + i + 4, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (v.val[1]))), s16_scale));
+        }
+
+        return i;
+    }
+
+    std::size_t convert_deinterleave_s32_neon (float* dest1, float* dest2, int32_t const* src, std::size_t frames)
+    {
+        std::size_t i = 0;
+
+        for (; i + 4 <= frames; i += 4) {
+            auto v = vld2q_s32 (src + 2*i);
+
+            vst1q_f32 (dest1 + i, vmulq_n_f32 (vcvtq_f32_s32 (v.val[0]), s32_scale));
+            vst1q_f32 (dest2 + i, vmulq_n_f32 (vcvtq_f32_s32 (v.val[1]), s32_scale));
+        }
+
+        return i;
+    }
+
+    std::size_t deinterleave_float_neon (float* dest1, float* dest2, float const* src, std::size_t frames)
+    {
+        std::size_t i = 0;
+
+        for (; i + 4 <= frames; i += 4) {
+            auto v = vld2q_f32 (src + 2*i);
+
+            vst1q_f32 (dest1 + i, v.val[0]);
+            vst1q_f32 (dest2 + i, v.val[1]);
+        }
+
+        return i;
+    }
+
+#endif // __ARM_NEON
+
+  } // anonymous namespace
+
+  std::size_t AudioConvert::convert_deinterleave_stereo_simd (float*                   dest1,
+                                                             float*                   dest2,
+                                                             void const*              src,
+                                                             std::size_t              frames,
+                                                             VisAudioSampleFormatType src_format)
+  {
+#if defined(LV_HAVE_AVX2_KERNELS)
+      if (visual_cpu_has_avx2 ()) {
+          switch (src_format) {
+              case VISUAL_AUDIO_SAMPLE_FORMAT_S16:
+                  return convert_deinterleave_s16_avx2 (dest1, dest2, static_cast<int16_t const*> (src), frames);
+              case VISUAL_AUDIO_SAMPLE_FORMAT_S32:
+                  return convert_deinterleave_s32_avx2 (dest1, dest2, static_cast<int32_t const*> (src), frames);
+              case VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT:
+                  return deinterleave_float_avx2 (dest1, dest2, static_cast<float const*> (src), frames);
+              default:
+                  return 0;
+          }
+      }
+#endif
+
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          switch (src_format) {
+              case VISUAL_AUDIO_SAMPLE_FORMAT_S16:
+                  return convert_deinterleave_s16_sse2 (dest1, dest2, static_cast<int16_t const*> (src), frames);
+              case VISUAL_AUDIO_SAMPLE_FORMAT_S32:
+                  return convert_deinterleave_s32_sse2 (dest1, dest2, static_cast<int32_t const*> (src), frames);
+              case VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT:
+                  return deinterleave_float_sse2 (dest1, dest2, static_cast<float const*> (src), frames);
+              default:
+                  return 0;
+          }
+      }
+#elif defined(__ARM_NEON)
+      switch (src_format) {
+          case VISUAL_AUDIO_SAMPLE_FORMAT_S16:
+              return convert_deinterleave_s16_neon (dest1, dest2, static_cast<int16_t const*> (src), frames);
+          case VISUAL_AUDIO_SAMPLE_FORMAT_S32:
+              return convert_deinterleave_s32_neon (dest1, dest2, static_cast<int32_t const*> (src), frames);
+          case VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT:
+              return deinterleave_float_neon (dest1, dest2, static_cast<float const*> (src), frames);
+          default:
+              return 0;
+      }
+#endif
+
+      return 0;
+  }
+
+} // LV namespace
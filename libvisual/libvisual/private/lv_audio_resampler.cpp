@@ -0,0 +1,247 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_audio_resampler.hpp"
+#include "lv_common.h"
+#include "lv_cpu.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace LV {
+
+  namespace {
+
+    // Zero crossings of the sinc on each side of the centre, at full bandwidth
+    unsigned int const sinc_zero_crossings = 16;
+
+    // Passband edge relative to the lower of the two Nyquist frequencies
+    double const sinc_cutoff = 0.9;
+
+    // VISUAL_MATH_PI is only float precision
+    double const pi = 3.14159265358979323846;
+
+    unsigned int gcd (unsigned int a, unsigned int b)
+    {
+        while (b != 0) {
+            unsigned int t = a % b;
+            a = b;
+            b = t;
+        }
+
+        return a;
+    }
+
+    double sinc (double x)
+    {
+        return x == 0.0 ? 1.0 : std::sin (pi * x) / (pi * x);
+    }
+
+    // Blackman window over [-1, 1]
+    double blackman (double x)
+    {
+        return 0.42 + 0.5 * std::cos (pi * x) + 0.08 * std::cos (2.0 * pi * x);
+    }
+
+    // count is a multiple of 4
+    float dot_product_c (float const* a, float const* b, unsigned int count)
+    {
+        float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+
+        for (unsigned int i = 0; i < count; i += 4) {
+            sum0 += a[i]   * b[i];
+            sum1 += a[i+1] * b[i+1];
+            sum2 += a[i+2] * b[i+2];
+            sum3 += a[i+3] * b[i+3];
+        }
+
+        return (sum0 + sum2) + (sum1 + sum3);
+    }
+
+#if defined(__SSE2__)
+
+    float dot_product_sse2 (float const* a, float const* b, unsigned int count)
+    {
+        auto sum = _mm_setzero_ps ();
+
+        for (unsigned int i = 0; i < count; i += 4) {
+            sum = _mm_add_ps (sum, _mm_mul_ps (_mm_loadu_ps (a + i), _mm_loadu_ps (b + i)));
+        }
+
+        sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+        sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+        return _mm_cvtss_f32 (sum);
+    }
+
+#endif // __SSE2__
+
+#if defined(__ARM_NEON)
+
+    float dot_product_neon (float const* a, float const* b, unsigned int count)
+    {
+        auto sum = vdupq_n_f32 (0.0f);
+
+        for (unsigned int i = 0; i < count; i += 4) {
+            sum = vmlaq_f32 (sum, vld1q_f32 (a + i), vld1q_f32 (b + i));
+        }
+
+        auto pair = vadd_f32 (vget_low_f32 (sum), vget_high_f32 (sum));
+
+        return vget_lane_f32 (vpadd_f32 (pair, pair), 0);
+    }
+
+#endif // __ARM_NEON
+
+    typedef float (*DotProductFunc) (float const*, float const*, unsigned int);
+
+    DotProductFunc select_dot_product ()
+    {
+#if defined(__SSE2__)
+        if (visual_cpu_has_sse2 ())
+            return dot_product_sse2;
+#elif defined(__ARM_NEON)
+        return dot_product_neon;
+#endif
+
+        return dot_product_c;
+    }
+
+  } // anonymous namespace
+
+  AudioResampler::AudioResampler (unsigned int in_rate, unsigned int out_rate, VisAudioResampleQuality quality)
+      : m_in_rate (in_rate)
+      , m_quality (quality)
+      , m_pos     (0)
+      , m_phase   (0)
+  {
+      auto divisor = gcd (in_rate, out_rate);
+
+      m_up   = out_rate / divisor;
+      m_down = in_rate  / divisor;
+
+      if (m_quality == VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH) {
+          make_filters ();
+      } else {
+          m_half = 1;
+          m_taps = 2;
+      }
+
+      // Start with silence before the first sample so the filter is primed
+      m_pos = m_half - 1;
+      m_history.assign (m_pos, 0.0f);
+  }
+
+  void AudioResampler::make_filters ()
+  {
+      // When downsampling, the cutoff moves down to the output Nyquist
+      // frequency and the filter widens by the same factor
+      double cutoff = sinc_cutoff * std::min (1.0, double (m_up) / m_down);
+
+      m_half = unsigned (std::ceil (sinc_zero_crossings / cutoff));
+      m_taps = (2 * m_half + 3) & ~3u;
+
+      m_filters.assign (std::size_t (m_up) * m_taps, 0.0f);
+
+      for (unsigned int phase = 0; phase < m_up; phase++) {
+          auto filter = &m_filters[std::size_t (phase) * m_taps];
+
+          double offset = double (phase) / m_up;
+          double sum = 0.0;
+
+          // Tap k weighs input sample (pos - half + 1 + k) for an output at
+          // pos + offset
+          for (unsigned int k = 0; k < 2 * m_half; k++) {
+              double distance = double (k) - (m_half - 1) - offset;
+
+              if (std::abs (distance) >= m_half)
+                  continue;
+
+              double value = cutoff * sinc (cutoff * distance) * blackman (distance / m_half);
+
+              filter[k] = value;
+              sum += value;
+          }
+
+          // Normalise for unity gain at DC
+          for (unsigned int k = 0; k < m_taps; k++)
+              filter[k] /= sum;
+      }
+  }
+
+  std::size_t AudioResampler::get_max_output (std::size_t count) const
+  {
+      return (m_history.size () + count) * m_up / m_down + 1;
+  }
+
+  std::size_t AudioResampler::process (float* dest, float const* src, std::size_t count)
+  {
+      m_history.insert (m_history.end (), src, src + count);
+
+      auto const input = m_history.data ();
+      auto const size  = m_history.size ();
+
+      std::size_t written = 0;
+
+      if (m_quality == VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH) {
+          auto dot_product = select_dot_product ();
+
+          // The padding taps are zero but still read, so they must lie
+          // within the history too
+          while (m_pos + (m_taps - m_half) < size) {
+              auto filter = &m_filters[std::size_t (m_phase) * m_taps];
+
+              dest[written++] = dot_product (filter, input + m_pos - (m_half - 1), m_taps);
+
+              m_phase += m_down;
+              m_pos   += m_phase / m_up;
+              m_phase %= m_up;
+          }
+      } else {
+          float const scale = 1.0f / m_up;
+
+          while (m_pos + 1 < size) {
+              float frac = m_phase * scale;
+
+              dest[written++] = input[m_pos] + (input[m_pos + 1] - input[m_pos]) * frac;
+
+              m_phase += m_down;
+              m_pos   += m_phase / m_up;
+              m_phase %= m_up;
+          }
+      }
+
+      // Drop the samples no future output will need
+      auto consumed = std::min (m_pos - (m_half - 1), size);
+
+      m_history.erase (m_history.begin (), m_history.begin () + consumed);
+      m_pos -= consumed;
+
+      return written;
+  }
+
+} // LV namespace
@@ -0,0 +1,94 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_AUDIO_RESAMPLER_HPP
+#define _LV_AUDIO_RESAMPLER_HPP
+
+#include "lv_audio.h"
+#include <vector>
+
+namespace LV {
+
+  /**
+   * Streaming sample rate converter for one channel of float samples.
+   *
+   * The ratio between the two rates is reduced to L/M, and each output
+   * sample is computed with one of L polyphase filters. The high quality
+   * mode uses Blackman-windowed sinc filters, the low quality mode plain
+   * linear interpolation. Input left over from one call is kept for the
+   * next, so a stream can be fed in blocks of any size.
+   */
+  class AudioResampler
+  {
+  public:
+
+      AudioResampler (unsigned int in_rate, unsigned int out_rate, VisAudioResampleQuality quality);
+
+      AudioResampler (AudioResampler const&) = delete;
+
+      AudioResampler& operator= (AudioResampler const&) = delete;
+
+      unsigned int get_in_rate () const
+      {
+          return m_in_rate;
+      }
+
+      VisAudioResampleQuality get_quality () const
+      {
+          return m_quality;
+      }
+
+      /**
+       * Returns an upper bound on the number of samples produced by
+       * process() for a given number of input samples.
+       */
+      std::size_t get_max_output (std::size_t count) const;
+
+      /**
+       * Resamples a block of samples.
+       *
+       * @param dest  output, must have room for get_max_output (count) samples
+       * @param src   input samples
+       * @param count number of input samples
+       *
+       * @return number of samples written to dest
+       */
+      std::size_t process (float* dest, float const* src, std::size_t count);
+
+  private:
+
+      unsigned int            m_in_rate;
+      VisAudioResampleQuality m_quality;
+
+      unsigned int       m_up;      // L, number of filter phases
+      unsigned int       m_down;    // M, input step per output in 1/L units
+      unsigned int       m_half;    // taps on each side of the centre
+      unsigned int       m_taps;    // filter length, padded to a multiple of 4
+      std::vector<float> m_filters; // m_up filters of m_taps each
+
+      std::vector<float> m_history; // input not yet fully consumed
+      std::size_t        m_pos;     // index of the input sample before the next output
+      unsigned int       m_phase;   // fractional position of the next output, in 1/L units
+
+      void make_filters ();
+  };
+
+} // LV namespace
+
+#endif // _LV_AUDIO_RESAMPLER_HPP
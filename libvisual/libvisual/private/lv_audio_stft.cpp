@@ -0,0 +1,198 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_audio_stft.hpp"
+#include "lv_common.h"
+#include "lv_math.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LV {
+
+  namespace {
+
+    // VISUAL_MATH_PI is only float precision
+    double const pi = 3.14159265358979323846;
+
+    double window_value (VisAudioWindowType window, unsigned int i, unsigned int size)
+    {
+        double x = 2.0 * pi * i / size;
+
+        switch (window) {
+            case VISUAL_AUDIO_WINDOW_HANN:
+                return 0.5 - 0.5 * std::cos (x);
+
+            case VISUAL_AUDIO_WINDOW_BLACKMAN:
+                return 0.42 - 0.5 * std::cos (x) + 0.08 * std::cos (2.0 * x);
+
+            default:
+                return 1.0;
+        }
+    }
+
+    // Maps a frequency in Hz onto a scale where the bands are equally wide
+    double to_scale (VisAudioBandScale scale, double freq)
+    {
+        switch (scale) {
+            case VISUAL_AUDIO_BAND_SCALE_BARK:
+                // Traunmüller's approximation
+                return 26.81 * freq / (1960.0 + freq) - 0.53;
+
+            case VISUAL_AUDIO_BAND_SCALE_MEL:
+                return 2595.0 * std::log10 (1.0 + freq / 700.0);
+
+            default:
+                return std::log (freq);
+        }
+    }
+
+    double from_scale (VisAudioBandScale scale, double value)
+    {
+        switch (scale) {
+            case VISUAL_AUDIO_BAND_SCALE_BARK:
+                return 1960.0 * (value + 0.53) / (26.28 - value);
+
+            case VISUAL_AUDIO_BAND_SCALE_MEL:
+                return 700.0 * (std::pow (10.0, value / 2595.0) - 1.0);
+
+            default:
+                return std::exp (value);
+        }
+    }
+
+  } // anonymous namespace
+
+  AudioSTFT::AudioSTFT (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window)
+      : m_frame_size (frame_size)
+      , m_hop_size   (std::min (std::max (hop_size, 1u), frame_size))
+      , m_frame      (frame_size, 0.0f)
+      , m_window     (frame_size)
+      , m_windowed   (frame_size)
+      , m_spectrum   (frame_size / 2, 0.0f)
+      , m_dft        (frame_size / 2, frame_size)
+  {
+      for (unsigned int i = 0; i < frame_size; i++)
+          m_window[i] = window_value (window, i, frame_size);
+  }
+
+  void AudioSTFT::push (float const* samples)
+  {
+      float* frame = m_frame.data ();
+
+      std::memmove (frame, frame + m_hop_size, (m_frame_size - m_hop_size) * sizeof (float));
+      std::memcpy (frame + (m_frame_size - m_hop_size), samples, m_hop_size * sizeof (float));
+
+      transform_frame ();
+  }
+
+  void AudioSTFT::transform (float const* samples)
+  {
+      std::memcpy (m_frame.data (), samples, m_frame_size * sizeof (float));
+
+      transform_frame ();
+  }
+
+  void AudioSTFT::transform_frame ()
+  {
+      visual_math_simd_mul_floats_floats (m_windowed.data (), m_frame.data (), m_window.data (), m_frame_size);
+
+      m_dft.perform (m_spectrum.data (), m_windowed.data ());
+  }
+
+  AudioBandMatrix::AudioBandMatrix (VisAudioBandScale scale,
+                                    unsigned int band_count,
+                                    float min_freq,
+                                    float max_freq,
+                                    unsigned int spectrum_size,
+                                    unsigned int rate)
+      : m_scale    (scale)
+      , m_min_freq (min_freq)
+      , m_max_freq (max_freq)
+      , m_starts   (band_count)
+      , m_offsets  (band_count + 1)
+  {
+      double bin_width = double (rate) / (2 * spectrum_size);
+
+      // Keep away from DC, which the log scale cannot place
+      double low  = std::max (double (min_freq), bin_width / 2);
+      double high = std::max (std::min (double (max_freq), rate / 2.0), low);
+
+      double scale_low  = to_scale (scale, low);
+      double scale_step = (to_scale (scale, high) - scale_low) / (band_count + 1);
+
+      for (unsigned int band = 0; band < band_count; band++) {
+          double left   = from_scale (scale, scale_low + scale_step * band);
+          double centre = from_scale (scale, scale_low + scale_step * (band + 1));
+          double right  = from_scale (scale, scale_low + scale_step * (band + 2));
+
+          auto first = unsigned (std::ceil (left / bin_width));
+          auto last  = std::min (unsigned (std::floor (right / bin_width)), spectrum_size - 1);
+
+          m_offsets[band] = m_weights.size ();
+
+          double sum = 0.0;
+
+          for (unsigned int bin = first; bin <= last; bin++) {
+              double freq = bin * bin_width;
+              double weight = freq < centre ? (freq - left) / (centre - left)
+                                            : (right - freq) / (right - centre);
+
+              m_weights.push_back (std::max (weight, 0.0));
+              sum += m_weights.back ();
+          }
+
+          // Narrow low bands can fall between two bins. Take the one
+          // nearest the centre instead.
+          if (sum <= 0.0) {
+              m_weights.resize (m_offsets[band]);
+              m_weights.push_back (1.0f);
+
+              first = std::min (unsigned (centre / bin_width + 0.5), spectrum_size - 1);
+              sum = 1.0;
+          }
+
+          m_starts[band] = first;
+
+          for (auto i = m_offsets[band]; i < m_weights.size (); i++)
+              m_weights[i] /= sum;
+      }
+
+      m_offsets[band_count] = m_weights.size ();
+  }
+
+  void AudioBandMatrix::apply (float* bands, float const* spectrum) const
+  {
+      auto const weights = m_weights.data ();
+
+      for (unsigned int band = 0; band < m_starts.size (); band++) {
+          auto const bins = spectrum + m_starts[band];
+          auto count = m_offsets[band + 1] - m_offsets[band];
+          auto const band_weights = weights + m_offsets[band];
+
+          float sum = 0.0f;
+          for (unsigned int i = 0; i < count; i++)
+              sum += band_weights[i] * bins[i];
+
+          bands[band] = sum;
+      }
+  }
+
+} // LV namespace
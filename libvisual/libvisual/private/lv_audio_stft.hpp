@@ -0,0 +1,141 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_AUDIO_STFT_HPP
+#define _LV_AUDIO_STFT_HPP
+
+#include "lv_audio.h"
+#include "lv_fourier.h"
+#include <vector>
+
+namespace LV {
+
+  /**
+   * Short-time Fourier transform over a stream of samples.
+   *
+   * Keeps the last frame_size samples. Each push slides hop_size new
+   * samples in, and the windowed frame is transformed into an amplitude
+   * spectrum of frame_size / 2 bins, which is kept until the next push.
+   */
+  class AudioSTFT
+  {
+  public:
+
+      AudioSTFT (unsigned int frame_size, unsigned int hop_size, VisAudioWindowType window);
+
+      AudioSTFT (AudioSTFT const&) = delete;
+
+      AudioSTFT& operator= (AudioSTFT const&) = delete;
+
+      unsigned int get_frame_size () const
+      {
+          return m_frame_size;
+      }
+
+      unsigned int get_hop_size () const
+      {
+          return m_hop_size;
+      }
+
+      unsigned int get_spectrum_size () const
+      {
+          return m_frame_size / 2;
+      }
+
+      /**
+       * Slides a hop of samples into the frame and transforms it.
+       *
+       * @param samples hop_size samples
+       */
+      void push (float const* samples);
+
+      /**
+       * Replaces the frame and transforms it.
+       *
+       * @param samples frame_size samples
+       */
+      void transform (float const* samples);
+
+      /**
+       * Returns the amplitude spectrum of the last frame transformed.
+       */
+      float const* get_spectrum () const
+      {
+          return m_spectrum.data ();
+      }
+
+  private:
+
+      unsigned int       m_frame_size;
+      unsigned int       m_hop_size;
+      std::vector<float> m_frame;
+      std::vector<float> m_window;
+      std::vector<float> m_windowed;
+      std::vector<float> m_spectrum;
+      DFT                m_dft;
+
+      void transform_frame ();
+  };
+
+  /**
+   * Sparse matrix summing the bins of an amplitude spectrum into bands.
+   *
+   * Bands are triangular filters whose centres are equally spaced on a
+   * log, Bark or mel frequency scale. Each band only stores the weights of
+   * the bins it overlaps, normalised to sum to one, so a band's value is a
+   * weighted average amplitude.
+   */
+  class AudioBandMatrix
+  {
+  public:
+
+      AudioBandMatrix (VisAudioBandScale scale,
+                       unsigned int band_count,
+                       float min_freq,
+                       float max_freq,
+                       unsigned int spectrum_size,
+                       unsigned int rate);
+
+      bool matches (VisAudioBandScale scale, unsigned int band_count, float min_freq, float max_freq) const
+      {
+          return scale == m_scale && band_count == m_starts.size ()
+              && min_freq == m_min_freq && max_freq == m_max_freq;
+      }
+
+      /**
+       * Computes band values from a spectrum.
+       *
+       * @param bands    output, one value per band
+       * @param spectrum amplitude spectrum of spectrum_size bins
+       */
+      void apply (float* bands, float const* spectrum) const;
+
+  private:
+
+      VisAudioBandScale         m_scale;
+      float                     m_min_freq;
+      float                     m_max_freq;
+      std::vector<unsigned int> m_starts;  // first bin of each band
+      std::vector<unsigned int> m_offsets; // start of each band's weights, plus one past the last
+      std::vector<float>        m_weights;
+  };
+
+} // LV namespace
+
+#endif // _LV_AUDIO_STFT_HPP
@@ -25,6 +25,8 @@
 #include "private/lv_audio_stream.hpp"
 #include "lv_common.h"
 
+#include <algorithm>
+#include <cmath>
 #include <list>
 
 namespace LV {
@@ -42,7 +44,19 @@ namespace LV {
       struct Fragment
       {
           BufferConstPtr buffer;
-          Time           timestamp;
+          Time           timestamp;    // capture time of the first sample
+          Time           arrival_time;
+          unsigned int   rate;
+
+          double get_start () const
+          {
+              return timestamp.to_secs ();
+          }
+
+          double get_end () const
+          {
+              return get_start () + double (buffer->get_size () / sizeof (float)) / rate;
+          }
       };
 
       typedef std::list<Fragment> FragmentList;
@@ -53,6 +67,12 @@ namespace LV {
       Impl ();
 
       void remove_stale_fragments (Time const& time);
+
+      // Reads nbytes ending skip bytes before the end of the stream
+      std::size_t read (BufferPtr const& buffer, std::size_t nbytes, std::size_t skip);
+
+      // Number of bytes captured after a given time
+      std::size_t get_size_after (Time const& time) const;
   };
 
   AudioStream::Impl::Impl ()
@@ -63,14 +83,73 @@ namespace LV {
 
   void AudioStream::Impl::remove_stale_fragments (Time const& time)
   {
-      fragments.remove_if ([&] (Fragment const& fragment) -> bool {
-          if ((time - fragment.timestamp).to_usecs () > max_lifetime) {
-              size -= fragment.buffer->get_size ();
-              return true;
+      // Fragments are written in time order, so the stale ones are all at
+      // the front. They are aged by arrival, as capture times can be
+      // arbitrarily old.
+      while (!fragments.empty () && (time - fragments.front ().arrival_time).to_usecs () > max_lifetime) {
+          size -= fragments.front ().buffer->get_size ();
+          fragments.pop_front ();
+      }
+  }
+
+  std::size_t AudioStream::Impl::read (BufferPtr const& buffer, std::size_t nbytes, std::size_t skip)
+  {
+      if (skip >= size) {
+          return 0;
+      }
+
+      // Truncate if read buffer is too small, or there is too little to read
+      nbytes = std::min ({ nbytes, buffer->get_size (), size - skip });
+
+      std::size_t end   = size - skip;
+      std::size_t begin = end - nbytes;
+
+      // Walk back from the latest fragment to the first one needed
+      auto fragment = fragments.end ();
+      std::size_t fragment_start = size;
+
+      while (fragment_start > begin) {
+          --fragment;
+          fragment_start -= fragment->buffer->get_size ();
+      }
+
+      std::size_t write_offset = 0;
+
+      for (; write_offset < nbytes; ++fragment) {
+          std::size_t fragment_size = fragment->buffer->get_size ();
+
+          std::size_t from = begin + write_offset - fragment_start;
+          std::size_t to   = std::min (fragment_size, end - fragment_start);
+
+          buffer->put (fragment->buffer->get_data (from), to - from, write_offset);
+
+          write_offset   += to - from;
+          fragment_start += fragment_size;
+      }
+
+      return nbytes;
+  }
+
+  std::size_t AudioStream::Impl::get_size_after (Time const& time) const
+  {
+      double t = time.to_secs ();
+      std::size_t after = 0;
+
+      for (auto fragment = fragments.rbegin (); fragment != fragments.rend (); ++fragment) {
+          std::size_t fragment_size = fragment->buffer->get_size ();
+
+          if (t >= fragment->get_start ()) {
+              // Samples up to and including the one captured at time
+              double count = std::floor ((t - fragment->get_start ()) * fragment->rate) + 1;
+              std::size_t before = std::min (std::size_t (count) * sizeof (float), fragment_size);
+
+              return after + fragment_size - before;
           }
 
-          return false;
-      });
+          after += fragment_size;
+      }
+
+      return after;
   }
 
   AudioStream::AudioStream ()
@@ -89,13 +168,15 @@ namespace LV {
       return m_impl->size;
   }
 
-  void AudioStream::write (BufferConstPtr const& buffer, Time const& timestamp)
+  void AudioStream::write (BufferConstPtr const& buffer, Time const& timestamp, unsigned int rate)
   {
+      auto now = Time::now ();
+
       // Invalidate stale fragments
-      m_impl->remove_stale_fragments (Time::now ());
+      m_impl->remove_stale_fragments (now);
 
       // Add fragment to list
-      m_impl->fragments.push_back ({ buffer, timestamp });
+      m_impl->fragments.push_back ({ buffer, timestamp, now, rate });
       m_impl->size += buffer->get_size ();
   }
 
@@ -103,63 +184,23 @@ namespace LV {
   {
       visual_return_val_if_fail (nbytes > 0, 0);
 
-      // Return if there are no fragments
-      if (m_impl->fragments.empty ()) {
-          return 0;
-      }
-
-      // Truncate if read buffer is too small
-      nbytes = std::min (nbytes, buffer->get_size ());
-
-      std::size_t size = 0;
-      std::size_t offset = 0;
-
-      auto last_fragment = m_impl->fragments.rbegin ();
-
-      auto fragment = last_fragment;
-
-      // Find the oldest fragment to read from
-      if (nbytes <= m_impl->size) {
-          while (fragment != m_impl->fragments.rend ()) {
-              size += fragment->buffer->get_size ();
-              if (size >= nbytes) {
-                  offset = size - nbytes;
-                  break;
-              }
-              ++fragment;
-          }
-      } else {
-          fragment = m_impl->fragments.rend (); --fragment;
-          nbytes = m_impl->size;
-      }
-
-      std::size_t write_offset = 0;
-
-      // Copy out a portion of the first fragment if its data is only partially needed
-      if (offset > 0) {
-          std::size_t size = fragment->buffer->get_size () - offset;
-          buffer->put (fragment->buffer->get_data (offset), size, write_offset);
+      return m_impl->read (buffer, nbytes, 0);
+  }
 
-          // Finish if this is the only fragment
-          if (fragment == last_fragment) {
-              return nbytes;
-          }
+  std::size_t AudioStream::read_at (BufferPtr const& buffer, std::size_t nbytes, Time const& time)
+  {
+      visual_return_val_if_fail (nbytes > 0, 0);
 
-          write_offset += size;
-          --fragment;
-      }
+      return m_impl->read (buffer, nbytes, m_impl->get_size_after (time));
+  }
 
-      // Copy out data in the remaining fragments
-      while (fragment != last_fragment) {
-          buffer->put (fragment->buffer, write_offset);
-          write_offset += fragment->buffer->get_size ();
-          --fragment;
+  Time AudioStream::get_end_time () const
+  {
+      if (m_impl->fragments.empty ()) {
+          return Time ();
       }
 
-      // Copy out data in the last fragment
-      buffer->put (fragment->buffer, write_offset);
-
-      return nbytes;
+      return Time::from_secs (m_impl->fragments.back ().get_end ());
   }
 
 } // LV namespace
@@ -47,10 +47,39 @@ namespace LV {
 
       std::size_t get_size () const;
 
-      void write (BufferConstPtr const& buffer, Time const& timestamp);
-
+      /**
+       * Appends samples to the stream.
+       *
+       * @param buffer    samples
+       * @param timestamp capture time of the first sample
+       * @param rate      sample rate
+       */
+      void write (BufferConstPtr const& buffer, Time const& timestamp, unsigned int rate);
+
+      /**
+       * Reads the latest samples.
+       *
+       * @return number of bytes read
+       */
       std::size_t read (BufferPtr const& buffer, std::size_t nbytes);
 
+      /**
+       * Reads the samples that end with the one captured at a given time.
+       *
+       * Times past the latest sample read the latest samples. If there are
+       * not enough samples before the time, the buffer is filled from the
+       * start as with read().
+       *
+       * @return number of bytes read
+       */
+      std::size_t read_at (BufferPtr const& buffer, std::size_t nbytes, Time const& time);
+
+      /**
+       * Returns the capture time just past the latest sample, or a zero
+       * time if the stream is empty.
+       */
+      Time get_end_time () const;
+
   private:
 
       class Impl;
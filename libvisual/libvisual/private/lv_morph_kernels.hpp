@@ -0,0 +1,61 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_MORPH_KERNELS_HPP
+#define _LV_MORPH_KERNELS_HPP
+
+#include "lvconfig.h"
+#include "lv_defines.h"
+#include "lv_types.h"
+#include <cstddef>
+
+namespace LV {
+
+  /**
+   * Row kernels behind the morph kernels. Crossfades use the alpha blend
+   * kernels of VideoBlend.
+   *
+   * Brightening rounds to nearest, (x + 128 + ((x + 128) >> 8)) >> 8
+   * standing in for x / 255, so the SIMD and C versions agree bit for bit.
+   */
+  class MorphKernels
+  {
+  public:
+
+      /**
+       * Moves bytes towards 255 by amount / 255 of the way.
+       */
+      static void brighten_bytes (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount);
+
+      /**
+       * Moves each channel of RGB565 pixels towards white by amount / 255 of the way.
+       */
+      static void brighten_rgb565 (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount);
+
+  private:
+
+      // SIMD versions of the above. These return the number of elements
+      // done, leaving the rest to the C version.
+      static std::size_t brighten_bytes_simd  (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount);
+      static std::size_t brighten_rgb565_simd (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount);
+  };
+
+} // LV namespace
+
+#endif // _LV_MORPH_KERNELS_HPP
@@ -0,0 +1,200 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_morph_kernels.hpp"
+#include "lv_cpu.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace LV {
+
+  namespace {
+
+#if defined(__SSE2__)
+
+    // Rounded division of 16-bit lanes holding at most 255 * 255 by 255
+    inline __m128i div255_epu16 (__m128i x)
+    {
+        x = _mm_add_epi16 (x, _mm_set1_epi16 (128));
+        return _mm_srli_epi16 (_mm_add_epi16 (x, _mm_srli_epi16 (x, 8)), 8);
+    }
+
+    // Interpolates 16-bit lanes holding values of up to 8 bits
+    inline __m128i lerp_epu16 (__m128i a, __m128i b, __m128i weight_a, __m128i weight_b)
+    {
+        return div255_epu16 (_mm_add_epi16 (_mm_mullo_epi16 (a, weight_a), _mm_mullo_epi16 (b, weight_b)));
+    }
+
+    inline __m128i lerp_epu8 (__m128i a, __m128i b, __m128i weight_a, __m128i weight_b)
+    {
+        auto const zero = _mm_setzero_si128 ();
+
+        auto lo = lerp_epu16 (_mm_unpacklo_epi8 (a, zero), _mm_unpacklo_epi8 (b, zero), weight_a, weight_b);
+        auto hi = lerp_epu16 (_mm_unpackhi_epi8 (a, zero), _mm_unpackhi_epi8 (b, zero), weight_a, weight_b);
+
+        return _mm_packus_epi16 (lo, hi);
+    }
+
+    inline __m128i lerp_rgb565 (__m128i a, __m128i b, __m128i weight_a, __m128i weight_b)
+    {
+        auto const mask5 = _mm_set1_epi16 (0x1f);
+        auto const mask6 = _mm_set1_epi16 (0x3f);
+
+        auto r = lerp_epu16 (_mm_srli_epi16 (a, 11), _mm_srli_epi16 (b, 11), weight_a, weight_b);
+        auto g = lerp_epu16 (_mm_and_si128 (_mm_srli_epi16 (a, 5), mask6),
+                             _mm_and_si128 (_mm_srli_epi16 (b, 5), mask6), weight_a, weight_b);
+        auto bl = lerp_epu16 (_mm_and_si128 (a, mask5), _mm_and_si128 (b, mask5), weight_a, weight_b);
+
+        return _mm_or_si128 (_mm_slli_epi16 (r, 11), _mm_or_si128 (_mm_slli_epi16 (g, 5), bl));
+    }
+
+    std::size_t brighten_bytes_sse2 (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount)
+    {
+        auto const weight1 = _mm_set1_epi16 (255 - amount);
+        auto const weight2 = _mm_set1_epi16 (amount);
+        auto const white   = _mm_set1_epi8 (char (0xff));
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto a = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + i));
+
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), lerp_epu8 (a, white, weight1, weight2));
+        }
+
+        return i;
+    }
+
+    std::size_t brighten_rgb565_sse2 (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount)
+    {
+        auto const weight1 = _mm_set1_epi16 (255 - amount);
+        auto const weight2 = _mm_set1_epi16 (amount);
+        auto const white   = _mm_set1_epi16 (short (0xffff));
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto a = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + i));
+
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dest + i), lerp_rgb565 (a, white, weight1, weight2));
+        }
+
+        return i;
+    }
+
+#endif // __SSE2__
+
+#if defined(__ARM_NEON)
+
+    // Rounded division by 255 narrowed to bytes: (x + 128 + ((x + 128) >> 8)) >> 8
+    inline uint8x8_t lerp_u8 (uint8x8_t a, uint8x8_t b, uint8x8_t weight_a, uint8x8_t weight_b)
+    {
+        auto x = vmlal_u8 (vmull_u8 (a, weight_a), b, weight_b);
+        return vraddhn_u16 (x, vrshrq_n_u16 (x, 8));
+    }
+
+    inline uint8x16_t lerp_u8q (uint8x16_t a, uint8x16_t b, uint8x8_t weight_a, uint8x8_t weight_b)
+    {
+        return vcombine_u8 (lerp_u8 (vget_low_u8  (a), vget_low_u8  (b), weight_a, weight_b),
+                            lerp_u8 (vget_high_u8 (a), vget_high_u8 (b), weight_a, weight_b));
+    }
+
+    inline uint16x8_t lerp_u16 (uint16x8_t a, uint16x8_t b, uint16x8_t weight_a, uint16x8_t weight_b)
+    {
+        auto x = vaddq_u16 (vmlaq_u16 (vmulq_u16 (a, weight_a), b, weight_b), vdupq_n_u16 (128));
+        return vshrq_n_u16 (vsraq_n_u16 (x, x, 8), 8);
+    }
+
+    inline uint16x8_t lerp_rgb565 (uint16x8_t a, uint16x8_t b, uint16x8_t weight_a, uint16x8_t weight_b)
+    {
+        auto const mask5 = vdupq_n_u16 (0x1f);
+        auto const mask6 = vdupq_n_u16 (0x3f);
+
+        auto r  = lerp_u16 (vshrq_n_u16 (a, 11), vshrq_n_u16 (b, 11), weight_a, weight_b);
+        auto g  = lerp_u16 (vandq_u16 (vshrq_n_u16 (a, 5), mask6),
+                            vandq_u16 (vshrq_n_u16 (b, 5), mask6), weight_a, weight_b);
+        auto bl = lerp_u16 (vandq_u16 (a, mask5), vandq_u16 (b, mask5), weight_a, weight_b);
+
+        return vorrq_u16 (vshlq_n_u16 (r, 11), vorrq_u16 (vshlq_n_u16 (g, 5), bl));
+    }
+
+    std::size_t brighten_bytes_neon (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount)
+    {
+        auto const weight1 = vdup_n_u8 (255 - amount);
+        auto const weight2 = vdup_n_u8 (amount);
+        auto const white   = vdupq_n_u8 (0xff);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+            vst1q_u8 (dest + i, lerp_u8q (vld1q_u8 (src + i), white, weight1, weight2));
+
+        return i;
+    }
+
+    std::size_t brighten_rgb565_neon (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount)
+    {
+        auto const weight1 = vdupq_n_u16 (255 - amount);
+        auto const weight2 = vdupq_n_u16 (amount);
+        auto const white   = vdupq_n_u16 (0xffff);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+            vst1q_u16 (dest + i, lerp_rgb565 (vld1q_u16 (src + i), white, weight1, weight2));
+
+        return i;
+    }
+
+#endif // __ARM_NEON
+
+  } // anonymous namespace
+
+  std::size_t MorphKernels::brighten_bytes_simd (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t amount)
+  {
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ())
+          return brighten_bytes_sse2 (dest, src, count, amount);
+#elif defined(__ARM_NEON)
+      return brighten_bytes_neon (dest, src, count, amount);
+#endif
+
+      return 0;
+  }
+
+  std::size_t MorphKernels::brighten_rgb565_simd (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t amount)
+  {
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ())
+          return brighten_rgb565_sse2 (dest, src, count, amount);
+#elif defined(__ARM_NEON)
+      return brighten_rgb565_neon (dest, src, count, amount);
+#endif
+
+      return 0;
+  }
+
+} // LV namespace
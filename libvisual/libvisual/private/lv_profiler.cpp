@@ -0,0 +1,322 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "private/lv_profiler.hpp"
+#include "private/lv_time_system.hpp"
+#include "lv_common.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace LV {
+
+  namespace {
+
+    // Histograms have 16 linear buckets per power of two, which bounds the
+    // error of a bucket's midpoint to 1/32
+    constexpr unsigned int sub_bucket_bits  = 4;
+    constexpr unsigned int sub_bucket_count = 1 << sub_bucket_bits;
+    constexpr unsigned int bucket_count     = 2 * sub_bucket_count + (63 - sub_bucket_bits) * sub_bucket_count;
+
+    // Trace events beyond this are dropped
+    constexpr std::size_t max_trace_events = 1 << 20;
+
+    unsigned int bucket_index (uint64_t value)
+    {
+        if (value < 2 * sub_bucket_count)
+            return value;
+
+        unsigned int exponent = 63 - __builtin_clzll (value);
+        unsigned int shift    = exponent - sub_bucket_bits;
+
+        return 2 * sub_bucket_count + (shift - 1) * sub_bucket_count + ((value >> shift) & (sub_bucket_count - 1));
+    }
+
+    double bucket_midpoint (unsigned int index)
+    {
+        if (index < 2 * sub_bucket_count)
+            return index;
+
+        unsigned int shift = (index - 2 * sub_bucket_count) / sub_bucket_count + 1;
+        uint64_t     lower = uint64_t (sub_bucket_count + index % sub_bucket_count) << shift;
+
+        return lower + (uint64_t (1) << shift) / 2.0;
+    }
+
+    int64_t to_nsecs (Time const& time)
+    {
+        return int64_t (time.sec) * VISUAL_NSECS_PER_SEC + time.nsec;
+    }
+
+    struct Series
+    {
+        uint64_t count;
+        uint64_t total;
+        uint64_t max;
+        std::array<uint64_t, bucket_count> buckets;
+
+        Series ()
+            : count (0)
+            , total (0)
+            , max   (0)
+        {
+            buckets.fill (0);
+        }
+
+        void add (uint64_t duration)
+        {
+            count++;
+            total += duration;
+            max = std::max (max, duration);
+            buckets[bucket_index (duration)]++;
+        }
+
+        double percentile (double p) const
+        {
+            auto rank = std::max (uint64_t (1), uint64_t (p * count + 0.5));
+
+            uint64_t seen = 0;
+
+            for (unsigned int i = 0; i < bucket_count; i++) {
+                seen += buckets[i];
+                if (seen >= rank)
+                    return std::min (bucket_midpoint (i), double (max));
+            }
+
+            return max;
+        }
+    };
+
+    struct TraceEvent
+    {
+        VisProfileStage stage;
+        unsigned int    name;
+        unsigned int    thread;
+        int64_t         start;
+        int64_t         duration;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+
+        std::map<std::pair<VisProfileStage, std::string>, Series> series;
+
+        bool                     tracing;
+        bool                     trace_full;
+        std::string              trace_filename;
+        int64_t                  trace_origin;
+        std::vector<TraceEvent>  trace_events;
+        std::vector<std::string> trace_names;
+
+        std::map<std::thread::id, unsigned int> threads;
+
+        State ()
+            : tracing      (false)
+            , trace_full   (false)
+            , trace_origin (0)
+        {}
+
+        unsigned int intern_name (std::string const& name)
+        {
+            auto entry = std::find (trace_names.begin (), trace_names.end (), name);
+            if (entry != trace_names.end ())
+                return entry - trace_names.begin ();
+
+            trace_names.push_back (name);
+            return trace_names.size () - 1;
+        }
+
+        unsigned int thread_index ()
+        {
+            return threads.emplace (std::this_thread::get_id (), threads.size ()).first->second;
+        }
+    };
+
+    State& get_state ()
+    {
+        static State state;
+        return state;
+    }
+
+    void write_json_string (std::FILE* file, std::string const& str)
+    {
+        std::fputc ('"', file);
+
+        for (auto c : str) {
+            if (c == '"' || c == '\\')
+                std::fputc ('\\', file);
+
+            if (static_cast<unsigned char> (c) >= 0x20)
+                std::fputc (c, file);
+        }
+
+        std::fputc ('"', file);
+    }
+
+  } // anonymous namespace
+
+  std::atomic<bool> Profiler::s_enabled {false};
+
+  void Profiler::set_enabled (bool enabled)
+  {
+      s_enabled.store (enabled, std::memory_order_relaxed);
+  }
+
+  void Profiler::record (VisProfileStage stage, std::string const& name, Time const& start, Time const& end)
+  {
+      auto duration = std::max (int64_t (0), to_nsecs (end) - to_nsecs (start));
+
+      auto& state = get_state ();
+      std::lock_guard<std::mutex> lock {state.mutex};
+
+      state.series[std::make_pair (stage, name)].add (duration);
+
+      if (!state.tracing)
+          return;
+
+      if (state.trace_events.size () >= max_trace_events) {
+          if (!state.trace_full) {
+              visual_log (VISUAL_LOG_WARNING, "Trace is full, dropping further events");
+              state.trace_full = true;
+          }
+
+          return;
+      }
+
+      state.trace_events.push_back ({ stage,
+                                      state.intern_name (name),
+                                      state.thread_index (),
+                                      to_nsecs (start) - state.trace_origin,
+                                      duration });
+  }
+
+  std::vector<ProfileStats> Profiler::get_stats ()
+  {
+      auto& state = get_state ();
+      std::lock_guard<std::mutex> lock {state.mutex};
+
+      std::vector<ProfileStats> stats;
+      stats.reserve (state.series.size ());
+
+      // Durations are kept in nanoseconds
+      double const scale = 1.0 / VISUAL_NSECS_PER_USEC;
+
+      for (auto const& entry : state.series) {
+          auto const& series = entry.second;
+
+          stats.push_back ({ entry.first.first,
+                             entry.first.second,
+                             series.count,
+                             series.total * scale / series.count,
+                             series.percentile (0.50) * scale,
+                             series.percentile (0.95) * scale,
+                             series.percentile (0.99) * scale,
+                             series.max * scale });
+      }
+
+      return stats;
+  }
+
+  void Profiler::reset ()
+  {
+      auto& state = get_state ();
+      std::lock_guard<std::mutex> lock {state.mutex};
+
+      state.series.clear ();
+  }
+
+  bool Profiler::start_trace (std::string const& filename)
+  {
+      auto& state = get_state ();
+      std::lock_guard<std::mutex> lock {state.mutex};
+
+      if (state.tracing) {
+          visual_log (VISUAL_LOG_ERROR, "A trace is already being recorded");
+          return false;
+      }
+
+      // Fail early rather than after recording
+      auto file = std::fopen (filename.c_str (), "w");
+      if (!file) {
+          visual_log (VISUAL_LOG_ERROR, "Failed to open trace file '%s'", filename.c_str ());
+          return false;
+      }
+
+      std::fclose (file);
+
+      state.tracing        = true;
+      state.trace_full     = false;
+      state.trace_filename = filename;
+      state.trace_origin   = to_nsecs (TimeSystem::now ());
+      state.trace_events.clear ();
+      state.trace_names.clear ();
+
+      return true;
+  }
+
+  void Profiler::stop_trace ()
+  {
+      auto& state = get_state ();
+      std::lock_guard<std::mutex> lock {state.mutex};
+
+      if (!state.tracing)
+          return;
+
+      state.tracing = false;
+
+      auto file = std::fopen (state.trace_filename.c_str (), "w");
+      if (!file) {
+          visual_log (VISUAL_LOG_ERROR, "Failed to open trace file '%s'", state.trace_filename.c_str ());
+          return;
+      }
+
+      // Complete events ("ph": "X") with times in microseconds
+      std::fputs ("{\"traceEvents\":[", file);
+
+      for (std::size_t i = 0; i < state.trace_events.size (); i++) {
+          auto const& event = state.trace_events[i];
+          auto const& name  = state.trace_names[event.name];
+
+          std::fputs (i > 0 ? ",\n" : "\n", file);
+          std::fputs ("{\"name\":", file);
+          write_json_string (file, std::string (visual_profile_stage_name (event.stage)) + " " + name);
+          std::fprintf (file, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"plugin\":",
+                        visual_profile_stage_name (event.stage),
+                        event.start * 1e-3,
+                        event.duration * 1e-3,
+                        event.thread);
+          write_json_string (file, name);
+          std::fputs ("}}", file);
+      }
+
+      std::fputs ("\n],\"displayTimeUnit\":\"ms\"}\n", file);
+      std::fclose (file);
+
+      state.trace_events.clear ();
+      state.trace_events.shrink_to_fit ();
+      state.trace_names.clear ();
+  }
+
+} // LV namespace
@@ -0,0 +1,67 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_PROFILER_HPP
+#define _LV_PROFILER_HPP
+
+#include "lv_profiler.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace LV {
+
+  /**
+   * Collects stage timings for the frame profiler.
+   *
+   * Timings are recorded from any thread.
+   */
+  class Profiler
+  {
+  public:
+
+      static bool is_enabled ()
+      {
+          return s_enabled.load (std::memory_order_relaxed);
+      }
+
+      static void set_enabled (bool enabled);
+
+      static void record (VisProfileStage stage, std::string const& name, Time const& start, Time const& end);
+
+      static std::vector<ProfileStats> get_stats ();
+
+      static void reset ();
+
+      /**
+       * Starts recording every timing as a trace event, to be written out
+       * as Chrome trace event JSON by stop_trace().
+       */
+      static bool start_trace (std::string const& filename);
+
+      static void stop_trace ();
+
+  private:
+
+      static std::atomic<bool> s_enabled;
+  };
+
+} // LV namespace
+
+#endif // _LV_PROFILER_HPP
@@ -0,0 +1,121 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_row_bands.hpp"
+#include "lv_worker_thread.hpp"
+#include "lv_common.h"
+#include "lv_util.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LV {
+
+  namespace {
+
+    // Below this, waking the workers costs more than it saves
+    std::size_t const min_split_bytes = 256 * 1024;
+    int const         min_band_rows   = 16;
+    unsigned int const max_workers    = 7;
+
+    // Set while the current thread is running a band
+    thread_local bool in_band = false;
+
+    class RowBandPool
+    {
+    public:
+
+        std::mutex                                 mutex;
+        std::vector<std::unique_ptr<WorkerThread>> workers;
+
+        static RowBandPool& instance ()
+        {
+            static RowBandPool pool;
+            return pool;
+        }
+
+    private:
+
+        RowBandPool ()
+        {
+            auto cpus = std::thread::hardware_concurrency ();
+            auto count = std::min (cpus > 1 ? cpus - 1 : 0, max_workers);
+
+            for (unsigned int i = 0; i < count; i++)
+                workers.emplace_back (new WorkerThread);
+        }
+    };
+
+    void run_band (RowBandFunc const& func, int y_begin, int y_end)
+    {
+        in_band = true;
+        func (y_begin, y_end);
+        in_band = false;
+    }
+
+  } // anonymous namespace
+
+  void run_row_bands (int height, std::size_t row_bytes, RowBandFunc const& func)
+  {
+      if (height <= 0)
+          return;
+
+      if (in_band || height < 2 * min_band_rows || height * row_bytes < min_split_bytes) {
+          func (0, height);
+          return;
+      }
+
+      auto& pool = RowBandPool::instance ();
+
+      std::unique_lock<std::mutex> lock (pool.mutex, std::try_to_lock);
+
+      if (!lock || pool.workers.empty ()) {
+          func (0, height);
+          return;
+      }
+
+      int bands = std::min (int (pool.workers.size ()) + 1, height / min_band_rows);
+
+      // The calling thread takes the first band
+      for (int band = 1; band < bands; band++) {
+          int y_begin = height * band / bands;
+          int y_end   = height * (band + 1) / bands;
+
+          pool.workers[band - 1]->submit ([&func, y_begin, y_end] { run_band (func, y_begin, y_end); });
+      }
+
+      run_band (func, 0, height / bands);
+
+      for (int band = 1; band < bands; band++)
+          pool.workers[band - 1]->wait ();
+  }
+
+} // LV namespace
+
+void visual_run_row_bands (int height, size_t row_bytes, VisRowBandFunc func, void *data)
+{
+    visual_return_if_fail (func != nullptr);
+
+    LV::run_row_bands (height, row_bytes, [=] (int y_begin, int y_end) {
+        func (y_begin, y_end, data);
+    });
+}
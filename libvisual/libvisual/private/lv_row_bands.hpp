@@ -0,0 +1,52 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_ROW_BANDS_HPP
+#define _LV_ROW_BANDS_HPP
+
+#include "lvconfig.h"
+#include "lv_defines.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace LV {
+
+  typedef std::function<void (int, int)> RowBandFunc;
+
+  /**
+   * Runs a function over bands of rows, concurrently when it pays off.
+   *
+   * Images smaller than a few hundred kilobytes, or machines with a single
+   * CPU, get a single call covering all rows. Otherwise the rows are split
+   * into one band per CPU, run on a shared pool of worker threads and the
+   * calling thread. Calls made from inside a band, or while another caller
+   * holds the pool, run on the calling thread alone.
+   *
+   * Bands never overlap, so the function may write to its rows freely.
+   *
+   * @param height    number of rows
+   * @param row_bytes bytes touched per row, used to judge the cost
+   * @param func      called with the first row and one past the last row of each band
+   */
+  void run_row_bands (int height, std::size_t row_bytes, RowBandFunc const& func);
+
+} // LV namespace
+
+#endif // _LV_ROW_BANDS_HPP
@@ -0,0 +1,56 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_THREAD_RNG_HPP
+#define _LV_THREAD_RNG_HPP
+
+#include "lv_random.h"
+
+namespace LV {
+
+  /**
+   * Gives the calling thread a generator of its own in place of the
+   * system-wide one, for the lifetime of the scope.
+   *
+   * Work moved off the render thread, such as loading an actor in the
+   * background, draws from it through LV::rand() and visual_rand(). It
+   * then neither races with the render thread on the system-wide
+   * generator nor changes the numbers the render thread draws.
+   */
+  class ThreadRngScope
+  {
+  public:
+
+      explicit ThreadRngScope (RandomSeed seed);
+
+      ThreadRngScope (ThreadRngScope const&) = delete;
+
+      ~ThreadRngScope ();
+
+      ThreadRngScope& operator= (ThreadRngScope const&) = delete;
+
+  private:
+
+      RandomContext  m_rng;
+      RandomContext* m_previous;
+  };
+
+} // LV namespace
+
+#endif // _LV_THREAD_RNG_HPP
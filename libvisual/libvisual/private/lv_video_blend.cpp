@@ -0,0 +1,189 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_video_blend.hpp"
+#include "lv_common.h"
+#include "lv_cpu.h"
+#include <cstring>
+
+namespace LV {
+
+  namespace {
+
+    void blend_bytes_c (uint8_t* dest, uint8_t const* src1, uint8_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dest[i] = VideoBlend::blend_byte (src1[i], src2[i], alpha);
+    }
+
+    void blend_rgb565_c (uint16_t* dest, uint16_t const* src1, uint16_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dest[i] = VideoBlend::blend_rgb565 (src1[i], src2[i], alpha);
+    }
+
+    void blit_alphasrc_argb32_c (uint8_t* dest, uint8_t const* src, std::size_t count)
+    {
+        for (std::size_t i = 0; i < count * 4; i += 4) {
+            int alpha = src[i + 3];
+
+            dest[i    ] = VideoBlend::blit_byte (dest[i    ], src[i    ], alpha);
+            dest[i + 1] = VideoBlend::blit_byte (dest[i + 1], src[i + 1], alpha);
+            dest[i + 2] = VideoBlend::blit_byte (dest[i + 2], src[i + 2], alpha);
+        }
+    }
+
+    void blit_surfacealpha_bytes_c (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dest[i] = VideoBlend::blit_byte (dest[i], src[i], alpha);
+    }
+
+    void blit_surfacealpha_argb32_c (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        for (std::size_t i = 0; i < count * 4; i += 4) {
+            dest[i    ] = VideoBlend::blit_byte (dest[i    ], src[i    ], alpha);
+            dest[i + 1] = VideoBlend::blit_byte (dest[i + 1], src[i + 1], alpha);
+            dest[i + 2] = VideoBlend::blit_byte (dest[i + 2], src[i + 2], alpha);
+        }
+    }
+
+    void blit_surfacealpha_rgb565_c (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t alpha)
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dest[i] = VideoBlend::blit_rgb565 (dest[i], src[i], alpha);
+    }
+
+    void blit_colorkey_16_c (uint16_t* dest, uint16_t const* src, std::size_t count, uint16_t key)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    void blit_colorkey_32_c (uint32_t* dest, uint32_t const* src, std::size_t count, uint32_t key)
+    {
+        for (std::size_t i = 0; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    VideoBlendFuncs const c_funcs = {
+        "c",
+        blend_bytes_c,
+        blend_rgb565_c,
+        blit_alphasrc_argb32_c,
+        blit_surfacealpha_bytes_c,
+        blit_surfacealpha_argb32_c,
+        blit_surfacealpha_rgb565_c,
+        blit_colorkey_16_c,
+        blit_colorkey_32_c
+    };
+
+    unsigned int const max_variants = 4;
+
+    // Supported variants from slowest to fastest, each with the gaps in
+    // its table filled in from the one before
+    VideoBlendFuncs variants[max_variants];
+    unsigned int    variant_count = 0;
+
+    template <typename Func>
+    void inherit (Func& func, Func base)
+    {
+        if (!func)
+            func = base;
+    }
+
+    void add_variant (VideoBlendFuncs const* funcs)
+    {
+        if (!funcs || variant_count == max_variants)
+            return;
+
+        auto& variant = variants[variant_count];
+        variant = *funcs;
+
+        if (variant_count > 0) {
+            auto const& base = variants[variant_count - 1];
+
+            inherit (variant.blend_bytes,              base.blend_bytes);
+            inherit (variant.blend_rgb565,             base.blend_rgb565);
+            inherit (variant.blit_alphasrc_argb32,     base.blit_alphasrc_argb32);
+            inherit (variant.blit_surfacealpha_bytes,  base.blit_surfacealpha_bytes);
+            inherit (variant.blit_surfacealpha_argb32, base.blit_surfacealpha_argb32);
+            inherit (variant.blit_surfacealpha_rgb565, base.blit_surfacealpha_rgb565);
+            inherit (variant.blit_colorkey_16,         base.blit_colorkey_16);
+            inherit (variant.blit_colorkey_32,         base.blit_colorkey_32);
+        }
+
+        variant_count++;
+    }
+
+  } // anonymous namespace
+
+  VideoBlendFuncs const* VideoBlend::s_funcs = &c_funcs;
+
+  void VideoBlend::initialize ()
+  {
+      variant_count = 0;
+
+      add_variant (&c_funcs);
+
+      if (visual_cpu_has_sse2 ())
+          add_variant (get_sse2_funcs ());
+
+      if (visual_cpu_has_avx2 ())
+          add_variant (get_avx2_funcs ());
+
+      if (visual_cpu_has_neon ())
+          add_variant (get_neon_funcs ());
+
+      s_funcs = &variants[variant_count - 1];
+
+      visual_log (VISUAL_LOG_DEBUG, "Using %s alpha blend and blit kernels", s_funcs->name);
+  }
+
+  char const* VideoBlend::get_variant_name (unsigned int index)
+  {
+      if (variant_count == 0)
+          return index == 0 ? c_funcs.name : nullptr;
+
+      return index < variant_count ? variants[index].name : nullptr;
+  }
+
+  bool VideoBlend::select (char const* name)
+  {
+      visual_return_val_if_fail (name != nullptr, false);
+
+      if (variant_count == 0)
+          return std::strcmp (name, c_funcs.name) == 0;
+
+      for (unsigned int i = 0; i < variant_count; i++) {
+          if (std::strcmp (name, variants[i].name) == 0) {
+              s_funcs = &variants[i];
+              return true;
+          }
+      }
+
+      return false;
+  }
+
+} // LV namespace
@@ -0,0 +1,135 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_VIDEO_BLEND_HPP
+#define _LV_VIDEO_BLEND_HPP
+
+#include "lvconfig.h"
+#include "lv_defines.h"
+#include "lv_types.h"
+#include <cstddef>
+
+namespace LV {
+
+  /**
+   * Row kernels for alpha blending and blitting.
+   *
+   * One table is chosen for the CPU when the library is initialised. Each
+   * SIMD variant only fills in the kernels it speeds up, and the rest come
+   * from the variant before it.
+   *
+   * Blends round to nearest. Blits keep the truncating arithmetic of the
+   * original compose functions, (alpha * (src - dest) >> 8) + dest in
+   * 8 bits, so every variant agrees bit for bit with the C one.
+   */
+  struct VideoBlendFuncs
+  {
+      char const* name;
+
+      // dest = (src1 * (255 - alpha) + src2 * alpha) / 255 per byte
+      void (*blend_bytes)  (uint8_t* dest, uint8_t const* src1, uint8_t const* src2, std::size_t count, uint8_t alpha);
+
+      // The same per channel of RGB565 pixels
+      void (*blend_rgb565) (uint16_t* dest, uint16_t const* src1, uint16_t const* src2, std::size_t count, uint8_t alpha);
+
+      // ARGB32 source blended over the colour channels with its own alpha
+      void (*blit_alphasrc_argb32) (uint8_t* dest, uint8_t const* src, std::size_t count);
+
+      // Surface alpha, over all bytes, the colour channels of ARGB32, and RGB565 channels
+      void (*blit_surfacealpha_bytes)  (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha);
+      void (*blit_surfacealpha_argb32) (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha);
+      void (*blit_surfacealpha_rgb565) (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t alpha);
+
+      // Copies source pixels that differ from the colour key
+      void (*blit_colorkey_16) (uint16_t* dest, uint16_t const* src, std::size_t count, uint16_t key);
+      void (*blit_colorkey_32) (uint32_t* dest, uint32_t const* src, std::size_t count, uint32_t key);
+  };
+
+  class VideoBlend
+  {
+  public:
+
+      /**
+       * Picks the fastest variant the CPU supports. Called by System::init().
+       */
+      static void initialize ();
+
+      /**
+       * Returns the kernels in use.
+       */
+      static VideoBlendFuncs const& get ()
+      {
+          return *s_funcs;
+      }
+
+      /**
+       * Returns the name of the nth variant the CPU supports, slowest
+       * first, or nullptr past the last.
+       */
+      static char const* get_variant_name (unsigned int index);
+
+      /**
+       * Switches to a supported variant. Returns false if there is none by
+       * that name.
+       */
+      static bool select (char const* name);
+
+      // Per element versions of the kernels, for the C variant and SIMD tails
+
+      static uint8_t blend_byte (unsigned int a, unsigned int b, unsigned int alpha)
+      {
+          unsigned int x = a * (255 - alpha) + b * alpha + 128;
+          return (x + (x >> 8)) >> 8;
+      }
+
+      static uint16_t blend_rgb565 (unsigned int a, unsigned int b, unsigned int alpha)
+      {
+          return blend_byte (a >> 11, b >> 11, alpha) << 11
+               | blend_byte ((a >> 5) & 0x3f, (b >> 5) & 0x3f, alpha) << 5
+               | blend_byte (a & 0x1f, b & 0x1f, alpha);
+      }
+
+      static uint8_t blit_byte (int dest, int src, int alpha)
+      {
+          return (alpha * (src - dest) >> 8) + dest;
+      }
+
+      static uint16_t blit_rgb565 (unsigned int dest, unsigned int src, int alpha)
+      {
+          unsigned int r = blit_byte (dest >> 11, src >> 11, alpha) & 0x1f;
+          unsigned int g = blit_byte ((dest >> 5) & 0x3f, (src >> 5) & 0x3f, alpha) & 0x3f;
+          unsigned int b = blit_byte (dest & 0x1f, src & 0x1f, alpha) & 0x1f;
+
+          return (r << 11) | (g << 5) | b;
+      }
+
+      // Tables of the SIMD variants, with nullptr for kernels left to the
+      // variant before. These return nullptr when not built in.
+      static VideoBlendFuncs const* get_sse2_funcs ();
+      static VideoBlendFuncs const* get_avx2_funcs ();
+      static VideoBlendFuncs const* get_neon_funcs ();
+
+  private:
+
+      static VideoBlendFuncs const* s_funcs;
+  };
+
+} // LV namespace
+
+#endif // _LV_VIDEO_BLEND_HPP
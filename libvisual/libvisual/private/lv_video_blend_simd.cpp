@@ -0,0 +1,743 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_video_blend.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64))
+#include <immintrin.h>
+#define LV_HAVE_AVX2_KERNELS 1
+#define LV_TARGET_AVX2 __attribute__ ((target ("avx2")))
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Blends work on 16-bit lanes, where a * (255 - alpha) + b * alpha + 128
+// still fits. Blits multiply signed differences and keep bits 8 to 15 of
+// the wrapped product, which are the bits the C version's arithmetic
+// shift leaves in the low byte.
+
+namespace LV {
+
+  namespace {
+
+#if defined(__SSE2__)
+
+    inline __m128i div255_epu16 (__m128i x)
+    {
+        x = _mm_add_epi16 (x, _mm_set1_epi16 (128));
+        return _mm_srli_epi16 (_mm_add_epi16 (x, _mm_srli_epi16 (x, 8)), 8);
+    }
+
+    inline __m128i lerp_epu16 (__m128i a, __m128i b, __m128i weight_a, __m128i weight_b)
+    {
+        return div255_epu16 (_mm_add_epi16 (_mm_mullo_epi16 (a, weight_a), _mm_mullo_epi16 (b, weight_b)));
+    }
+
+    // (alpha * (src - dest) >> 8) + dest, masked down to the channel width
+    inline __m128i blit_epi16 (__m128i dest, __m128i src, __m128i alpha, __m128i mask)
+    {
+        auto x = _mm_mullo_epi16 (_mm_sub_epi16 (src, dest), alpha);
+        return _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (x, 8), dest), mask);
+    }
+
+    // Blits 16 bytes with separate weights for the low and high 8
+    inline __m128i blit_epu8 (__m128i dest, __m128i src, __m128i alpha_lo, __m128i alpha_hi)
+    {
+        auto const zero = _mm_setzero_si128 ();
+        auto const mask = _mm_set1_epi16 (0xff);
+
+        auto lo = blit_epi16 (_mm_unpacklo_epi8 (dest, zero), _mm_unpacklo_epi8 (src, zero), alpha_lo, mask);
+        auto hi = blit_epi16 (_mm_unpackhi_epi8 (dest, zero), _mm_unpackhi_epi8 (src, zero), alpha_hi, mask);
+
+        return _mm_packus_epi16 (lo, hi);
+    }
+
+    // Spreads the alpha of two unpacked ARGB32 pixels over their colour lanes
+    inline __m128i spread_alpha (__m128i pixels)
+    {
+        auto alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (pixels, 0xff), 0xff);
+        return _mm_and_si128 (alpha, _mm_set_epi16 (0, -1, -1, -1, 0, -1, -1, -1));
+    }
+
+    inline __m128i loadu (void const* p)
+    {
+        return _mm_loadu_si128 (static_cast<__m128i const*> (p));
+    }
+
+    inline void storeu (void* p, __m128i x)
+    {
+        _mm_storeu_si128 (static_cast<__m128i*> (p), x);
+    }
+
+    void blend_bytes_sse2 (uint8_t* dest, uint8_t const* src1, uint8_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const zero    = _mm_setzero_si128 ();
+        auto const weight1 = _mm_set1_epi16 (255 - alpha);
+        auto const weight2 = _mm_set1_epi16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto a = loadu (src1 + i);
+            auto b = loadu (src2 + i);
+
+            auto lo = lerp_epu16 (_mm_unpacklo_epi8 (a, zero), _mm_unpacklo_epi8 (b, zero), weight1, weight2);
+            auto hi = lerp_epu16 (_mm_unpackhi_epi8 (a, zero), _mm_unpackhi_epi8 (b, zero), weight1, weight2);
+
+            storeu (dest + i, _mm_packus_epi16 (lo, hi));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_byte (src1[i], src2[i], alpha);
+    }
+
+    void blend_rgb565_sse2 (uint16_t* dest, uint16_t const* src1, uint16_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const weight1 = _mm_set1_epi16 (255 - alpha);
+        auto const weight2 = _mm_set1_epi16 (alpha);
+        auto const mask5   = _mm_set1_epi16 (0x1f);
+        auto const mask6   = _mm_set1_epi16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto a = loadu (src1 + i);
+            auto b = loadu (src2 + i);
+
+            auto r  = lerp_epu16 (_mm_srli_epi16 (a, 11), _mm_srli_epi16 (b, 11), weight1, weight2);
+            auto g  = lerp_epu16 (_mm_and_si128 (_mm_srli_epi16 (a, 5), mask6),
+                                  _mm_and_si128 (_mm_srli_epi16 (b, 5), mask6), weight1, weight2);
+            auto bl = lerp_epu16 (_mm_and_si128 (a, mask5), _mm_and_si128 (b, mask5), weight1, weight2);
+
+            storeu (dest + i, _mm_or_si128 (_mm_slli_epi16 (r, 11), _mm_or_si128 (_mm_slli_epi16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_rgb565 (src1[i], src2[i], alpha);
+    }
+
+    void blit_alphasrc_argb32_sse2 (uint8_t* dest, uint8_t const* src, std::size_t count)
+    {
+        auto const zero = _mm_setzero_si128 ();
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            auto s = loadu (src  + i * 4);
+            auto d = loadu (dest + i * 4);
+
+            auto alpha_lo = spread_alpha (_mm_unpacklo_epi8 (s, zero));
+            auto alpha_hi = spread_alpha (_mm_unpackhi_epi8 (s, zero));
+
+            storeu (dest + i * 4, blit_epu8 (d, s, alpha_lo, alpha_hi));
+        }
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], s[3]);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], s[3]);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], s[3]);
+        }
+    }
+
+    void blit_surfacealpha_bytes_sse2 (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm_set1_epi16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16)
+            storeu (dest + i, blit_epu8 (loadu (dest + i), loadu (src + i), weight, weight));
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_byte (dest[i], src[i], alpha);
+    }
+
+    void blit_surfacealpha_argb32_sse2 (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm_set_epi16 (0, alpha, alpha, alpha, 0, alpha, alpha, alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4)
+            storeu (dest + i * 4, blit_epu8 (loadu (dest + i * 4), loadu (src + i * 4), weight, weight));
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], alpha);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], alpha);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], alpha);
+        }
+    }
+
+    void blit_surfacealpha_rgb565_sse2 (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm_set1_epi16 (alpha);
+        auto const mask5  = _mm_set1_epi16 (0x1f);
+        auto const mask6  = _mm_set1_epi16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto d = loadu (dest + i);
+            auto s = loadu (src  + i);
+
+            auto r  = blit_epi16 (_mm_srli_epi16 (d, 11), _mm_srli_epi16 (s, 11), weight, mask5);
+            auto g  = blit_epi16 (_mm_and_si128 (_mm_srli_epi16 (d, 5), mask6),
+                                  _mm_and_si128 (_mm_srli_epi16 (s, 5), mask6), weight, mask6);
+            auto bl = blit_epi16 (_mm_and_si128 (d, mask5), _mm_and_si128 (s, mask5), weight, mask5);
+
+            storeu (dest + i, _mm_or_si128 (_mm_slli_epi16 (r, 11), _mm_or_si128 (_mm_slli_epi16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_rgb565 (dest[i], src[i], alpha);
+    }
+
+    void blit_colorkey_16_sse2 (uint16_t* dest, uint16_t const* src, std::size_t count, uint16_t key)
+    {
+        auto const keys = _mm_set1_epi16 (short (key));
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = loadu (src + i);
+            auto keyed = _mm_cmpeq_epi16 (s, keys);
+
+            storeu (dest + i, _mm_or_si128 (_mm_and_si128 (keyed, loadu (dest + i)), _mm_andnot_si128 (keyed, s)));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    void blit_colorkey_32_sse2 (uint32_t* dest, uint32_t const* src, std::size_t count, uint32_t key)
+    {
+        auto const keys = _mm_set1_epi32 (int (key));
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            auto s = loadu (src + i);
+            auto keyed = _mm_cmpeq_epi32 (s, keys);
+
+            storeu (dest + i, _mm_or_si128 (_mm_and_si128 (keyed, loadu (dest + i)), _mm_andnot_si128 (keyed, s)));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    VideoBlendFuncs const sse2_funcs = {
+        "sse2",
+        blend_bytes_sse2,
+        blend_rgb565_sse2,
+        blit_alphasrc_argb32_sse2,
+        blit_surfacealpha_bytes_sse2,
+        blit_surfacealpha_argb32_sse2,
+        blit_surfacealpha_rgb565_sse2,
+        blit_colorkey_16_sse2,
+        blit_colorkey_32_sse2
+    };
+
+#endif // __SSE2__
+
+#if defined(LV_HAVE_AVX2_KERNELS)
+
+    // The AVX2 kernels are built for any x86 target and only picked when
+    // the CPU and OS support them. Unpacking and packing both work within
+    // 128-bit lanes, so bytes come out in the order they went in.
+
+    LV_TARGET_AVX2 inline __m256i div255_epu16_avx2 (__m256i x)
+    {
+        x = _mm256_add_epi16 (x, _mm256_set1_epi16 (128));
+        return _mm256_srli_epi16 (_mm256_add_epi16 (x, _mm256_srli_epi16 (x, 8)), 8);
+    }
+
+    LV_TARGET_AVX2 inline __m256i lerp_epu16_avx2 (__m256i a, __m256i b, __m256i weight_a, __m256i weight_b)
+    {
+        return div255_epu16_avx2 (_mm256_add_epi16 (_mm256_mullo_epi16 (a, weight_a), _mm256_mullo_epi16 (b, weight_b)));
+    }
+
+    LV_TARGET_AVX2 inline __m256i blit_epi16_avx2 (__m256i dest, __m256i src, __m256i alpha, __m256i mask)
+    {
+        auto x = _mm256_mullo_epi16 (_mm256_sub_epi16 (src, dest), alpha);
+        return _mm256_and_si256 (_mm256_add_epi16 (_mm256_srli_epi16 (x, 8), dest), mask);
+    }
+
+    LV_TARGET_AVX2 inline __m256i blit_epu8_avx2 (__m256i dest, __m256i src, __m256i alpha_lo, __m256i alpha_hi)
+    {
+        auto const zero = _mm256_setzero_si256 ();
+        auto const mask = _mm256_set1_epi16 (0xff);
+
+        auto lo = blit_epi16_avx2 (_mm256_unpacklo_epi8 (dest, zero), _mm256_unpacklo_epi8 (src, zero), alpha_lo, mask);
+        auto hi = blit_epi16_avx2 (_mm256_unpackhi_epi8 (dest, zero), _mm256_unpackhi_epi8 (src, zero), alpha_hi, mask);
+
+        return _mm256_packus_epi16 (lo, hi);
+    }
+
+    LV_TARGET_AVX2 inline __m256i spread_alpha_avx2 (__m256i pixels)
+    {
+        auto alpha = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (pixels, 0xff), 0xff);
+        return _mm256_and_si256 (alpha, _mm256_set_epi16 (0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1));
+    }
+
+    LV_TARGET_AVX2 inline __m256i loadu_avx2 (void const* p)
+    {
+        return _mm256_loadu_si256 (static_cast<__m256i const*> (p));
+    }
+
+    LV_TARGET_AVX2 inline void storeu_avx2 (void* p, __m256i x)
+    {
+        _mm256_storeu_si256 (static_cast<__m256i*> (p), x);
+    }
+
+    LV_TARGET_AVX2 void blend_bytes_avx2 (uint8_t* dest, uint8_t const* src1, uint8_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const zero    = _mm256_setzero_si256 ();
+        auto const weight1 = _mm256_set1_epi16 (255 - alpha);
+        auto const weight2 = _mm256_set1_epi16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= count; i += 32) {
+            auto a = loadu_avx2 (src1 + i);
+            auto b = loadu_avx2 (src2 + i);
+
+            auto lo = lerp_epu16_avx2 (_mm256_unpacklo_epi8 (a, zero), _mm256_unpacklo_epi8 (b, zero), weight1, weight2);
+            auto hi = lerp_epu16_avx2 (_mm256_unpackhi_epi8 (a, zero), _mm256_unpackhi_epi8 (b, zero), weight1, weight2);
+
+            storeu_avx2 (dest + i, _mm256_packus_epi16 (lo, hi));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_byte (src1[i], src2[i], alpha);
+    }
+
+    LV_TARGET_AVX2 void blend_rgb565_avx2 (uint16_t* dest, uint16_t const* src1, uint16_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const weight1 = _mm256_set1_epi16 (255 - alpha);
+        auto const weight2 = _mm256_set1_epi16 (alpha);
+        auto const mask5   = _mm256_set1_epi16 (0x1f);
+        auto const mask6   = _mm256_set1_epi16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto a = loadu_avx2 (src1 + i);
+            auto b = loadu_avx2 (src2 + i);
+
+            auto r  = lerp_epu16_avx2 (_mm256_srli_epi16 (a, 11), _mm256_srli_epi16 (b, 11), weight1, weight2);
+            auto g  = lerp_epu16_avx2 (_mm256_and_si256 (_mm256_srli_epi16 (a, 5), mask6),
+                                       _mm256_and_si256 (_mm256_srli_epi16 (b, 5), mask6), weight1, weight2);
+            auto bl = lerp_epu16_avx2 (_mm256_and_si256 (a, mask5), _mm256_and_si256 (b, mask5), weight1, weight2);
+
+            storeu_avx2 (dest + i, _mm256_or_si256 (_mm256_slli_epi16 (r, 11), _mm256_or_si256 (_mm256_slli_epi16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_rgb565 (src1[i], src2[i], alpha);
+    }
+
+    LV_TARGET_AVX2 void blit_alphasrc_argb32_avx2 (uint8_t* dest, uint8_t const* src, std::size_t count)
+    {
+        auto const zero = _mm256_setzero_si256 ();
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = loadu_avx2 (src  + i * 4);
+            auto d = loadu_avx2 (dest + i * 4);
+
+            auto alpha_lo = spread_alpha_avx2 (_mm256_unpacklo_epi8 (s, zero));
+            auto alpha_hi = spread_alpha_avx2 (_mm256_unpackhi_epi8 (s, zero));
+
+            storeu_avx2 (dest + i * 4, blit_epu8_avx2 (d, s, alpha_lo, alpha_hi));
+        }
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], s[3]);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], s[3]);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], s[3]);
+        }
+    }
+
+    LV_TARGET_AVX2 void blit_surfacealpha_bytes_avx2 (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm256_set1_epi16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 32 <= count; i += 32)
+            storeu_avx2 (dest + i, blit_epu8_avx2 (loadu_avx2 (dest + i), loadu_avx2 (src + i), weight, weight));
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_byte (dest[i], src[i], alpha);
+    }
+
+    LV_TARGET_AVX2 void blit_surfacealpha_argb32_avx2 (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm256_set_epi16 (0, alpha, alpha, alpha, 0, alpha, alpha, alpha,
+                                              0, alpha, alpha, alpha, 0, alpha, alpha, alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+            storeu_avx2 (dest + i * 4, blit_epu8_avx2 (loadu_avx2 (dest + i * 4), loadu_avx2 (src + i * 4), weight, weight));
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], alpha);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], alpha);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], alpha);
+        }
+    }
+
+    LV_TARGET_AVX2 void blit_surfacealpha_rgb565_avx2 (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = _mm256_set1_epi16 (alpha);
+        auto const mask5  = _mm256_set1_epi16 (0x1f);
+        auto const mask6  = _mm256_set1_epi16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto d = loadu_avx2 (dest + i);
+            auto s = loadu_avx2 (src  + i);
+
+            auto r  = blit_epi16_avx2 (_mm256_srli_epi16 (d, 11), _mm256_srli_epi16 (s, 11), weight, mask5);
+            auto g  = blit_epi16_avx2 (_mm256_and_si256 (_mm256_srli_epi16 (d, 5), mask6),
+                                       _mm256_and_si256 (_mm256_srli_epi16 (s, 5), mask6), weight, mask6);
+            auto bl = blit_epi16_avx2 (_mm256_and_si256 (d, mask5), _mm256_and_si256 (s, mask5), weight, mask5);
+
+            storeu_avx2 (dest + i, _mm256_or_si256 (_mm256_slli_epi16 (r, 11), _mm256_or_si256 (_mm256_slli_epi16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_rgb565 (dest[i], src[i], alpha);
+    }
+
+    LV_TARGET_AVX2 void blit_colorkey_16_avx2 (uint16_t* dest, uint16_t const* src, std::size_t count, uint16_t key)
+    {
+        auto const keys = _mm256_set1_epi16 (short (key));
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto s = loadu_avx2 (src + i);
+            storeu_avx2 (dest + i, _mm256_blendv_epi8 (s, loadu_avx2 (dest + i), _mm256_cmpeq_epi16 (s, keys)));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    LV_TARGET_AVX2 void blit_colorkey_32_avx2 (uint32_t* dest, uint32_t const* src, std::size_t count, uint32_t key)
+    {
+        auto const keys = _mm256_set1_epi32 (int (key));
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = loadu_avx2 (src + i);
+            storeu_avx2 (dest + i, _mm256_blendv_epi8 (s, loadu_avx2 (dest + i), _mm256_cmpeq_epi32 (s, keys)));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    VideoBlendFuncs const avx2_funcs = {
+        "avx2",
+        blend_bytes_avx2,
+        blend_rgb565_avx2,
+        blit_alphasrc_argb32_avx2,
+        blit_surfacealpha_bytes_avx2,
+        blit_surfacealpha_argb32_avx2,
+        blit_surfacealpha_rgb565_avx2,
+        blit_colorkey_16_avx2,
+        blit_colorkey_32_avx2
+    };
+
+#endif // LV_HAVE_AVX2_KERNELS
+
+#if defined(__ARM_NEON)
+
+    inline uint8x8_t lerp_u8 (uint8x8_t a, uint8x8_t b, uint8x8_t weight_a, uint8x8_t weight_b)
+    {
+        auto x = vmlal_u8 (vmull_u8 (a, weight_a), b, weight_b);
+        return vraddhn_u16 (x, vrshrq_n_u16 (x, 8));
+    }
+
+    inline uint16x8_t lerp_u16 (uint16x8_t a, uint16x8_t b, uint16x8_t weight_a, uint16x8_t weight_b)
+    {
+        auto x = vaddq_u16 (vmlaq_u16 (vmulq_u16 (a, weight_a), b, weight_b), vdupq_n_u16 (128));
+        return vshrq_n_u16 (vsraq_n_u16 (x, x, 8), 8);
+    }
+
+    // Wrapping arithmetic gives the same low bits as the signed C version
+    inline uint16x8_t blit_u16 (uint16x8_t dest, uint16x8_t src, uint16x8_t alpha, uint16x8_t mask)
+    {
+        auto x = vmulq_u16 (vsubq_u16 (src, dest), alpha);
+        return vandq_u16 (vsraq_n_u16 (dest, x, 8), mask);
+    }
+
+    inline uint8x8_t blit_u8 (uint8x8_t dest, uint8x8_t src, uint16x8_t alpha)
+    {
+        auto x = vmulq_u16 (vsubl_u8 (src, dest), alpha);
+        return vmovn_u16 (vsraq_n_u16 (vmovl_u8 (dest), x, 8));
+    }
+
+    void blend_bytes_neon (uint8_t* dest, uint8_t const* src1, uint8_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const weight1 = vdup_n_u8 (255 - alpha);
+        auto const weight2 = vdup_n_u8 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+            auto a = vld1q_u8 (src1 + i);
+            auto b = vld1q_u8 (src2 + i);
+
+            vst1q_u8 (dest + i, vcombine_u8 (lerp_u8 (vget_low_u8  (a), vget_low_u8  (b), weight1, weight2),
+                                             lerp_u8 (vget_high_u8 (a), vget_high_u8 (b), weight1, weight2)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_byte (src1[i], src2[i], alpha);
+    }
+
+    void blend_rgb565_neon (uint16_t* dest, uint16_t const* src1, uint16_t const* src2, std::size_t count, uint8_t alpha)
+    {
+        auto const weight1 = vdupq_n_u16 (255 - alpha);
+        auto const weight2 = vdupq_n_u16 (alpha);
+        auto const mask5   = vdupq_n_u16 (0x1f);
+        auto const mask6   = vdupq_n_u16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto a = vld1q_u16 (src1 + i);
+            auto b = vld1q_u16 (src2 + i);
+
+            auto r  = lerp_u16 (vshrq_n_u16 (a, 11), vshrq_n_u16 (b, 11), weight1, weight2);
+            auto g  = lerp_u16 (vandq_u16 (vshrq_n_u16 (a, 5), mask6),
+                                vandq_u16 (vshrq_n_u16 (b, 5), mask6), weight1, weight2);
+            auto bl = lerp_u16 (vandq_u16 (a, mask5), vandq_u16 (b, mask5), weight1, weight2);
+
+            vst1q_u16 (dest + i, vorrq_u16 (vshlq_n_u16 (r, 11), vorrq_u16 (vshlq_n_u16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blend_rgb565 (src1[i], src2[i], alpha);
+    }
+
+    void blit_alphasrc_argb32_neon (uint8_t* dest, uint8_t const* src, std::size_t count)
+    {
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = vld4_u8 (src  + i * 4);
+            auto d = vld4_u8 (dest + i * 4);
+
+            auto alpha = vmovl_u8 (s.val[3]);
+
+            d.val[0] = blit_u8 (d.val[0], s.val[0], alpha);
+            d.val[1] = blit_u8 (d.val[1], s.val[1], alpha);
+            d.val[2] = blit_u8 (d.val[2], s.val[2], alpha);
+
+            vst4_u8 (dest + i * 4, d);
+        }
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], s[3]);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], s[3]);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], s[3]);
+        }
+    }
+
+    void blit_surfacealpha_bytes_neon (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = vdupq_n_u16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8)
+            vst1_u8 (dest + i, blit_u8 (vld1_u8 (dest + i), vld1_u8 (src + i), weight));
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_byte (dest[i], src[i], alpha);
+    }
+
+    void blit_surfacealpha_argb32_neon (uint8_t* dest, uint8_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = vdupq_n_u16 (alpha);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = vld4_u8 (src  + i * 4);
+            auto d = vld4_u8 (dest + i * 4);
+
+            d.val[0] = blit_u8 (d.val[0], s.val[0], weight);
+            d.val[1] = blit_u8 (d.val[1], s.val[1], weight);
+            d.val[2] = blit_u8 (d.val[2], s.val[2], weight);
+
+            vst4_u8 (dest + i * 4, d);
+        }
+
+        for (; i < count; i++) {
+            auto d = dest + i * 4;
+            auto s = src  + i * 4;
+
+            d[0] = VideoBlend::blit_byte (d[0], s[0], alpha);
+            d[1] = VideoBlend::blit_byte (d[1], s[1], alpha);
+            d[2] = VideoBlend::blit_byte (d[2], s[2], alpha);
+        }
+    }
+
+    void blit_surfacealpha_rgb565_neon (uint16_t* dest, uint16_t const* src, std::size_t count, uint8_t alpha)
+    {
+        auto const weight = vdupq_n_u16 (alpha);
+        auto const mask5  = vdupq_n_u16 (0x1f);
+        auto const mask6  = vdupq_n_u16 (0x3f);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto d = vld1q_u16 (dest + i);
+            auto s = vld1q_u16 (src  + i);
+
+            auto r  = blit_u16 (vshrq_n_u16 (d, 11), vshrq_n_u16 (s, 11), weight, mask5);
+            auto g  = blit_u16 (vandq_u16 (vshrq_n_u16 (d, 5), mask6),
+                                vandq_u16 (vshrq_n_u16 (s, 5), mask6), weight, mask6);
+            auto bl = blit_u16 (vandq_u16 (d, mask5), vandq_u16 (s, mask5), weight, mask5);
+
+            vst1q_u16 (dest + i, vorrq_u16 (vshlq_n_u16 (r, 11), vorrq_u16 (vshlq_n_u16 (g, 5), bl)));
+        }
+
+        for (; i < count; i++)
+            dest[i] = VideoBlend::blit_rgb565 (dest[i], src[i], alpha);
+    }
+
+    void blit_colorkey_16_neon (uint16_t* dest, uint16_t const* src, std::size_t count, uint16_t key)
+    {
+        auto const keys = vdupq_n_u16 (key);
+
+        std::size_t i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+            auto s = vld1q_u16 (src + i);
+            vst1q_u16 (dest + i, vbslq_u16 (vceqq_u16 (s, keys), vld1q_u16 (dest + i), s));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    void blit_colorkey_32_neon (uint32_t* dest, uint32_t const* src, std::size_t count, uint32_t key)
+    {
+        auto const keys = vdupq_n_u32 (key);
+
+        std::size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            auto s = vld1q_u32 (src + i);
+            vst1q_u32 (dest + i, vbslq_u32 (vceqq_u32 (s, keys), vld1q_u32 (dest + i), s));
+        }
+
+        for (; i < count; i++) {
+            if (src[i] != key)
+                dest[i] = src[i];
+        }
+    }
+
+    VideoBlendFuncs const neon_funcs = {
+        "neon",
+        blend_bytes_neon,
+        blend_rgb565_neon,
+        blit_alphasrc_argb32_neon,
+        blit_surfacealpha_bytes_neon,
+        blit_surfacealpha_argb32_neon,
+        blit_surfacealpha_rgb565_neon,
+        blit_colorkey_16_neon,
+        blit_colorkey_32_neon
+    };
+
+#endif // __ARM_NEON
+
+  } // anonymous namespace
+
+  VideoBlendFuncs const* VideoBlend::get_sse2_funcs ()
+  {
+#if defined(__SSE2__)
+      return &sse2_funcs;
+#else
+      return nullptr;
+#endif
+  }
+
+  VideoBlendFuncs const* VideoBlend::get_avx2_funcs ()
+  {
+#if defined(LV_HAVE_AVX2_KERNELS)
+      return &avx2_funcs;
+#else
+      return nullptr;
+#endif
+  }
+
+  VideoBlendFuncs const* VideoBlend::get_neon_funcs ()
+  {
+#if defined(__ARM_NEON)
+      return &neon_funcs;
+#else
+      return nullptr;
+#endif
+  }
+
+} // LV namespace
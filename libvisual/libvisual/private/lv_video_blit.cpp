@@ -24,8 +24,11 @@
 #include "config.h"
 #include "lv_video_blit.hpp"
 #include "lv_video_private.hpp"
+#include "lv_video_blend.hpp"
 #include "lv_common.h"
 #include "lv_cpu.h"
+#include <algorithm>
+#include <array>
 
 #pragma pack(1)
 
@@ -39,6 +42,12 @@ typedef struct {
 
 #pragma pack()
 
+#if VISUAL_LITTLE_ENDIAN == 1
+  #define ARGB(a,r,g,b) ((a)<<24 | (r)<<16 | (g) << 8 | (b))
+#else
+  #define ARGB(a,r,g,b) ((b)<<24 | (g)<<16 | (r) << 8 | (a))
+#endif
+
 namespace LV {
 
   void VideoBlit::blit_overlay_noalpha (Video* dest, Video* src)
@@ -66,36 +75,25 @@ namespace LV {
       auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
       auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
 
-      if (visual_cpu_has_mmx ()) {
-          blit_overlay_alphasrc_mmx (dest, src);
-          return;
-      }
+      auto const& blend = VideoBlend::get ();
 
       for (int y = 0; y < src->m_impl->height; y++) {
-          for (int x = 0; x < src->m_impl->width; x++) {
-              uint8_t alpha = srcbuf[3];
+          blend.blit_alphasrc_argb32 (destbuf, srcbuf, src->m_impl->width);
 
-              destbuf[0] = (alpha * (srcbuf[0] - destbuf[0]) >> 8) + destbuf[0];
-              destbuf[1] = (alpha * (srcbuf[1] - destbuf[1]) >> 8) + destbuf[1];
-              destbuf[2] = (alpha * (srcbuf[2] - destbuf[2]) >> 8) + destbuf[2];
-
-              destbuf += dest->m_impl->bpp;
-              srcbuf  += src->m_impl->bpp;
-          }
-
-          destbuf += dest->m_impl->pitch - (dest->m_impl->width * dest->m_impl->bpp);
-          srcbuf  += src->m_impl->pitch  - (src->m_impl->width  * src->m_impl->bpp);
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
       }
   }
 
   void VideoBlit::blit_overlay_colorkey (Video* dest, Video* src)
   {
-      unsigned int pixel_count = dest->m_impl->width * dest->m_impl->height;
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
 
-      if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT) {
-          auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
-          auto srcbuf = static_cast<uint8_t const*> (src->get_pixels ());
+      int width  = src->m_impl->width;
+      int height = src->m_impl->height;
 
+      if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT) {
           auto& palette = src->m_impl->palette;
 
           if (!palette.empty ()) {
@@ -103,61 +101,58 @@ namespace LV {
               return;
           }
 
-          int index = palette.find_color (*src->m_impl->colorkey);
+          int index = palette.find_color (src->m_impl->colorkey);
 
-          for (unsigned int i = 0; i < pixel_count; i++) {
-              if (*srcbuf != index)
-                  *destbuf = *srcbuf;
+          for (int y = 0; y < height; y++) {
+              for (int x = 0; x < width; x++) {
+                  if (srcbuf[x] != index)
+                      destbuf[x] = srcbuf[x];
+              }
 
-              destbuf++;
-              srcbuf++;
+              destbuf += dest->m_impl->pitch;
+              srcbuf  += src->m_impl->pitch;
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_16BIT) {
-          auto destbuf = static_cast<uint16_t*> (dest->get_pixels ());
-          auto srcbuf  = static_cast<uint16_t const*> (src->get_pixels ());
+          uint16_t color = src->m_impl->colorkey.to_uint16 ();
 
-          uint16_t color = src->m_impl->colorkey->to_uint16 ();
+          auto const& blend = VideoBlend::get ();
 
-          for (unsigned int i = 0; i < pixel_count; i++) {
-              if (color != *srcbuf)
-                  *destbuf = *srcbuf;
+          for (int y = 0; y < height; y++) {
+              blend.blit_colorkey_16 (reinterpret_cast<uint16_t*> (destbuf), reinterpret_cast<uint16_t const*> (srcbuf), width, color);
 
-              destbuf++;
-              srcbuf++;
+              destbuf += dest->m_impl->pitch;
+              srcbuf  += src->m_impl->pitch;
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_24BIT) {
-          auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
-          auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
-
-          uint8_t r = src->m_impl->colorkey->r;
-          uint8_t g = src->m_impl->colorkey->g;
-          uint8_t b = src->m_impl->colorkey->b;
-
-          for (unsigned int i = 0; i < pixel_count; i++) {
-              if (b != srcbuf[0] && g != srcbuf[1] && r != srcbuf[2]) {
-                  destbuf[0] = srcbuf[0];
-                  destbuf[1] = srcbuf[1];
-                  destbuf[2] = srcbuf[2];
+          uint8_t r = src->m_impl->colorkey.r;
+          uint8_t g = src->m_impl->colorkey.g;
+          uint8_t b = src->m_impl->colorkey.b;
+
+          for (int y = 0; y < height; y++) {
+              for (int x = 0; x < width * 3; x += 3) {
+                  if (b != srcbuf[x] && g != srcbuf[x + 1] && r != srcbuf[x + 2]) {
+                      destbuf[x    ] = srcbuf[x    ];
+                      destbuf[x + 1] = srcbuf[x + 1];
+                      destbuf[x + 2] = srcbuf[x + 2];
+                  }
               }
 
-              destbuf += 3;
-              srcbuf  += 3;
+              destbuf += dest->m_impl->pitch;
+              srcbuf  += src->m_impl->pitch;
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT) {
-          auto destbuf = static_cast<uint32_t*> (dest->get_pixels ());
-          auto srcbuf  = static_cast<uint32_t const*> (src->get_pixels ());
+          uint32_t color = src->m_impl->colorkey.to_uint32 ();
 
-          uint32_t color = src->m_impl->colorkey->to_uint32 ();
+          auto const& blend = VideoBlend::get ();
 
-          for (unsigned int i = 0; i < pixel_count; i++) {
-              if (color != *srcbuf)
-                  *destbuf = *srcbuf;
+          for (int y = 0; y < height; y++) {
+              blend.blit_colorkey_32 (reinterpret_cast<uint32_t*> (destbuf), reinterpret_cast<uint32_t const*> (srcbuf), width, color);
 
-              destbuf++;
-              srcbuf++;
+              destbuf += dest->m_impl->pitch;
+              srcbuf  += src->m_impl->pitch;
           }
       }
   }
@@ -169,70 +164,28 @@ namespace LV {
 
       uint8_t alpha = src->m_impl->alpha;
 
-      if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT) {
-
-          for (int y = 0; y < src->m_impl->height; y++) {
-              for (int x = 0; x < src->m_impl->width; x++) {
-                  *destbuf = ((alpha * (*srcbuf - *destbuf) >> 8) + *destbuf);
-
-                  destbuf += dest->m_impl->bpp;
-                  srcbuf += src->m_impl->bpp;
-              }
-
-              destbuf += dest->m_impl->pitch - (dest->m_impl->width * dest->m_impl->bpp);
-              srcbuf  += src->m_impl->pitch  - (src->m_impl->width  * src->m_impl->bpp);
-          }
+      int width  = src->m_impl->width;
+      int height = src->m_impl->height;
 
-      } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_16BIT) {
+      auto const& blend = VideoBlend::get ();
 
-          for (int y = 0; y < src->m_impl->height; y++) {
-              auto destr = reinterpret_cast<rgb16_t*> (destbuf);
-              auto srcr  = reinterpret_cast<rgb16_t const*> (srcbuf);
+      for (int y = 0; y < height; y++) {
+          switch (dest->m_impl->depth) {
+              case VISUAL_VIDEO_DEPTH_16BIT:
+                  blend.blit_surfacealpha_rgb565 (reinterpret_cast<uint16_t*> (destbuf), reinterpret_cast<uint16_t const*> (srcbuf), width, alpha);
+                  break;
 
-              for (int x = 0; x < src->m_impl->width; x++) {
-                  destr->r = (alpha * (srcr->r - destr->r) >> 8) + destr->r;
-                  destr->g = (alpha * (srcr->g - destr->g) >> 8) + destr->g;
-                  destr->b = (alpha * (srcr->b - destr->b) >> 8) + destr->b;
+              case VISUAL_VIDEO_DEPTH_32BIT:
+                  blend.blit_surfacealpha_argb32 (destbuf, srcbuf, width, alpha);
+                  break;
 
-                  destr++;
-                  srcr++;
-              }
-
-              destbuf += dest->m_impl->pitch;
-              srcbuf += src->m_impl->pitch;
-          }
-
-      } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_24BIT) {
-
-          for (int y = 0; y < src->m_impl->height; y++) {
-              for (int x = 0; x < src->m_impl->width; x++) {
-                  destbuf[0] = (alpha * (srcbuf[0] - destbuf[0]) >> 8) + destbuf[0];
-                  destbuf[1] = (alpha * (srcbuf[1] - destbuf[1]) >> 8) + destbuf[1];
-                  destbuf[2] = (alpha * (srcbuf[2] - destbuf[2]) >> 8) + destbuf[2];
-
-                  destbuf += dest->m_impl->bpp;
-                  srcbuf  += src->m_impl->bpp;
-              }
-
-              destbuf += dest->m_impl->pitch - (dest->m_impl->width * dest->m_impl->bpp);
-              srcbuf  += src->m_impl->pitch  - (src->m_impl->width  * src->m_impl->bpp);
+              default:
+                  blend.blit_surfacealpha_bytes (destbuf, srcbuf, width * dest->m_impl->bpp, alpha);
+                  break;
           }
 
-      } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT) {
-
-          for (int y = 0; y < src->m_impl->height; y++) {
-              for (int x = 0; x < src->m_impl->width; x++) {
-                  destbuf[0] = (alpha * (srcbuf[0] - destbuf[0]) >> 8) + destbuf[0];
-                  destbuf[1] = (alpha * (srcbuf[1] - destbuf[1]) >> 8) + destbuf[1];
-                  destbuf[2] = (alpha * (srcbuf[2] - destbuf[2]) >> 8) + destbuf[2];
-
-                  destbuf += dest->m_impl->bpp;
-                  srcbuf  += src->m_impl->bpp;
-              }
-
-              destbuf += dest->m_impl->pitch - (dest->m_impl->width * dest->m_impl->bpp);
-              srcbuf  += src->m_impl->pitch  - (src->m_impl->width  * src->m_impl->bpp);
-          }
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
       }
   }
 
@@ -251,7 +204,7 @@ namespace LV {
               return;
           }
 
-          int index = palette.find_color (*src->m_impl->colorkey);
+          int index = palette.find_color (src->m_impl->colorkey);
 
           int dstep = dest->m_impl->pitch - dest->m_impl->width * dest->m_impl->bpp;
           int sstep = src->m_impl->pitch  - src->m_impl->width  * src->m_impl->bpp;
@@ -270,7 +223,7 @@ namespace LV {
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_16BIT) {
-          uint16_t color = src->m_impl->colorkey->to_uint16 ();
+          uint16_t color = src->m_impl->colorkey.to_uint16 ();
 
           for (int y = 0; y < src->m_impl->height; y++) {
               auto destr = reinterpret_cast<rgb16_t*> (destbuf);
@@ -292,9 +245,9 @@ namespace LV {
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_24BIT) {
-          uint8_t r = src->m_impl->colorkey->r;
-          uint8_t g = src->m_impl->colorkey->g;
-          uint8_t b = src->m_impl->colorkey->b;
+          uint8_t r = src->m_impl->colorkey.r;
+          uint8_t g = src->m_impl->colorkey.g;
+          uint8_t b = src->m_impl->colorkey.b;
 
           for (int y = 0; y < src->m_impl->height; y++) {
               for (int x = 0; x < src->m_impl->width; x++) {
@@ -313,7 +266,7 @@ namespace LV {
           }
 
       } else if (dest->m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT) {
-          uint32_t color = src->m_impl->colorkey->to_uint32 ();
+          uint32_t color = src->m_impl->colorkey.to_uint32 ();
 
           for (int y = 0; y < src->m_impl->height; y++) {
               for (int x = 0; x < src->m_impl->width; x++) {
@@ -333,4 +286,189 @@ namespace LV {
       }
   }
 
+  void VideoBlit::expand_palette_argb32 (Palette const& palette, uint32_t* colors)
+  {
+      auto const& src_colors = palette.colors;
+
+      for (int i = 0; i < 256; i++) {
+          colors[i] = ARGB (255, src_colors[i].r, src_colors[i].g, src_colors[i].b);
+      }
+  }
+
+  bool VideoBlit::is_index8_compose_function (VisVideoComposeFunc func)
+  {
+      return func == blit_overlay_index8_noalpha
+          || func == blit_overlay_index8_colorkey
+          || func == blit_overlay_index8_surfacealpha
+          || func == blit_overlay_index8_surfacealphacolorkey
+          || func == visual_video_compose_index8_noalpha
+          || func == visual_video_compose_index8_colorkey
+          || func == visual_video_compose_index8_surfacealpha
+          || func == visual_video_compose_index8_surfacealphacolorkey;
+  }
+
+  bool VideoBlit::is_index8_blit (Video const* dest, Video const* src)
+  {
+      return src->m_impl->depth == VISUAL_VIDEO_DEPTH_8BIT
+          && dest->m_impl->depth == VISUAL_VIDEO_DEPTH_32BIT
+          && src->m_impl->palette.size () == 256;
+  }
+
+  void VideoBlit::blit_overlay_index8_noalpha (Video* dest, Video* src)
+  {
+      if (!is_index8_blit (dest, src)) {
+          blit_overlay_noalpha (dest, src);
+          return;
+      }
+
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          blit_overlay_index8_noalpha_sse2 (dest, src);
+          return;
+      }
+#endif
+
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = reinterpret_cast<uint32_t*> (destbuf);
+
+          for (int x = 0; x < width; x++)
+              destp[x] = colors[srcbuf[x]];
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+  }
+
+  void VideoBlit::blit_overlay_index8_colorkey (Video* dest, Video* src)
+  {
+      if (!is_index8_blit (dest, src)) {
+          blit_overlay_colorkey (dest, src);
+          return;
+      }
+
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          blit_overlay_index8_colorkey_sse2 (dest, src);
+          return;
+      }
+#endif
+
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      uint32_t color = src->m_impl->colorkey.to_uint32 ();
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = reinterpret_cast<uint32_t*> (destbuf);
+
+          for (int x = 0; x < width; x++) {
+              uint32_t pixel = colors[srcbuf[x]];
+
+              if (color != pixel)
+                  destp[x] = pixel;
+          }
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+  }
+
+  void VideoBlit::blit_overlay_index8_surfacealpha (Video* dest, Video* src)
+  {
+      if (!is_index8_blit (dest, src)) {
+          blit_overlay_surfacealpha (dest, src);
+          return;
+      }
+
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          blit_overlay_index8_surfacealpha_sse2 (dest, src);
+          return;
+      }
+#endif
+
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      uint8_t alpha = src->m_impl->alpha;
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = destbuf;
+
+          for (int x = 0; x < width; x++) {
+              auto srcp = reinterpret_cast<uint8_t const*> (&colors[srcbuf[x]]);
+
+              destp[0] = (alpha * (srcp[0] - destp[0]) >> 8) + destp[0];
+              destp[1] = (alpha * (srcp[1] - destp[1]) >> 8) + destp[1];
+              destp[2] = (alpha * (srcp[2] - destp[2]) >> 8) + destp[2];
+
+              destp += 4;
+          }
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+  }
+
+  void VideoBlit::blit_overlay_index8_surfacealphacolorkey (Video* dest, Video* src)
+  {
+      if (!is_index8_blit (dest, src)) {
+          blit_overlay_surfacealphacolorkey (dest, src);
+          return;
+      }
+
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      uint8_t  alpha = src->m_impl->alpha;
+      uint32_t color = src->m_impl->colorkey.to_uint32 ();
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      /* Matches the argb32 variant, which keys on the destination pixel */
+      for (int y = 0; y < height; y++) {
+          auto destp = destbuf;
+
+          for (int x = 0; x < width; x++) {
+              if (color == *reinterpret_cast<uint32_t*> (destp)) {
+                  auto srcp = reinterpret_cast<uint8_t const*> (&colors[srcbuf[x]]);
+
+                  destp[0] = (alpha * (srcp[0] - destp[0]) >> 8) + destp[0];
+                  destp[1] = (alpha * (srcp[1] - destp[1]) >> 8) + destp[1];
+                  destp[2] = (alpha * (srcp[2] - destp[2]) >> 8) + destp[2];
+              }
+
+              destp += 4;
+          }
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+  }
+
 } // LV namespace
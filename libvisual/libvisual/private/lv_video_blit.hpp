@@ -23,6 +23,7 @@
 #define _LV_VIDEO_BLIT_HPP
 
 #include "lv_video.h"
+#include "lv_palette.h"
 
 namespace LV {
 
@@ -36,7 +37,23 @@ namespace LV {
       static void blit_overlay_surfacealpha (Video* dest, Video* src);
       static void blit_overlay_surfacealphacolorkey (Video* dest, Video* src);
 
-      static void blit_overlay_alphasrc_mmx (Video* dest, Video* src);
+      // Fused palette expansion and compose of 8-bit indexed sources onto 32-bit destinations
+      static void blit_overlay_index8_noalpha      (Video* dest, Video* src);
+      static void blit_overlay_index8_colorkey     (Video* dest, Video* src);
+      static void blit_overlay_index8_surfacealpha (Video* dest, Video* src);
+      static void blit_overlay_index8_surfacealphacolorkey (Video* dest, Video* src);
+
+      static bool is_index8_compose_function (VisVideoComposeFunc func);
+
+      // Whether the index8 kernels can take src and dest: an 8-bit source with a
+      // full 256 entry palette onto a 32-bit destination. Others use the generic path.
+      static bool is_index8_blit (Video const* dest, Video const* src);
+
+      static void expand_palette_argb32 (Palette const& palette, uint32_t* colors);
+
+      static void blit_overlay_index8_noalpha_sse2      (Video* dest, Video* src);
+      static void blit_overlay_index8_colorkey_sse2     (Video* dest, Video* src);
+      static void blit_overlay_index8_surfacealpha_sse2 (Video* dest, Video* src);
   };
 }
 
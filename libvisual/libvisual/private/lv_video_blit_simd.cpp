@@ -26,50 +26,156 @@
 #include "lv_video_blit.hpp"
 #include "lv_video_private.hpp"
 #include "lv_common.h"
+#include <algorithm>
+#include <array>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace LV {
 
-  void VideoBlit::blit_overlay_alphasrc_mmx (Video* dest, Video* src)
+#if defined(__SSE2__)
+
+  namespace {
+
+    // Gathers four palette entries into one vector
+    inline __m128i gather_argb32 (uint32_t const* colors, uint8_t const* indices)
+    {
+        return _mm_set_epi32 (colors[indices[3]], colors[indices[2]], colors[indices[1]], colors[indices[0]]);
+    }
+
+  } // anonymous namespace
+
+#endif /* __SSE2__ */
+
+  void VideoBlit::blit_overlay_index8_noalpha_sse2 (Video* dest, Video* src)
+  {
+#if defined(__SSE2__)
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = reinterpret_cast<uint32_t*> (destbuf);
+          int x = 0;
+
+          for (; x + 4 <= width; x += 4)
+              _mm_storeu_si128 (reinterpret_cast<__m128i*> (destp + x), gather_argb32 (colors.data (), srcbuf + x));
+
+          for (; x < width; x++)
+              destp[x] = colors[srcbuf[x]];
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+#endif /* __SSE2__ */
+  }
+
+  void VideoBlit::blit_overlay_index8_colorkey_sse2 (Video* dest, Video* src)
+  {
+#if defined(__SSE2__)
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      uint32_t color = src->m_impl->colorkey.to_uint32 ();
+      __m128i  key   = _mm_set1_epi32 (color);
+
+      auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = reinterpret_cast<uint32_t*> (destbuf);
+          int x = 0;
+
+          for (; x + 4 <= width; x += 4) {
+              auto dptr  = reinterpret_cast<__m128i*> (destp + x);
+              auto pixel = gather_argb32 (colors.data (), srcbuf + x);
+              auto keyed = _mm_cmpeq_epi32 (pixel, key);
+
+              _mm_storeu_si128 (dptr, _mm_or_si128 (_mm_and_si128 (keyed, _mm_loadu_si128 (dptr)),
+                                                    _mm_andnot_si128 (keyed, pixel)));
+          }
+
+          for (; x < width; x++) {
+              uint32_t pixel = colors[srcbuf[x]];
+
+              if (color != pixel)
+                  destp[x] = pixel;
+          }
+
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
+      }
+#endif /* __SSE2__ */
+  }
+
+  void VideoBlit::blit_overlay_index8_surfacealpha_sse2 (Video* dest, Video* src)
   {
-#if defined(VISUAL_ARCH_X86) || defined(VISUAL_ARCH_X86_64)
+#if defined(__SSE2__)
+      std::array<uint32_t, 256> colors;
+      expand_palette_argb32 (src->m_impl->palette, colors.data ());
+
+      uint8_t alpha = src->m_impl->alpha;
+
+      /* Zero weight in the alpha lanes keeps the destination alpha. Only bits
+       * 8..15 of alpha * (src - dest) survive truncation to 8 bits, so the
+       * low half of the 16-bit multiply suffices. */
+      auto const zero    = _mm_setzero_si128 ();
+      auto const lo_mask = _mm_set1_epi16 (0x00ff);
+      auto const weights = _mm_set_epi16 (0, alpha, alpha, alpha, 0, alpha, alpha, alpha);
+
       auto destbuf = static_cast<uint8_t*> (dest->get_pixels ());
-      auto srcbuf = static_cast<uint8_t const*> (src->get_pixels ());
-
-      for (int i = 0; i < src->m_impl->height; i++) {
-          for (int j = 0; j < src->m_impl->width; j++) {
-              __asm __volatile
-                  ("\n\t movd %[spix], %%mm0"
-                   "\n\t movd %[dpix], %%mm1"
-                   "\n\t movq %%mm0, %%mm2"
-                   "\n\t movq %%mm0, %%mm3"
-                   "\n\t psrlq $24, %%mm2"  /* The alpha */
-                   "\n\t movq %%mm0, %%mm4"
-                   "\n\t psrld $24, %%mm3"
-                   "\n\t psrld $24, %%mm4"
-                   "\n\t psllq $32, %%mm2"
-                   "\n\t psllq $16, %%mm3"
-                   "\n\t por %%mm4, %%mm2"
-                   "\n\t punpcklbw %%mm6, %%mm0"    /* interleaving dest */
-                   "\n\t por %%mm3, %%mm2"
-                   "\n\t punpcklbw %%mm6, %%mm1"    /* interleaving source */
-                   "\n\t psubsw %%mm1, %%mm0"   /* (src - dest) part */
-                   "\n\t pmullw %%mm2, %%mm0"   /* alpha * (src - dest) */
-                   "\n\t psrlw $8, %%mm0"       /* / 256 */
-                   "\n\t paddb %%mm1, %%mm0"    /* + dest */
-                   "\n\t packuswb %%mm0, %%mm0"
-                   "\n\t movd %%mm0, %[dest]"
-                   : [dest] "=m" (*destbuf)
-                   : [dpix] "m" (*destbuf)
-                   , [spix] "m" (*srcbuf));
-
-              destbuf += 4;
-              srcbuf += 4;
+      auto srcbuf  = static_cast<uint8_t const*> (src->get_pixels ());
+
+      int width  = std::min (src->m_impl->width,  dest->m_impl->width);
+      int height = std::min (src->m_impl->height, dest->m_impl->height);
+
+      for (int y = 0; y < height; y++) {
+          auto destp = destbuf;
+          int x = 0;
+
+          for (; x + 4 <= width; x += 4) {
+              auto dptr  = reinterpret_cast<__m128i*> (destp);
+              auto d     = _mm_loadu_si128 (dptr);
+              auto s     = gather_argb32 (colors.data (), srcbuf + x);
+
+              auto d_lo = _mm_unpacklo_epi8 (d, zero);
+              auto d_hi = _mm_unpackhi_epi8 (d, zero);
+
+              auto r_lo = _mm_mullo_epi16 (weights, _mm_sub_epi16 (_mm_unpacklo_epi8 (s, zero), d_lo));
+              auto r_hi = _mm_mullo_epi16 (weights, _mm_sub_epi16 (_mm_unpackhi_epi8 (s, zero), d_hi));
+
+              r_lo = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (r_lo, 8), d_lo), lo_mask);
+              r_hi = _mm_and_si128 (_mm_add_epi16 (_mm_srli_epi16 (r_hi, 8), d_hi), lo_mask);
+
+              _mm_storeu_si128 (dptr, _mm_packus_epi16 (r_lo, r_hi));
+
+              destp += 16;
+          }
+
+          for (; x < width; x++) {
+              auto srcp = reinterpret_cast<uint8_t const*> (&colors[srcbuf[x]]);
+
+              destp[0] = (alpha * (srcp[0] - destp[0]) >> 8) + destp[0];
+              destp[1] = (alpha * (srcp[1] - destp[1]) >> 8) + destp[1];
+              destp[2] = (alpha * (srcp[2] - destp[2]) >> 8) + destp[2];
+
+              destp += 4;
           }
 
-          destbuf += dest->m_impl->pitch - (dest->m_impl->width * dest->m_impl->bpp);
-          srcbuf += src->m_impl->pitch - (src->m_impl->width * src->m_impl->bpp);
+          destbuf += dest->m_impl->pitch;
+          srcbuf  += src->m_impl->pitch;
       }
-#endif /* !VISUAL_ARCH_X86 */
+#endif /* __SSE2__ */
   }
 
 } // LV namespace
@@ -51,9 +51,12 @@ namespace LV {
 
       VisVideoComposeType compose_type;
       VisVideoComposeFunc compose_func;
-      Color*              colorkey;
+      Color               colorkey;
       uint8_t             alpha;
 
+      std::vector<Rect>   damage;
+      bool                damage_recorded;
+
       Impl ();
 
       ~Impl ();
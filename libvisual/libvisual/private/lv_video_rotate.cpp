@@ -24,110 +24,193 @@
 #include "config.h"
 #include "lv_video_transform.hpp"
 #include "lv_video_private.hpp"
+#include "lv_row_bands.hpp"
 #include "lv_common.h"
+#include <algorithm>
+#include <cstring>
+
+// Rotations by 90 and 270 degrees are transposes with the rows of one side
+// walked bottom up. Pixels are moved in square tiles, with a SIMD kernel
+// transposing a whole tile in registers where there is one. Tiles are
+// visited in blocks small enough for the source rows they touch to stay in
+// the cache until every tile reading them is done.
 
 namespace LV {
 
+  namespace {
+
+    // Pixels per side of a block
+    int const block_size = 64;
+
+    // Transposes a width x height area of the source pixel by pixel
+    template <int Bpp>
+    void transpose_area (uint8_t* dst, std::ptrdiff_t dst_pitch, uint8_t const* src, std::ptrdiff_t src_pitch, int width, int height)
+    {
+        for (int x = 0; x < width; x++) {
+            auto dst_row = dst + x * dst_pitch;
+            auto src_col = src + x * Bpp;
+
+            for (int y = 0; y < height; y++)
+                std::memcpy (dst_row + y * Bpp, src_col + y * src_pitch, Bpp);
+        }
+    }
+
+    typedef void (*TransposeAreaFunc) (uint8_t* dst, std::ptrdiff_t dst_pitch, uint8_t const* src, std::ptrdiff_t src_pitch, int width, int height);
+
+    TransposeAreaFunc get_transpose_area (int bpp)
+    {
+        switch (bpp) {
+            case 1:  return transpose_area<1>;
+            case 2:  return transpose_area<2>;
+            case 3:  return transpose_area<3>;
+            default: return transpose_area<4>;
+        }
+    }
+
+    // Writes dst[x][y] = src[y][x] for a source of width x height pixels
+    void transpose (uint8_t* dst, std::ptrdiff_t dst_pitch,
+                    uint8_t const* src, std::ptrdiff_t src_pitch,
+                    int width, int height, int bpp)
+    {
+        int  tile_size = VideoTransform::get_tile_size (bpp);
+        auto transpose_tile = VideoTransform::get_transpose_tile_simd (bpp);
+        auto transpose_area = get_transpose_area (bpp);
+
+        // Bands are destination rows, which are source columns
+        run_row_bands (width, height * bpp * 2, [=] (int y_begin, int y_end) {
+            for (int block_y = y_begin; block_y < y_end; block_y += block_size) {
+                int block_height = std::min (block_size, y_end - block_y);
+
+                for (int block_x = 0; block_x < height; block_x += block_size) {
+                    int block_width = std::min (block_size, height - block_x);
+
+                    auto dst_block = dst + block_y * dst_pitch + block_x * bpp;
+                    auto src_block = src + block_x * src_pitch + block_y * bpp;
+
+                    if (!transpose_tile) {
+                        transpose_area (dst_block, dst_pitch, src_block, src_pitch, block_height, block_width);
+                        continue;
+                    }
+
+                    for (int y = 0; y < block_height; y += tile_size) {
+                        for (int x = 0; x < block_width; x += tile_size) {
+                            auto dst_tile = dst_block + y * dst_pitch + x * bpp;
+                            auto src_tile = src_block + x * src_pitch + y * bpp;
+
+                            if (y + tile_size <= block_height && x + tile_size <= block_width) {
+                                transpose_tile (dst_tile, dst_pitch, src_tile, src_pitch);
+                            } else {
+                                transpose_area (dst_tile, dst_pitch, src_tile, src_pitch,
+                                                std::min (tile_size, block_height - y),
+                                                std::min (tile_size, block_width - x));
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    template <int Bpp>
+    void mirror_row_c (uint8_t* dst, uint8_t const* src, std::size_t begin, std::size_t count)
+    {
+        for (auto i = begin; i < count; i++)
+            std::memcpy (dst + i * Bpp, src + (count - 1 - i) * Bpp, Bpp);
+    }
+
+    void mirror_row (uint8_t* dst, uint8_t const* src, std::size_t count, int bpp)
+    {
+        auto done = VideoTransform::mirror_row_simd (dst, src, count, bpp);
+
+        switch (bpp) {
+            case 1:  mirror_row_c<1> (dst, src, done, count); break;
+            case 2:  mirror_row_c<2> (dst, src, done, count); break;
+            case 3:  mirror_row_c<3> (dst, src, done, count); break;
+            default: mirror_row_c<4> (dst, src, done, count); break;
+        }
+    }
+
+  } // anonymous namespace
+
+  int VideoTransform::get_tile_size (int bpp)
+  {
+      // One SIMD register per tile row
+      switch (bpp) {
+          case 1:  return 16;
+          case 2:  return 8;
+          case 4:  return 4;
+          default: return 8;
+      }
+  }
+
   void VideoTransform::rotate_90 (Video& dst, Video const& src)
   {
       visual_return_if_fail (dst.m_impl->width == src.m_impl->height);
       visual_return_if_fail (dst.m_impl->height == src.m_impl->width);
+      visual_return_if_fail (dst.m_impl->depth == src.m_impl->depth);
 
-      auto tsbuf = static_cast<uint8_t*> (src.m_impl->pixel_rows[src.m_impl->height-1]);
-      auto sbuf  = tsbuf;
-
-      for (int y = 0; y < dst.m_impl->height; y++) {
-          auto dbuf = static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]);
-
-          for (int x = 0; x < dst.m_impl->width; x++) {
-              for (int i = 0; i < dst.m_impl->bpp; i++) {
-                  *(dbuf++) = *(sbuf + i);
-              }
-
-              sbuf -= src.m_impl->pitch;
-          }
-
-          tsbuf += src.m_impl->bpp;
-          sbuf = tsbuf;
-      }
+      // dst[y][x] = src[height - 1 - x][y]
+      transpose (static_cast<uint8_t*> (dst.m_impl->pixel_rows[0]), dst.m_impl->pitch,
+                 static_cast<uint8_t const*> (src.m_impl->pixel_rows[src.m_impl->height - 1]), -std::ptrdiff_t (src.m_impl->pitch),
+                 src.m_impl->width, src.m_impl->height, src.m_impl->bpp);
   }
 
   void VideoTransform::rotate_180 (Video& dst, Video const& src)
   {
-      int h1 = src.m_impl->height - 1;
-      int w1 = (src.m_impl->width - 1) * src.m_impl->bpp;
-
       visual_return_if_fail (dst.m_impl->width  == src.m_impl->width);
       visual_return_if_fail (dst.m_impl->height == src.m_impl->height);
+      visual_return_if_fail (dst.m_impl->depth == src.m_impl->depth);
 
-      for (int y = 0; y < dst.m_impl->height; y++) {
-          auto dbuf = static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]);
-          auto sbuf = static_cast<uint8_t const*> (src.m_impl->pixel_rows[h1 - y]) + w1;
-
-          for (int x = 0; x < dst.m_impl->width; x++) {
-              for (int i = 0; i < src.m_impl->bpp; i++) {
-                  *(dbuf++) = *(sbuf + i);
-              }
+      int height = dst.m_impl->height;
+      int width  = dst.m_impl->width;
+      int bpp    = dst.m_impl->bpp;
 
-              sbuf -= src.m_impl->bpp;
+      run_row_bands (height, width * bpp * 2, [&] (int y_begin, int y_end) {
+          for (int y = y_begin; y < y_end; y++) {
+              mirror_row (static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]),
+                          static_cast<uint8_t const*> (src.m_impl->pixel_rows[height - 1 - y]),
+                          width, bpp);
           }
-      }
+      });
   }
 
   void VideoTransform::rotate_270 (Video& dst, Video const& src)
   {
-      auto tsbuf = static_cast<uint8_t*> (src.get_pixels ()) + src.m_impl->pitch - src.m_impl->bpp;
-      auto sbuf = tsbuf;
-
       visual_return_if_fail (dst.m_impl->width == src.m_impl->height);
       visual_return_if_fail (dst.m_impl->height == src.m_impl->width);
+      visual_return_if_fail (dst.m_impl->depth == src.m_impl->depth);
 
-      for (int y = 0; y < dst.m_impl->height; y++) {
-          auto dbuf = static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]);
-
-          for (int x = 0; x < dst.m_impl->width; x++) {
-              for (int i = 0; i < dst.m_impl->bpp; i++) {
-                  *(dbuf++) = *(sbuf + i);
-              }
-
-              sbuf += src.m_impl->pitch;
-          }
-
-          tsbuf -= src.m_impl->bpp;
-          sbuf = tsbuf;
-      }
+      // dst[width - 1 - x][y] = src[y][x]
+      transpose (static_cast<uint8_t*> (dst.m_impl->pixel_rows[dst.m_impl->height - 1]), -std::ptrdiff_t (dst.m_impl->pitch),
+                 static_cast<uint8_t const*> (src.m_impl->pixel_rows[0]), src.m_impl->pitch,
+                 src.m_impl->width, src.m_impl->height, src.m_impl->bpp);
   }
 
   // Mirror functions
 
   void VideoTransform::mirror_x (Video& dst, Video const& src)
   {
-      const int step2 = dst.m_impl->bpp << 1;
-      const int w1b = (dst.m_impl->width - 1) * dst.m_impl->bpp;
-
-      for (int y = 0; y < dst.m_impl->height; y++) {
-          auto sbuf = static_cast<uint8_t*> (src.m_impl->pixel_rows[y]) + w1b;
-          auto dbuf = static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]);
-
-          for (int x = 0; x < dst.m_impl->width; x++) {
-
-              for (int i = 0; i < dst.m_impl->bpp; i++)
-                  *(dbuf++) = *(sbuf++);
-
-              sbuf -= step2;
+      int width = dst.m_impl->width;
+      int bpp   = dst.m_impl->bpp;
+
+      run_row_bands (dst.m_impl->height, width * bpp * 2, [&] (int y_begin, int y_end) {
+          for (int y = y_begin; y < y_end; y++) {
+              mirror_row (static_cast<uint8_t*> (dst.m_impl->pixel_rows[y]),
+                          static_cast<uint8_t const*> (src.m_impl->pixel_rows[y]),
+                          width, bpp);
           }
-      }
+      });
   }
 
   void VideoTransform::mirror_y (Video& dst, Video const& src)
   {
-      int y;
+      int height    = dst.m_impl->height;
+      int row_bytes = dst.m_impl->width * dst.m_impl->bpp;
 
-      for (y = 0; y < dst.m_impl->height; y++) {
-          visual_mem_copy (dst.m_impl->pixel_rows[y],
-                           src.m_impl->pixel_rows[dst.m_impl->height - 1 - y],
-                           dst.m_impl->width * dst.m_impl->bpp);
-      }
+      run_row_bands (height, row_bytes * 2, [&] (int y_begin, int y_end) {
+          for (int y = y_begin; y < y_end; y++)
+              std::memcpy (dst.m_impl->pixel_rows[y], src.m_impl->pixel_rows[height - 1 - y], row_bytes);
+      });
   }
 
 } // LV namespace
@@ -0,0 +1,274 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_video_transform.hpp"
+#include "lv_cpu.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Tiles are transposed by interleaving row i with row i + N/2, N/2 rows at
+// a time. After log2(N) rounds of this perfect shuffle every row holds a
+// column of the tile.
+
+namespace LV {
+
+  namespace {
+
+#if defined(__SSE2__)
+
+    struct Interleave8
+    {
+        static __m128i lo (__m128i a, __m128i b) { return _mm_unpacklo_epi8 (a, b); }
+        static __m128i hi (__m128i a, __m128i b) { return _mm_unpackhi_epi8 (a, b); }
+    };
+
+    struct Interleave16
+    {
+        static __m128i lo (__m128i a, __m128i b) { return _mm_unpacklo_epi16 (a, b); }
+        static __m128i hi (__m128i a, __m128i b) { return _mm_unpackhi_epi16 (a, b); }
+    };
+
+    struct Interleave32
+    {
+        static __m128i lo (__m128i a, __m128i b) { return _mm_unpacklo_epi32 (a, b); }
+        static __m128i hi (__m128i a, __m128i b) { return _mm_unpackhi_epi32 (a, b); }
+    };
+
+    template <int N, int Rounds, typename Interleave>
+    void transpose_tile_sse2 (uint8_t* dst, std::ptrdiff_t dst_pitch, uint8_t const* src, std::ptrdiff_t src_pitch)
+    {
+        __m128i rows[N];
+        __m128i shuffled[N];
+
+        for (int i = 0; i < N; i++)
+            rows[i] = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + i * src_pitch));
+
+        for (int round = 0; round < Rounds; round++) {
+            for (int i = 0; i < N / 2; i++) {
+                shuffled[2 * i]     = Interleave::lo (rows[i], rows[i + N / 2]);
+                shuffled[2 * i + 1] = Interleave::hi (rows[i], rows[i + N / 2]);
+            }
+
+            for (int i = 0; i < N; i++)
+                rows[i] = shuffled[i];
+        }
+
+        for (int i = 0; i < N; i++)
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i * dst_pitch), rows[i]);
+    }
+
+    // Reverses the order of the 16-bit lanes
+    inline __m128i reverse_epi16 (__m128i x)
+    {
+        x = _mm_shuffle_epi32 (x, _MM_SHUFFLE (1, 0, 3, 2));
+        x = _mm_shufflelo_epi16 (x, _MM_SHUFFLE (0, 1, 2, 3));
+        return _mm_shufflehi_epi16 (x, _MM_SHUFFLE (0, 1, 2, 3));
+    }
+
+    // Reverses the order of the pixels in a vector
+    template <int Bpp>
+    __m128i reverse_pixels (__m128i x);
+
+    template <>
+    inline __m128i reverse_pixels<1> (__m128i x)
+    {
+        x = reverse_epi16 (x);
+        return _mm_or_si128 (_mm_slli_epi16 (x, 8), _mm_srli_epi16 (x, 8));
+    }
+
+    template <>
+    inline __m128i reverse_pixels<2> (__m128i x)
+    {
+        return reverse_epi16 (x);
+    }
+
+    template <>
+    inline __m128i reverse_pixels<4> (__m128i x)
+    {
+        return _mm_shuffle_epi32 (x, _MM_SHUFFLE (0, 1, 2, 3));
+    }
+
+    template <int Bpp>
+    std::size_t mirror_row_sse2 (uint8_t* dst, uint8_t const* src, std::size_t count)
+    {
+        std::size_t const step = 16 / Bpp;
+
+        std::size_t i = 0;
+
+        for (; i + step <= count; i += step) {
+            auto x = _mm_loadu_si128 (reinterpret_cast<__m128i const*> (src + (count - i - step) * Bpp));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i * Bpp), reverse_pixels<Bpp> (x));
+        }
+
+        return i;
+    }
+
+#endif // __SSE2__
+
+#if defined(__ARM_NEON)
+
+    struct Interleave8
+    {
+        static uint8x16x2_t zip (uint8x16_t a, uint8x16_t b) { return vzipq_u8 (a, b); }
+    };
+
+    struct Interleave16
+    {
+        static uint8x16x2_t zip (uint8x16_t a, uint8x16_t b)
+        {
+            auto z = vzipq_u16 (vreinterpretq_u16_u8 (a), vreinterpretq_u16_u8 (b));
+            return { { vreinterpretq_u8_u16 (z.val[0]), vreinterpretq_u8_u16 (z.val[1]) } };
+        }
+    };
+
+    struct Interleave32
+    {
+        static uint8x16x2_t zip (uint8x16_t a, uint8x16_t b)
+        {
+            auto z = vzipq_u32 (vreinterpretq_u32_u8 (a), vreinterpretq_u32_u8 (b));
+            return { { vreinterpretq_u8_u32 (z.val[0]), vreinterpretq_u8_u32 (z.val[1]) } };
+        }
+    };
+
+    template <int N, int Rounds, typename Interleave>
+    void transpose_tile_neon (uint8_t* dst, std::ptrdiff_t dst_pitch, uint8_t const* src, std::ptrdiff_t src_pitch)
+    {
+        uint8x16_t rows[N];
+        uint8x16_t shuffled[N];
+
+        for (int i = 0; i < N; i++)
+            rows[i] = vld1q_u8 (src + i * src_pitch);
+
+        for (int round = 0; round < Rounds; round++) {
+            for (int i = 0; i < N / 2; i++) {
+                auto z = Interleave::zip (rows[i], rows[i + N / 2]);
+                shuffled[2 * i]     = z.val[0];
+                shuffled[2 * i + 1] = z.val[1];
+            }
+
+            for (int i = 0; i < N; i++)
+                rows[i] = shuffled[i];
+        }
+
+        for (int i = 0; i < N; i++)
+            vst1q_u8 (dst + i * dst_pitch, rows[i]);
+    }
+
+    inline uint8x16_t reverse_u8 (uint8x16_t x)
+    {
+        x = vrev64q_u8 (x);
+        return vcombine_u8 (vget_high_u8 (x), vget_low_u8 (x));
+    }
+
+    std::size_t mirror_row_neon (uint8_t* dst, uint8_t const* src, std::size_t count, int bpp)
+    {
+        std::size_t i = 0;
+
+        if (bpp == 3) {
+            // Deinterleaves the channels so each can be reversed as bytes
+            for (; i + 16 <= count; i += 16) {
+                auto x = vld3q_u8 (src + (count - i - 16) * 3);
+
+                x.val[0] = reverse_u8 (x.val[0]);
+                x.val[1] = reverse_u8 (x.val[1]);
+                x.val[2] = reverse_u8 (x.val[2]);
+
+                vst3q_u8 (dst + i * 3, x);
+            }
+
+            return i;
+        }
+
+        std::size_t step = 16 / bpp;
+
+        for (; i + step <= count; i += step) {
+            auto x = vld1q_u8 (src + (count - i - step) * bpp);
+
+            switch (bpp) {
+                case 1:
+                    x = reverse_u8 (x);
+                    break;
+                case 2: {
+                    auto y = vrev64q_u16 (vreinterpretq_u16_u8 (x));
+                    x = vreinterpretq_u8_u16 (vcombine_u16 (vget_high_u16 (y), vget_low_u16 (y)));
+                    break;
+                }
+                default: {
+                    auto y = vrev64q_u32 (vreinterpretq_u32_u8 (x));
+                    x = vreinterpretq_u8_u32 (vcombine_u32 (vget_high_u32 (y), vget_low_u32 (y)));
+                    break;
+                }
+            }
+
+            vst1q_u8 (dst + i * bpp, x);
+        }
+
+        return i;
+    }
+
+#endif // __ARM_NEON
+
+  } // anonymous namespace
+
+  VideoTransform::TransposeTileFunc VideoTransform::get_transpose_tile_simd (int bpp)
+  {
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          switch (bpp) {
+              case 1: return transpose_tile_sse2<16, 4, Interleave8>;
+              case 2: return transpose_tile_sse2<8, 3, Interleave16>;
+              case 4: return transpose_tile_sse2<4, 2, Interleave32>;
+          }
+      }
+#elif defined(__ARM_NEON)
+      switch (bpp) {
+          case 1: return transpose_tile_neon<16, 4, Interleave8>;
+          case 2: return transpose_tile_neon<8, 3, Interleave16>;
+          case 4: return transpose_tile_neon<4, 2, Interleave32>;
+      }
+#endif
+
+      return nullptr;
+  }
+
+  std::size_t VideoTransform::mirror_row_simd (uint8_t* dst, uint8_t const* src, std::size_t count, int bpp)
+  {
+#if defined(__SSE2__)
+      if (visual_cpu_has_sse2 ()) {
+          switch (bpp) {
+              case 1: return mirror_row_sse2<1> (dst, src, count);
+              case 2: return mirror_row_sse2<2> (dst, src, count);
+              case 4: return mirror_row_sse2<4> (dst, src, count);
+          }
+      }
+#elif defined(__ARM_NEON)
+      return mirror_row_neon (dst, src, count, bpp);
+#endif
+
+      return 0;
+  }
+
+} // LV namespace
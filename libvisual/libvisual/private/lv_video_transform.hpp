@@ -23,6 +23,7 @@
 #define _LV_VIDEO_SCALE_HPP
 
 #include "lv_video.h"
+#include <cstddef>
 
 namespace LV {
 
@@ -48,6 +49,20 @@ namespace LV {
       static void scale_bilinear_color32 (Video& dst, Video const& src);
 
       static void scale_bilinear_color32_mmx (Video& dst, Video const& src);
+
+      // Transposes a square tile of get_tile_size() pixels. Pitches may be
+      // negative to walk rows bottom up.
+      typedef void (*TransposeTileFunc) (uint8_t* dst, std::ptrdiff_t dst_pitch, uint8_t const* src, std::ptrdiff_t src_pitch);
+
+      // Pixels per side of the tiles rotations are done in
+      static int get_tile_size (int bpp);
+
+      // SIMD tile transpose for the pixel size, or nullptr if there is none
+      static TransposeTileFunc get_transpose_tile_simd (int bpp);
+
+      // Writes a row of pixels in reverse. Returns the number of pixels
+      // done, leaving the rest to the C version.
+      static std::size_t mirror_row_simd (uint8_t* dst, uint8_t const* src, std::size_t count, int bpp);
   };
 
 } // LV namespace
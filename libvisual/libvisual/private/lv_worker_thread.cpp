@@ -0,0 +1,120 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "config.h"
+#include "lv_worker_thread.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace LV {
+
+  class WorkerThread::Impl
+  {
+  public:
+
+      mutable std::mutex      mutex;
+      std::condition_variable job_ready;
+      std::condition_variable jobs_done;
+      std::deque<Job>         jobs;
+      bool                    running;  // true while a job is being run
+      bool                    stopping;
+      std::thread             thread;
+
+      Impl ();
+
+      void loop ();
+  };
+
+  WorkerThread::Impl::Impl ()
+      : running  (false)
+      , stopping (false)
+  {
+      // empty
+  }
+
+  void WorkerThread::Impl::loop ()
+  {
+      std::unique_lock<std::mutex> lock (mutex);
+
+      for (;;) {
+          job_ready.wait (lock, [this] { return stopping || !jobs.empty (); });
+
+          if (jobs.empty ())
+              return;
+
+          auto job = std::move (jobs.front ());
+          jobs.pop_front ();
+          running = true;
+
+          lock.unlock ();
+          job ();
+          lock.lock ();
+
+          running = false;
+
+          if (jobs.empty ())
+              jobs_done.notify_all ();
+      }
+  }
+
+  WorkerThread::WorkerThread ()
+      : m_impl (new Impl)
+  {
+      m_impl->thread = std::thread (&Impl::loop, m_impl.get ());
+  }
+
+  WorkerThread::~WorkerThread ()
+  {
+      {
+          std::lock_guard<std::mutex> lock (m_impl->mutex);
+          m_impl->stopping = true;
+      }
+
+      // The thread drains the queue before it stops
+      m_impl->job_ready.notify_one ();
+      m_impl->thread.join ();
+  }
+
+  void WorkerThread::submit (Job job)
+  {
+      {
+          std::lock_guard<std::mutex> lock (m_impl->mutex);
+          m_impl->jobs.push_back (std::move (job));
+      }
+
+      m_impl->job_ready.notify_one ();
+  }
+
+  void WorkerThread::wait ()
+  {
+      std::unique_lock<std::mutex> lock (m_impl->mutex);
+
+      m_impl->jobs_done.wait (lock, [this] { return m_impl->jobs.empty () && !m_impl->running; });
+  }
+
+  bool WorkerThread::is_idle () const
+  {
+      std::lock_guard<std::mutex> lock (m_impl->mutex);
+
+      return m_impl->jobs.empty () && !m_impl->running;
+  }
+
+} // LV namespace
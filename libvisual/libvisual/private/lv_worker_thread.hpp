@@ -0,0 +1,79 @@
+/* Libvisual - The audio visualisation framework.
+ *
+ * Copyright (C) 2012 Libvisual team
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _LV_WORKER_THREAD_HPP
+#define _LV_WORKER_THREAD_HPP
+
+#include "lvconfig.h"
+#include "lv_defines.h"
+
+#include <functional>
+#include <memory>
+
+namespace LV {
+
+  /**
+   * Background thread running jobs in the order they are submitted.
+   *
+   * The thread is started with the worker and kept until the worker is
+   * destroyed, so handing it a job costs a wake-up rather than a thread
+   * creation.
+   */
+  class WorkerThread
+  {
+  public:
+
+      typedef std::function<void ()> Job;
+
+      WorkerThread ();
+
+      WorkerThread (WorkerThread const&) = delete;
+
+      /**
+       * Waits for all submitted jobs to finish, then stops the thread.
+       */
+      ~WorkerThread ();
+
+      WorkerThread& operator= (WorkerThread const&) = delete;
+
+      /**
+       * Queues a job to run on the thread.
+       */
+      void submit (Job job);
+
+      /**
+       * Waits for all submitted jobs to finish.
+       */
+      void wait ();
+
+      /**
+       * Returns true if no job is queued or running.
+       */
+      bool is_idle () const;
+
+  private:
+
+      class Impl;
+
+      const std::unique_ptr<Impl> m_impl;
+  };
+
+} // LV namespace
+
+#endif // _LV_WORKER_THREAD_HPP
@@ -0,0 +1,723 @@
+#include <libvisual/libvisual.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+
+// Renders a fixed number of frames of every actor plugin at every depth it
+// supports, and records or checks the frames against a golden set.
+//
+// Rendering is made repeatable by seeding the random number generators
+// before each actor is loaded, feeding the same audio for every frame and
+// running on a virtual clock that moves 1/60 of a second per frame. A
+// golden set records a hash of every frame, the time it took to render and
+// the last frame itself. Checking renders the frames again and reports:
+//
+//   identical  all frame hashes match
+//   close      some hashes differ, but the last frame is within the PSNR
+//              threshold of the golden one
+//   DIFFERENT  the last frame is below the PSNR threshold
+//   unstable   the actor did not render the same frames twice when the
+//              golden set was recorded, e.g. as it reads the system clock
+//
+// along with the change in median render time. Typical use is to record a
+// golden set from a base build, then check a build with the change against
+// it:
+//
+//   actor_golden --record golden/ [actor...]
+//   actor_golden --check golden/ [actor...]
+//
+// --pairs needs no golden set. It renders two instances of each actor at
+// the same time on two threads, and checks that both produce the frames
+// of one instance rendering alone. Actors that keep state outside their
+// instance fail this check.
+
+namespace {
+
+  typedef std::chrono::steady_clock Clock;
+  typedef std::chrono::duration<double, std::micro> Duration;
+
+  unsigned int const sample_rate    = 44100;
+  unsigned int const frame_rate     = 60;
+  unsigned int const frame_samples  = sample_rate / frame_rate;
+
+  struct Settings
+  {
+      unsigned int width      = 320;
+      unsigned int height     = 240;
+      unsigned int frames     = 60;
+      unsigned int seed       = 1;
+      std::string  pcm_path;          // raw S16 stereo at 44.1kHz, empty for the built-in signal
+  };
+
+  // Interleaved stereo S16 audio fed to the actors, 1/60 s per frame
+  class PcmSource
+  {
+  public:
+
+      explicit PcmSource (std::string const& path)
+      {
+          if (path.empty ()) {
+              generate ();
+          } else {
+              load (path);
+          }
+
+          if (m_samples.size () < frame_samples * 2) {
+              throw std::runtime_error ("Audio file is shorter than a frame");
+          }
+      }
+
+      // Uploads the audio of a frame. The audio loops when it runs out.
+      void upload (LV::Audio& audio, unsigned int frame) const
+      {
+          auto buffer = LV::Buffer::create (frame_samples * 2 * sizeof (int16_t));
+          auto data   = static_cast<int16_t*> (buffer->get_data ());
+
+          std::size_t position = std::size_t (frame) * frame_samples * 2;
+
+          for (unsigned int i = 0; i < frame_samples * 2; i++)
+              data[i] = m_samples[(position + i) % m_samples.size ()];
+
+          audio.input (buffer, VISUAL_AUDIO_SAMPLE_RATE_44100,
+                       VISUAL_AUDIO_SAMPLE_FORMAT_S16, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+      }
+
+  private:
+
+      std::vector<int16_t> m_samples;
+
+      void load (std::string const& path)
+      {
+          std::ifstream file (path, std::ios::binary);
+          if (!file) {
+              throw std::runtime_error ("Cannot open " + path);
+          }
+
+          std::vector<char> bytes ((std::istreambuf_iterator<char> (file)), std::istreambuf_iterator<char> ());
+
+          // Samples are little endian
+          m_samples.resize (bytes.size () / 2);
+
+          for (std::size_t i = 0; i < m_samples.size (); i++)
+              m_samples[i] = int16_t (uint8_t (bytes[i*2]) | (uint8_t (bytes[i*2+1]) << 8));
+      }
+
+      // Ten seconds of a bass line, a wobbling tone and a kick drum every
+      // half second
+      void generate ()
+      {
+          unsigned int const length = sample_rate * 10;
+
+          m_samples.resize (length * 2);
+
+          uint32_t noise = 1;
+
+          for (unsigned int i = 0; i < length; i++) {
+              float t = float (i) / sample_rate;
+
+              float bass = 0.3f * std::sin (2.0f * VISUAL_MATH_PI * 110.0f * t);
+              float tone = 0.2f * std::sin (2.0f * VISUAL_MATH_PI * 440.0f * t * (1.0f + 0.1f * std::sin (0.5f * t)));
+
+              noise = noise * 1664525u + 1013904223u;
+              float since_kick = float (i % (sample_rate / 2)) / sample_rate;
+              float kick = 0.5f * std::exp (-since_kick * 40.0f) * (float (noise >> 8) / float (1u << 23) - 1.0f);
+
+              m_samples[i*2]   = int16_t ((bass + tone + kick) * 32767 / 1.5f);
+              m_samples[i*2+1] = int16_t ((bass - tone + kick) * 32767 / 1.5f);
+          }
+      }
+  };
+
+  // FNV-1a hash of the visible pixels and, for indexed video, the palette
+  uint64_t hash_frame (LV::Video const& video, LV::Palette const* palette)
+  {
+      uint64_t hash = 14695981039346656037ull;
+
+      auto add = [&hash] (uint8_t const* data, std::size_t size) {
+          for (std::size_t i = 0; i < size; i++) {
+              hash ^= data[i];
+              hash *= 1099511628211ull;
+          }
+      };
+
+      auto row_size = std::size_t (video.get_width ()) * video.get_bpp ();
+
+      for (int y = 0; y < video.get_height (); y++)
+          add (static_cast<uint8_t const*> (video.get_pixel_ptr (0, y)), row_size);
+
+      if (video.get_depth () == VISUAL_VIDEO_DEPTH_8BIT && palette) {
+          for (auto const& color : palette->colors) {
+              uint8_t rgb[] = { color.r, color.g, color.b };
+              add (rgb, sizeof (rgb));
+          }
+      }
+
+      return hash;
+  }
+
+  struct Run
+  {
+      std::vector<uint64_t> hashes;
+      std::vector<double>   times;    // render time of each frame in microseconds
+      std::vector<uint8_t>  last;     // last frame as tightly packed 32-bit pixels
+  };
+
+  // Actor rendering into its own video
+  struct Instance
+  {
+      LV::ActorPtr actor;
+      LV::VideoPtr video;
+      LV::Audio    audio;
+  };
+
+  // Loads an actor with the random number generators seeded, so every
+  // instance starts from the same state
+  std::unique_ptr<Instance> load_instance (std::string const& actor_name, VisVideoDepth depth, Settings const& settings)
+  {
+      LV::System::instance ()->set_rng_seed (settings.seed);
+      std::srand (settings.seed);
+
+      std::unique_ptr<Instance> instance {new Instance};
+
+      instance->actor = LV::Actor::load (actor_name);
+      if (!instance->actor) {
+          throw std::runtime_error ("Cannot load actor " + actor_name);
+      }
+
+      instance->actor->realize ();
+
+      instance->video = LV::Video::create (settings.width, settings.height, depth);
+      instance->actor->set_video (instance->video);
+      instance->actor->video_negotiate (depth, false, true);
+
+      return instance;
+  }
+
+  // Renders frames of an actor from a fresh start
+  Run render (std::string const& actor_name, VisVideoDepth depth, Settings const& settings, PcmSource const& source)
+  {
+      // Restarts the virtual clock at zero
+      LV::Time::use_virtual_clock (true);
+
+      auto instance = load_instance (actor_name, depth, settings);
+
+      auto& actor = instance->actor;
+      auto& video = instance->video;
+      auto& audio = instance->audio;
+
+      Run run;
+
+      for (unsigned int frame = 0; frame < settings.frames; frame++) {
+          source.upload (audio, frame);
+
+          auto start = Clock::now ();
+          actor->run (audio);
+          run.times.push_back (Duration (Clock::now () - start).count ());
+
+          run.hashes.push_back (hash_frame (*video, actor->get_palette ()));
+
+          LV::Time::advance_virtual_clock (LV::Time::from_usecs (VISUAL_USECS_PER_SEC / frame_rate));
+      }
+
+      // Indexed frames are stored with their palette applied
+      auto last = LV::Video::create (settings.width, settings.height, VISUAL_VIDEO_DEPTH_32BIT);
+      if (depth == VISUAL_VIDEO_DEPTH_8BIT && actor->get_palette ())
+          video->set_palette (*actor->get_palette ());
+      last->convert_depth (video);
+
+      for (int y = 0; y < last->get_height (); y++) {
+          auto row = static_cast<uint8_t const*> (last->get_pixel_ptr (0, y));
+          run.last.insert (run.last.end (), row, row + last->get_width () * 4);
+      }
+
+      instance.reset ();
+      LV::Time::use_virtual_clock (false);
+
+      return run;
+  }
+
+  // Renders frames of two instances of an actor side by side, each frame
+  // on two threads at once, and returns their frame hashes
+  std::pair<std::vector<uint64_t>, std::vector<uint64_t>>
+  render_pair (std::string const& actor_name, VisVideoDepth depth, Settings const& settings, PcmSource const& source)
+  {
+      LV::Time::use_virtual_clock (true);
+
+      auto first  = load_instance (actor_name, depth, settings);
+      auto second = load_instance (actor_name, depth, settings);
+
+      std::pair<std::vector<uint64_t>, std::vector<uint64_t>> hashes;
+
+      for (unsigned int frame = 0; frame < settings.frames; frame++) {
+          source.upload (first->audio, frame);
+          source.upload (second->audio, frame);
+
+          std::thread worker ([&first] {
+              first->actor->run (first->audio);
+          });
+
+          second->actor->run (second->audio);
+          worker.join ();
+
+          hashes.first.push_back (hash_frame (*first->video, first->actor->get_palette ()));
+          hashes.second.push_back (hash_frame (*second->video, second->actor->get_palette ()));
+
+          LV::Time::advance_virtual_clock (LV::Time::from_usecs (VISUAL_USECS_PER_SEC / frame_rate));
+      }
+
+      first.reset ();
+      second.reset ();
+      LV::Time::use_virtual_clock (false);
+
+      return hashes;
+  }
+
+  // PSNR over the colour channels, infinite for identical frames
+  double compute_psnr (std::vector<uint8_t> const& a, std::vector<uint8_t> const& b)
+  {
+      if (a.size () != b.size () || a.empty ()) {
+          return 0.0;
+      }
+
+      double error = 0.0;
+      std::size_t count = 0;
+
+      for (std::size_t i = 0; i < a.size (); i++) {
+          // Skip the unused fourth byte
+          if (i % 4 == 3)
+              continue;
+
+          double diff = double (a[i]) - double (b[i]);
+          error += diff * diff;
+          count++;
+      }
+
+      if (error == 0.0)
+          return INFINITY;
+
+      return 10.0 * std::log10 (255.0 * 255.0 / (error / count));
+  }
+
+  double median (std::vector<double> values)
+  {
+      std::sort (values.begin (), values.end ());
+      return values.empty () ? 0.0 : values[values.size () / 2];
+  }
+
+  // Golden data of one actor at one depth
+  struct Golden
+  {
+      bool                  stable = true;
+      std::vector<uint64_t> hashes;
+      std::vector<double>   times;
+  };
+
+  std::string key (std::string const& actor_name, VisVideoDepth depth)
+  {
+      return actor_name + "-" + std::to_string (visual_video_depth_bpp (depth));
+  }
+
+  std::string frame_path (std::string const& dir, std::string const& key)
+  {
+      return dir + "/" + key + ".raw";
+  }
+
+  // Returns the names of all actors that do not need OpenGL
+  std::vector<std::string> get_actor_names ()
+  {
+      std::vector<std::string> names;
+
+      for (auto const& plugin : LV::PluginRegistry::instance ()->get_plugins_by_type (VISUAL_PLUGIN_TYPE_ACTOR))
+          names.push_back (plugin.info->plugname);
+
+      std::sort (names.begin (), names.end ());
+
+      return names;
+  }
+
+  std::vector<VisVideoDepth> get_depths (std::string const& actor_name)
+  {
+      auto actor = LV::Actor::load (actor_name);
+      if (!actor) {
+          throw std::runtime_error ("Cannot load actor " + actor_name);
+      }
+
+      std::vector<VisVideoDepth> depths;
+
+      for (int bpp = 1; bpp <= 4; bpp++) {
+          auto depth = visual_video_depth_from_bpp (bpp * 8);
+          if (visual_video_depth_is_supported (actor->get_supported_depths (), depth))
+              depths.push_back (depth);
+      }
+
+      return depths;
+  }
+
+  // Creates dir along with any missing parent directories, like mkdir -p
+  void make_dirs (std::string const& dir)
+  {
+      for (std::size_t end = dir.find ('/', 1); ; end = dir.find ('/', end + 1)) {
+          auto path = dir.substr (0, end);
+
+          if (::mkdir (path.c_str (), 0755) < 0 && errno != EEXIST) {
+              throw std::runtime_error ("Cannot create " + path + ": " + std::strerror (errno));
+          }
+
+          if (end == std::string::npos)
+              break;
+      }
+
+      struct stat info;
+      if (::stat (dir.c_str (), &info) < 0 || !S_ISDIR (info.st_mode)) {
+          throw std::runtime_error (dir + " is not a directory");
+      }
+  }
+
+  void record (std::string const& dir, std::vector<std::string> const& actor_names, Settings const& settings)
+  {
+      PcmSource source (settings.pcm_path);
+
+      make_dirs (dir);
+
+      std::ofstream index (dir + "/golden.txt");
+      if (!index) {
+          throw std::runtime_error ("Cannot write to " + dir);
+      }
+
+      index << "size " << settings.width << " " << settings.height << "\n"
+            << "frames " << settings.frames << "\n"
+            << "seed " << settings.seed << "\n"
+            << "pcm " << (settings.pcm_path.empty () ? "-" : settings.pcm_path) << "\n";
+
+      for (auto const& actor_name : actor_names) {
+          for (auto depth : get_depths (actor_name)) {
+              auto run    = render (actor_name, depth, settings, source);
+              auto rerun  = render (actor_name, depth, settings, source);
+              bool stable = run.hashes == rerun.hashes;
+
+              index << "actor " << key (actor_name, depth) << " " << (stable ? "stable" : "unstable") << "\n";
+
+              for (unsigned int i = 0; i < settings.frames; i++) {
+                  index << "frame " << i << " " << std::hex << std::setw (16) << std::setfill ('0') << run.hashes[i]
+                        << std::dec << std::setfill (' ') << " " << std::min (run.times[i], rerun.times[i]) << "\n";
+              }
+
+              std::ofstream frame (frame_path (dir, key (actor_name, depth)), std::ios::binary);
+              frame.write (reinterpret_cast<char const*> (run.last.data ()), run.last.size ());
+
+              std::cout << std::left << std::setw (24) << key (actor_name, depth) << std::right
+                        << (stable ? "recorded" : "recorded (unstable)") << "\n";
+          }
+      }
+  }
+
+  std::map<std::string, Golden> load_golden (std::string const& dir, Settings& settings)
+  {
+      std::ifstream index (dir + "/golden.txt");
+      if (!index) {
+          throw std::runtime_error ("Cannot read " + dir + "/golden.txt");
+      }
+
+      std::map<std::string, Golden> goldens;
+      Golden* current = nullptr;
+
+      std::string line;
+      while (std::getline (index, line)) {
+          std::istringstream fields (line);
+
+          std::string type;
+          fields >> type;
+
+          if (type == "size") {
+              fields >> settings.width >> settings.height;
+          }
+          else if (type == "frames") {
+              fields >> settings.frames;
+          }
+          else if (type == "seed") {
+              fields >> settings.seed;
+          }
+          else if (type == "pcm") {
+              fields >> settings.pcm_path;
+              if (settings.pcm_path == "-")
+                  settings.pcm_path.clear ();
+          }
+          else if (type == "actor") {
+              std::string name, stability;
+              fields >> name >> stability;
+
+              current = &goldens[name];
+              current->stable = stability == "stable";
+          }
+          else if (type == "frame" && current) {
+              unsigned int i;
+              uint64_t hash;
+              double time;
+              fields >> i >> std::hex >> hash >> std::dec >> time;
+
+              current->hashes.push_back (hash);
+              current->times.push_back (time);
+          }
+      }
+
+      return goldens;
+  }
+
+  bool check (std::string const& dir, std::vector<std::string> const& actor_names, Settings settings, double min_psnr)
+  {
+      auto goldens = load_golden (dir, settings);
+
+      PcmSource source (settings.pcm_path);
+
+      std::cout << std::left << std::setw (24) << "actor" << std::right
+                << std::setw (10) << "matches" << std::setw (12) << "result" << std::setw (10) << "PSNR"
+                << std::setw (14) << "golden (us)" << std::setw (14) << "render (us)" << std::setw (10) << "change" << "\n";
+
+      bool passed = true;
+
+      for (auto const& actor_name : actor_names) {
+          for (auto depth : get_depths (actor_name)) {
+              auto name = key (actor_name, depth);
+
+              std::cout << std::left << std::setw (24) << name << std::right;
+
+              auto entry = goldens.find (name);
+              if (entry == goldens.end ()) {
+                  std::cout << std::setw (10) << "-" << std::setw (12) << "new" << "\n";
+                  continue;
+              }
+
+              auto const& golden = entry->second;
+              auto run = render (actor_name, depth, settings, source);
+
+              unsigned int matches = 0;
+              for (std::size_t i = 0; i < run.hashes.size () && i < golden.hashes.size (); i++) {
+                  if (run.hashes[i] == golden.hashes[i])
+                      matches++;
+              }
+
+              std::ifstream frame (frame_path (dir, name), std::ios::binary);
+              std::vector<uint8_t> golden_last ((std::istreambuf_iterator<char> (frame)), std::istreambuf_iterator<char> ());
+
+              double psnr = compute_psnr (run.last, golden_last);
+
+              char const* result;
+              if (!golden.stable) {
+                  result = "unstable";
+              }
+              else if (matches == golden.hashes.size ()) {
+                  result = "identical";
+              }
+              else if (psnr >= min_psnr) {
+                  result = "close";
+              }
+              else {
+                  result = "DIFFERENT";
+                  passed = false;
+              }
+
+              double golden_time = median (golden.times);
+              double time        = median (run.times);
+
+              std::cout << std::setw (10) << (std::to_string (matches) + "/" + std::to_string (golden.hashes.size ()))
+                        << std::setw (12) << result << std::fixed << std::setprecision (1);
+
+              if (std::isinf (psnr))
+                  std::cout << std::setw (10) << "inf";
+              else
+                  std::cout << std::setw (10) << psnr;
+
+              std::cout << std::setw (14) << golden_time << std::setw (14) << time
+                        << std::showpos << std::setw (9) << (golden_time > 0.0 ? (time / golden_time - 1.0) * 100.0 : 0.0)
+                        << "%" << std::noshowpos << "\n";
+          }
+      }
+
+      return passed;
+  }
+
+  // Checks that two instances of each actor rendering at the same time
+  // produce the frames of one instance rendering alone
+  bool check_pairs (std::vector<std::string> const& actor_names, Settings const& settings)
+  {
+      PcmSource source (settings.pcm_path);
+
+      std::cout << std::left << std::setw (24) << "actor" << std::right
+                << std::setw (10) << "first" << std::setw (10) << "second" << std::setw (14) << "result" << "\n";
+
+      bool passed = true;
+
+      for (auto const& actor_name : actor_names) {
+          for (auto depth : get_depths (actor_name)) {
+              auto alone = render (actor_name, depth, settings, source);
+              bool stable = alone.hashes == render (actor_name, depth, settings, source).hashes;
+
+              auto pair = render_pair (actor_name, depth, settings, source);
+
+              auto count_matches = [&alone] (std::vector<uint64_t> const& hashes) {
+                  unsigned int matches = 0;
+                  for (std::size_t i = 0; i < hashes.size (); i++) {
+                      if (hashes[i] == alone.hashes[i])
+                          matches++;
+                  }
+                  return matches;
+              };
+
+              auto first_matches  = count_matches (pair.first);
+              auto second_matches = count_matches (pair.second);
+
+              char const* result;
+              if (!stable) {
+                  result = "unstable";
+              }
+              else if (first_matches == settings.frames && second_matches == settings.frames) {
+                  result = "identical";
+              }
+              else {
+                  result = "SHARED STATE";
+                  passed = false;
+              }
+
+              std::cout << std::left << std::setw (24) << key (actor_name, depth) << std::right
+                        << std::setw (10) << (std::to_string (first_matches) + "/" + std::to_string (settings.frames))
+                        << std::setw (10) << (std::to_string (second_matches) + "/" + std::to_string (settings.frames))
+                        << std::setw (14) << result << "\n";
+          }
+      }
+
+      return passed;
+  }
+
+  void print_usage ()
+  {
+      std::cerr << "Usage: actor_golden (--record DIR | --check DIR | --pairs) [options] [actor...]\n"
+                << "\n"
+                << "Options:\n"
+                << "  --frames N   frames to render per actor and depth [60]\n"
+                << "  --size WxH   frame size [320x240]\n"
+                << "  --seed N     random seed [1]\n"
+                << "  --pcm FILE   raw S16 stereo 44.1kHz audio to feed [built-in signal]\n"
+                << "  --psnr DB    lowest PSNR of a close last frame when checking [40]\n"
+                << "\n"
+                << "Recording creates DIR and any missing parents. A golden set holds:\n"
+                << "  DIR/golden.txt       settings, then a line per actor and depth with the\n"
+                << "                       hash and render time of each of its frames\n"
+                << "  DIR/ACTOR-BPP.raw    last frame of ACTOR at BPP bits per pixel, as raw\n"
+                << "                       pixels of the frame size\n"
+                << "\n"
+                << "Checking uses the frames, size, seed and audio of the golden set.\n";
+  }
+
+} // anonymous
+
+int main (int argc, char** argv)
+{
+    try {
+        LV::System::init (argc, argv);
+
+        Settings settings;
+        std::string record_dir;
+        std::string check_dir;
+        bool pairs = false;
+        double min_psnr = 40.0;
+        std::vector<std::string> actor_names;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            bool has_value = arg == "--record" || arg == "--check" || arg == "--frames" || arg == "--size"
+                          || arg == "--seed" || arg == "--pcm" || arg == "--psnr";
+
+            if (has_value && i + 1 >= argc) {
+                throw std::invalid_argument ("Missing value for " + arg);
+            }
+
+            if (arg == "--help" || arg == "-h") {
+                print_usage ();
+                return EXIT_SUCCESS;
+            }
+            else if (arg == "--record") {
+                record_dir = argv[++i];
+            }
+            else if (arg == "--check") {
+                check_dir = argv[++i];
+            }
+            else if (arg == "--pairs") {
+                pairs = true;
+            }
+            else if (arg == "--frames") {
+                settings.frames = std::max (1, std::atoi (argv[++i]));
+            }
+            else if (arg == "--size") {
+                if (std::sscanf (argv[++i], "%ux%u", &settings.width, &settings.height) != 2 || !settings.width || !settings.height) {
+                    throw std::invalid_argument ("Invalid size specified");
+                }
+            }
+            else if (arg == "--seed") {
+                settings.seed = std::atoi (argv[++i]);
+            }
+            else if (arg == "--pcm") {
+                settings.pcm_path = argv[++i];
+            }
+            else if (arg == "--psnr") {
+                min_psnr = std::atof (argv[++i]);
+            }
+            else if (arg.size () > 1 && arg[0] == '-') {
+                std::cerr << "Unknown option " << arg << "\n\n";
+                print_usage ();
+                return EXIT_FAILURE;
+            }
+            else {
+                actor_names.push_back (arg);
+            }
+        }
+
+        if (!record_dir.empty () + !check_dir.empty () + pairs != 1) {
+            print_usage ();
+            return EXIT_FAILURE;
+        }
+
+        if (actor_names.empty ()) {
+            for (auto const& name : get_actor_names ()) {
+                auto actor = LV::Actor::load (name);
+                if (actor && actor->get_supported_depths () != VISUAL_VIDEO_DEPTH_GL)
+                    actor_names.push_back (name);
+            }
+        }
+
+        bool passed = true;
+
+        if (!record_dir.empty ()) {
+            record (record_dir, actor_names, settings);
+        } else if (pairs) {
+            passed = check_pairs (actor_names, settings);
+        } else {
+            passed = check (check_dir, actor_names, settings, min_psnr);
+        }
+
+        LV::System::destroy ();
+
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -1,9 +1,11 @@
 #include "test.h"
 #include <libvisual/libvisual.h>
 #include <vector>
+#include <string>
 #include <cstring>
 #include <cstdint>
 #include <limits>
+#include <cmath>
 
 const unsigned int sample_count = 256;
 
@@ -49,6 +51,472 @@ int main (int argc, char** argv)
         LV_TEST_ASSERT (output_data[i] == float (i*2+0.5) / int_max);
     }
 
+    // Check S32 and float input, with a frame count that is not a multiple of
+    // the SIMD width
+
+    const unsigned int odd_count = sample_count - 5;
+
+    auto output_odd_buffer = LV::Buffer::create (odd_count * sizeof (float));
+    auto output_odd_data = static_cast<float*> (output_odd_buffer->get_data ());
+
+    {
+        auto input32_buffer = LV::Buffer::create (odd_count * 2 * sizeof (int32_t));
+        auto input32_data = static_cast<int32_t*> (input32_buffer->get_data ());
+
+        for (unsigned int i = 0; i < odd_count*2; i++) {
+            input32_data[i] = int32_t (i) << 20;
+        }
+
+        LV::Audio audio32;
+        audio32.input (input32_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_S32, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+
+        audio32.get_sample (output_odd_buffer, VISUAL_AUDIO_CHANNEL_LEFT);
+        for (unsigned int i = 0; i < odd_count; i++) {
+            LV_TEST_ASSERT (output_odd_data[i] == float (i*2) / 2048);
+        }
+
+        audio32.get_sample (output_odd_buffer, VISUAL_AUDIO_CHANNEL_RIGHT);
+        for (unsigned int i = 0; i < odd_count; i++) {
+            LV_TEST_ASSERT (output_odd_data[i] == float (i*2+1) / 2048);
+        }
+    }
+
+    {
+        auto inputf_buffer = LV::Buffer::create (odd_count * 2 * sizeof (float));
+        auto inputf_data = static_cast<float*> (inputf_buffer->get_data ());
+
+        for (unsigned int i = 0; i < odd_count*2; i++) {
+            inputf_data[i] = float (i) / (odd_count*2);
+        }
+
+        LV::Audio audiof;
+        audiof.input (inputf_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+
+        audiof.get_sample (output_odd_buffer, VISUAL_AUDIO_CHANNEL_LEFT);
+        for (unsigned int i = 0; i < odd_count; i++) {
+            LV_TEST_ASSERT (output_odd_data[i] == inputf_data[i*2]);
+        }
+
+        audiof.get_sample (output_odd_buffer, VISUAL_AUDIO_CHANNEL_RIGHT);
+        for (unsigned int i = 0; i < odd_count; i++) {
+            LV_TEST_ASSERT (output_odd_data[i] == inputf_data[i*2+1]);
+        }
+    }
+
+    // Check that mono input is shared by the left and right channels
+
+    {
+        auto mono_buffer = LV::Buffer::create (sample_count * sizeof (int16_t));
+        auto mono_data = static_cast<int16_t*> (mono_buffer->get_data ());
+
+        for (unsigned int i = 0; i < sample_count; i++) {
+            mono_data[i] = i;
+        }
+
+        LV::Audio audio_mono;
+        audio_mono.input (mono_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_S16, VISUAL_AUDIO_SAMPLE_CHANNEL_MONO);
+
+        for (auto channel : { VISUAL_AUDIO_CHANNEL_LEFT, VISUAL_AUDIO_CHANNEL_RIGHT }) {
+            LV_TEST_ASSERT (audio_mono.get_sample (output_buffer, channel));
+
+            for (unsigned int i = 0; i < sample_count; i++) {
+                LV_TEST_ASSERT (output_data[i] == float (i) / int_max);
+            }
+        }
+    }
+
+    // Check interleaved and planar input with other channel layouts
+
+    {
+        const std::vector<std::string> names { "front", "back", "sub" };
+
+        auto input3_buffer = LV::Buffer::create (sample_count * names.size () * sizeof (int16_t));
+        auto input3_data = static_cast<int16_t*> (input3_buffer->get_data ());
+
+        for (unsigned int i = 0; i < sample_count * names.size (); i++) {
+            input3_data[i] = i;
+        }
+
+        LV::Audio audio3;
+        audio3.input_interleaved (input3_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_S16, names);
+
+        for (unsigned int c = 0; c < names.size (); c++) {
+            LV_TEST_ASSERT (audio3.get_sample (output_buffer, names[c]));
+
+            for (unsigned int i = 0; i < sample_count; i++) {
+                LV_TEST_ASSERT (output_data[i] == float (i * names.size () + c) / int_max);
+            }
+        }
+
+        std::vector<LV::BufferPtr> planes;
+
+        for (unsigned int c = 0; c < names.size (); c++) {
+            auto plane = LV::Buffer::create (sample_count * sizeof (float));
+            auto plane_data = static_cast<float*> (plane->get_data ());
+
+            for (unsigned int i = 0; i < sample_count; i++) {
+                plane_data[i] = float (c) - float (i) / sample_count;
+            }
+
+            planes.push_back (plane);
+        }
+
+        LV::Audio audio_planar;
+        audio_planar.input_planar (planes, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, names);
+
+        for (unsigned int c = 0; c < names.size (); c++) {
+            LV_TEST_ASSERT (audio_planar.get_sample (output_buffer, names[c]));
+            LV_TEST_ASSERT (std::memcmp (output_data, planes[c]->get_data (), sample_count * sizeof (float)) == 0);
+        }
+
+        // The caller may reuse its buffers once they are input
+        for (auto const& plane : planes) {
+            plane->fill (0);
+        }
+
+        for (unsigned int c = 0; c < names.size (); c++) {
+            LV_TEST_ASSERT (audio_planar.get_sample (output_buffer, names[c]));
+
+            for (unsigned int i = 0; i < sample_count; i++) {
+                LV_TEST_ASSERT (output_data[i] == float (c) - float (i) / sample_count);
+            }
+        }
+    }
+
+    // Check resampling of a 1kHz tone from 48kHz to the default 44.1kHz, fed
+    // in blocks to exercise the carried over filter state
+
+    for (auto quality : { VISUAL_AUDIO_RESAMPLE_QUALITY_HIGH, VISUAL_AUDIO_RESAMPLE_QUALITY_LOW }) {
+        const unsigned int block_frames = 2400;
+        const unsigned int block_count  = 4;
+
+        LV::Audio audio48;
+        audio48.set_resample_quality (quality);
+
+        // Planar input is resampled straight from the caller's buffers,
+        // which are reused for every block
+        LV::Audio audio48_planar;
+        audio48_planar.set_resample_quality (quality);
+
+        std::vector<LV::BufferPtr> tone_planes {
+            LV::Buffer::create (block_frames * sizeof (float)),
+            LV::Buffer::create (block_frames * sizeof (float))
+        };
+
+        LV_TEST_ASSERT (audio48.get_sample_rate () == VISUAL_AUDIO_SAMPLE_RATE_44100);
+
+        for (unsigned int block = 0; block < block_count; block++) {
+            auto tone_buffer = LV::Buffer::create (block_frames * 2 * sizeof (float));
+            auto tone_data = static_cast<float*> (tone_buffer->get_data ());
+
+            for (unsigned int i = 0; i < block_frames; i++) {
+                float value = 0.5f * std::sin (2 * M_PI * 1000.0 * (block * block_frames + i) / 48000.0);
+                tone_data[i*2]   = value;
+                tone_data[i*2+1] = value;
+            }
+
+            audio48.input (tone_buffer, VISUAL_AUDIO_SAMPLE_RATE_48000, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+
+            for (auto const& plane : tone_planes) {
+                auto plane_data = static_cast<float*> (plane->get_data ());
+
+                for (unsigned int i = 0; i < block_frames; i++) {
+                    plane_data[i] = tone_data[i*2];
+                }
+            }
+
+            audio48_planar.input_planar (tone_planes, VISUAL_AUDIO_SAMPLE_RATE_48000, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT,
+                                         { VISUAL_AUDIO_CHANNEL_LEFT, VISUAL_AUDIO_CHANNEL_RIGHT });
+        }
+
+        const unsigned int tone_count = 4096;
+
+        auto tone_output = LV::Buffer::create (tone_count * sizeof (float));
+        auto tone_output_data = static_cast<float*> (tone_output->get_data ());
+
+        audio48.get_sample (tone_output, VISUAL_AUDIO_CHANNEL_LEFT);
+
+        unsigned int crossings = 0;
+        float peak = 0.0f;
+
+        for (unsigned int i = 0; i < tone_count; i++) {
+            if (i > 0 && (tone_output_data[i-1] < 0.0f) != (tone_output_data[i] < 0.0f))
+                crossings++;
+
+            peak = std::max (peak, std::abs (tone_output_data[i]));
+        }
+
+        // 2 crossings per period, 4096 samples at 44.1kHz is 92.9 periods
+        LV_TEST_ASSERT (crossings >= 184 && crossings <= 188);
+        LV_TEST_ASSERT (peak > 0.49f && peak < 0.51f);
+
+        auto planar_output = LV::Buffer::create (tone_count * sizeof (float));
+
+        for (auto channel : { VISUAL_AUDIO_CHANNEL_LEFT, VISUAL_AUDIO_CHANNEL_RIGHT }) {
+            LV_TEST_ASSERT (audio48_planar.get_sample (planar_output, channel));
+            LV_TEST_ASSERT (std::memcmp (planar_output->get_data (), tone_output_data, tone_count * sizeof (float)) == 0);
+        }
+    }
+
+    // Check onset detection and tempo estimation on a 120 BPM click track
+    // over a quiet steady tone, fed in blocks of one video frame
+
+    {
+        const unsigned int rate         = 44100;
+        const unsigned int beat_frames  = rate / 2;
+        const unsigned int click_count  = 20;
+        const unsigned int block_frames = 735;
+        const unsigned int total_frames = beat_frames * click_count;
+
+        LV::Audio audio_beat;
+
+        unsigned int last_count = 0;
+        unsigned int onset_blocks = 0;
+
+        for (unsigned int start = 0; start < total_frames; start += block_frames) {
+            auto block_buffer = LV::Buffer::create (block_frames * 2 * sizeof (float));
+            auto block_data = static_cast<float*> (block_buffer->get_data ());
+
+            for (unsigned int i = 0; i < block_frames; i++) {
+                unsigned int t = start + i;
+                unsigned int since_click = t % beat_frames;
+
+                float value = 0.05f * std::sin (2 * M_PI * 220.0 * t / rate);
+
+                // Each click is a decaying 2kHz burst
+                if (since_click < 1024)
+                    value += 0.8f * std::exp (-float (since_click) / 128) * std::sin (2 * M_PI * 2000.0 * since_click / rate);
+
+                block_data[i*2]   = value;
+                block_data[i*2+1] = value;
+            }
+
+            audio_beat.input (block_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+
+            if (audio_beat.get_onset_count () != last_count) {
+                onset_blocks++;
+                last_count = audio_beat.get_onset_count ();
+            }
+        }
+
+        // The tone starting up may count as one more onset
+        auto onsets = audio_beat.get_onset_count ();
+        LV_TEST_ASSERT (onsets >= click_count - 1 && onsets <= click_count + 1);
+        LV_TEST_ASSERT (onset_blocks == onsets);
+
+        auto tempo = audio_beat.get_tempo ();
+        LV_TEST_ASSERT (tempo > 118.0f && tempo < 122.0f);
+
+        // The tone is in the 150-400Hz band, nothing is below 60Hz
+        LV_TEST_ASSERT (audio_beat.get_band_energy (2) > audio_beat.get_band_energy (0));
+    }
+
+    // Check that a steady tone has no onsets after its start, and no tempo
+
+    {
+        const unsigned int rate         = 44100;
+        const unsigned int block_frames = 1024;
+
+        LV::Audio audio_tone;
+
+        for (unsigned int start = 0; start < rate * 4; start += block_frames) {
+            auto block_buffer = LV::Buffer::create (block_frames * sizeof (float));
+            auto block_data = static_cast<float*> (block_buffer->get_data ());
+
+            for (unsigned int i = 0; i < block_frames; i++) {
+                block_data[i] = 0.5f * std::sin (2 * M_PI * 440.0 * (start + i) / rate);
+            }
+
+            audio_tone.input (block_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_MONO);
+        }
+
+        LV_TEST_ASSERT (audio_tone.get_onset_count () <= 1);
+        LV_TEST_ASSERT (audio_tone.get_tempo () == 0.0f);
+    }
+
+    // Check the short-time spectrum of a 1kHz tone, sliding in a hop at a
+    // time, against transforming the same frame whole
+
+    {
+        const unsigned int rate         = 44100;
+        const unsigned int frame_size   = 1024;
+        const unsigned int hop_size     = 256;
+        const unsigned int block_frames = 200;
+        const unsigned int total_frames = block_frames * 40;
+
+        auto tone_buffer = LV::Buffer::create (total_frames * sizeof (float));
+        auto tone_data = static_cast<float*> (tone_buffer->get_data ());
+
+        for (unsigned int i = 0; i < total_frames; i++) {
+            tone_data[i] = 0.5f * std::sin (2 * M_PI * 1000.0 * i / rate);
+        }
+
+        auto spectrum = LV::Buffer::create (frame_size / 2 * sizeof (float));
+        auto spectrum_data = static_cast<float*> (spectrum->get_data ());
+
+        LV::Audio audio_hops;
+
+        for (unsigned int start = 0; start < total_frames; start += block_frames) {
+            auto block = LV::Buffer::create (block_frames * sizeof (float));
+            block->put (tone_data + start, block->get_size (), 0);
+
+            audio_hops.input (block, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_CHANNEL_LEFT);
+            audio_hops.get_spectrum_stft (spectrum, VISUAL_AUDIO_CHANNEL_LEFT, frame_size, hop_size, VISUAL_AUDIO_WINDOW_HANN, false);
+        }
+
+        // 1kHz falls in bin 1000 * 1024 / 44100 = 23.2
+        unsigned int peak = 0;
+        for (unsigned int bin = 0; bin < frame_size / 2; bin++) {
+            if (spectrum_data[bin] > spectrum_data[peak])
+                peak = bin;
+        }
+
+        LV_TEST_ASSERT (peak == 23);
+
+        LV::Audio audio_whole;
+        audio_whole.input (tone_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_CHANNEL_LEFT);
+
+        auto whole_spectrum = LV::Buffer::create (spectrum->get_size ());
+        audio_whole.get_spectrum_stft (whole_spectrum, VISUAL_AUDIO_CHANNEL_LEFT, frame_size, hop_size, VISUAL_AUDIO_WINDOW_HANN, false);
+
+        LV_TEST_ASSERT (std::memcmp (spectrum_data, whole_spectrum->get_data (), spectrum->get_size ()) == 0);
+
+        // The band holding 1kHz is the loudest. On a log scale from 50Hz to
+        // 16kHz, the centre of band 8 is at 1056Hz.
+        const unsigned int band_count = 16;
+
+        auto bands = LV::Buffer::create (band_count * sizeof (float));
+        auto bands_data = static_cast<float*> (bands->get_data ());
+
+        for (auto scale : { VISUAL_AUDIO_BAND_SCALE_LOG, VISUAL_AUDIO_BAND_SCALE_BARK, VISUAL_AUDIO_BAND_SCALE_MEL }) {
+            audio_hops.get_spectrum_bands (bands, VISUAL_AUDIO_CHANNEL_LEFT, frame_size, hop_size, VISUAL_AUDIO_WINDOW_HANN,
+                                           scale, 50.0f, 16000.0f, false);
+
+            unsigned int loudest = 0;
+            for (unsigned int band = 0; band < band_count; band++) {
+                LV_TEST_ASSERT (bands_data[band] >= 0.0f);
+
+                if (bands_data[band] > bands_data[loudest])
+                    loudest = band;
+            }
+
+            if (scale == VISUAL_AUDIO_BAND_SCALE_LOG)
+                LV_TEST_ASSERT (loudest == 7 || loudest == 8);
+
+            LV_TEST_ASSERT (bands_data[loudest] > 10 * bands_data[band_count - 1]);
+        }
+    }
+
+    // Check the fast logarithm against the documented error bound, and the
+    // fused, normalised spectrum against scaling the plain one
+
+    {
+        std::vector<float> values;
+
+        for (float x = 1e-30f; x < 1e30f; x *= 1.0371f)
+            values.push_back (x);
+
+        for (unsigned int i = 0; i < 1000; i++)
+            values.push_back (0.5f + 1.5f * i / 1000);
+
+        std::vector<float> logs (values.size ());
+        visual_math_simd_log_floats (logs.data (), values.data (), values.size ());
+
+        for (unsigned int i = 0; i < values.size (); i++) {
+            double exact = std::log (double (values[i]));
+            double error = std::abs (logs[i] - exact);
+
+            if (values[i] >= 0.5f && values[i] <= 2.0f) {
+                LV_TEST_ASSERT (error < 4e-7);
+            } else {
+                LV_TEST_ASSERT (error < 2.5e-7 * std::abs (exact));
+            }
+        }
+
+        const unsigned int frame_size = 512;
+
+        auto noise = LV::Buffer::create (frame_size * sizeof (float));
+        auto noise_data = static_cast<float*> (noise->get_data ());
+
+        for (unsigned int i = 0; i < frame_size; i++) {
+            noise_data[i] = 0.5f * std::sin (0.37f * i * i) + 0.3f * std::sin (2 * M_PI * 40.0 * i / frame_size);
+        }
+
+        auto plain = LV::Buffer::create (frame_size / 2 * sizeof (float));
+        auto plain_data = static_cast<float*> (plain->get_data ());
+
+        auto scaled = LV::Buffer::create (plain->get_size ());
+        auto scaled_data = static_cast<float*> (scaled->get_data ());
+
+        LV::Audio::get_spectrum_for_sample (plain, noise, false);
+        LV::Audio::get_spectrum_for_sample (scaled, noise, true);
+
+        for (unsigned int i = 0; i < frame_size / 2; i++) {
+            if (plain_data[i] > 0.001f) {
+                LV_TEST_ASSERT (std::abs (scaled_data[i] - (1.0f + std::log (plain_data[i]) / 6.908f)) < 1e-5f);
+            } else {
+                LV_TEST_ASSERT (scaled_data[i] == 0.0f);
+            }
+        }
+    }
+
+    // Check that samples can be read by the time they were captured, and
+    // their age measured
+
+    {
+        const unsigned int rate         = 44100;
+        const unsigned int block_frames = rate / 10;
+        const unsigned int block_count  = 4;
+
+        LV::Audio audio_timed;
+
+        auto start_usecs = (LV::Time::now () - LV::Time::from_msecs (500)).to_usecs ();
+
+        for (unsigned int block = 0; block < block_count; block++) {
+            auto block_buffer = LV::Buffer::create (block_frames * sizeof (float));
+            auto block_data = static_cast<float*> (block_buffer->get_data ());
+
+            for (unsigned int i = 0; i < block_frames; i++) {
+                block_data[i] = float (block * block_frames + i);
+            }
+
+            audio_timed.input (block_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT,
+                               VISUAL_AUDIO_CHANNEL_LEFT, LV::Time::from_usecs (start_usecs + block * 100000));
+        }
+
+        auto end_usecs = audio_timed.get_end_time (VISUAL_AUDIO_CHANNEL_LEFT).to_usecs ();
+        LV_TEST_ASSERT (end_usecs + 1 >= start_usecs + 400000 && end_usecs <= start_usecs + 400001);
+
+        const unsigned int window = 100;
+
+        auto window_buffer = LV::Buffer::create (window * sizeof (float));
+        auto window_data = static_cast<float*> (window_buffer->get_data ());
+
+        // 150.01 ms in is sample 6615
+        LV_TEST_ASSERT (audio_timed.get_sample_at (window_buffer, VISUAL_AUDIO_CHANNEL_LEFT,
+                                                   LV::Time::from_usecs (start_usecs + 150010)));
+
+        for (unsigned int i = 0; i < window; i++) {
+            LV_TEST_ASSERT (window_data[i] == float (6615 - window + 1 + i));
+        }
+
+        // Later than the latest sample
+        audio_timed.get_sample_at (window_buffer, VISUAL_AUDIO_CHANNEL_LEFT, LV::Time::from_usecs (start_usecs + 900000));
+        LV_TEST_ASSERT (window_data[window - 1] == float (block_count * block_frames - 1));
+
+        // Earlier than the first sample
+        audio_timed.get_sample_at (window_buffer, VISUAL_AUDIO_CHANNEL_LEFT, LV::Time::from_usecs (start_usecs - 1000));
+        LV_TEST_ASSERT (window_data[0] == 0.0f && window_data[window - 1] == 0.0f);
+
+        // The latest sample was captured 100 ms ago
+        audio_timed.record_latency ();
+
+        auto latency = audio_timed.get_latency_stats ();
+        LV_TEST_ASSERT (latency.count == 1);
+        LV_TEST_ASSERT (latency.median >= 99.0f && latency.median < 200.0f);
+        LV_TEST_ASSERT (latency.min == latency.max);
+    }
+
     LV::System::destroy ();
 
     return EXIT_SUCCESS;
@@ -25,6 +25,65 @@ int main (int argc, char** argv)
     LV_TEST_ASSERT (time3.to_msecs () == 1250);
     LV_TEST_ASSERT (time3.to_usecs () == 1250000);
 
+    // Virtual clock
+
+    LV_TEST_ASSERT (!Time::is_virtual_clock ());
+
+    Time::use_virtual_clock (true);
+    LV_TEST_ASSERT (Time::is_virtual_clock ());
+    LV_TEST_ASSERT (Time::now () == Time (0, 0));
+
+    LV::Timer timer;
+    timer.start ();
+
+    Time::usleep (1000);
+    LV_TEST_ASSERT (timer.elapsed () == Time (0, 0));
+
+    Time::advance_virtual_clock (Time::from_msecs (1500));
+    Time::advance_virtual_clock (Time::from_msecs (700));
+    LV_TEST_ASSERT (Time::now () == Time (2, 200 * VISUAL_NSECS_PER_MSEC));
+    LV_TEST_ASSERT (timer.elapsed ().to_msecs () == 2200);
+
+    Time::use_virtual_clock (false);
+    LV_TEST_ASSERT (!Time::is_virtual_clock ());
+    LV_TEST_ASSERT (Time::now () > Time (0, 0));
+
+    // Profiling
+
+    auto system = LV::System::instance ();
+
+    // Stages are timed on the system clock even under the virtual clock
+    Time::use_virtual_clock (true);
+
+    {
+        LV::ProfileScope scope {VISUAL_PROFILE_STAGE_RENDER, "disabled"};
+    }
+
+    LV_TEST_ASSERT (system->get_profile_stats ().empty ());
+
+    system->set_profiling (true);
+
+    for (unsigned int i = 0; i < 100; i++) {
+        LV::ProfileScope scope {VISUAL_PROFILE_STAGE_RENDER, "test"};
+        Time::usleep (i < 90 ? 100 : 2000);
+    }
+
+    auto stats = system->get_profile_stats ();
+    LV_TEST_ASSERT (stats.size () == 1);
+    LV_TEST_ASSERT (stats[0].stage == VISUAL_PROFILE_STAGE_RENDER);
+    LV_TEST_ASSERT (stats[0].name == "test");
+    LV_TEST_ASSERT (stats[0].count == 100);
+    LV_TEST_ASSERT (stats[0].p50 >= 100 && stats[0].p50 <= stats[0].p95);
+    LV_TEST_ASSERT (stats[0].p95 >= 2000 * 0.96 && stats[0].p95 <= stats[0].p99);
+    LV_TEST_ASSERT (stats[0].p99 <= stats[0].max);
+
+    system->reset_profile_stats ();
+    LV_TEST_ASSERT (system->get_profile_stats ().empty ());
+
+    system->set_profiling (false);
+
+    Time::use_virtual_clock (false);
+
     LV::System::destroy ();
 
     return EXIT_SUCCESS;
@@ -0,0 +1,429 @@
+#include "test.h"
+#include <libvisual/libvisual.h>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+  LV::VideoPtr make_random_video (int width, int height, VisVideoDepth depth)
+  {
+      auto video = LV::Video::create (width, height, depth);
+
+      auto pixels = static_cast<uint8_t*> (video->get_pixels ());
+      for (std::size_t i = 0; i < video->get_size (); i++)
+          pixels[i] = std::rand () & 0xff;
+
+      if (depth == VISUAL_VIDEO_DEPTH_8BIT) {
+          LV::Palette palette (256);
+          for (auto& color : palette.colors)
+              color = LV::Color (std::rand () & 0xff, std::rand () & 0xff, std::rand () & 0xff);
+
+          video->set_palette (palette);
+      }
+
+      return video;
+  }
+
+  bool video_pixels_equal (LV::VideoConstPtr const& a, LV::VideoConstPtr const& b)
+  {
+      return a->get_size () == b->get_size ()
+          && std::memcmp (a->get_pixels (), b->get_pixels (), a->get_size ()) == 0;
+  }
+
+  // Composes an indexed source onto a 32-bit target directly, and via an
+  // explicit depth conversion, and checks that both agree
+  bool test_index8_compose (VisVideoComposeType type, int x, int y)
+  {
+      int const width  = 67;
+      int const height = 33;
+
+      auto src = make_random_video (width, height, VISUAL_VIDEO_DEPTH_8BIT);
+      auto src_argb32 = LV::Video::create (width, height, VISUAL_VIDEO_DEPTH_32BIT);
+      src_argb32->convert_depth (src);
+
+      auto dest = make_random_video (width + x, height + y, VISUAL_VIDEO_DEPTH_32BIT);
+      auto dest_ref = LV::Video::create (width + x, height + y, VISUAL_VIDEO_DEPTH_32BIT);
+      std::memcpy (dest_ref->get_pixels (), dest->get_pixels (), dest->get_size ());
+
+      for (auto video : { src, src_argb32 }) {
+          video->set_compose_type (type);
+          video->set_compose_surface (100);
+      }
+
+      dest->blit (src, x, y, true);
+      dest_ref->blit (src_argb32, x, y, true);
+
+      return video_pixels_equal (dest, dest_ref);
+  }
+
+  // Composes an indexed source with a colour key onto a 32-bit target and
+  // checks every pixel against the palette
+  bool test_index8_compose_colorkey (int x, int y)
+  {
+      int const width  = 67;
+      int const height = 33;
+
+      auto src  = make_random_video (width, height, VISUAL_VIDEO_DEPTH_8BIT);
+      auto dest = make_random_video (width + x, height + y, VISUAL_VIDEO_DEPTH_32BIT);
+
+      auto dest_orig = LV::Video::create (width + x, height + y, VISUAL_VIDEO_DEPTH_32BIT);
+      std::memcpy (dest_orig->get_pixels (), dest->get_pixels (), dest->get_size ());
+
+      auto const& colors = src->get_palette ().colors;
+      auto key = colors[static_cast<uint8_t const*> (src->get_pixels ())[0]];
+
+      src->set_compose_type (VISUAL_VIDEO_COMPOSE_TYPE_COLORKEY);
+      src->set_compose_colorkey (key);
+
+      dest->blit (src, x, y, true);
+
+      for (int sy = 0; sy < height; sy++) {
+          auto srcp  = static_cast<uint8_t const*> (src->get_pixel_ptr (0, sy));
+          auto destp = static_cast<uint32_t const*> (dest->get_pixel_ptr (x, sy + y));
+          auto origp = static_cast<uint32_t const*> (dest_orig->get_pixel_ptr (x, sy + y));
+
+          for (int sx = 0; sx < width; sx++) {
+              auto color = colors[srcp[sx]];
+              auto expected = color.to_uint32 () == key.to_uint32 () ? origp[sx] : color.to_uint32 ();
+
+              if (destp[sx] != expected)
+                  return false;
+          }
+      }
+
+      return true;
+  }
+
+  // Calls an exported index8 compose function directly with a source larger
+  // than the destination and one without a full palette, and checks both
+  // against composing through the video
+  bool test_index8_compose_direct (VisVideoComposeType type, VisVideoComposeFunc func)
+  {
+      for (int palette_size : { 256, 16 }) {
+          auto src = make_random_video (67, 33, VISUAL_VIDEO_DEPTH_8BIT);
+          src->set_palette (LV::Palette (palette_size));
+          src->set_compose_type (type);
+          src->set_compose_surface (100);
+
+          auto dest = make_random_video (40, 20, VISUAL_VIDEO_DEPTH_32BIT);
+          auto dest_ref = LV::Video::create (40, 20, VISUAL_VIDEO_DEPTH_32BIT);
+          std::memcpy (dest_ref->get_pixels (), dest->get_pixels (), dest->get_size ());
+
+          func (dest.get (), src.get ());
+          dest_ref->blit (src, 0, 0, true);
+
+          if (!video_pixels_equal (dest, dest_ref))
+              return false;
+      }
+
+      return true;
+  }
+
+  // Reference for the morph kernels' blend, x / 255 rounded to nearest
+  unsigned int blend_channel (unsigned int a, unsigned int b, unsigned int alpha)
+  {
+      return ((255 - alpha) * a + alpha * b + 127) / 255;
+  }
+
+  // Crossfades two videos with a pitch wider than their rows, and checks
+  // each pixel against a plain per-channel blend
+  bool test_morph_crossfade (VisVideoDepth depth)
+  {
+      int const width  = 67;
+      int const height = 33;
+      uint8_t const alpha = 100;
+
+      auto src1 = make_random_video (width + 3, height, depth);
+      auto src2 = make_random_video (width, height, depth);
+      auto dest = LV::Video::create (width, height, depth);
+
+      visual_morph_kernel_crossfade (dest.get (), src1.get (), src2.get (), alpha / 255.0f);
+
+      for (int y = 0; y < height; y++) {
+          auto row  = static_cast<uint8_t const*> (dest->get_pixel_ptr (0, y));
+          auto row1 = static_cast<uint8_t const*> (src1->get_pixel_ptr (0, y));
+          auto row2 = static_cast<uint8_t const*> (src2->get_pixel_ptr (0, y));
+
+          if (depth == VISUAL_VIDEO_DEPTH_16BIT) {
+              for (int x = 0; x < width; x++) {
+                  auto pixel  = reinterpret_cast<uint16_t const*> (row)[x];
+                  auto pixel1 = reinterpret_cast<uint16_t const*> (row1)[x];
+                  auto pixel2 = reinterpret_cast<uint16_t const*> (row2)[x];
+
+                  unsigned int expected = blend_channel (pixel1 >> 11, pixel2 >> 11, alpha) << 11
+                                        | blend_channel ((pixel1 >> 5) & 0x3f, (pixel2 >> 5) & 0x3f, alpha) << 5
+                                        | blend_channel (pixel1 & 0x1f, pixel2 & 0x1f, alpha);
+
+                  if (pixel != expected)
+                      return false;
+              }
+          } else {
+              for (int i = 0; i < width * dest->get_bpp (); i++) {
+                  if (row[i] != blend_channel (row1[i], row2[i], alpha))
+                      return false;
+              }
+          }
+      }
+
+      return true;
+  }
+
+  // Checks that the transitions show the first video at the start and the
+  // second at the end
+  bool test_morph_kernel_ends (VisVideoDepth depth)
+  {
+      int const width  = 67;
+      int const height = 33;
+
+      auto src1 = make_random_video (width, height, depth);
+      auto src2 = make_random_video (width, height, depth);
+      auto dest = LV::Video::create (width, height, depth);
+
+      for (auto direction : { VISUAL_MORPH_SLIDE_LEFT, VISUAL_MORPH_SLIDE_RIGHT,
+                              VISUAL_MORPH_SLIDE_UP, VISUAL_MORPH_SLIDE_DOWN }) {
+          visual_morph_kernel_slide (dest.get (), src1.get (), src2.get (), 0.0f, direction);
+          if (!video_pixels_equal (dest, src1))
+              return false;
+
+          visual_morph_kernel_slide (dest.get (), src1.get (), src2.get (), 1.0f, direction);
+          if (!video_pixels_equal (dest, src2))
+              return false;
+      }
+
+      visual_morph_kernel_crossfade (dest.get (), src1.get (), src2.get (), 0.0f);
+      if (!video_pixels_equal (dest, src1))
+          return false;
+
+      visual_morph_kernel_flash (dest.get (), src1.get (), src2.get (), 1.0f);
+      if (!video_pixels_equal (dest, src2))
+          return false;
+
+      // One tile covering everything
+      visual_morph_kernel_checkers (dest.get (), src1.get (), src2.get (), 1, 1, TRUE);
+      return video_pixels_equal (dest, src2);
+  }
+
+  // Blits with the compose type using the kernel variant, and checks that
+  // the result matches the C variant's
+  bool test_blit_variant (char const* variant, VisVideoComposeType type, VisVideoDepth depth)
+  {
+      int const width  = 67;
+      int const height = 33;
+      int const x = 5;
+      int const y = 3;
+
+      LV::Color const key {10, 20, 30};
+
+      auto src = make_random_video (width, height, depth);
+      src->set_compose_type (type);
+      src->set_compose_surface (100);
+      src->set_compose_colorkey (key);
+
+      // Key out every third pixel
+      for (int py = 0; py < height; py++) {
+          for (int px = 0; px < width; px += 3) {
+              if (depth == VISUAL_VIDEO_DEPTH_16BIT)
+                  *static_cast<uint16_t*> (src->get_pixel_ptr (px, py)) = key.to_uint16 ();
+              else if (depth == VISUAL_VIDEO_DEPTH_32BIT)
+                  *static_cast<uint32_t*> (src->get_pixel_ptr (px, py)) = key.to_uint32 ();
+          }
+      }
+
+      auto dest = make_random_video (width + x, height + y, depth);
+      auto dest_ref = LV::Video::create (width + x, height + y, depth);
+      std::memcpy (dest_ref->get_pixels (), dest->get_pixels (), dest->get_size ());
+
+      visual_alpha_blend_set_variant ("c");
+      dest_ref->blit (src, x, y, true);
+
+      visual_alpha_blend_set_variant (variant);
+      dest->blit (src, x, y, true);
+
+      return video_pixels_equal (dest, dest_ref);
+  }
+
+  // Rotates and mirrors a region of a larger video, so rows are padded,
+  // and checks every pixel against where it came from
+  bool test_rotate_mirror (VisVideoDepth depth)
+  {
+      int const width  = 131;
+      int const height = 75;
+
+      auto parent = make_random_video (width + 7, height + 2, depth);
+      auto src = LV::Video::create_sub (parent, LV::Rect (3, 1, width, height));
+
+      int bpp = src->get_bpp ();
+
+      auto rotated = LV::Video::create (height, width, depth);
+      auto same    = LV::Video::create (width, height, depth);
+
+      auto pixel_matches = [bpp] (LV::VideoPtr const& video, int x, int y, LV::VideoPtr const& other, int other_x, int other_y) {
+          return std::memcmp (video->get_pixel_ptr (x, y), other->get_pixel_ptr (other_x, other_y), bpp) == 0;
+      };
+
+      rotated->rotate (src, VISUAL_VIDEO_ROTATE_90);
+      for (int y = 0; y < width; y++) {
+          for (int x = 0; x < height; x++) {
+              if (!pixel_matches (rotated, x, y, src, y, height - 1 - x))
+                  return false;
+          }
+      }
+
+      rotated->rotate (src, VISUAL_VIDEO_ROTATE_270);
+      for (int y = 0; y < width; y++) {
+          for (int x = 0; x < height; x++) {
+              if (!pixel_matches (rotated, x, y, src, width - 1 - y, x))
+                  return false;
+          }
+      }
+
+      same->rotate (src, VISUAL_VIDEO_ROTATE_180);
+      for (int y = 0; y < height; y++) {
+          for (int x = 0; x < width; x++) {
+              if (!pixel_matches (same, x, y, src, width - 1 - x, height - 1 - y))
+                  return false;
+          }
+      }
+
+      same->mirror (src, VISUAL_VIDEO_MIRROR_X);
+      for (int y = 0; y < height; y++) {
+          for (int x = 0; x < width; x++) {
+              if (!pixel_matches (same, x, y, src, width - 1 - x, y))
+                  return false;
+          }
+      }
+
+      same->mirror (src, VISUAL_VIDEO_MIRROR_Y);
+      for (int y = 0; y < height; y++) {
+          for (int x = 0; x < width; x++) {
+              if (!pixel_matches (same, x, y, src, x, height - 1 - y))
+                  return false;
+          }
+      }
+
+      return true;
+  }
+
+  bool rect_equals (LV::Rect const& rect, int x, int y, int width, int height)
+  {
+      return rect.x == x && rect.y == y && rect.width == width && rect.height == height;
+  }
+
+  bool test_damage ()
+  {
+      auto video = LV::Video::create (100, 80, VISUAL_VIDEO_DEPTH_32BIT);
+
+      // Without damage the whole video counts as changed
+      auto damage = video->get_damage ();
+      if (video->has_damage () || damage.size () != 1 || !rect_equals (damage[0], 0, 0, 100, 80))
+          return false;
+
+      // Overlapping areas merge and areas are clipped
+      video->add_damage (LV::Rect (10, 10, 20, 20));
+      video->add_damage (LV::Rect (25, 15, 20, 20));
+      video->add_damage (LV::Rect (90, 70, 20, 20));
+      video->add_damage (LV::Rect ());
+
+      damage = video->get_damage ();
+      if (!video->has_damage () || damage.size () != 2)
+          return false;
+
+      if (!rect_equals (damage[0], 10, 10, 35, 25) || !rect_equals (damage[1], 90, 70, 10, 10))
+          return false;
+
+      // Empty areas are ignored, only set_undamaged() records that nothing
+      // changed
+      video->clear_damage ();
+      video->add_damage (LV::Rect ());
+      video->add_damage (LV::Rect (200, 10, 20, 20));
+
+      if (video->has_damage ())
+          return false;
+
+      video->set_undamaged ();
+
+      return video->has_damage () && video->get_damage ().empty ();
+  }
+
+  // Checks that every pixel changed by scaling lies in the scaled damage
+  bool test_scale_damage (int src_width, int src_height, int dst_width, int dst_height, VisVideoScaleMethod method)
+  {
+      auto src = make_random_video (src_width, src_height, VISUAL_VIDEO_DEPTH_32BIT);
+      auto dst = LV::Video::create (dst_width, dst_height, VISUAL_VIDEO_DEPTH_32BIT);
+      auto old = LV::Video::create (dst_width, dst_height, VISUAL_VIDEO_DEPTH_32BIT);
+
+      old->scale (src, method);
+
+      LV::Rect const changed (src_width / 3, src_height / 2, 2, 1);
+      src->fill_color (LV::Color (1, 2, 3), changed);
+      src->add_damage (changed);
+
+      dst->scale (src, method);
+      dst->copy_damage (src);
+
+      auto damage = dst->get_damage ();
+      if (!dst->has_damage () || damage.size () != 1)
+          return false;
+
+      for (int y = 0; y < dst_height; y++) {
+          for (int x = 0; x < dst_width; x++) {
+              if (std::memcmp (dst->get_pixel_ptr (x, y), old->get_pixel_ptr (x, y), 4) != 0
+                  && !damage[0].contains (LV::Rect (x, y, 1, 1)))
+                  return false;
+          }
+      }
+
+      return true;
+  }
+
+} // anonymous namespace
+
+int main (int argc, char** argv)
+{
+    LV::System::init (argc, argv);
+
+    std::srand (42);
+
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_NONE, 0, 0));
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_NONE, 5, 3));
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_SURFACE, 0, 0));
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_SURFACE, 5, 3));
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_COLORKEY, 5, 3));
+    LV_TEST_ASSERT (test_index8_compose (VISUAL_VIDEO_COMPOSE_TYPE_SURFACECOLORKEY, 0, 0));
+    LV_TEST_ASSERT (test_index8_compose_colorkey (0, 0));
+    LV_TEST_ASSERT (test_index8_compose_colorkey (5, 3));
+    LV_TEST_ASSERT (test_index8_compose_direct (VISUAL_VIDEO_COMPOSE_TYPE_NONE, visual_video_compose_index8_noalpha));
+    LV_TEST_ASSERT (test_index8_compose_direct (VISUAL_VIDEO_COMPOSE_TYPE_SURFACE, visual_video_compose_index8_surfacealpha));
+
+    // Every blend and blit variant the CPU supports
+    for (unsigned int i = 0; auto variant = visual_alpha_blend_get_variant_name (i); i++) {
+        for (auto depth : { VISUAL_VIDEO_DEPTH_8BIT, VISUAL_VIDEO_DEPTH_16BIT,
+                            VISUAL_VIDEO_DEPTH_24BIT, VISUAL_VIDEO_DEPTH_32BIT }) {
+            LV_TEST_ASSERT (visual_alpha_blend_set_variant (variant));
+            LV_TEST_ASSERT (test_morph_crossfade (depth));
+            LV_TEST_ASSERT (test_morph_kernel_ends (depth));
+
+            LV_TEST_ASSERT (test_blit_variant (variant, VISUAL_VIDEO_COMPOSE_TYPE_SURFACE, depth));
+            LV_TEST_ASSERT (test_blit_variant (variant, VISUAL_VIDEO_COMPOSE_TYPE_COLORKEY, depth));
+        }
+
+        LV_TEST_ASSERT (test_blit_variant (variant, VISUAL_VIDEO_COMPOSE_TYPE_SRC, VISUAL_VIDEO_DEPTH_32BIT));
+    }
+
+    for (auto depth : { VISUAL_VIDEO_DEPTH_8BIT, VISUAL_VIDEO_DEPTH_16BIT,
+                        VISUAL_VIDEO_DEPTH_24BIT, VISUAL_VIDEO_DEPTH_32BIT }) {
+        LV_TEST_ASSERT (test_rotate_mirror (depth));
+    }
+
+    LV_TEST_ASSERT (test_damage ());
+
+    for (auto method : { VISUAL_VIDEO_SCALE_NEAREST, VISUAL_VIDEO_SCALE_BILINEAR }) {
+        LV_TEST_ASSERT (test_scale_damage (64, 48, 64, 48, method));
+        LV_TEST_ASSERT (test_scale_damage (64, 48, 203, 157, method));
+        LV_TEST_ASSERT (test_scale_damage (203, 157, 64, 48, method));
+    }
+
+    LV::System::destroy ();
+
+    return EXIT_SUCCESS;
+}
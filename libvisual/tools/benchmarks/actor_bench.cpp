@@ -3,6 +3,7 @@
 #include <libvisual/lv_util.hpp>
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 #include <cstdlib>
 
 namespace {
@@ -12,9 +13,12 @@ namespace {
   {
   public:
 
-      ActorBench (std::string const& actor_name, unsigned int width, unsigned height, VisVideoDepth depth, bool forced_depth)
-          : Benchmark { "ActorBench" }
-          , m_actor { LV::Actor::load (actor_name) }
+      ActorBench (std::string const& actor_name, unsigned int width, unsigned height, VisVideoDepth depth, bool forced_depth, bool resize)
+          : Benchmark { resize ? "ActorResizeBench" : "ActorBench" }
+          , m_actor  { LV::Actor::load (actor_name) }
+          , m_width  { width }
+          , m_height { height }
+          , m_resize { resize }
       {
           if (!m_actor) {
               throw std::invalid_argument ("Cannot load actor '" + actor_name);
@@ -27,16 +31,25 @@ namespace {
               depth = visual_video_depth_get_highest (supported_depths);
           }
 
-          auto m_dest = LV::Video::create (640, 400, depth);
+          m_depth = depth;
 
-          m_actor->set_video (m_dest);
-          m_actor->video_negotiate (depth, false, false);
+          set_size (m_width, m_height);
       }
 
       virtual void operator() (unsigned int max_runs)
       {
-          for (unsigned int i = 0; i < max_runs; i++)
+          for (unsigned int i = 0; i < max_runs; i++) {
+              // In resize mode, every run alternates between the full and
+              // half size, so the timing includes the actor's reallocation
+              if (m_resize) {
+                  if (i % 2 == 0)
+                      set_size (m_width / 2, m_height / 2);
+                  else
+                      set_size (m_width, m_height);
+              }
+
               m_actor->run (m_audio);
+          }
       }
 
       virtual ~ActorBench ()
@@ -46,8 +59,20 @@ namespace {
 
   private:
 
-      LV::ActorPtr m_actor;
-      LV::Audio    m_audio;
+      LV::ActorPtr  m_actor;
+      LV::Audio     m_audio;
+      unsigned int  m_width;
+      unsigned int  m_height;
+      VisVideoDepth m_depth;
+      bool          m_resize;
+
+      void set_size (unsigned int width, unsigned int height)
+      {
+          auto dest = LV::Video::create (std::max (width, 1u), std::max (height, 1u), m_depth);
+
+          m_actor->set_video (dest);
+          m_actor->video_negotiate (m_depth, false, false);
+      }
   };
 
   std::unique_ptr<ActorBench> make_benchmark (int& argc, char**& argv)
@@ -57,6 +82,13 @@ namespace {
       unsigned int  height       = 480;
       VisVideoDepth depth        = VISUAL_VIDEO_DEPTH_32BIT;
       bool          forced_depth = false;
+      bool          resize       = false;
+
+      // A trailing "resize" selects the resize latency benchmark
+      if (argc > 1 && std::string (argv[argc - 1]) == "resize") {
+          resize = true;
+          argc--;
+      }
 
       if (argc > 1) {
           actor_name = argv[1];
@@ -88,7 +120,7 @@ namespace {
           argc--; argv++;
       }
 
-      return LV::make_unique<ActorBench> (actor_name, width, height, depth, forced_depth);
+      return LV::make_unique<ActorBench> (actor_name, width, height, depth, forced_depth, resize);
   }
 
 } // anonymous
@@ -97,6 +129,7 @@ int main (int argc, char **argv)
 {
     try {
         LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
         unsigned int max_runs = 500;
 
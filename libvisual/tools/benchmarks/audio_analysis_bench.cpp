@@ -0,0 +1,125 @@
+#include <libvisual/libvisual.h>
+#include "benchmark.hpp"
+#include "random.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+namespace {
+
+  // Measures the per-frame cost of onset, band energy and tempo analysis.
+  // Each run uploads one video frame's worth of stereo float samples into
+  // a long-lived Audio and queries the analysis like an actor would.
+  class AudioAnalysisBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      AudioAnalysisBench (unsigned int frames, unsigned int block_count)
+          : Benchmark ("AudioAnalysisBench")
+          , m_frames  { frames }
+      {
+          // Noise with a click every half second, so there are onsets and
+          // a tempo to find
+          for (unsigned int block = 0; block < block_count; block++) {
+              auto samples = LV::Tools::make_random<std::vector<float>> (-0.1f, 0.1f, frames * 2);
+
+              for (unsigned int i = 0; i < frames; i++) {
+                  unsigned int since_click = (block * frames + i) % 22050;
+
+                  if (since_click < 512) {
+                      float click = 0.8f * std::exp (-float (since_click) / 64);
+                      samples[i*2]   += click;
+                      samples[i*2+1] += click;
+                  }
+              }
+
+              auto buffer = LV::Buffer::create (samples.size () * sizeof (float));
+              buffer->put (samples.data (), buffer->get_size (), 0);
+
+              m_blocks.push_back (buffer);
+          }
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          unsigned int onsets = 0;
+          float level = 0.0f;
+
+          for (unsigned int i = 0; i < max_runs; i++) {
+              m_audio.input (m_blocks[i % m_blocks.size ()], VISUAL_AUDIO_SAMPLE_RATE_44100,
+                             VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+
+              onsets = m_audio.get_onset_count ();
+              level += m_audio.get_band_energy (0) + m_audio.get_tempo ();
+          }
+
+          // Keep the queries from being optimised away
+          if (level < 0.0f)
+              std::cout << onsets << "\n";
+      }
+
+      virtual ~AudioAnalysisBench ()
+      {}
+
+      LV::Audio const& get_audio () const
+      {
+          return m_audio;
+      }
+
+  private:
+
+      unsigned int               m_frames;
+      std::vector<LV::BufferPtr> m_blocks;
+      LV::Audio                  m_audio;
+  };
+
+} // anonymous
+
+int main (int argc, char** argv)
+{
+    try {
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
+
+        unsigned int max_runs = 10000;
+        unsigned int frames   = 735; // 44.1kHz at 60 fps
+
+        if (argc > 1) {
+            int value = std::atoi (argv[1]);
+            if (value <= 0) {
+                throw std::invalid_argument ("Number of runs is non-positive");
+            }
+
+            max_runs = value;
+        }
+
+        if (argc > 2) {
+            int value = std::atoi (argv[2]);
+            if (value <= 0) {
+                throw std::invalid_argument ("Number of frames is non-positive");
+            }
+
+            frames = value;
+        }
+
+        // Enough distinct blocks for several seconds of audio
+        AudioAnalysisBench bench (frames, 44100 * 8 / frames + 1);
+
+        auto total_time = LV::Tools::run_benchmark (bench, max_runs);
+
+        std::cout << "Time / frame: " << total_time / max_runs << " us\n";
+        std::cout << "Onsets: " << bench.get_audio ().get_onset_count ()
+                  << ", tempo: " << bench.get_audio ().get_tempo () << " BPM\n";
+
+        LV::System::destroy ();
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,119 @@
+#include <libvisual/libvisual.h>
+#include "benchmark.hpp"
+#include "random.hpp"
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+namespace {
+
+  // Measures Audio::input() with interleaved stereo samples of a given format
+  class AudioInputBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      AudioInputBench (VisAudioSampleFormatType format, unsigned int frames)
+          : Benchmark ("AudioInputBench")
+          , m_format  { format }
+          , m_buffer  { LV::Buffer::create (frames * 2 * visual_audio_sample_format_get_size (format)) }
+      {
+          // Random bytes are valid samples for the integer formats. For
+          // floats, fill in values in [-1, 1] instead.
+          if (format == VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT) {
+              auto samples = LV::Tools::make_random<std::vector<float>> (-1.0f, 1.0f, frames * 2);
+              m_buffer->put (samples.data (), samples.size () * sizeof (float), 0);
+          } else {
+              auto bytes = LV::Tools::make_random<std::vector<int>> (0, 255, m_buffer->get_size ());
+              auto data = static_cast<uint8_t*> (m_buffer->get_data ());
+              for (std::size_t i = 0; i < bytes.size (); i++)
+                  data[i] = bytes[i];
+          }
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              // A fresh Audio per run keeps old fragments from piling up
+              LV::Audio audio;
+              audio.input (m_buffer, VISUAL_AUDIO_SAMPLE_RATE_44100, m_format, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+          }
+      }
+
+      virtual ~AudioInputBench ()
+      {}
+
+  private:
+
+      VisAudioSampleFormatType m_format;
+      LV::BufferPtr            m_buffer;
+  };
+
+  VisAudioSampleFormatType parse_format (std::string const& name)
+  {
+      if (name == "u8")    return VISUAL_AUDIO_SAMPLE_FORMAT_U8;
+      if (name == "s8")    return VISUAL_AUDIO_SAMPLE_FORMAT_S8;
+      if (name == "u16")   return VISUAL_AUDIO_SAMPLE_FORMAT_U16;
+      if (name == "s16")   return VISUAL_AUDIO_SAMPLE_FORMAT_S16;
+      if (name == "u32")   return VISUAL_AUDIO_SAMPLE_FORMAT_U32;
+      if (name == "s32")   return VISUAL_AUDIO_SAMPLE_FORMAT_S32;
+      if (name == "float") return VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT;
+
+      throw std::invalid_argument ("Unknown sample format '" + name + "'");
+  }
+
+} // anonymous
+
+int main (int argc, char** argv)
+{
+    try {
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
+
+        unsigned int max_runs = 10000;
+        unsigned int frames   = 4096;
+        std::vector<std::string> formats { "s16", "s32", "float" };
+
+        if (argc > 1) {
+            int value = std::atoi (argv[1]);
+            if (value <= 0) {
+                throw std::invalid_argument ("Number of runs is non-positive");
+            }
+
+            max_runs = value;
+        }
+
+        if (argc > 2) {
+            int value = std::atoi (argv[2]);
+            if (value <= 0) {
+                throw std::invalid_argument ("Number of frames is non-positive");
+            }
+
+            frames = value;
+        }
+
+        if (argc > 3) {
+            formats.assign (argv + 3, argv + argc);
+        }
+
+        for (auto const& name : formats) {
+            AudioInputBench bench (parse_format (name), frames);
+
+            std::cout << "Format: " << name << "\n";
+            auto total_time = LV::Tools::run_benchmark (bench, max_runs);
+
+            std::cout << "Samples / sec: " << double (frames) * 2 * max_runs / total_time * 1e6 << "\n\n";
+        }
+
+        LV::System::destroy ();
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -1,25 +1,802 @@
+#include "config.h"
 #include "benchmark.hpp"
+#include <algorithm>
 #include <chrono>
+#include <memory>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(HAVE_SCHED_SETAFFINITY)
+#include <sched.h>
+#endif
 
 namespace LV {
   namespace Tools {
 
-    // Benchmark clock settings
-    typedef std::chrono::high_resolution_clock Clock;
-    typedef std::chrono::duration<double, std::micro> Duration;
+    namespace {
+
+      // Benchmark clock settings
+      typedef std::chrono::high_resolution_clock Clock;
+      typedef std::chrono::duration<double, std::micro> Duration;
+
+      BenchmarkSettings settings;
+
+      std::vector<BenchmarkResult> results;
+
+      // Hardware counters of the calling thread, read as a group so they
+      // cover the same interval
+      class PerfCounters
+      {
+      public:
+
+          enum Counter { CYCLES, INSTRUCTIONS, CACHE_MISSES, COUNTER_COUNT };
+
+          PerfCounters ()
+          {
+              std::fill (m_fds, m_fds + COUNTER_COUNT, -1);
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+              std::uint64_t const configs[COUNTER_COUNT] = {
+                  PERF_COUNT_HW_CPU_CYCLES,
+                  PERF_COUNT_HW_INSTRUCTIONS,
+                  PERF_COUNT_HW_CACHE_MISSES
+              };
+
+              for (int i = 0; i < COUNTER_COUNT; i++) {
+                  perf_event_attr attr;
+                  std::memset (&attr, 0, sizeof (attr));
+
+                  attr.size           = sizeof (attr);
+                  attr.type           = PERF_TYPE_HARDWARE;
+                  attr.config         = configs[i];
+                  attr.disabled       = m_fds[CYCLES] < 0;
+                  attr.exclude_kernel = 1;
+                  attr.exclude_hv     = 1;
+                  attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+                                      | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                  m_fds[i] = syscall (__NR_perf_event_open, &attr, 0, -1, m_fds[CYCLES], 0);
+
+                  if (m_fds[i] < 0) {
+                      // Without the group leader there is nothing to read
+                      if (i == CYCLES)
+                          break;
+
+                      continue;
+                  }
+
+                  ioctl (m_fds[i], PERF_EVENT_IOC_ID, &m_ids[i]);
+              }
+#endif
+          }
+
+          ~PerfCounters ()
+          {
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+              for (int i = COUNTER_COUNT - 1; i >= 0; i--) {
+                  if (m_fds[i] >= 0)
+                      close (m_fds[i]);
+              }
+#endif
+          }
+
+          bool is_open () const
+          {
+              return m_fds[CYCLES] >= 0;
+          }
+
+          void start ()
+          {
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+              ioctl (m_fds[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+              ioctl (m_fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+          }
+
+          // Stops counting and stores the counts, negative for counters that
+          // could not be opened or never ran
+          void stop (double counts[COUNTER_COUNT])
+          {
+              std::fill (counts, counts + COUNTER_COUNT, -1.0);
+
+#if defined(HAVE_LINUX_PERF_EVENT_H)
+              ioctl (m_fds[CYCLES], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+              // nr, time enabled, time running, then a value and ID each
+              std::uint64_t data[3 + 2 * COUNTER_COUNT];
+
+              if (read (m_fds[CYCLES], data, sizeof (data)) < ssize_t (3 * sizeof (std::uint64_t)))
+                  return;
+
+              auto time_enabled = data[1];
+              auto time_running = data[2];
+
+              if (time_running == 0)
+                  return;
+
+              // Scale up counts for the time the counters were multiplexed
+              // out
+              double scale = double (time_enabled) / time_running;
+
+              for (std::uint64_t j = 0; j < data[0] && j < COUNTER_COUNT; j++) {
+                  for (int i = 0; i < COUNTER_COUNT; i++) {
+                      if (m_fds[i] >= 0 && m_ids[i] == data[4 + 2 * j])
+                          counts[i] = data[3 + 2 * j] * scale;
+                  }
+              }
+#endif
+          }
+
+      private:
+
+          int           m_fds[COUNTER_COUNT];
+          std::uint64_t m_ids[COUNTER_COUNT] = {};
+      };
+
+      unsigned int parse_count (std::string const& option, char const* value, unsigned int min)
+      {
+          char* end = nullptr;
+          long count = std::strtol (value, &end, 10);
+
+          if (*value == '\0' || *end != '\0' || count < long (min)) {
+              throw std::invalid_argument ("Invalid value for " + option + ": " + value);
+          }
+
+          return count;
+      }
+
+      void pin_to_cpu (int cpu)
+      {
+#if defined(HAVE_SCHED_SETAFFINITY)
+          cpu_set_t set;
+          CPU_ZERO (&set);
+          CPU_SET (cpu, &set);
+
+          if (sched_setaffinity (0, sizeof (set), &set) != 0) {
+              throw std::runtime_error ("Cannot pin to CPU " + std::to_string (cpu));
+          }
+#else
+          (void) cpu;
+          throw std::runtime_error ("CPU pinning is not supported on this platform");
+#endif
+      }
+
+      // Linearly interpolated percentile of sorted values
+      double percentile (std::vector<double> const& sorted, double p)
+      {
+          double pos = p / 100.0 * (sorted.size () - 1);
+
+          auto i = std::size_t (pos);
+          if (i + 1 >= sorted.size ())
+              return sorted.back ();
+
+          return sorted[i] + (sorted[i + 1] - sorted[i]) * (pos - i);
+      }
+
+      double median (std::vector<double> values)
+      {
+          std::sort (values.begin (), values.end ());
+          return percentile (values, 50.0);
+      }
+
+      void compute_statistics (BenchmarkResult& result)
+      {
+          auto sorted = result.sample_times;
+          std::sort (sorted.begin (), sorted.end ());
+
+          result.samples = sorted.size ();
+          result.median  = percentile (sorted, 50.0);
+          result.min     = sorted.front ();
+          result.max     = sorted.back ();
+          result.p5      = percentile (sorted, 5.0);
+          result.p95     = percentile (sorted, 95.0);
+
+          double sum = 0.0;
+          std::vector<double> deviations;
+
+          for (auto time : sorted) {
+              sum += time;
+              deviations.push_back (std::abs (time - result.median));
+          }
+
+          result.mean = sum / sorted.size ();
+          result.mad  = median (deviations);
+      }
+
+      void print_result (BenchmarkResult const& result)
+      {
+          std::cout << "-- " << result.name << " --\n"
+                    << "Total runs: " << result.runs << " x " << result.samples << " samples"
+                    << " (" << settings.warmup << " warm-up)\n"
+                    << "Total time: " << result.median * result.runs << "us\n"
+                    << "Time / run: " << result.median << "us"
+                    << " (MAD " << result.mad << "us, min " << result.min << "us, p95 " << result.p95 << "us)\n";
+
+          if (result.cycles >= 0.0)
+              std::cout << "Cycles / run: " << result.cycles << "\n";
+
+          if (result.instructions >= 0.0)
+              std::cout << "Instructions / run: " << result.instructions << "\n";
+
+          if (result.cache_misses >= 0.0)
+              std::cout << "Cache misses / run: " << result.cache_misses << "\n";
+
+          std::cout << "\n";
+      }
+
+      std::string json_quote (std::string const& text)
+      {
+          std::string quoted = "\"";
+
+          for (char c : text) {
+              if (c == '"' || c == '\\') {
+                  quoted += '\\';
+                  quoted += c;
+              }
+              else if (static_cast<unsigned char> (c) < 0x20) {
+                  char escape[8];
+                  std::snprintf (escape, sizeof (escape), "\\u%04x", c);
+                  quoted += escape;
+              }
+              else {
+                  quoted += c;
+              }
+          }
+
+          return quoted + "\"";
+      }
+
+      std::string csv_quote (std::string const& text)
+      {
+          std::string quoted = "\"";
+
+          for (char c : text) {
+              if (c == '"')
+                  quoted += '"';
+
+              quoted += c;
+          }
+
+          return quoted + "\"";
+      }
+
+      // Counters that were not read are written as null in JSON and left
+      // empty in CSV
+      std::string format_counter (double count, char const* missing)
+      {
+          if (count < 0.0)
+              return missing;
+
+          std::ostringstream stream;
+          stream << std::setprecision (17) << count;
+          return stream.str ();
+      }
+
+      void write_json (std::string const& path)
+      {
+          std::ofstream file (path);
+          file << std::setprecision (17);
+
+          file << "{\n  \"benchmarks\": [";
+
+          for (std::size_t i = 0; i < results.size (); i++) {
+              auto const& result = results[i];
+
+              file << (i == 0 ? "\n" : ",\n")
+                   << "    {\n"
+                   << "      \"name\": "         << json_quote (result.name) << ",\n"
+                   << "      \"runs\": "         << result.runs << ",\n"
+                   << "      \"samples\": "      << result.samples << ",\n"
+                   << "      \"median_us\": "    << result.median << ",\n"
+                   << "      \"mad_us\": "       << result.mad << ",\n"
+                   << "      \"mean_us\": "      << result.mean << ",\n"
+                   << "      \"min_us\": "       << result.min << ",\n"
+                   << "      \"max_us\": "       << result.max << ",\n"
+                   << "      \"p5_us\": "        << result.p5 << ",\n"
+                   << "      \"p95_us\": "       << result.p95 << ",\n"
+                   << "      \"cycles\": "       << format_counter (result.cycles, "null") << ",\n"
+                   << "      \"instructions\": " << format_counter (result.instructions, "null") << ",\n"
+                   << "      \"cache_misses\": " << format_counter (result.cache_misses, "null") << ",\n"
+                   << "      \"sample_times_us\": [";
+
+              for (std::size_t j = 0; j < result.sample_times.size (); j++)
+                  file << (j == 0 ? "" : ", ") << result.sample_times[j];
+
+              file << "]\n    }";
+          }
+
+          file << "\n  ]\n}\n";
+
+          if (!file) {
+              throw std::runtime_error ("Cannot write results to " + path);
+          }
+      }
+
+      char const csv_header[] =
+          "name,runs,samples,median_us,mad_us,mean_us,min_us,max_us,p5_us,p95_us,cycles,instructions,cache_misses";
+
+      void write_csv (std::string const& path)
+      {
+          std::ofstream file (path);
+          file << std::setprecision (17);
+
+          file << csv_header << "\n";
+
+          for (auto const& result : results) {
+              file << csv_quote (result.name) << ","
+                   << result.runs << "," << result.samples << ","
+                   << result.median << "," << result.mad << "," << result.mean << ","
+                   << result.min << "," << result.max << ","
+                   << result.p5 << "," << result.p95 << ","
+                   << format_counter (result.cycles, "") << ","
+                   << format_counter (result.instructions, "") << ","
+                   << format_counter (result.cache_misses, "") << "\n";
+          }
+
+          if (!file) {
+              throw std::runtime_error ("Cannot write results to " + path);
+          }
+      }
+
+      // Reader for the JSON written above. Unknown members are skipped.
+      class JsonReader
+      {
+      public:
+
+          JsonReader (std::string const& text, std::string const& path)
+              : m_text (text)
+              , m_path (path)
+              , m_pos  (0)
+          {}
+
+          std::vector<BenchmarkResult> read ()
+          {
+              std::vector<BenchmarkResult> results;
+
+              read_members ([&] (std::string const& key) {
+                  if (key != "benchmarks") {
+                      skip_value ();
+                      return;
+                  }
+
+                  read_elements ([&] {
+                      results.push_back (read_result ());
+                  });
+              });
+
+              return results;
+          }
+
+      private:
+
+          std::string const& m_text;
+          std::string const& m_path;
+          std::size_t        m_pos;
+
+          BenchmarkResult read_result ()
+          {
+              BenchmarkResult result;
+
+              std::pair<char const*, double*> const numbers[] = {
+                  { "median_us",    &result.median       },
+                  { "mad_us",       &result.mad          },
+                  { "mean_us",      &result.mean         },
+                  { "min_us",       &result.min          },
+                  { "max_us",       &result.max          },
+                  { "p5_us",        &result.p5           },
+                  { "p95_us",       &result.p95          },
+                  { "cycles",       &result.cycles       },
+                  { "instructions", &result.instructions },
+                  { "cache_misses", &result.cache_misses }
+              };
+
+              read_members ([&] (std::string const& key) {
+                  if (key == "name") {
+                      result.name = read_string ();
+                  }
+                  else if (key == "runs") {
+                      result.runs = read_number ();
+                  }
+                  else if (key == "samples") {
+                      result.samples = read_number ();
+                  }
+                  else if (key == "sample_times_us") {
+                      read_elements ([&] {
+                          result.sample_times.push_back (read_number ());
+                      });
+                  }
+                  else {
+                      for (auto const& number : numbers) {
+                          if (key == number.first) {
+                              *number.second = read_number ();
+                              return;
+                          }
+                      }
+
+                      skip_value ();
+                  }
+              });
 
-    void run_benchmark (LV::Tools::Benchmark& test, unsigned int max_runs)
+              return result;
+          }
+
+          template <typename Function>
+          void read_members (Function const& read_member)
+          {
+              expect ('{');
+
+              if (peek () == '}') {
+                  m_pos++;
+                  return;
+              }
+
+              do {
+                  auto key = read_string ();
+                  expect (':');
+                  read_member (key);
+              } while (accept (','));
+
+              expect ('}');
+          }
+
+          template <typename Function>
+          void read_elements (Function const& read_element)
+          {
+              expect ('[');
+
+              if (peek () == ']') {
+                  m_pos++;
+                  return;
+              }
+
+              do {
+                  read_element ();
+              } while (accept (','));
+
+              expect (']');
+          }
+
+          std::string read_string ()
+          {
+              expect ('"');
+
+              std::string value;
+
+              while (m_pos < m_text.size () && m_text[m_pos] != '"') {
+                  char c = m_text[m_pos++];
+
+                  if (c == '\\' && m_pos < m_text.size ()) {
+                      c = m_text[m_pos++];
+
+                      switch (c) {
+                          case 'n': c = '\n'; break;
+                          case 't': c = '\t'; break;
+                          case 'r': c = '\r'; break;
+                          case 'b': c = '\b'; break;
+                          case 'f': c = '\f'; break;
+                          case 'u':
+                              // Only control characters are written escaped
+                              c = char (std::strtol (m_text.substr (m_pos, 4).c_str (), nullptr, 16));
+                              m_pos += 4;
+                              break;
+                          default:
+                              break;
+                      }
+                  }
+
+                  value += c;
+              }
+
+              expect ('"');
+
+              return value;
+          }
+
+          // Reads a number, or null as -1 as used for missing counters
+          double read_number ()
+          {
+              peek ();
+
+              if (m_text.compare (m_pos, 4, "null") == 0) {
+                  m_pos += 4;
+                  return -1.0;
+              }
+
+              char const* start = m_text.c_str () + m_pos;
+              char* end = nullptr;
+              double value = std::strtod (start, &end);
+
+              if (end == start) {
+                  fail ("number expected");
+              }
+
+              m_pos += end - start;
+
+              return value;
+          }
+
+          void skip_value ()
+          {
+              switch (peek ()) {
+                  case '{':
+                      read_members ([&] (std::string const&) { skip_value (); });
+                      break;
+                  case '[':
+                      read_elements ([&] { skip_value (); });
+                      break;
+                  case '"':
+                      read_string ();
+                      break;
+                  case 't':
+                      m_pos += 4;
+                      break;
+                  case 'f':
+                      m_pos += 5;
+                      break;
+                  default:
+                      read_number ();
+                      break;
+              }
+          }
+
+          char peek ()
+          {
+              while (m_pos < m_text.size () && std::isspace (static_cast<unsigned char> (m_text[m_pos])))
+                  m_pos++;
+
+              return m_pos < m_text.size () ? m_text[m_pos] : '\0';
+          }
+
+          bool accept (char c)
+          {
+              if (peek () != c)
+                  return false;
+
+              m_pos++;
+              return true;
+          }
+
+          void expect (char c)
+          {
+              if (!accept (c)) {
+                  fail (std::string ("'") + c + "' expected");
+              }
+          }
+
+          void fail (std::string const& reason)
+          {
+              throw std::runtime_error (m_path + ": " + reason + " at offset " + std::to_string (m_pos));
+          }
+      };
+
+      // Splits a CSV line written by write_csv() into fields
+      std::vector<std::string> split_csv_line (std::string const& line)
+      {
+          std::vector<std::string> fields (1);
+          bool quoted = false;
+
+          for (std::size_t i = 0; i < line.size (); i++) {
+              char c = line[i];
+
+              if (c == '"') {
+                  if (quoted && i + 1 < line.size () && line[i + 1] == '"') {
+                      fields.back () += '"';
+                      i++;
+                  }
+                  else {
+                      quoted = !quoted;
+                  }
+              }
+              else if (c == ',' && !quoted) {
+                  fields.emplace_back ();
+              }
+              else {
+                  fields.back () += c;
+              }
+          }
+
+          return fields;
+      }
+
+      std::vector<BenchmarkResult> read_csv (std::istream& input, std::string const& path)
+      {
+          std::vector<BenchmarkResult> results;
+
+          std::string line;
+          std::getline (input, line);
+
+          while (std::getline (input, line)) {
+              if (line.empty ())
+                  continue;
+
+              auto fields = split_csv_line (line);
+              if (fields.size () != 13) {
+                  throw std::runtime_error (path + ": malformed line: " + line);
+              }
+
+              auto number = [&] (std::size_t i) {
+                  return fields[i].empty () ? -1.0 : std::strtod (fields[i].c_str (), nullptr);
+              };
+
+              BenchmarkResult result;
+
+              result.name         = fields[0];
+              result.runs         = number (1);
+              result.samples      = number (2);
+              result.median       = number (3);
+              result.mad          = number (4);
+              result.mean         = number (5);
+              result.min          = number (6);
+              result.max          = number (7);
+              result.p5           = number (8);
+              result.p95          = number (9);
+              result.cycles       = number (10);
+              result.instructions = number (11);
+              result.cache_misses = number (12);
+
+              results.push_back (result);
+          }
+
+          return results;
+      }
+
+    } // anonymous namespace
+
+    void init_benchmarks (int& argc, char**& argv)
+    {
+        int remaining = 1;
+
+        for (int i = 1; i < argc; i++) {
+            std::string option = argv[i];
+
+            bool has_value = option == "--samples" || option == "--warmup" || option == "--pin"
+                          || option == "--json"    || option == "--csv";
+
+            if (has_value && i + 1 >= argc) {
+                throw std::invalid_argument ("Missing value for " + option);
+            }
+
+            if (option == "--samples") {
+                settings.samples = parse_count (option, argv[++i], 1);
+            }
+            else if (option == "--warmup") {
+                settings.warmup = parse_count (option, argv[++i], 0);
+            }
+            else if (option == "--pin") {
+                settings.cpu = parse_count (option, argv[++i], 0);
+            }
+            else if (option == "--json") {
+                settings.json_path = argv[++i];
+            }
+            else if (option == "--csv") {
+                settings.csv_path = argv[++i];
+            }
+            else if (option == "--perf") {
+                settings.perf = true;
+            }
+            else {
+                argv[remaining++] = argv[i];
+            }
+        }
+
+        argc = remaining;
+        argv[argc] = nullptr;
+
+        if (settings.cpu >= 0) {
+            pin_to_cpu (settings.cpu);
+        }
+    }
+
+    BenchmarkSettings const& get_benchmark_settings ()
+    {
+        return settings;
+    }
+
+    double run_benchmark (LV::Tools::Benchmark& test, unsigned int max_runs)
+    {
+        std::unique_ptr<PerfCounters> counters;
+
+        if (settings.perf) {
+            counters.reset (new PerfCounters);
+
+            if (!counters->is_open ()) {
+                std::cerr << "Hardware counters are unavailable, collecting times only\n";
+                settings.perf = false;
+                counters.reset ();
+            }
+        }
+
+        for (unsigned int i = 0; i < settings.warmup; i++) {
+            test (max_runs);
+        }
+
+        BenchmarkResult result;
+        result.name = test.get_name ();
+        result.runs = max_runs;
+
+        std::vector<double> counts[PerfCounters::COUNTER_COUNT];
+
+        for (unsigned int i = 0; i < settings.samples; i++) {
+            if (counters)
+                counters->start ();
+
+            auto start_time = Clock::now ();
+            test (max_runs);
+            Duration duration = Clock::now () - start_time;
+
+            if (counters) {
+                double sample_counts[PerfCounters::COUNTER_COUNT];
+                counters->stop (sample_counts);
+
+                for (int j = 0; j < PerfCounters::COUNTER_COUNT; j++) {
+                    if (sample_counts[j] >= 0.0)
+                        counts[j].push_back (sample_counts[j] / max_runs);
+                }
+            }
+
+            result.sample_times.push_back (duration.count () / max_runs);
+        }
+
+        compute_statistics (result);
+
+        // Counters only count if every sample read them
+        auto median_count = [&] (int counter) {
+            return counts[counter].size () == settings.samples ? median (counts[counter]) : -1.0;
+        };
+
+        result.cycles       = median_count (PerfCounters::CYCLES);
+        result.instructions = median_count (PerfCounters::INSTRUCTIONS);
+        result.cache_misses = median_count (PerfCounters::CACHE_MISSES);
+
+        print_result (result);
+
+        results.push_back (result);
+
+        if (!settings.json_path.empty ())
+            write_json (settings.json_path);
+
+        if (!settings.csv_path.empty ())
+            write_csv (settings.csv_path);
+
+        return result.median * max_runs;
+    }
+
+    std::vector<BenchmarkResult> load_benchmark_results (std::string const& path)
     {
-        auto start_time = Clock::now ();
-        test (max_runs);
-        Duration duration = Clock::now () - start_time;
-
-        // Print timings
-        std::cout << "-- " << test.get_name () << " --\n"
-                  << "Total runs: " << max_runs << "\n"
-                  << "Total time: " << duration.count () << "us\n"
-                  << "Time / run: " << duration.count () / max_runs << "us\n\n";
+        std::ifstream file (path);
+        if (!file) {
+            throw std::runtime_error ("Cannot open " + path);
+        }
+
+        std::string first_line;
+        std::getline (file, first_line);
+
+        if (first_line == csv_header) {
+            file.seekg (0);
+            return read_csv (file, path);
+        }
+
+        std::ostringstream text;
+        text << first_line << "\n" << file.rdbuf ();
+
+        auto contents = text.str ();
+        return JsonReader (contents, path).read ();
     }
 
   } // Tools namespace
@@ -2,6 +2,7 @@
 #define _LV_TOOLS_BENCHMARK_HPP
 
 #include <string>
+#include <vector>
 
 namespace LV {
   namespace Tools {
@@ -31,7 +32,61 @@ namespace LV {
         std::string m_name;
     };
 
-    void run_benchmark (Benchmark& benchmark, unsigned int max_runs);
+    // Harness settings, shared by all benchmarks of a program
+    struct BenchmarkSettings
+    {
+        unsigned int warmup    = 1;     // samples run and discarded first
+        unsigned int samples   = 5;     // samples measured
+        int          cpu       = -1;    // CPU to pin the process to, or -1
+        bool         perf      = false; // collect hardware counters
+        std::string  json_path;         // results file, empty for none
+        std::string  csv_path;          // results file, empty for none
+    };
+
+    // Timings of one benchmark. Times are in microseconds per run and
+    // counters in events per run. Counters that could not be read are
+    // negative.
+    struct BenchmarkResult
+    {
+        std::string  name;
+        unsigned int runs         = 0;  // runs per sample
+        unsigned int samples      = 0;
+        double       median       = 0.0;
+        double       mad          = 0.0; // median absolute deviation
+        double       mean         = 0.0;
+        double       min          = 0.0;
+        double       max          = 0.0;
+        double       p5           = 0.0;
+        double       p95          = 0.0;
+        double       cycles       = -1.0;
+        double       instructions = -1.0;
+        double       cache_misses = -1.0;
+
+        std::vector<double> sample_times;
+    };
+
+    // Removes the harness options from the command line and applies them:
+    //
+    //   --samples N   samples to measure (default 5)
+    //   --warmup N    samples to run before measuring (default 1)
+    //   --pin CPU     pins the process to a CPU
+    //   --perf        collects cycles, instructions and cache misses
+    //   --json FILE   writes all results to FILE as JSON
+    //   --csv FILE    writes all results to FILE as CSV
+    //
+    // The remaining arguments are left for the program.
+    void init_benchmarks (int& argc, char**& argv);
+
+    BenchmarkSettings const& get_benchmark_settings ();
+
+    // Runs the benchmark for every warm-up and measured sample, each of
+    // max_runs runs, and prints its statistics. The results files are
+    // rewritten with every benchmark run so far. Returns the median sample
+    // time in microseconds.
+    double run_benchmark (Benchmark& benchmark, unsigned int max_runs);
+
+    // Reads a results file written in either format
+    std::vector<BenchmarkResult> load_benchmark_results (std::string const& path);
 
   } // Tools namespace
 } // LV namespace
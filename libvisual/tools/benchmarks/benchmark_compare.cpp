@@ -0,0 +1,128 @@
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Compares two benchmark results files, as written with --json or --csv,
+// and exits with failure if any benchmark got significantly slower.
+//
+// A change is significant when the medians differ by more than the
+// threshold and by more than the given number of standard deviations, as
+// estimated from the MADs of both results.
+
+namespace {
+
+  // Scales a MAD to the standard deviation of normally distributed samples
+  double const mad_to_sigma = 1.4826;
+
+  void print_usage ()
+  {
+      std::cerr << "Usage: benchmark_compare [--threshold PERCENT] [--sigmas N] <baseline> <results>\n";
+  }
+
+  double parse_number (std::string const& option, char const* value)
+  {
+      char* end = nullptr;
+      double number = std::strtod (value, &end);
+
+      if (*value == '\0' || *end != '\0' || number < 0.0) {
+          throw std::invalid_argument ("Invalid value for " + option + ": " + value);
+      }
+
+      return number;
+  }
+
+} // anonymous
+
+int main (int argc, char** argv)
+{
+    try {
+        double threshold = 5.0;
+        double sigmas    = 3.0;
+
+        std::vector<std::string> paths;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if ((arg == "--threshold" || arg == "--sigmas") && i + 1 < argc) {
+                (arg == "--threshold" ? threshold : sigmas) = parse_number (arg, argv[++i]);
+            }
+            else {
+                paths.push_back (arg);
+            }
+        }
+
+        if (paths.size () != 2) {
+            print_usage ();
+            return EXIT_FAILURE;
+        }
+
+        auto baseline = LV::Tools::load_benchmark_results (paths[0]);
+        auto results  = LV::Tools::load_benchmark_results (paths[1]);
+
+        unsigned int regressions = 0;
+
+        std::cout << std::left << std::setw (48) << "benchmark" << std::right
+                  << std::setw (14) << "baseline (us)" << std::setw (14) << "result (us)"
+                  << std::setw (10) << "change" << "\n";
+
+        for (auto const& result : results) {
+            auto old = std::find_if (baseline.begin (), baseline.end (), [&] (LV::Tools::BenchmarkResult const& entry) {
+                return entry.name == result.name;
+            });
+
+            std::cout << std::left << std::setw (48) << result.name << std::right << std::fixed << std::setprecision (2);
+
+            if (old == baseline.end ()) {
+                std::cout << std::setw (14) << "-" << std::setw (14) << result.median << std::setw (10) << "-" << "  new\n";
+                continue;
+            }
+
+            double change = result.median - old->median;
+            double noise  = mad_to_sigma * std::sqrt (old->mad * old->mad + result.mad * result.mad);
+            double percent = old->median > 0.0 ? change / old->median * 100.0 : 0.0;
+
+            bool significant = std::abs (percent) > threshold && std::abs (change) > sigmas * noise;
+
+            std::cout << std::setw (14) << old->median << std::setw (14) << result.median
+                      << std::showpos << std::setw (9) << percent << "%" << std::noshowpos;
+
+            if (significant && change > 0.0) {
+                std::cout << "  REGRESSION";
+                regressions++;
+            }
+            else if (significant) {
+                std::cout << "  improvement";
+            }
+
+            std::cout << "\n";
+        }
+
+        for (auto const& old : baseline) {
+            auto found = std::any_of (results.begin (), results.end (), [&] (LV::Tools::BenchmarkResult const& entry) {
+                return entry.name == old.name;
+            });
+
+            if (!found) {
+                std::cout << std::left << std::setw (48) << old.name << std::right
+                          << std::setw (14) << old.median << std::setw (14) << "-" << std::setw (10) << "-" << "  missing\n";
+            }
+        }
+
+        if (regressions > 0) {
+            std::cout << "\n" << regressions << " significant regression(s)\n";
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,406 @@
+#include "benchmark.hpp"
+#include <libvisual/libvisual.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Times whole frames through a Bin: input upload, actor render, depth
+// conversion and scaling, morphing and display. Each actor is swept over a
+// range of resolutions, reporting frames per second and the time spent in
+// each stage of the pipeline.
+
+namespace {
+
+  unsigned int const sample_rate = 44100;
+
+  // Audio frames uploaded per video frame, as at 60 fps
+  unsigned int const frames_per_upload = sample_rate / 60;
+
+  // Deterministic test signal with a bass line, a wobbling tone and a kick
+  // drum every half second, so actors see beats and a full spectrum
+  class SignalGenerator
+  {
+  public:
+
+      SignalGenerator ()
+          : m_buffer   { LV::Buffer::create (frames_per_upload * 2 * sizeof (float)) }
+          , m_position { 0 }
+          , m_noise    { 1 }
+      {}
+
+      LV::BufferPtr const& next ()
+      {
+          auto samples = static_cast<float*> (m_buffer->get_data ());
+
+          for (unsigned int i = 0; i < frames_per_upload; i++, m_position++) {
+              float t = float (m_position) / sample_rate;
+
+              float bass = 0.3f * std::sin (2.0f * VISUAL_MATH_PI * 110.0f * t);
+              float tone = 0.2f * std::sin (2.0f * VISUAL_MATH_PI * 440.0f * t * (1.0f + 0.1f * std::sin (0.5f * t)));
+
+              // Decaying noise burst at each beat
+              float since_kick = float (m_position % (sample_rate / 2)) / sample_rate;
+              float kick = 0.5f * std::exp (-since_kick * 40.0f) * next_noise ();
+
+              samples[i*2]   = bass + tone + kick;
+              samples[i*2+1] = bass - tone + kick;
+          }
+
+          return m_buffer;
+      }
+
+  private:
+
+      LV::BufferPtr m_buffer;
+      uint64_t      m_position;
+      uint32_t      m_noise;
+
+      // Noise in [-1, 1] from a linear congruential generator
+      float next_noise ()
+      {
+          m_noise = m_noise * 1664525u + 1013904223u;
+          return float (m_noise >> 8) / float (1u << 23) - 1.0f;
+      }
+  };
+
+  // Display that presents damaged areas into a front buffer in memory, as
+  // a display driver would upload them
+  class NullDisplay
+  {
+  public:
+
+      LV::VideoPtr create (unsigned int width, unsigned int height, VisVideoDepth depth)
+      {
+          m_video = LV::Video::create (width, height, depth);
+          m_front = LV::Video::create (width, height, depth);
+
+          return m_video;
+      }
+
+      void update_damage ()
+      {
+          LV::ProfileScope scope {VISUAL_PROFILE_STAGE_DISPLAY, "null"};
+
+          auto bpp = m_video->get_bpp ();
+
+          for (auto const& rect : m_video->get_damage ()) {
+              for (int y = rect.y; y < rect.y + rect.height; y++) {
+                  std::memcpy (m_front->get_pixel_ptr (rect.x, y),
+                               m_video->get_pixel_ptr (rect.x, y),
+                               rect.width * bpp);
+              }
+          }
+      }
+
+  private:
+
+      LV::VideoPtr m_video;
+      LV::VideoPtr m_front;
+  };
+
+  struct Scenario
+  {
+      std::string   morph_name;                          // morph into the next actor, if set
+      VisVideoDepth depth    = VISUAL_VIDEO_DEPTH_NONE;  // display depth, or the actor's own
+      bool          misalign = false;                    // display size off actor alignment
+  };
+
+  // Renders frames through a Bin set up the way lv-tool does it
+  class BinBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      BinBench (std::string const& name,
+                std::string const& actor_name,
+                std::string const& next_actor_name,
+                Scenario const&    scenario,
+                unsigned int       width,
+                unsigned int       height)
+          : Benchmark { name }
+      {
+          m_bin.set_supported_depth (VISUAL_VIDEO_DEPTH_ALL);
+          m_bin.use_morph (!scenario.morph_name.empty ());
+
+          if (!m_bin.connect (actor_name, "debug")) {
+              throw std::invalid_argument ("Cannot load actor " + actor_name);
+          }
+
+          // The debug plugin paces itself in real time, so the signal is
+          // uploaded directly
+          m_bin.get_input ()->set_callback ([this] (LV::Audio& audio) {
+              audio.input (m_signal.next (), VISUAL_AUDIO_SAMPLE_RATE_44100,
+                           VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+              return true;
+          });
+
+          auto depthflag = m_bin.get_actor ()->get_supported_depths ();
+          if (depthflag == VISUAL_VIDEO_DEPTH_GL) {
+              throw std::invalid_argument ("Actor " + actor_name + " needs OpenGL");
+          }
+
+          // A display depth the actor cannot render at makes it convert
+          auto depth = scenario.depth != VISUAL_VIDEO_DEPTH_NONE ? scenario.depth
+                                                                 : visual_video_depth_get_highest_nogl (depthflag);
+          m_bin.set_depth (depth);
+
+          m_width  = width;
+          m_height = height;
+
+          // Odd sizes are rounded down by actors that render on aligned
+          // dimensions, which then need their output scaled
+          if (scenario.misalign) {
+              m_width  += 2;
+              m_height += 1;
+          }
+
+          m_bin.set_video (m_display.create (m_width, m_height, depth));
+          m_bin.realize ();
+          m_bin.sync (false);
+          m_bin.depth_changed ();
+
+          if (!scenario.morph_name.empty ()) {
+              m_bin.set_morph (scenario.morph_name);
+              if (!m_bin.get_morph ()) {
+                  throw std::invalid_argument ("Cannot load morph " + scenario.morph_name);
+              }
+
+              // Long enough for the morph to last all runs
+              m_bin.switch_set_time (LV::Time (24 * 60 * 60, 0));
+              m_bin.set_concurrent_morph (true);
+              m_bin.switch_actor (next_actor_name);
+
+              sync_depth ();
+          }
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          // Keep the stage timings of the last sample only
+          LV::System::instance ()->reset_profile_stats ();
+
+          for (unsigned int i = 0; i < max_runs; i++) {
+              m_bin.run ();
+              sync_depth ();
+
+              m_display.update_damage ();
+          }
+      }
+
+      virtual ~BinBench ()
+      {}
+
+  private:
+
+      LV::Bin         m_bin;
+      NullDisplay     m_display;
+      SignalGenerator m_signal;
+      unsigned int    m_width;
+      unsigned int    m_height;
+
+      // Gives the bin a new video when it changes depth, as lv-tool would
+      void sync_depth ()
+      {
+          if (m_bin.depth_changed ()) {
+              m_bin.set_video (m_display.create (m_width, m_height, m_bin.get_depth ()));
+              m_bin.sync (true);
+          }
+      }
+  };
+
+  struct Size
+  {
+      unsigned int width;
+      unsigned int height;
+  };
+
+  Size const sizes[] = { { 320, 240 }, { 640, 480 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+  void print_stage_stats ()
+  {
+      auto stats = LV::System::instance ()->get_profile_stats ();
+
+      auto flags     = std::cout.flags ();
+      auto precision = std::cout.precision ();
+
+      std::cout << std::left << std::setw (10) << "stage" << std::setw (16) << "plugin" << std::right
+                << std::setw (10) << "mean (us)" << std::setw (10) << "p95 (us)" << "\n";
+
+      for (auto const& entry : stats) {
+          std::cout << std::left << std::setw (10) << visual_profile_stage_name (entry.stage)
+                    << std::setw (16) << entry.name << std::right << std::fixed << std::setprecision (1)
+                    << std::setw (10) << entry.mean << std::setw (10) << entry.p95 << "\n";
+      }
+
+      std::cout.flags (flags);
+      std::cout.precision (precision);
+      std::cout << "\n";
+  }
+
+  void print_usage ()
+  {
+      std::cerr << "Usage: bin_bench [RUNS] [--morph MORPH] [--depth BPP] [--misalign] [ACTOR...]\n"
+                << "\n"
+                << "  RUNS          runs per sample at 320x240, fewer at larger sizes (default 200)\n"
+                << "  --morph MORPH morph each actor into the next one with MORPH\n"
+                << "  --depth BPP   display depth in bits per pixel, converted to from the actor's\n"
+                << "  --misalign    use display sizes off the actors' alignment, so they get scaled\n"
+                << "  ACTOR         actors to run (default lv_analyzer lv_scope infinite jess bumpscope)\n"
+                << "\n"
+                << "The benchmark options --samples, --warmup, --pin, --perf, --json and --csv\n"
+                << "are taken as well.\n";
+  }
+
+  // Reads the options left by the benchmark harness. Anything that looks
+  // like an option is never taken for an actor name.
+  void parse_arguments (int argc, char** argv, Scenario& scenario, std::vector<std::string>& actor_names)
+  {
+      for (int i = 1; i < argc; i++) {
+          std::string arg = argv[i];
+
+          if ((arg == "--morph" || arg == "--depth") && i + 1 >= argc) {
+              throw std::invalid_argument ("Missing value for " + arg);
+          }
+
+          if (arg == "--morph") {
+              scenario.morph_name = argv[++i];
+          }
+          else if (arg == "--depth") {
+              scenario.depth = visual_video_depth_from_bpp (std::atoi (argv[++i]));
+              if (scenario.depth == VISUAL_VIDEO_DEPTH_NONE) {
+                  throw std::invalid_argument ("Invalid video depth specified");
+              }
+          }
+          else if (arg == "--misalign") {
+              scenario.misalign = true;
+          }
+          else if (arg.size () > 1 && arg[0] == '-') {
+              throw std::invalid_argument ("Unknown option " + arg);
+          }
+          else {
+              actor_names.push_back (arg);
+          }
+      }
+
+      if (actor_names.empty ()) {
+          actor_names = { "lv_analyzer", "lv_scope", "infinite", "jess", "bumpscope" };
+      }
+  }
+
+  void run_benchmarks (unsigned int max_runs, Scenario const& scenario, std::vector<std::string> const& actor_names)
+  {
+      std::vector<std::pair<std::string, std::vector<double>>> results;
+
+      for (std::size_t i = 0; i < actor_names.size (); i++) {
+          auto const& actor_name      = actor_names[i];
+          auto const& next_actor_name = actor_names[(i + 1) % actor_names.size ()];
+
+          auto label = scenario.morph_name.empty () ? actor_name
+                                                    : actor_name + " > " + next_actor_name;
+
+          results.emplace_back (label, std::vector<double> {});
+
+          for (auto const& size : sizes) {
+              auto name = "BinBench (" + label + ", " + std::to_string (size.width) + "x" + std::to_string (size.height) + ")";
+
+              // Actors of the same plugin share state, so only one bench
+              // is kept alive at a time
+              BinBench bench (name, actor_name, next_actor_name, scenario, size.width, size.height);
+
+              // Fewer runs for larger frames, keeping the total time similar
+              auto runs = std::max (10u, unsigned (max_runs * 320.0 * 240.0 / (size.width * size.height)));
+
+              double time = LV::Tools::run_benchmark (bench, runs) / runs;
+              results.back ().second.push_back (1e6 / time);
+
+              print_stage_stats ();
+          }
+      }
+
+      std::cout << "Frames / sec";
+
+      if (!scenario.morph_name.empty ())
+          std::cout << ", morphing with " << scenario.morph_name;
+
+      if (scenario.depth != VISUAL_VIDEO_DEPTH_NONE)
+          std::cout << ", " << visual_video_depth_bpp (scenario.depth) << "-bit display";
+
+      if (scenario.misalign)
+          std::cout << ", misaligned sizes";
+
+      std::cout << "\n" << std::left << std::setw (24) << "actor" << std::right;
+
+      for (auto const& size : sizes)
+          std::cout << std::setw (11) << (std::to_string (size.width) + "x" + std::to_string (size.height));
+
+      std::cout << "\n";
+
+      for (auto const& result : results) {
+          std::cout << std::left << std::setw (24) << result.first << std::right;
+
+          for (auto fps : result.second)
+              std::cout << std::setw (11) << std::fixed << std::setprecision (1) << fps;
+
+          std::cout << "\n";
+      }
+  }
+
+} // anonymous
+
+int main (int argc, char** argv)
+{
+    try {
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp (argv[i], "--help") == 0 || std::strcmp (argv[i], "-h") == 0) {
+                print_usage ();
+                return EXIT_SUCCESS;
+            }
+        }
+
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
+
+        LV::System::instance ()->set_profiling (true);
+
+        unsigned int max_runs = 200;
+
+        if (argc > 1 && std::atoi (argv[1]) > 0) {
+            max_runs = std::atoi (argv[1]);
+
+            argc--; argv++;
+        }
+
+        Scenario scenario;
+        std::vector<std::string> actor_names;
+
+        try {
+            parse_arguments (argc, argv, scenario, actor_names);
+        }
+        catch (std::invalid_argument& error) {
+            std::cerr << error.what () << "\n\n";
+            print_usage ();
+            return EXIT_FAILURE;
+        }
+
+        run_benchmarks (max_runs, scenario, actor_names);
+
+        LV::System::destroy ();
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (...) {
+        std::cerr << "Unknown exception caught\n";
+        return EXIT_FAILURE;
+    }
+}
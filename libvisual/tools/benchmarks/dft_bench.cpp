@@ -2,6 +2,8 @@
 #include <libvisual/lv_aligned_allocator.hpp>
 #include "benchmark.hpp"
 #include "random.hpp"
+#include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <cstdlib>
 
@@ -52,18 +54,25 @@ namespace {
 
 int main (int argc, char** argv)
 {
-    LV::System::init (argc, argv);
+    try {
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
-    unsigned int data_size = 1024;
-    unsigned int max_runs  = 1000;
+        unsigned int data_size = 1024;
+        unsigned int max_runs  = 1000;
 
-    if (argc > 2) {
-        data_size = std::atoi (argv[1]);
-        max_runs  = std::atoi (argv[2]);
-    }
+        if (argc > 2) {
+            data_size = std::atoi (argv[1]);
+            max_runs  = std::atoi (argv[2]);
+        }
 
-    DFTBench bench (data_size);
-    LV::Tools::run_benchmark (bench, max_runs);
+        DFTBench bench (data_size);
+        LV::Tools::run_benchmark (bench, max_runs);
 
-    return EXIT_SUCCESS;
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
 }
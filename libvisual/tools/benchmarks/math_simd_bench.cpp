@@ -2,8 +2,11 @@
 #include <libvisual/lv_aligned_allocator.hpp>
 #include "benchmark.hpp"
 #include "random.hpp"
+#include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <cstdlib>
+#include <cmath>
 
 namespace {
 
@@ -148,31 +151,184 @@ namespace {
       Output m_output;
   };
 
+  // Bench class for visual_math_simd_log_floats()
+  class LogFloatsBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      typedef typename Vector<float>::type Input;
+      typedef typename Vector<float>::type Output;
+
+      explicit LogFloatsBench (unsigned int data_size)
+          : Benchmark ("LogFloatsBench")
+          , m_input   (LV::Tools::make_random<Input> (0.001, 1.0, data_size))
+          , m_output  (data_size)
+      {}
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              visual_math_simd_log_floats (m_output.data (), m_input.data (), m_output.size ());
+          }
+      }
+
+      virtual ~LogFloatsBench ()
+      {}
+
+  private:
+
+      Input  m_input;
+      Output m_output;
+  };
+
+  // Bench class for the scalar loop visual_math_simd_log_scale_floats()
+  // replaces, for comparison
+  class LogScaleScalarBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      typedef typename Vector<float>::type Input;
+      typedef typename Vector<float>::type Output;
+
+      explicit LogScaleScalarBench (unsigned int data_size)
+          : Benchmark ("LogScaleScalarBench")
+          , m_input   (LV::Tools::make_random<Input> (0.0, 1.0, data_size))
+          , m_output  (data_size)
+      {}
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              for (unsigned int j = 0; j < m_output.size (); j++) {
+                  if (m_input[j] > 0.001f)
+                      m_output[j] = 1.0f + std::log (m_input[j]) / 6.908f;
+                  else
+                      m_output[j] = 0.0f;
+              }
+          }
+      }
+
+      virtual ~LogScaleScalarBench ()
+      {}
+
+  private:
+
+      Input  m_input;
+      Output m_output;
+  };
+
+  // Bench class for visual_math_simd_log_scale_floats()
+  class LogScaleBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      typedef typename Vector<float>::type Input;
+      typedef typename Vector<float>::type Output;
+
+      explicit LogScaleBench (unsigned int data_size)
+          : Benchmark ("LogScaleBench")
+          , m_input   (LV::Tools::make_random<Input> (0.0, 1.0, data_size))
+          , m_output  (data_size)
+      {}
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              visual_math_simd_log_scale_floats (m_output.data (), m_input.data (), 0.001f, 6.908f, m_output.size ());
+          }
+      }
+
+      virtual ~LogScaleBench ()
+      {}
+
+  private:
+
+      Input  m_input;
+      Output m_output;
+  };
+
+  // Bench class for visual_math_simd_complex_scaled_norm_log_scale()
+  class ComplexScaledNormLogScaleBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      typedef typename Vector<float>::type Input1;
+      typedef typename Vector<float>::type Input2;
+      typedef typename Vector<float>::type Output;
+
+      explicit ComplexScaledNormLogScaleBench (unsigned int data_size)
+          : Benchmark ("ComplexScaledNormLogScaleBench")
+          , m_input1  (LV::Tools::make_random<Input1> (0.0, 1.0, data_size))
+          , m_input2  (LV::Tools::make_random<Input2> (0.0, 1.0, data_size))
+          , m_output  (data_size)
+      {}
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              visual_math_simd_complex_scaled_norm_log_scale (m_output.data (), m_input1.data (), m_input2.data (),
+                                                              0.5f, 0.001f, 6.908f, m_output.size ());
+          }
+      }
+
+      virtual ~ComplexScaledNormLogScaleBench ()
+      {}
+
+  private:
+
+      Input1 m_input1;
+      Input2 m_input2;
+      Output m_output;
+  };
+
 } // anonymous
 
 int main (int argc, char** argv)
 {
-    LV::System::init (argc, argv);
+    try {
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
-    unsigned int data_size = 100000;
-    unsigned int max_runs  = 10000;
+        unsigned int data_size = 100000;
+        unsigned int max_runs  = 10000;
 
-    if (argc > 2) {
-        data_size = std::atoi (argv[1]);
-        max_runs  = std::atoi (argv[2]);
-    }
+        if (argc > 2) {
+            data_size = std::atoi (argv[1]);
+            max_runs  = std::atoi (argv[2]);
+        }
 
-    MulFloatsFloatsBench test1 (data_size);
-    LV::Tools::run_benchmark (test1, max_runs);
+        MulFloatsFloatsBench test1 (data_size);
+        LV::Tools::run_benchmark (test1, max_runs);
 
-    DenormNegBench test2 (data_size);
-    LV::Tools::run_benchmark (test2, max_runs);
+        DenormNegBench test2 (data_size);
+        LV::Tools::run_benchmark (test2, max_runs);
 
-    ComplexNormBench test3 (data_size);
-    LV::Tools::run_benchmark (test3, max_runs);
+        ComplexNormBench test3 (data_size);
+        LV::Tools::run_benchmark (test3, max_runs);
 
-    ComplexScaledNormBench test4 (data_size);
-    LV::Tools::run_benchmark (test4, max_runs);
+        ComplexScaledNormBench test4 (data_size);
+        LV::Tools::run_benchmark (test4, max_runs);
 
-    return EXIT_SUCCESS;
+        LogFloatsBench test5 (data_size);
+        LV::Tools::run_benchmark (test5, max_runs);
+
+        LogScaleScalarBench test6 (data_size);
+        LV::Tools::run_benchmark (test6, max_runs);
+
+        LogScaleBench test7 (data_size);
+        LV::Tools::run_benchmark (test7, max_runs);
+
+        ComplexScaledNormLogScaleBench test8 (data_size);
+        LV::Tools::run_benchmark (test8, max_runs);
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
 }
@@ -1,8 +1,13 @@
 #include "benchmark.hpp"
+#include "random.hpp"
 #include <libvisual/libvisual.h>
 #include <libvisual/lv_util.hpp>
 #include <iostream>
+#include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <vector>
 #include <cstdlib>
 
 namespace {
@@ -12,8 +17,9 @@ namespace {
   {
   public:
 
-      MorphBench (std::string const& morph_name, unsigned int width, unsigned int height, VisVideoDepth depth)
-          : Benchmark { "MorphBench" }
+      MorphBench (std::string const& morph_name, unsigned int width, unsigned int height, VisVideoDepth depth,
+                  std::string const& name = "MorphBench")
+          : Benchmark { name }
           , m_morph { LV::Morph::load (morph_name) }
       {
           if (!m_morph) {
@@ -26,6 +32,12 @@ namespace {
           m_src1 = LV::Video::create (width, height, depth);
           m_src2 = LV::Video::create (width, height, depth);
 
+          // Noise keeps blends from working on constant data
+          for (auto const& video : { m_src1, m_src2 }) {
+              auto pixels = LV::Tools::make_random<std::vector<uint8_t>> (uint8_t (0), uint8_t (255), video->get_size ());
+              std::copy (pixels.begin (), pixels.end (), static_cast<uint8_t*> (video->get_pixels ()));
+          }
+
           m_morph->set_video (m_dest);
       }
 
@@ -55,6 +67,334 @@ namespace {
       LV::VideoPtr m_src2;
   };
 
+  // Bin fed with noise, resized like a display would on depth changes
+  class BenchBin
+  {
+  public:
+
+      BenchBin (std::string const& actor_name, unsigned int width, unsigned int height)
+          : m_width  { width }
+          , m_height { height }
+      {
+          m_bin.set_supported_depth (VISUAL_VIDEO_DEPTH_ALL);
+          m_bin.use_morph (true);
+
+          if (!m_bin.connect (actor_name, "debug")) {
+              throw std::invalid_argument ("Cannot load actor " + actor_name);
+          }
+
+          // Feed noise directly, as the debug plugin paces itself in real
+          // time
+          m_samples = LV::Buffer::create (735 * 2 * sizeof (float));
+          auto samples = LV::Tools::make_random<std::vector<float>> (-1.0f, 1.0f, 735 * 2);
+          m_samples->put (samples.data (), m_samples->get_size (), 0);
+
+          m_bin.get_input ()->set_callback ([this] (LV::Audio& audio) {
+              audio.input (m_samples, VISUAL_AUDIO_SAMPLE_RATE_44100,
+                           VISUAL_AUDIO_SAMPLE_FORMAT_FLOAT, VISUAL_AUDIO_SAMPLE_CHANNEL_STEREO);
+              return true;
+          });
+
+          auto depth = visual_video_depth_get_highest_nogl (m_bin.get_actor ()->get_supported_depths ());
+          m_bin.set_depth (depth);
+
+          m_bin.set_video (LV::Video::create (width, height, depth));
+          m_bin.realize ();
+          m_bin.sync (false);
+          m_bin.depth_changed ();
+      }
+
+      LV::Bin& get ()
+      {
+          return m_bin;
+      }
+
+      void set_morph (std::string const& morph_name)
+      {
+          m_bin.set_morph (morph_name);
+          if (!m_bin.get_morph ()) {
+              throw std::invalid_argument ("Cannot load morph " + morph_name);
+          }
+      }
+
+      void run ()
+      {
+          m_bin.run ();
+
+          sync_depth ();
+      }
+
+      // Gives the bin a new video when it changes depth, as a display would
+      void sync_depth ()
+      {
+          if (m_bin.depth_changed ()) {
+              m_bin.set_video (LV::Video::create (m_width, m_height, m_bin.get_depth ()));
+              m_bin.sync (true);
+          }
+      }
+
+  private:
+
+      LV::Bin       m_bin;
+      LV::BufferPtr m_samples;
+      unsigned int  m_width;
+      unsigned int  m_height;
+  };
+
+  // Renders frames through a Bin, optionally in the middle of a morph from
+  // one actor to another, to time what a transition costs a frame
+  class TransitionBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      TransitionBench (std::string const& name,
+                       std::string const& actor_name,
+                       std::string const& next_actor_name,
+                       std::string const& morph_name,
+                       bool               concurrent,
+                       unsigned int       width,
+                       unsigned int       height)
+          : Benchmark { name }
+          , m_bin     { actor_name, width, height }
+      {
+          if (next_actor_name.empty ())
+              return;
+
+          m_bin.set_morph (morph_name);
+
+          // Long enough for the morph to last all runs
+          m_bin.get ().switch_set_time (LV::Time (24 * 60 * 60, 0));
+          m_bin.get ().set_concurrent_morph (concurrent);
+          m_bin.get ().switch_actor (next_actor_name);
+
+          m_bin.sync_depth ();
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              m_bin.run ();
+          }
+      }
+
+      virtual ~TransitionBench ()
+      {
+          // nothing
+      }
+
+  private:
+
+      BenchBin m_bin;
+  };
+
+  // Renders frames through a Bin and switches actors a quarter of the way
+  // through, recording the time of every frame to find the switch spike
+  class SwitchBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      typedef std::chrono::duration<double, std::micro> Duration;
+
+      SwitchBench (std::string const& name,
+                   std::string const& actor_name,
+                   std::string const& next_actor_name,
+                   std::string const& morph_name,
+                   bool               async,
+                   unsigned int       width,
+                   unsigned int       height)
+          : Benchmark         { name }
+          , m_bin             { actor_name, width, height }
+          , m_next_actor_name { next_actor_name }
+          , m_async           { async }
+      {
+          m_bin.set_morph (morph_name);
+          m_bin.get ().switch_set_time (LV::Time (0, 250 * VISUAL_NSECS_PER_MSEC));
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          m_frame_times.clear ();
+
+          // An async switch may still be loading after max_runs frames
+          for (unsigned int i = 0; i < max_runs || m_bin.get ().is_switch_pending (); i++) {
+              auto start = std::chrono::steady_clock::now ();
+
+              if (i == max_runs / 4) {
+                  if (m_async)
+                      m_bin.get ().switch_actor_async (m_next_actor_name);
+                  else
+                      m_bin.get ().switch_actor (m_next_actor_name);
+
+                  m_bin.sync_depth ();
+              }
+
+              m_bin.run ();
+
+              m_frame_times.push_back (Duration (std::chrono::steady_clock::now () - start).count ());
+          }
+      }
+
+      virtual ~SwitchBench ()
+      {
+          // nothing
+      }
+
+      // Prints the median and worst frame times
+      void print_frame_times () const
+      {
+          auto sorted = m_frame_times;
+          std::sort (sorted.begin (), sorted.end ());
+
+          if (sorted.empty ())
+              return;
+
+          std::cout << "Frames:       " << sorted.size () << "\n"
+                    << "Median frame: " << sorted[sorted.size () / 2] << "us\n"
+                    << "Worst frame:  " << sorted.back () << "us\n\n";
+      }
+
+  private:
+
+      BenchBin            m_bin;
+      std::string         m_next_actor_name;
+      bool                m_async;
+      std::vector<double> m_frame_times;
+  };
+
+  struct BinScenario
+  {
+      std::string  actor_name      = "infinite";
+      std::string  next_actor_name = "jess";
+      std::string  morph_name      = "slide_up";
+      unsigned int width           = 640;
+      unsigned int height          = 480;
+
+      // Parses [actor next_actor] [morph] [width height]
+      BinScenario (int argc, char** argv)
+      {
+          if (argc > 2) {
+              actor_name      = argv[1];
+              next_actor_name = argv[2];
+              argc -= 2; argv += 2;
+          }
+
+          if (argc > 1) {
+              morph_name = argv[1];
+              argc--; argv++;
+          }
+
+          if (argc > 2) {
+              int value1 = std::atoi (argv[1]);
+              int value2 = std::atoi (argv[2]);
+
+              if (value1 <= 0 || value2 <= 0) {
+                  throw std::invalid_argument ("Invalid dimensions specified");
+              }
+
+              width  = value1;
+              height = value2;
+          }
+      }
+  };
+
+  // Times each actor alone, the morph alone, and a transition between the
+  // actors rendered one after the other and concurrently
+  void run_transition_benchmarks (unsigned int max_runs, int argc, char** argv)
+  {
+      BinScenario scenario (argc, argv);
+
+      auto const& actor_name      = scenario.actor_name;
+      auto const& next_actor_name = scenario.next_actor_name;
+
+      // Actors of the same plugin share state, so only one bench is kept
+      // alive at a time
+      auto time_bin = [&] (std::string const& name, std::string const& first, std::string const& next, bool concurrent) {
+          TransitionBench bench ("TransitionBench (" + name + ")", first, next,
+                                 scenario.morph_name, concurrent, scenario.width, scenario.height);
+          return LV::Tools::run_benchmark (bench, max_runs) / max_runs;
+      };
+
+      auto actor_time      = time_bin (actor_name, actor_name, "", false);
+      auto next_actor_time = time_bin (next_actor_name, next_actor_name, "", false);
+      auto serial_time     = time_bin ("serial", actor_name, next_actor_name, false);
+      auto concurrent_time = time_bin ("concurrent", actor_name, next_actor_name, true);
+
+      MorphBench morph_bench (scenario.morph_name, scenario.width, scenario.height, VISUAL_VIDEO_DEPTH_32BIT);
+      auto morph_time = LV::Tools::run_benchmark (morph_bench, max_runs) / max_runs;
+
+      std::cout << "Sum of actors + morph: " << actor_time + next_actor_time + morph_time << "us\n"
+                << "Max of actors + morph: " << std::max (actor_time, next_actor_time) + morph_time << "us\n"
+                << "Serial transition:     " << serial_time << "us\n"
+                << "Concurrent transition: " << concurrent_time << "us\n";
+  }
+
+  // Compares the worst frame of a switch done on the render thread with one
+  // where the next actor is set up in the background
+  void run_switch_benchmarks (unsigned int max_runs, int argc, char** argv)
+  {
+      BinScenario scenario (argc, argv);
+
+      for (bool async : { false, true }) {
+          SwitchBench bench (async ? "SwitchBench (async)" : "SwitchBench (sync)",
+                             scenario.actor_name, scenario.next_actor_name, scenario.morph_name,
+                             async, scenario.width, scenario.height);
+
+          LV::Tools::run_benchmark (bench, max_runs);
+          bench.print_frame_times ();
+      }
+  }
+
+  // Times every morph plugin at every depth, by default at 1080p
+  void run_all_morph_benchmarks (unsigned int max_runs, int argc, char** argv)
+  {
+      unsigned int width  = 1920;
+      unsigned int height = 1080;
+
+      if (argc > 2) {
+          int value1 = std::atoi (argv[1]);
+          int value2 = std::atoi (argv[2]);
+
+          if (value1 <= 0 || value2 <= 0) {
+              throw std::invalid_argument ("Invalid dimensions specified");
+          }
+
+          width  = value1;
+          height = value2;
+      }
+
+      std::vector<std::pair<std::string, std::vector<double>>> results;
+
+      for (auto const& plugin : LV::PluginRegistry::instance ()->get_plugins_by_type (VISUAL_PLUGIN_TYPE_MORPH)) {
+          std::string name = plugin.info->plugname;
+          results.emplace_back (name, std::vector<double> {});
+
+          for (int bpp = 1; bpp <= 4; bpp++) {
+              auto depth = visual_video_depth_from_bpp (bpp * 8);
+
+              MorphBench bench (name, width, height, depth,
+                                "MorphBench (" + name + ", " + std::to_string (bpp * 8) + "-bit)");
+
+              results.back ().second.push_back (LV::Tools::run_benchmark (bench, max_runs) / max_runs);
+          }
+      }
+
+      std::cout << "Time / frame at " << width << "x" << height << " (us)\n"
+                << std::left << std::setw (16) << "morph" << std::right
+                << std::setw (10) << "8-bit" << std::setw (10) << "16-bit"
+                << std::setw (10) << "24-bit" << std::setw (10) << "32-bit" << "\n";
+
+      for (auto const& result : results) {
+          std::cout << std::left << std::setw (16) << result.first << std::right;
+
+          for (auto time : result.second)
+              std::cout << std::setw (10) << int (time + 0.5);
+
+          std::cout << "\n";
+      }
+  }
+
   std::unique_ptr<MorphBench> make_benchmark (int& argc, char** argv)
   {
       std::string   morph_name = "slide_up";
@@ -99,6 +439,7 @@ int main (int argc, char **argv)
 {
     try {
         LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
         unsigned int max_runs = 1000;
 
@@ -113,6 +454,21 @@ int main (int argc, char **argv)
             argc--; argv++;
         }
 
+        if (argc > 1 && std::string (argv[1]) == "--transition") {
+            run_transition_benchmarks (max_runs, argc - 1, argv + 1);
+            return EXIT_SUCCESS;
+        }
+
+        if (argc > 1 && std::string (argv[1]) == "--all") {
+            run_all_morph_benchmarks (max_runs, argc - 1, argv + 1);
+            return EXIT_SUCCESS;
+        }
+
+        if (argc > 1 && std::string (argv[1]) == "--switch") {
+            run_switch_benchmarks (max_runs, argc - 1, argv + 1);
+            return EXIT_SUCCESS;
+        }
+
         auto benchmark = make_benchmark (argc, argv);
         LV::Tools::run_benchmark (*benchmark, max_runs);
 
@@ -1,27 +1,111 @@
 #include "benchmark.hpp"
+#include "random.hpp"
 #include <libvisual/libvisual.h>
 #include <libvisual/lv_util.hpp>
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include <cstdlib>
 
 namespace {
 
+  enum class Operation
+  {
+      BLEND,
+      ALPHASRC,
+      SURFACEALPHA,
+      COLORKEY
+  };
+
+  struct OperationInfo
+  {
+      Operation   operation;
+      char const* name;
+  };
+
+  OperationInfo const operations[] = {
+      { Operation::BLEND,        "blend"        },
+      { Operation::ALPHASRC,     "alphasrc"     },
+      { Operation::SURFACEALPHA, "surfacealpha" },
+      { Operation::COLORKEY,     "colorkey"     }
+  };
+
+  // Times one blend or blit operation with the kernel variant in use
   class VideoAlphaBlendBench
       : public LV::Tools::Benchmark
   {
   public:
 
-      VideoAlphaBlendBench (unsigned int width, unsigned int height, VisVideoDepth depth)
-          : Benchmark { "VideoAlphaBlendBench" }
-          , m_src     { LV::Video::create (width, height, depth) }
-          , m_dest    { LV::Video::create (width, height, depth) }
-      {}
+      VideoAlphaBlendBench (std::string const& name, Operation operation, unsigned int width, unsigned int height, VisVideoDepth depth)
+          : Benchmark   { name }
+          , m_operation { operation }
+          , m_src1      { LV::Video::create (width, height, depth) }
+          , m_src2      { LV::Video::create (width, height, depth) }
+          , m_dest      { LV::Video::create (width, height, depth) }
+      {
+          // Noise gives the colour key and per pixel alpha a mix of cases
+          for (auto const& video : { m_src1, m_src2, m_dest }) {
+              auto pixels = LV::Tools::make_random<std::vector<uint8_t>> (uint8_t (0), uint8_t (255), video->get_size ());
+              std::copy (pixels.begin (), pixels.end (), static_cast<uint8_t*> (video->get_pixels ()));
+          }
+
+          switch (operation) {
+              case Operation::ALPHASRC:
+                  m_src1->set_compose_type (VISUAL_VIDEO_COMPOSE_TYPE_SRC);
+                  break;
+
+              case Operation::SURFACEALPHA:
+                  m_src1->set_compose_type (VISUAL_VIDEO_COMPOSE_TYPE_SURFACE);
+                  m_src1->set_compose_surface (100);
+                  break;
+
+              case Operation::COLORKEY:
+                  m_src1->set_compose_type (VISUAL_VIDEO_COMPOSE_TYPE_COLORKEY);
+                  m_src1->set_compose_colorkey (LV::Color {0, 0, 0});
+                  break;
+
+              default:
+                  break;
+          }
+      }
 
       virtual void operator() (unsigned int max_runs)
       {
+          if (m_operation != Operation::BLEND) {
+              for (unsigned int i = 0; i < max_runs; i++) {
+                  m_dest->blit (m_src1, 0, 0, true);
+              }
+
+              return;
+          }
+
+          auto dest = static_cast<uint8_t*> (m_dest->get_pixels ());
+          auto src1 = static_cast<uint8_t const*> (m_src1->get_pixels ());
+          auto src2 = static_cast<uint8_t const*> (m_src2->get_pixels ());
+
+          auto size  = m_dest->get_size ();
+          auto depth = m_dest->get_depth ();
+
           for (unsigned int i = 0; i < max_runs; i++) {
-              m_dest->blit (m_src, 0, 0, true);
+              auto alpha = uint8_t (i * 7);
+
+              switch (depth) {
+                  case VISUAL_VIDEO_DEPTH_8BIT:
+                      visual_alpha_blend_8  (dest, src1, src2, size, alpha);
+                      break;
+                  case VISUAL_VIDEO_DEPTH_16BIT:
+                      visual_alpha_blend_16 (dest, src1, src2, size, alpha);
+                      break;
+                  case VISUAL_VIDEO_DEPTH_24BIT:
+                      visual_alpha_blend_24 (dest, src1, src2, size / 3, alpha);
+                      break;
+                  default:
+                      visual_alpha_blend_32 (dest, src1, src2, size / 4, alpha);
+                      break;
+              }
           }
       }
 
@@ -30,11 +114,14 @@ namespace {
 
   private:
 
-      LV::VideoPtr m_src;
+      Operation    m_operation;
+      LV::VideoPtr m_src1;
+      LV::VideoPtr m_src2;
       LV::VideoPtr m_dest;
   };
 
-  std::unique_ptr<VideoAlphaBlendBench> make_benchmark (int& argc, char**& argv)
+  // Times every operation with every kernel variant the CPU supports
+  void run_benchmarks (unsigned int max_runs, int argc, char** argv)
   {
       unsigned int  width    = 1024;
       unsigned int  height   = 768;
@@ -63,7 +150,51 @@ namespace {
           argc--; argv++;
       }
 
-      return LV::make_unique<VideoAlphaBlendBench> (width, height, depth);
+      std::string default_variant = visual_alpha_blend_get_variant ();
+
+      std::vector<std::pair<std::string, std::vector<double>>> results;
+
+      for (unsigned int i = 0; auto variant = visual_alpha_blend_get_variant_name (i); i++) {
+          visual_alpha_blend_set_variant (variant);
+          results.emplace_back (variant, std::vector<double> {});
+
+          for (auto const& info : operations) {
+              // Only 32-bit video carries per pixel alpha
+              if (info.operation == Operation::ALPHASRC && depth != VISUAL_VIDEO_DEPTH_32BIT) {
+                  results.back ().second.push_back (-1.0);
+                  continue;
+              }
+
+              VideoAlphaBlendBench bench ("VideoAlphaBlendBench (" + std::string (info.name) + ", " + variant + ")",
+                                          info.operation, width, height, depth);
+
+              results.back ().second.push_back (LV::Tools::run_benchmark (bench, max_runs) / max_runs);
+          }
+      }
+
+      visual_alpha_blend_set_variant (default_variant.c_str ());
+
+      std::cout << "Time / run at " << width << "x" << height << ", "
+                << visual_video_depth_bpp (depth) << "-bit (us)\n"
+                << std::left << std::setw (10) << "variant" << std::right;
+
+      for (auto const& info : operations)
+          std::cout << std::setw (14) << info.name;
+
+      std::cout << "\n";
+
+      for (auto const& result : results) {
+          std::cout << std::left << std::setw (10) << result.first << std::right;
+
+          for (auto time : result.second) {
+              if (time < 0.0)
+                  std::cout << std::setw (14) << "-";
+              else
+                  std::cout << std::setw (14) << std::fixed << std::setprecision (1) << time;
+          }
+
+          std::cout << "\n";
+      }
   }
 
 }
@@ -72,8 +203,9 @@ int main (int argc, char **argv)
 {
     try {
         LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
-        unsigned int max_runs = 100000;
+        unsigned int max_runs = 1000;
 
         if (argc > 1) {
             int value = std::atoi (argv[1]);
@@ -86,8 +218,7 @@ int main (int argc, char **argv)
             argc--; argv++;
         }
 
-        auto bench = make_benchmark (argc, argv);
-        LV::Tools::run_benchmark (*bench, max_runs);
+        run_benchmarks (max_runs, argc, argv);
 
         return EXIT_SUCCESS;
     }
@@ -84,6 +84,7 @@ int main (int argc, char **argv)
 {
     try {
         LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
 
         unsigned int max_runs = 1000;
 
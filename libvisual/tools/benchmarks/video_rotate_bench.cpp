@@ -0,0 +1,207 @@
+#include "benchmark.hpp"
+#include "random.hpp"
+#include <libvisual/libvisual.h>
+#include <libvisual/lv_util.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+namespace {
+
+  struct Transform
+  {
+      char const*           name;
+      VisVideoRotateDegrees degrees;
+      VisVideoMirrorOrient  orient;
+  };
+
+  Transform const transforms[] = {
+      { "rotate_90",  VISUAL_VIDEO_ROTATE_90,   VISUAL_VIDEO_MIRROR_NONE },
+      { "rotate_180", VISUAL_VIDEO_ROTATE_180,  VISUAL_VIDEO_MIRROR_NONE },
+      { "rotate_270", VISUAL_VIDEO_ROTATE_270,  VISUAL_VIDEO_MIRROR_NONE },
+      { "mirror_x",   VISUAL_VIDEO_ROTATE_NONE, VISUAL_VIDEO_MIRROR_X    },
+      { "mirror_y",   VISUAL_VIDEO_ROTATE_NONE, VISUAL_VIDEO_MIRROR_Y    }
+  };
+
+  Transform const& find_transform (std::string const& name)
+  {
+      for (auto const& transform : transforms) {
+          if (name == transform.name)
+              return transform;
+      }
+
+      throw std::invalid_argument ("Unknown transform " + name);
+  }
+
+  class VideoRotateBench
+      : public LV::Tools::Benchmark
+  {
+  public:
+
+      VideoRotateBench (Transform const& transform, unsigned int width, unsigned int height, VisVideoDepth depth)
+          : Benchmark   { std::string ("VideoRotateBench (") + transform.name + ")" }
+          , m_transform ( transform )
+          , m_src       { LV::Video::create (width, height, depth) }
+      {
+          bool swap_sides = transform.degrees == VISUAL_VIDEO_ROTATE_90 || transform.degrees == VISUAL_VIDEO_ROTATE_270;
+
+          m_dst = swap_sides ? LV::Video::create (height, width, depth)
+                             : LV::Video::create (width, height, depth);
+
+          auto pixels = LV::Tools::make_random<std::vector<uint8_t>> (uint8_t (0), uint8_t (255), m_src->get_size ());
+          std::copy (pixels.begin (), pixels.end (), static_cast<uint8_t*> (m_src->get_pixels ()));
+      }
+
+      virtual void operator() (unsigned int max_runs)
+      {
+          for (unsigned int i = 0; i < max_runs; i++) {
+              if (m_transform.degrees != VISUAL_VIDEO_ROTATE_NONE)
+                  m_dst->rotate (m_src, m_transform.degrees);
+              else
+                  m_dst->mirror (m_src, m_transform.orient);
+          }
+      }
+
+      virtual ~VideoRotateBench ()
+      {}
+
+  private:
+
+      Transform const& m_transform;
+      LV::VideoPtr     m_src;
+      LV::VideoPtr     m_dst;
+  };
+
+  // Times every transform over a range of resolutions. Time per pixel
+  // should hold steady as frames outgrow the caches.
+  void run_all_benchmarks (unsigned int max_runs, int argc, char** argv)
+  {
+      VisVideoDepth depth = VISUAL_VIDEO_DEPTH_32BIT;
+
+      if (argc > 1) {
+          depth = visual_video_depth_from_bpp (std::atoi (argv[1]));
+          if (depth == VISUAL_VIDEO_DEPTH_NONE) {
+              throw std::invalid_argument ("Invalid video depth specified");
+          }
+      }
+
+      struct Size { unsigned int width, height; };
+
+      Size const sizes[] = { { 320, 240 }, { 640, 480 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+      std::vector<std::pair<std::string, std::vector<double>>> results;
+
+      for (auto const& transform : transforms) {
+          results.emplace_back (transform.name, std::vector<double> {});
+
+          for (auto const& size : sizes) {
+              VideoRotateBench bench (transform, size.width, size.height, depth);
+
+              // Fewer runs for larger frames, keeping the total time similar
+              auto runs = std::max (1u, unsigned (max_runs * 320.0 * 240.0 / (size.width * size.height)));
+
+              double time = LV::Tools::run_benchmark (bench, runs) / runs;
+              results.back ().second.push_back (time * 1000.0 / (size.width * size.height));
+          }
+      }
+
+      std::cout << "Time / pixel at " << visual_video_depth_bpp (depth) << "-bit (ns)\n"
+                << std::left << std::setw (12) << "transform" << std::right;
+
+      for (auto const& size : sizes)
+          std::cout << std::setw (11) << (std::to_string (size.width) + "x" + std::to_string (size.height));
+
+      std::cout << "\n";
+
+      for (auto const& result : results) {
+          std::cout << std::left << std::setw (12) << result.first << std::right;
+
+          for (auto time : result.second)
+              std::cout << std::setw (11) << std::fixed << std::setprecision (2) << time;
+
+          std::cout << "\n";
+      }
+  }
+
+  std::unique_ptr<VideoRotateBench> make_benchmark (int& argc, char**& argv)
+  {
+      std::string   name   = "rotate_90";
+      unsigned int  width  = 1920;
+      unsigned int  height = 1080;
+      VisVideoDepth depth  = VISUAL_VIDEO_DEPTH_32BIT;
+
+      if (argc > 1) {
+          name = argv[1];
+          argc--; argv++;
+      }
+
+      if (argc > 2) {
+          int value1 = std::atoi (argv[1]);
+          int value2 = std::atoi (argv[2]);
+
+          if (value1 <= 0 || value2 <= 0) {
+              throw std::invalid_argument ("Invalid dimensions specified");
+          }
+
+          width  = value1;
+          height = value2;
+
+          argc -= 2; argv += 2;
+      }
+
+      if (argc > 1) {
+          depth = visual_video_depth_from_bpp (std::atoi (argv[1]));
+          if (depth == VISUAL_VIDEO_DEPTH_NONE) {
+              throw std::invalid_argument ("Invalid video depth specified");
+          }
+
+          argc--; argv++;
+      }
+
+      return LV::make_unique<VideoRotateBench> (find_transform (name), width, height, depth);
+  }
+
+}
+
+int main (int argc, char **argv)
+{
+    try {
+        LV::System::init (argc, argv);
+        LV::Tools::init_benchmarks (argc, argv);
+
+        unsigned int max_runs = 1000;
+
+        if (argc > 1) {
+            int value = std::atoi (argv[1]);
+            if (value <= 0) {
+                throw std::invalid_argument ("Number of runs is non-positive");
+            }
+
+            max_runs = value;
+
+            argc--; argv++;
+        }
+
+        if (argc > 1 && std::string (argv[1]) == "--all") {
+            run_all_benchmarks (max_runs, argc - 1, argv + 1);
+            return EXIT_SUCCESS;
+        }
+
+        auto bench = make_benchmark (argc, argv);
+        LV::Tools::run_benchmark (*bench, max_runs);
+
+        return EXIT_SUCCESS;
+    }
+    catch (std::exception& error) {
+        std::cerr << "Exception caught: " << error.what () << std::endl;
+        return EXIT_FAILURE;
+    }
+    catch (...) {
+        std::cerr << "Unknown exception caught\n";
+        return EXIT_FAILURE;
+    }
+}
@@ -108,6 +108,18 @@ void Display::update_rect (LV::Rect const& rect)
     m_impl->driver->update_rect (rect);
 }
 
+void Display::update_damage ()
+{
+    LV::VideoPtr video = get_video ();
+
+    if (!video->has_damage ()) {
+        update_all ();
+        return;
+    }
+
+    m_impl->driver->update_rects (video->get_damage ());
+}
+
 void Display::set_fullscreen (bool fullscreen, bool autoscale)
 {
     m_impl->driver->set_fullscreen (fullscreen, autoscale);
@@ -26,6 +26,7 @@
 #define _LV_TOOL_DISPLAY_DRIVER_HPP
 
 #include <string>
+#include <vector>
 #include <libvisual/libvisual.h>
 
 class Display;
@@ -49,6 +50,18 @@ public:
 
     virtual void update_rect (LV::Rect const& rect) = 0;
 
+    // Pushes a set of changed areas. Drivers that cannot update areas
+    // separately update the bounding box.
+    virtual void update_rects (std::vector<LV::Rect> const& rects)
+    {
+        LV::Rect bounds;
+
+        for (auto const& rect : rects)
+            bounds = bounds.unite (rect);
+
+        update_rect (bounds);
+    }
+
     virtual void drain_events (VisEventQueue& eventqueue) = 0;
 
     virtual LV::VideoPtr get_video () const = 0;
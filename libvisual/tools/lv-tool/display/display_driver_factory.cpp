@@ -25,6 +25,7 @@
 #include "config.h"
 #include "display_driver_factory.hpp"
 #include "stdout_driver.hpp"
+#include "stdout_spans_driver.hpp"
 
 #if HAVE_SDL
 #include "sdl_driver.hpp"
@@ -46,6 +47,7 @@ DisplayDriverFactory::DisplayDriverFactory ()
     : m_impl (new Impl)
 {
     add_driver ("stdout", stdout_driver_new);
+    add_driver ("stdout_spans", stdout_spans_driver_new);
 #if defined(HAVE_SDL)
     add_driver ("sdl", sdl_driver_new);
     add_driver ("stdout_sdl", stdout_sdl_driver_new);
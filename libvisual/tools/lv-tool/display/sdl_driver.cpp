@@ -29,6 +29,7 @@
 
 #include <SDL/SDL.h>
 #include <array>
+#include <vector>
 
 namespace {
 
@@ -221,22 +222,7 @@ namespace {
 
       virtual void update_rect (LV::Rect const& rect)
       {
-          if (m_screen->format->BitsPerPixel == 8) {
-              auto const& pal = m_display.get_video ()->get_palette ();
-
-              if (!pal.empty () && pal.size() <= 256) {
-                  std::array<SDL_Color, 256> colors;
-                  visual_mem_set (colors.data (), 0, sizeof (colors));
-
-                  for (unsigned int i = 0; i < pal.size(); i++) {
-                      colors[i].r = pal.colors[i].r;
-                      colors[i].g = pal.colors[i].g;
-                      colors[i].b = pal.colors[i].b;
-                  }
-
-                  SDL_SetColors (m_screen, colors.data (), 0, 256);
-              }
-          }
+          update_palette ();
 
           if (m_requested_depth == VISUAL_VIDEO_DEPTH_GL)
               SDL_GL_SwapBuffers ();
@@ -244,6 +230,34 @@ namespace {
               SDL_UpdateRect (m_screen, rect.x, rect.y, rect.width, rect.height);
       }
 
+      virtual void update_rects (std::vector<LV::Rect> const& rects)
+      {
+          if (m_requested_depth == VISUAL_VIDEO_DEPTH_GL) {
+              update_rect (LV::Rect ());
+              return;
+          }
+
+          update_palette ();
+
+          if (rects.empty ())
+              return;
+
+          std::vector<SDL_Rect> sdl_rects;
+          sdl_rects.reserve (rects.size ());
+
+          for (auto const& rect : rects) {
+              SDL_Rect sdl_rect;
+              sdl_rect.x = rect.x;
+              sdl_rect.y = rect.y;
+              sdl_rect.w = rect.width;
+              sdl_rect.h = rect.height;
+
+              sdl_rects.push_back (sdl_rect);
+          }
+
+          SDL_UpdateRects (m_screen, sdl_rects.size (), sdl_rects.data ());
+      }
+
       virtual void drain_events (VisEventQueue& eventqueue)
       {
           // Visible or not
@@ -322,6 +336,26 @@ namespace {
 
   private:
 
+      void update_palette ()
+      {
+          if (m_screen->format->BitsPerPixel == 8) {
+              auto const& pal = m_display.get_video ()->get_palette ();
+
+              if (!pal.empty () && pal.size() <= 256) {
+                  std::array<SDL_Color, 256> colors;
+                  visual_mem_set (colors.data (), 0, sizeof (colors));
+
+                  for (unsigned int i = 0; i < pal.size(); i++) {
+                      colors[i].r = pal.colors[i].r;
+                      colors[i].g = pal.colors[i].g;
+                      colors[i].b = pal.colors[i].b;
+                  }
+
+                  SDL_SetColors (m_screen, colors.data (), 0, 256);
+              }
+          }
+      }
+
       Display&    m_display;
       SDL_Surface*  m_screen;
       LV::VideoPtr  m_screen_video;
@@ -0,0 +1,188 @@
+// lv-tool - Libvisual commandline tool
+//
+// Copyright (C) 2012-2013 Libvisual team
+//               2004-2006 Dennis Smit
+//
+// Authors: Daniel Hiepler <daniel@niftylight.de>
+//          Chong Kai Xiong <kaixiong@codeleft.sg>
+//          Dennis Smit <ds@nerds-incorporated.org>
+//
+// This file is part of lv-tool.
+//
+// lv-tool is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// lv-tool is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with lv-tool.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdout_spans_driver.hpp"
+#include "display.hpp"
+#include "display_driver.hpp"
+#include <libvisual/libvisual.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// MinGW unistd.h doesn't have *_FILENO or SEEK_* defined
+#ifdef VISUAL_WITH_MINGW
+#  define STDOUT_FILENO 1
+#endif
+
+// Writes only the rows of each frame that changed, for sinks where
+// bandwidth is scarce, such as serial or network attached LED panels.
+//
+// Every frame starts with a 32-bit count of spans. Each span has a
+// header of three 16-bit values, x, y and width, followed by width
+// pixels. All values are in host byte order. A frame without changes
+// has no spans.
+
+namespace {
+
+  class StdoutSpansDriver
+      : public DisplayDriver
+  {
+  public:
+
+      StdoutSpansDriver (Display& display)
+      {}
+
+      virtual ~StdoutSpansDriver ()
+      {
+          close ();
+      }
+
+      virtual LV::VideoPtr create (VisVideoDepth depth,
+                                   VisVideoAttrOptions const* vidoptions,
+                                   unsigned int width,
+                                   unsigned int height,
+                                   bool resizable)
+      {
+          if (depth == VISUAL_VIDEO_DEPTH_GL)
+          {
+              visual_log (VISUAL_LOG_ERROR, "Cannot use stdout_spans driver for OpenGL rendering");
+              return nullptr;
+          }
+
+          if (width > UINT16_MAX || height > UINT16_MAX)
+          {
+              visual_log (VISUAL_LOG_ERROR, "Dimensions too large for stdout_spans driver");
+              return nullptr;
+          }
+
+          m_screen_video = LV::Video::create (width, height, depth);
+
+          return m_screen_video;
+      }
+
+      virtual void close ()
+      {
+          m_screen_video.reset ();
+      }
+
+      virtual void lock ()
+      {
+          // nothing to do
+      }
+
+      virtual void unlock ()
+      {
+          // nothing to do
+      }
+
+      virtual void set_fullscreen (bool fullscreen, bool autoscale)
+      {
+          // nothing to do
+      }
+
+      virtual LV::VideoPtr get_video () const
+      {
+          return m_screen_video;
+      }
+
+      virtual void set_title(std::string const& title)
+      {
+          // nothing to do
+      }
+
+      virtual void update_rect (LV::Rect const& rect)
+      {
+          update_rects ({ rect });
+      }
+
+      virtual void update_rects (std::vector<LV::Rect> const& rects)
+      {
+          uint32_t span_count = 0;
+
+          for (auto const& rect : rects) {
+              if (!rect.empty ())
+                  span_count += rect.height;
+          }
+
+          m_frame.clear ();
+          append (&span_count, sizeof (span_count));
+
+          int bpp = m_screen_video->get_bpp ();
+
+          for (auto const& rect : rects) {
+              if (rect.empty ())
+                  continue;
+
+              for (int y = rect.y; y < rect.y + rect.height; y++) {
+                  uint16_t const header[3] = { uint16_t (rect.x), uint16_t (y), uint16_t (rect.width) };
+
+                  append (header, sizeof (header));
+                  append (m_screen_video->get_pixel_ptr (rect.x, y), rect.width * bpp);
+              }
+          }
+
+          write_frame ();
+      }
+
+      virtual void drain_events (VisEventQueue& eventqueue)
+      {
+          // nothing to do
+      }
+
+  private:
+
+      LV::VideoPtr         m_screen_video;
+      std::vector<uint8_t> m_frame;
+
+      void append (void const* data, std::size_t size)
+      {
+          auto bytes = static_cast<uint8_t const*> (data);
+          m_frame.insert (m_frame.end (), bytes, bytes + size);
+      }
+
+      void write_frame ()
+      {
+          // A partial frame would corrupt the stream, so finish short writes
+          std::size_t written = 0;
+
+          while (written < m_frame.size ()) {
+              auto result = write (STDOUT_FILENO, m_frame.data () + written, m_frame.size () - written);
+              if (result == -1) {
+                  visual_log (VISUAL_LOG_ERROR, "Failed to write spans to stdout");
+                  return;
+              }
+
+              written += result;
+          }
+      }
+  };
+
+} // anonymous namespace
+
+// creator
+DisplayDriver* stdout_spans_driver_new (Display& display)
+{
+    return new StdoutSpansDriver (display);
+}
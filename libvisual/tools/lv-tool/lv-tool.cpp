@@ -71,6 +71,9 @@ namespace {
   bool have_seed = 0;
   uint32_t seed = 0;
 
+  bool show_stats = false;
+  std::string trace_filename;
+
   volatile std::sig_atomic_t terminate_process = false;
 
   enum class CycleDir
@@ -161,6 +164,25 @@ namespace {
 
   }
 
+  /** print time spent in each pipeline stage */
+  void print_profile_stats ()
+  {
+      auto stats = LV::System::instance()->get_profile_stats ();
+
+      std::fprintf (stderr, "%-8s %-16s %8s %10s %10s %10s %10s %10s\n",
+                    "stage", "plugin", "count", "mean", "p50", "p95", "p99", "max");
+
+      for (auto const& entry : stats) {
+          std::fprintf (stderr, "%-8s %-16s %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+                        visual_profile_stage_name (entry.stage),
+                        entry.name.c_str (),
+                        static_cast<unsigned long long> (entry.count),
+                        entry.mean, entry.p50, entry.p95, entry.p99, entry.max);
+      }
+
+      std::fprintf (stderr, "(times in microseconds)\n");
+  }
+
   /** print commandline help */
   void print_help(std::string const& name)
   {
@@ -180,6 +202,8 @@ namespace {
                   "\t--framecount <n>\t-F <n>\t\tOutput n frames, then exit.\n"
                   "\t--switch <n>\t\t-S <n>\t\tSwitch actor after n frames.\n"
                   "\t--exclude <actors>\t-x <actors>\tProvide a list of actors to exclude.\n"
+                  "\t--stats\t\t\t-P\t\tPrint time spent in each pipeline stage on exit.\n"
+                  "\t--trace <file>\t\t-t <file>\tWrite a Chrome trace of pipeline stages to file.\n"
                   "\n",
                   name.c_str (),
                   width, height,
@@ -221,12 +245,14 @@ namespace {
           {"framecount",  required_argument, 0, 'F'},
           {"switch",      required_argument, 0, 'S'},
           {"depth",       required_argument, 0, 'c'},
+          {"stats",       no_argument,       0, 'P'},
+          {"trace",       required_argument, 0, 't'},
           {0,             0,                 0,  0 }
       };
 
       int index, argument;
 
-      while ((argument = getopt_long(argc, argv, "hpvD:d:i:a:m:f:s:F:S:x:c:", loptions, &index)) >= 0) {
+      while ((argument = getopt_long(argc, argv, "hpvD:d:i:a:m:f:s:F:S:x:c:Pt:", loptions, &index)) >= 0) {
 
           switch(argument) {
               // --help
@@ -343,6 +369,18 @@ namespace {
                   break;
               }
 
+              // --stats
+              case 'P': {
+                  show_stats = true;
+                  break;
+              }
+
+              // --trace
+              case 't': {
+                  trace_filename = optarg;
+                  break;
+              }
+
               // invalid argument
               case '?': {
                   print_help(argv[0]);
@@ -441,6 +479,15 @@ int main (int argc, char **argv)
             LV::System::instance()->set_rng_seed (seed);
         }
 
+        // Time pipeline stages
+        if (show_stats || !trace_filename.empty ()) {
+            LV::System::instance()->set_profiling (true);
+        }
+
+        if (!trace_filename.empty () && !LV::System::instance()->start_profile_trace (trace_filename)) {
+            throw std::runtime_error ("Failed to open trace file '" + trace_filename + "'");
+        }
+
         // create new VisBin for video output
         LV::Bin bin;
         bin.set_supported_depth(VISUAL_VIDEO_DEPTH_ALL);
@@ -521,7 +568,7 @@ int main (int argc, char **argv)
             // Check if process termination was signaled
             if (terminate_process) {
                 std::cerr << "Received signal to terminate process, exiting..\n";
-                return EXIT_SUCCESS;
+                break;
             }
 
             // Control frame rate
@@ -537,8 +584,11 @@ int main (int argc, char **argv)
                 // Draw audio data and render
                 bin.run();
 
-                // Display rendering
-                display.update_all ();
+                // Display the areas changed by rendering
+                {
+                    LV::ProfileScope scope {VISUAL_PROFILE_STAGE_DISPLAY, driver_name.c_str ()};
+                    display.update_damage ();
+                }
 
                 // Record frame time
                 last_frame_time = LV::Time::now ();
@@ -679,6 +729,20 @@ int main (int argc, char **argv)
             }
         }
 
+        auto latency = bin.get_input ()->get_audio ().get_latency_stats ();
+
+        if (latency.count > 0) {
+            visual_log (VISUAL_LOG_INFO,
+                        "Audio latency over %u frames: median %.1f ms, 90%% %.1f ms, 99%% %.1f ms, max %.1f ms",
+                        latency.count, latency.median, latency.p90, latency.p99, latency.max);
+        }
+
+        if (show_stats) {
+            print_profile_stats ();
+        }
+
+        LV::System::instance()->stop_profile_trace ();
+
         return EXIT_SUCCESS;
     }
     catch (std::exception& error) {